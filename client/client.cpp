@@ -49,15 +49,6 @@ auto rtrim(std::string &s) -> std::string &
 
 auto trim(std::string &s) -> std::string & { return ltrim(rtrim(s)); }
 
-void Split(const std::string &s, char delim, std::vector<std::string> &elems)
-{
-  std::stringstream ss(s);
-  std::string       item;
-  while (std::getline(ss, item, delim)) {
-    elems.push_back(item);
-  }
-}
-
 class Client
 {
 
@@ -200,8 +191,10 @@ private:
 
   void DoReceive()
   {
-    std::vector<int> col_width;
-    size_t           rec_num = 0;
+    std::vector<int>                      col_width;
+    std::vector<net::NetColumn>           columns;
+    std::vector<std::vector<std::string>> records;
+    size_t                                rec_num = 0;
     while (err_no_ >= 0) {
       Receive();
       if (pkg_.type_ == net::NET_PKG_OK) {
@@ -214,11 +207,24 @@ private:
         break;
       } else if (pkg_.type_ == net::NET_PKG_REC_HEADER) {
         output_ << std::endl;
-        PrintRecord(std::string(pkg_.buf_, pkg_.len_), col_width);
+        if (!net::DecodeRecHeader(pkg_, columns)) {
+          WSDB_LOG("ERROR malformed result header");
+          err_no_ = -1;
+          break;
+        }
+        std::vector<std::string> names;
+        for (auto &col : columns) {
+          names.push_back(col.name_);
+        }
+        PrintRecord(names, col_width);
       } else if (pkg_.type_ == net::NET_PKG_REC_BODY) {
-        // records are seperated by '\0'
-        std::vector<std::string> records;
-        Split(std::string(pkg_.buf_, pkg_.len_), '\0', records);
+        // a body packs as many binary records as fit in one package, see net.h
+        records.clear();
+        if (!net::DecodeRecBody(pkg_, columns, records)) {
+          WSDB_LOG("ERROR malformed result records");
+          err_no_ = -1;
+          break;
+        }
         for (auto &rec : records) {
           PrintRecord(rec, col_width);
         }
@@ -244,11 +250,9 @@ private:
     output_ << std::endl;
   }
 
-  void PrintRecord(const std::string &rec, std::vector<int> &col_width)
+  void PrintRecord(const std::vector<std::string> &fields, std::vector<int> &col_width)
   {
-    // the header is one line seperated by '\t', should construct a table using '+' and '-'
-    std::vector<std::string> fields;
-    Split(rec, '\t', fields);
+    // construct a table using '+' and '-'
     if (col_width.empty()) {
       for (auto &f : fields) {
         col_width.push_back(std::max(static_cast<int>(f.size()) + 2, 14));
@@ -66,6 +66,10 @@ namespace wsdb {
  * @a WSDB_UNSUPPORTED_OP: unsupported operation
  * @a WSDB_UNEXPECTED_NULL: unexpected null value after adequate check
  * @a WSDB_CLIENT_DOWN: client down, should close the client connection
+ * @a WSDB_INDEX_MISS: index not exists on the given fields
+ * @a WSDB_INDEX_EXIST: index already exists on the given fields
+ * @a WSDB_STMT_MISS: prepared statement not exists in the session
+ * @a WSDB_STMT_EXIST: prepared statement already exists when attempting to prepare another one of the same name
  */
 #define ENUM_ENTITIES          \
   ENUM(WSDB_EXCEPTION_EMPTY)   \
@@ -95,7 +99,11 @@ namespace wsdb {
   ENUM(WSDB_TYPE_MISSMATCH)    \
   ENUM(WSDB_UNSUPPORTED_OP)    \
   ENUM(WSDB_UNEXPECTED_NULL)   \
-  ENUM(WSDB_CLIENT_DOWN)
+  ENUM(WSDB_CLIENT_DOWN)       \
+  ENUM(WSDB_INDEX_MISS)        \
+  ENUM(WSDB_INDEX_EXIST)       \
+  ENUM(WSDB_STMT_MISS)         \
+  ENUM(WSDB_STMT_EXIST)
 #define ENUM(ent) ENUMENTRY(ent)
 DECLARE_ENUM(WSDBExceptionType)
 #undef ENUM
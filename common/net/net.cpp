@@ -19,7 +19,9 @@
 // Created by ziqi on 2024/7/31.
 //
 #include <sys/socket.h>
+#include <sys/uio.h>
 #include <netinet/in.h>
+#include <cstring>
 #include "net.h"
 #include "../error.h"
 #include "../micro.h"
@@ -44,25 +46,6 @@ static ssize_t readn(int sockfd, char *buf, int len)
   return len;
 }
 
-static ssize_t writen(int sockfd, char *buf, int len)
-{
-  ssize_t n;
-  ssize_t nleft = len;
-  while (nleft > 0) {
-    n = write(sockfd, buf, nleft);
-    if (n < 0) {
-      WSDB_LOG("ERROR writing to socket");
-      return -1;
-    } else if (n == 0) {
-      WSDB_LOG(fmt::format("connection to {} closed", sockfd));
-      return -1;
-    }
-    nleft -= n;
-    buf += n;
-  }
-  return len;
-}
-
 int ReadNetPkg(int sockfd, NetPkg &pkg)
 {
   // read pkg type
@@ -73,6 +56,10 @@ int ReadNetPkg(int sockfd, NetPkg &pkg)
   n = readn(sockfd, (char *)&pkg.len_, sizeof(pkg.len_));
   if (n <= 0)
     return static_cast<int>(n);
+  if (pkg.len_ > NET_BUFFER_SIZE) {
+    WSDB_LOG(fmt::format("package of {} bytes from {} is too large", pkg.len_, sockfd));
+    return -1;
+  }
   // read pkg data
   if (pkg.len_ == 0) {
     return static_cast<int>(sizeof(pkg.type_) + sizeof(pkg.len_));
@@ -85,21 +72,176 @@ int ReadNetPkg(int sockfd, NetPkg &pkg)
 
 int WriteNetPkg(int sockfd, NetPkg &pkg)
 {
-  // write pkg type
-  auto n = writen(sockfd, (char *)&pkg.type_, sizeof(pkg.type_));
-  if (n <= 0)
-    return static_cast<int>(n);
-  // write pkg length
-  n = writen(sockfd, (char *)&pkg.len_, sizeof(pkg.len_));
-  if (n <= 0)
-    return static_cast<int>(n);
-  // write pkg data
-  if (pkg.len_ == 0) {
-    return static_cast<int>(sizeof(pkg.type_) + sizeof(pkg.len_));
+  // the whole package in one call, a small one is not held back by nagle until its header is acked
+  iovec  iov[3] = {{&pkg.type_, sizeof(pkg.type_)}, {&pkg.len_, sizeof(pkg.len_)}, {pkg.buf_, pkg.len_}};
+  iovec *pos    = iov;
+  int    left   = 3;
+  while (left > 0) {
+    auto n = writev(sockfd, pos, left);
+    if (n < 0) {
+      WSDB_LOG("ERROR writing to socket");
+      return -1;
+    } else if (n == 0) {
+      WSDB_LOG(fmt::format("connection to {} closed", sockfd));
+      return -1;
+    }
+    for (; left > 0 && static_cast<size_t>(n) >= pos->iov_len; pos++, left--) {
+      n -= static_cast<ssize_t>(pos->iov_len);
+    }
+    if (left > 0) {
+      pos->iov_base = static_cast<char *>(pos->iov_base) + n;
+      pos->iov_len -= n;
+    }
   }
-  n = writen(sockfd, pkg.buf_, static_cast<int>(pkg.len_));
-  if (n <= 0)
-    return static_cast<int>(n);
-  return static_cast<int>(sizeof(pkg.type_) + sizeof(pkg.len_) + n);
+  return static_cast<int>(sizeof(pkg.type_) + sizeof(pkg.len_) + pkg.len_);
+}
+
+void AppendNetPkg(const NetPkg &pkg, std::string &out)
+{
+  out.append(reinterpret_cast<const char *>(&pkg.type_), sizeof(pkg.type_));
+  out.append(reinterpret_cast<const char *>(&pkg.len_), sizeof(pkg.len_));
+  out.append(pkg.buf_, pkg.len_);
+}
+
+auto ParseNetPkg(const char *data, size_t size, NetPkgType &type, std::string_view &body) -> ssize_t
+{
+  constexpr size_t header_size = sizeof(NetPkg::type_) + sizeof(NetPkg::len_);
+  if (size < header_size) {
+    return 0;
+  }
+  size_t len;
+  memcpy(&type, data, sizeof(NetPkg::type_));
+  memcpy(&len, data + sizeof(NetPkg::type_), sizeof(NetPkg::len_));
+  if (len > NET_BUFFER_SIZE) {
+    return -1;
+  }
+  if (size < header_size + len) {
+    return 0;
+  }
+  body = std::string_view(data + header_size, len);
+  return static_cast<ssize_t>(header_size + len);
+}
+
+template <typename T>
+static void Put(NetPkg &pkg, T value)
+{
+  memcpy(pkg.buf_ + pkg.len_, &value, sizeof(T));
+  pkg.len_ += sizeof(T);
+}
+
+/// read a T at pos and move past it, false if it does not end before end
+template <typename T>
+static auto Get(const char *&pos, const char *end, T &value) -> bool
+{
+  if (static_cast<size_t>(end - pos) < sizeof(T)) {
+    return false;
+  }
+  memcpy(&value, pos, sizeof(T));
+  pos += sizeof(T);
+  return true;
+}
+
+/// point str at the len bytes at pos and move past them, false if they do not end before end
+static auto GetBytes(const char *&pos, const char *end, size_t len, std::string &str) -> bool
+{
+  if (static_cast<size_t>(end - pos) < len) {
+    return false;
+  }
+  str.assign(pos, len);
+  pos += len;
+  return true;
+}
+
+void EncodeRecHeader(const std::vector<NetColumn> &columns, NetPkg &pkg)
+{
+  pkg.type_ = NET_PKG_REC_HEADER;
+  pkg.len_  = 0;
+  Put(pkg, static_cast<uint32_t>(columns.size()));
+  for (const auto &column : columns) {
+    auto name_len = std::min(column.name_.size(), NET_BUFFER_SIZE - pkg.len_ - sizeof(uint8_t) - sizeof(uint16_t));
+    Put(pkg, column.type_);
+    Put(pkg, static_cast<uint16_t>(name_len));
+    memcpy(pkg.buf_ + pkg.len_, column.name_.data(), name_len);
+    pkg.len_ += name_len;
+  }
+}
+
+auto DecodeRecHeader(const NetPkg &pkg, std::vector<NetColumn> &columns) -> bool
+{
+  const char *pos = pkg.buf_;
+  const char *end = pkg.buf_ + std::min(pkg.len_, NET_BUFFER_SIZE);
+  uint32_t    column_num;
+  // a column takes at least its type and name length, a larger count cannot be right
+  if (!Get(pos, end, column_num) ||
+      column_num > static_cast<size_t>(end - pos) / (sizeof(NetFieldType) + sizeof(uint16_t))) {
+    return false;
+  }
+  columns.assign(column_num, NetColumn{});
+  for (auto &column : columns) {
+    uint16_t name_len;
+    if (!Get(pos, end, column.type_) || column.type_ > NET_FIELD_STRING || !Get(pos, end, name_len) ||
+        !GetBytes(pos, end, name_len, column.name_)) {
+      columns.clear();
+      return false;
+    }
+  }
+  return pos == end;
+}
+
+auto DecodeRecBody(const NetPkg &pkg, const std::vector<NetColumn> &columns,
+    std::vector<std::vector<std::string>> &records) -> bool
+{
+  const char              *pos          = pkg.buf_;
+  const char              *end          = pkg.buf_ + std::min(pkg.len_, NET_BUFFER_SIZE);
+  size_t                   nullmap_size = (columns.size() + 7) / 8;
+  std::vector<std::string> record;
+  while (pos < end) {
+    if (static_cast<size_t>(end - pos) < nullmap_size) {
+      return false;
+    }
+    const char *nullmap = pos;
+    pos += nullmap_size;
+    record.assign(columns.size(), std::string());
+    for (size_t i = 0; i < columns.size(); i++) {
+      if ((nullmap[i / 8] & (1 << (i % 8))) != 0) {
+        record[i] = "(null)";
+        continue;
+      }
+      bool ok = false;
+      switch (columns[i].type_) {
+        case NET_FIELD_INT: {
+          int32_t value;
+          if ((ok = Get(pos, end, value))) {
+            record[i] = std::to_string(value);
+          }
+          break;
+        }
+        case NET_FIELD_FLOAT: {
+          float value;
+          if ((ok = Get(pos, end, value))) {
+            record[i] = std::to_string(value);
+          }
+          break;
+        }
+        case NET_FIELD_BOOL: {
+          uint8_t value;
+          if ((ok = Get(pos, end, value))) {
+            record[i] = std::to_string(static_cast<bool>(value));
+          }
+          break;
+        }
+        case NET_FIELD_STRING: {
+          uint16_t len;
+          ok = Get(pos, end, len) && GetBytes(pos, end, len, record[i]);
+          break;
+        }
+      }
+      if (!ok) {
+        return false;
+      }
+    }
+    records.push_back(std::move(record));
+  }
+  return true;
 }
 }  // namespace net
@@ -19,17 +19,45 @@
 // Created by ziqi on 2024/7/31.
 //
 
+/**
+ * @brief Packets between the server and the clients.
+ *
+ * A result set is sent as a NET_PKG_REC_HEADER, any number of NET_PKG_REC_BODY and a NET_PKG_REC_END, integers are
+ * little endian:
+ *  - REC_HEADER: uint32 column count, then per column a uint8 NetFieldType, a uint16 name length and the name
+ *  - REC_BODY: as many records as fit in the packet, each a null bitmap of (column count + 7) / 8 bytes followed by
+ *    the values that are not null: int32 and float in 4 bytes, bool in 1 byte, strings as a uint16 length and the
+ *    bytes without padding
+ */
+
 #ifndef WSDB_NET_H
 #define WSDB_NET_H
 
 #include <unistd.h>
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <vector>
 
 namespace net {
 
-constexpr size_t MAX_CLIENTS     = 10;
-constexpr size_t NET_BUFFER_SIZE = 2048;
+// connections served at once
+constexpr size_t MAX_CLIENTS     = 10000;
+constexpr size_t NET_BUFFER_SIZE = 64 * 1024;
 constexpr int    SERVER_PORT     = 5001;
 constexpr int    CLIENT_PORT     = 5002;
+// a partly filled REC_BODY is sent once its first record has waited this long, so slow queries still show progress
+constexpr int NET_FLUSH_INTERVAL_MS = 20;
+// a query stops producing results while more bytes than this wait for its client to read them
+constexpr size_t NET_WRITE_BUFFER_LIMIT = 1024 * 1024;
+// a statement waits for its client to read the results at most this long in all, a blocking socket that reads none of
+// them for this long is taken as down
+constexpr int NET_WRITE_TIMEOUT_MS = 10000;
+// results a statement may leave to the loop thread when its worker does not wait for the client, more and the client is
+// taken as down
+constexpr size_t NET_WRITE_BUFFER_MAX = 16 * 1024 * 1024;
+// results left to the loop thread by all connections, more and the client with the most of them is dropped
+constexpr size_t NET_WRITE_BUFFER_TOTAL = 256 * 1024 * 1024;
 
 enum NetPkgType
 {
@@ -42,6 +70,14 @@ enum NetPkgType
   NET_PKG_RAW_STRING
 };
 
+enum NetFieldType : uint8_t
+{
+  NET_FIELD_INT = 0,
+  NET_FIELD_FLOAT,
+  NET_FIELD_BOOL,
+  NET_FIELD_STRING
+};
+
 struct NetPkg
 {
   NetPkgType type_{};
@@ -49,9 +85,40 @@ struct NetPkg
   char       buf_[NET_BUFFER_SIZE]{0};
 };
 
+struct NetColumn
+{
+  NetFieldType type_{};
+  std::string  name_{};
+};
+
 int ReadNetPkg(int sockfd, NetPkg &pkg);
 
 int WriteNetPkg(int sockfd, NetPkg &pkg);
+
+/// append the bytes WriteNetPkg sends for pkg to out
+void AppendNetPkg(const NetPkg &pkg, std::string &out);
+
+/**
+ * parse the package at the front of data[0, size) without copying its body
+ * @return bytes the package takes, 0 if data does not hold all of it yet, -1 if it is larger than NET_BUFFER_SIZE
+ */
+auto ParseNetPkg(const char *data, size_t size, NetPkgType &type, std::string_view &body) -> ssize_t;
+
+/// fill pkg with a REC_HEADER of columns
+void EncodeRecHeader(const std::vector<NetColumn> &columns, NetPkg &pkg);
+
+/**
+ * fill columns from a REC_HEADER
+ * @return false if a count or a length points past the end of the package, or a column has an unknown type
+ */
+auto DecodeRecHeader(const NetPkg &pkg, std::vector<NetColumn> &columns) -> bool;
+
+/**
+ * append the records of a REC_BODY to records, each value in its display form, e.g. "(null)" for nulls
+ * @return false if a record does not end within the package, the records before it are appended
+ */
+auto DecodeRecBody(const NetPkg &pkg, const std::vector<NetColumn> &columns,
+    std::vector<std::vector<std::string>> &records) -> bool;
 }  // namespace net
 
 #endif  // WSDB_NET_H
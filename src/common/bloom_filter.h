@@ -0,0 +1,112 @@
+/*------------------------------------------------------------------------------
+ - Copyright (c) 2024. Websoft research group, Nanjing University.
+ -
+ - This program is free software: you can redistribute it and/or modify
+ - it under the terms of the GNU General Public License as published by
+ - the Free Software Foundation, either version 3 of the License, or
+ - (at your option) any later version.
+ -
+ - This program is distributed in the hope that it will be useful,
+ - but WITHOUT ANY WARRANTY; without even the implied warranty of
+ - MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ - GNU General Public License for more details.
+ -
+ - You should have received a copy of the GNU General Public License
+ - along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ -----------------------------------------------------------------------------*/
+
+/**
+ * @brief Bloom filter over 64 bit hashes, sized for an expected number of keys and a false positive rate. The k
+ * probes of a key are derived from its hash by double hashing.
+ *
+ */
+
+#ifndef WSDB_BLOOM_FILTER_H
+#define WSDB_BLOOM_FILTER_H
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <vector>
+
+namespace wsdb {
+
+class BloomFilter
+{
+public:
+  BloomFilter() = default;
+
+  /**
+   * @param key_num expected number of keys
+   * @param fpr target false positive rate
+   * @param max_bits upper bound of the filter size, a larger key_num raises the false positive rate instead
+   */
+  BloomFilter(size_t key_num, double fpr, size_t max_bits)
+  {
+    key_num    = std::max<size_t>(key_num, 1);
+    auto ln2   = std::log(2.0);
+    auto bits  = static_cast<double>(key_num) * -std::log(fpr) / (ln2 * ln2);
+    auto words = static_cast<size_t>(std::ceil(std::min(bits, static_cast<double>(max_bits)) / 64));
+    words_     = std::vector<uint64_t>(std::max<size_t>(words, 1), 0);
+    bit_num_   = words_.size() * 64;
+    // the number of probes minimizing the false positive rate for the size
+    auto k    = std::round(static_cast<double>(bit_num_) / static_cast<double>(key_num) * ln2);
+    hash_num_ = static_cast<size_t>(std::clamp(k, 1.0, 16.0));
+  }
+
+  void Add(uint64_t hash)
+  {
+    uint64_t step = (hash >> 32) | 1;
+    for (size_t i = 0; i < hash_num_; i++, hash += step) {
+      auto bit = hash % bit_num_;
+      words_[bit / 64] |= uint64_t{1} << (bit % 64);
+    }
+  }
+
+  [[nodiscard]] auto MayContain(uint64_t hash) const -> bool
+  {
+    uint64_t step = (hash >> 32) | 1;
+    for (size_t i = 0; i < hash_num_; i++, hash += step) {
+      auto bit = hash % bit_num_;
+      if ((words_[bit / 64] & (uint64_t{1} << (bit % 64))) == 0) {
+        return false;
+      }
+    }
+    return true;
+  }
+
+  [[nodiscard]] auto GetBitNum() const -> size_t { return bit_num_; }
+
+  [[nodiscard]] auto GetHashNum() const -> size_t { return hash_num_; }
+
+  /// expected false positive rate after adding key_num keys
+  [[nodiscard]] auto EstimateFpr(size_t key_num) const -> double
+  {
+    auto fill = 1 - std::exp(-static_cast<double>(hash_num_ * key_num) / static_cast<double>(GetBitNum()));
+    return std::pow(fill, static_cast<double>(hash_num_));
+  }
+
+  /// 64 bit hash of a byte string, FNV-1a followed by a murmur finalizer so that all bits depend on all bytes
+  static auto Hash(const char *data, size_t size) -> uint64_t
+  {
+    uint64_t h = 0xcbf29ce484222325ULL;
+    for (size_t i = 0; i < size; i++) {
+      h = (h ^ static_cast<uint8_t>(data[i])) * 0x100000001b3ULL;
+    }
+    h ^= h >> 33;
+    h *= 0xff51afd7ed558ccdULL;
+    h ^= h >> 33;
+    h *= 0xc4ceb9fe1a85ec53ULL;
+    h ^= h >> 33;
+    return h;
+  }
+
+private:
+  std::vector<uint64_t> words_;
+  size_t                bit_num_{0};
+  size_t                hash_num_{0};
+};
+
+}  // namespace wsdb
+
+#endif  // WSDB_BLOOM_FILTER_H
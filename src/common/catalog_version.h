@@ -0,0 +1,49 @@
+/*------------------------------------------------------------------------------
+ - Copyright (c) 2024. Websoft research group, Nanjing University.
+ -
+ - This program is free software: you can redistribute it and/or modify
+ - it under the terms of the GNU General Public License as published by
+ - the Free Software Foundation, either version 3 of the License, or
+ - (at your option) any later version.
+ -
+ - This program is distributed in the hope that it will be useful,
+ - but WITHOUT ANY WARRANTY; without even the implied warranty of
+ - MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ - GNU General Public License for more details.
+ -
+ - You should have received a copy of the GNU General Public License
+ - along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ -----------------------------------------------------------------------------*/
+
+/**
+ * @brief Version of what optimized plans depend on: tables, indexes and their statistics. DDL and ANALYZE bump it, a
+ * cached plan optimized under an older version is optimized again before it runs
+ *
+ */
+
+#ifndef WSDB_CATALOG_VERSION_H
+#define WSDB_CATALOG_VERSION_H
+
+#include <atomic>
+#include <cstdint>
+
+namespace wsdb {
+
+class CatalogVersion
+{
+public:
+  static auto Get() -> uint64_t { return Ref().load(std::memory_order_acquire); }
+
+  static void Bump() { Ref().fetch_add(1, std::memory_order_acq_rel); }
+
+private:
+  static auto Ref() -> std::atomic<uint64_t> &
+  {
+    static std::atomic<uint64_t> version{0};
+    return version;
+  }
+};
+
+}  // namespace wsdb
+
+#endif  // WSDB_CATALOG_VERSION_H
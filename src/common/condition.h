@@ -92,6 +92,21 @@ public:
 
   [[nodiscard]] auto GetOp() const -> CompOp { return op_; }
 
+  /// the same comparison of two columns with the sides swapped, e.g. a < b becomes b > a
+  [[nodiscard]] auto Swap() const -> Condition
+  {
+    WSDB_ASSERT(rval_type_ == kColumn, fmt::format("should be: {}", CondRvalTypeToString(kColumn)));
+    CompOp op = op_;
+    switch (op_) {
+      case OP_LT: op = OP_GT; break;
+      case OP_GT: op = OP_LT; break;
+      case OP_LE: op = OP_GE; break;
+      case OP_GE: op = OP_LE; break;
+      default: break;
+    }
+    return {op, r_col_, l_col_};
+  }
+
   [[nodiscard]] auto GetSubqueryId() const -> int32_t
   {
     WSDB_ASSERT(rval_type_ == kSubquery, "should be subquery");
@@ -28,18 +28,71 @@ constexpr size_t  BUFFER_POOL_SIZE = 8;
 const std::string REPLACER         = "LRUReplacer";
 // enable this to use LRUKReplacer
 const size_t REPLACER_LRU_K = 10;
+/// index
+// fraction of a b+ tree node filled by bulk loading, the rest is left to later inserts
+constexpr double BPTREE_FILL_FACTOR = 0.8;
+// an index scan probes one range per combination of its IN values, IN lists past this many are left to the filter
+constexpr size_t INDEX_SCAN_MAX_RANGES = 1024;
 /// system
 constexpr size_t MAX_REC_SIZE = 1024;
+// threads of the server running statements, a connection only takes one while a statement of it runs
+constexpr size_t QUERY_THREAD_NUM = 32;
 /// executor
 // 64MB, used for sort executor's buffer
 constexpr size_t SORT_BUFFER_SIZE = 64 * 1024 * 1024;
 // 10-way merge sort, max tmp file to use in merge sort
 constexpr size_t SORT_WAY_NUM = 10;
+// outer records of an index nested loop join sorted and probed together, equal keys share one probe
+constexpr size_t INLJ_BATCH_SIZE = 256;
+// bloom filters built from the join keys of the build side and checked by the probe side scan
+constexpr double BLOOM_FILTER_FPR      = 0.01;
+constexpr size_t BLOOM_FILTER_MAX_BITS = 64 * 1024 * 1024;
+// a filter with a higher expected false positive rate (the build side is too large for its size) is not used
+constexpr double BLOOM_FILTER_MAX_FPR = 0.3;
+/// optimizer
+// rows sampled per column by ANALYZE to build histograms and most common values
+constexpr size_t ANALYZE_SAMPLE_SIZE = 30000;
+constexpr size_t STATS_MCV_NUM       = 16;
+constexpr size_t STATS_BUCKET_NUM    = 32;
+// selectivities assumed for predicates on columns without statistics
+constexpr double DEFAULT_EQ_SELECTIVITY    = 0.005;
+constexpr double DEFAULT_RANGE_SELECTIVITY = 1.0 / 3;
+// cost units of the optimizer, reading a page sequentially costs 1
+constexpr double SEQ_PAGE_COST     = 1.0;
+constexpr double RANDOM_PAGE_COST  = 4.0;
+constexpr double CPU_TUPLE_COST    = 0.01;
+constexpr double CPU_OPERATOR_COST = 0.0025;
+// a hash join whose build side takes more memory is costed as partitioning both sides to disk
+constexpr size_t HASH_JOIN_BUFFER_SIZE = SORT_BUFFER_SIZE;
+// joins of more tables are ordered greedily instead of by dynamic programming
+constexpr size_t DP_JOIN_MAX_TABLES = 10;
+// optimized plans kept by the plan cache, the least recently used one is evicted first
+constexpr size_t PLAN_CACHE_SIZE = 1024;
+/// parallel execution
+// number of threads in the shared worker pool, 0 means one thread per hardware thread
+constexpr size_t WORKER_THREAD_NUM = 0;
+// default degree of parallelism of parallel operators, 0 means the size of the worker pool
+constexpr size_t DEFAULT_DOP = 0;
+// sort buffers with fewer records are sorted by the calling thread only
+constexpr size_t PARALLEL_SORT_THRESHOLD = 1 << 16;
+// pages handed out to a parallel scan worker at a time
+constexpr size_t MORSEL_PAGE_NUM = 16;
+// tables with fewer pages are scanned by one thread
+constexpr size_t PARALLEL_SCAN_MIN_PAGES = 64;
+// records passed from a parallel worker to the gather operator at a time
+constexpr size_t GATHER_BATCH_SIZE = 256;
+// batches buffered by the gather operator before workers block
+constexpr size_t GATHER_QUEUE_SIZE = 16;
+// bytes of a COPY input file read and then parsed in parallel at a time
+constexpr size_t COPY_CHUNK_SIZE = 16 * 1024 * 1024;
+// records of COPY TO encoded by a thread at a time, also the rows of a binary row group
+constexpr size_t COPY_ROW_GROUP_SIZE = 4096;
 
-const std::string DB_SUFFIX  = ".db";
-const std::string TAB_SUFFIX = ".tab";
-const std::string IDX_SUFFIX = ".idx";
-const std::string TMP_SUFFIX = ".tmp";
+const std::string DB_SUFFIX   = ".db";
+const std::string TAB_SUFFIX  = ".tab";
+const std::string IDX_SUFFIX  = ".idx";
+const std::string TMP_SUFFIX  = ".tmp";
+const std::string STAT_SUFFIX = ".stat";
 
 const std::string DB_DIR  = "db";
 const std::string TAB_DIR = "tab";
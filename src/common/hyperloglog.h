@@ -0,0 +1,83 @@
+/*------------------------------------------------------------------------------
+ - Copyright (c) 2024. Websoft research group, Nanjing University.
+ -
+ - This program is free software: you can redistribute it and/or modify
+ - it under the terms of the GNU General Public License as published by
+ - the Free Software Foundation, either version 3 of the License, or
+ - (at your option) any later version.
+ -
+ - This program is distributed in the hope that it will be useful,
+ - but WITHOUT ANY WARRANTY; without even the implied warranty of
+ - MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ - GNU General Public License for more details.
+ -
+ - You should have received a copy of the GNU General Public License
+ - along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ -----------------------------------------------------------------------------*/
+
+/**
+ * @brief HyperLogLog sketch estimating the number of distinct 64 bit hashes with 2^HLL_PRECISION one byte
+ * registers, the standard error is about 1.04 / sqrt(2^HLL_PRECISION). Small cardinalities are estimated by linear
+ * counting of the empty registers.
+ *
+ */
+
+#ifndef WSDB_HYPERLOGLOG_H
+#define WSDB_HYPERLOGLOG_H
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <vector>
+
+namespace wsdb {
+
+class HyperLogLog
+{
+public:
+  static constexpr size_t HLL_PRECISION = 12;
+  static constexpr size_t REGISTER_NUM  = size_t{1} << HLL_PRECISION;
+
+  HyperLogLog() : registers_(REGISTER_NUM, 0) {}
+
+  void Add(uint64_t hash)
+  {
+    auto idx = hash >> (64 - HLL_PRECISION);
+    // the low bits with a sentinel, so that the rank is at most 64 - HLL_PRECISION + 1
+    auto rest = (hash << HLL_PRECISION) | (uint64_t{1} << (HLL_PRECISION - 1));
+    auto rank = static_cast<uint8_t>(__builtin_clzll(rest) + 1);
+    if (rank > registers_[idx]) {
+      registers_[idx] = rank;
+    }
+  }
+
+  void Merge(const HyperLogLog &other)
+  {
+    for (size_t i = 0; i < REGISTER_NUM; i++) {
+      registers_[i] = std::max(registers_[i], other.registers_[i]);
+    }
+  }
+
+  [[nodiscard]] auto Estimate() const -> double
+  {
+    auto   m     = static_cast<double>(REGISTER_NUM);
+    double sum   = 0;
+    size_t zeros = 0;
+    for (auto reg : registers_) {
+      sum += std::ldexp(1.0, -reg);
+      zeros += reg == 0;
+    }
+    auto estimate = 0.7213 / (1 + 1.079 / m) * m * m / sum;
+    if (estimate <= 2.5 * m && zeros > 0) {
+      return m * std::log(m / static_cast<double>(zeros));
+    }
+    return estimate;
+  }
+
+private:
+  std::vector<uint8_t> registers_;
+};
+
+}  // namespace wsdb
+
+#endif  // WSDB_HYPERLOGLOG_H
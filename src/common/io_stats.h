@@ -0,0 +1,63 @@
+/*------------------------------------------------------------------------------
+ - Copyright (c) 2024. Websoft research group, Nanjing University.
+ -
+ - This program is free software: you can redistribute it and/or modify
+ - it under the terms of the GNU General Public License as published by
+ - the Free Software Foundation, either version 3 of the License, or
+ - (at your option) any later version.
+ -
+ - This program is distributed in the hope that it will be useful,
+ - but WITHOUT ANY WARRANTY; without even the implied warranty of
+ - MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ - GNU General Public License for more details.
+ -
+ - You should have received a copy of the GNU General Public License
+ - along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ -----------------------------------------------------------------------------*/
+
+/**
+ * @brief Page access counters of the current thread, the buffer pool counts hits and misses and the disk manager
+ * counts the pages it reads and writes. The counters only grow, a reader takes the difference of two snapshots, e.g.
+ * EXPLAIN ANALYZE around every call of an executor
+ *
+ */
+
+#ifndef WSDB_IO_STATS_H
+#define WSDB_IO_STATS_H
+
+#include <cstddef>
+
+namespace wsdb {
+
+struct IoStats
+{
+  size_t hits_{0};    // pages found in the buffer pool
+  size_t misses_{0};  // pages that had to be loaded into a frame
+  size_t reads_{0};   // pages read from disk
+  size_t writes_{0};  // pages written to disk
+
+  /// the counters of the calling thread
+  static auto Local() -> IoStats &
+  {
+    thread_local IoStats stats;
+    return stats;
+  }
+
+  auto operator+=(const IoStats &rhs) -> IoStats &
+  {
+    hits_ += rhs.hits_;
+    misses_ += rhs.misses_;
+    reads_ += rhs.reads_;
+    writes_ += rhs.writes_;
+    return *this;
+  }
+
+  auto operator-(const IoStats &rhs) const -> IoStats
+  {
+    return {hits_ - rhs.hits_, misses_ - rhs.misses_, reads_ - rhs.reads_, writes_ - rhs.writes_};
+  }
+};
+
+}  // namespace wsdb
+
+#endif  // WSDB_IO_STATS_H
@@ -0,0 +1,93 @@
+/*------------------------------------------------------------------------------
+ - Copyright (c) 2024. Websoft research group, Nanjing University.
+ -
+ - This program is free software: you can redistribute it and/or modify
+ - it under the terms of the GNU General Public License as published by
+ - the Free Software Foundation, either version 3 of the License, or
+ - (at your option) any later version.
+ -
+ - This program is distributed in the hope that it will be useful,
+ - but WITHOUT ANY WARRANTY; without even the implied warranty of
+ - MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ - GNU General Public License for more details.
+ -
+ - You should have received a copy of the GNU General Public License
+ - along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ -----------------------------------------------------------------------------*/
+
+/**
+ * @brief A version latch for optimistic lock coupling.
+ * Readers take no lock: they read the version, read the protected data, then validate that the version has not
+ * changed and restart otherwise. A writer makes the version odd while it holds the latch and even again when it
+ * releases it, so every reader that overlaps a write fails its validation.
+ */
+
+#ifndef WSDB_OPTIMISTIC_LATCH_H
+#define WSDB_OPTIMISTIC_LATCH_H
+
+#include <atomic>
+#include <cstdint>
+#include <thread>
+#include "../../common/micro.h"
+
+namespace wsdb {
+
+class OptimisticLatch
+{
+public:
+  OptimisticLatch() = default;
+
+  DISABLE_COPY_MOVE_AND_ASSIGN(OptimisticLatch)
+
+  /// wait until no writer holds the latch, and return the version to validate against
+  [[nodiscard]] auto ReadLock() const -> uint64_t
+  {
+    auto version = version_.load(std::memory_order_acquire);
+    while ((version & 1) != 0) {
+      std::this_thread::yield();
+      version = version_.load(std::memory_order_acquire);
+    }
+    return version;
+  }
+
+  /// whether no writer has taken the latch since version was read, the reads in between are consistent if so
+  [[nodiscard]] auto Validate(uint64_t version) const -> bool
+  {
+    std::atomic_thread_fence(std::memory_order_acquire);
+    return version_.load(std::memory_order_relaxed) == version;
+  }
+
+  /// take the latch for writing if it is still at version, fail without waiting otherwise
+  auto TryUpgrade(uint64_t version) -> bool
+  {
+    return version_.compare_exchange_strong(version, version + 1, std::memory_order_acquire);
+  }
+
+  void Lock()
+  {
+    while (!TryUpgrade(ReadLock())) {}
+  }
+
+  void Unlock() { version_.fetch_add(1, std::memory_order_release); }
+
+private:
+  std::atomic<uint64_t> version_{0};
+};
+
+/// holds the write latch for a scope
+class WriteLatchGuard
+{
+public:
+  explicit WriteLatchGuard(OptimisticLatch &latch) : latch_(latch) { latch_.Lock(); }
+
+  ~WriteLatchGuard() { latch_.Unlock(); }
+
+  DISABLE_COPY_MOVE_AND_ASSIGN(WriteLatchGuard)
+
+private:
+  OptimisticLatch &latch_;
+};
+
+}  // namespace wsdb
+
+#endif  // WSDB_OPTIMISTIC_LATCH_H
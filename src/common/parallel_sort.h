@@ -0,0 +1,114 @@
+/*------------------------------------------------------------------------------
+ - Copyright (c) 2024. Websoft research group, Nanjing University.
+ -
+ - This program is free software: you can redistribute it and/or modify
+ - it under the terms of the GNU General Public License as published by
+ - the Free Software Foundation, either version 3 of the License, or
+ - (at your option) any later version.
+ -
+ - This program is distributed in the hope that it will be useful,
+ - but WITHOUT ANY WARRANTY; without even the implied warranty of
+ - MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ - GNU General Public License for more details.
+ -
+ - You should have received a copy of the GNU General Public License
+ - along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ -----------------------------------------------------------------------------*/
+
+/**
+ * @brief Parallel stable sort on the shared worker pool: the input is cut into dop runs which are sorted
+ * concurrently, then runs are merged pairwise. Every pairwise merge is split along its merge path so that
+ * all threads stay busy in the last rounds as well.
+ *
+ */
+
+#ifndef WSDB_PARALLEL_SORT_H
+#define WSDB_PARALLEL_SORT_H
+
+#include <algorithm>
+#include <vector>
+#include "thread_pool.h"
+
+namespace wsdb {
+
+template <typename T, typename Compare>
+void ParallelSort(std::vector<T> &data, Compare comp, size_t dop = 0)
+{
+  dop      = ThreadPool::ResolveDop(dop);
+  size_t n = data.size();
+  if (dop == 1 || n < PARALLEL_SORT_THRESHOLD) {
+    std::stable_sort(data.begin(), data.end(), comp);
+    return;
+  }
+  auto &pool = ThreadPool::GetInstance();
+
+  // 1. sort dop runs concurrently
+  std::vector<size_t> bounds(dop + 1);
+  for (size_t i = 0; i <= dop; i++) {
+    bounds[i] = n * i / dop;
+  }
+  pool.ParallelFor(dop, dop, [&](size_t i) {
+    std::stable_sort(data.begin() + bounds[i], data.begin() + bounds[i + 1], comp);
+  });
+
+  // 2. merge runs pairwise, ping-ponging between data and tmp
+  std::vector<T> tmp(n);
+  T             *src = data.data();
+  T             *dst = tmp.data();
+  struct MergeTask
+  {
+    size_t a_begin_, a_end_, b_begin_, b_end_;  // the two runs to merge
+    size_t d_begin_, d_end_;                    // range of the output diagonals handled by this task
+  };
+  // number of elements taken from run a among the first d merged elements, ties are taken from a first
+  auto split = [&comp](const T *a, size_t a_len, const T *b, size_t b_len, size_t d) -> size_t {
+    size_t lo = d > b_len ? d - b_len : 0;
+    size_t hi = std::min(d, a_len);
+    while (lo < hi) {
+      size_t mid = (lo + hi) / 2;
+      if (comp(b[d - mid - 1], a[mid])) {
+        hi = mid;
+      } else {
+        lo = mid + 1;
+      }
+    }
+    return lo;
+  };
+  while (bounds.size() > 2) {
+    std::vector<MergeTask> tasks;
+    std::vector<size_t>    new_bounds;
+    for (size_t r = 0; r + 1 < bounds.size(); r += 2) {
+      new_bounds.push_back(bounds[r]);
+      if (r + 2 >= bounds.size()) {
+        // odd run out, copy it over
+        tasks.push_back({bounds[r], bounds[r + 1], bounds[r + 1], bounds[r + 1], 0, bounds[r + 1] - bounds[r]});
+        continue;
+      }
+      size_t len   = bounds[r + 2] - bounds[r];
+      size_t parts = std::max<size_t>(1, dop * len / n);
+      for (size_t p = 0; p < parts; p++) {
+        tasks.push_back({bounds[r], bounds[r + 1], bounds[r + 1], bounds[r + 2], len * p / parts, len * (p + 1) / parts});
+      }
+    }
+    new_bounds.push_back(n);
+    pool.ParallelFor(tasks.size(), dop, [&](size_t i) {
+      const auto &t     = tasks[i];
+      const T    *a     = src + t.a_begin_;
+      const T    *b     = src + t.b_begin_;
+      size_t      a_len = t.a_end_ - t.a_begin_;
+      size_t      b_len = t.b_end_ - t.b_begin_;
+      size_t      i0    = split(a, a_len, b, b_len, t.d_begin_);
+      size_t      i1    = split(a, a_len, b, b_len, t.d_end_);
+      std::merge(a + i0, a + i1, b + (t.d_begin_ - i0), b + (t.d_end_ - i1), dst + t.a_begin_ + t.d_begin_, comp);
+    });
+    std::swap(src, dst);
+    bounds = std::move(new_bounds);
+  }
+  if (src != data.data()) {
+    std::copy(src, src + n, data.data());
+  }
+}
+
+}  // namespace wsdb
+
+#endif  // WSDB_PARALLEL_SORT_H
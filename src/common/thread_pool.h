@@ -0,0 +1,180 @@
+/*------------------------------------------------------------------------------
+ - Copyright (c) 2024. Websoft research group, Nanjing University.
+ -
+ - This program is free software: you can redistribute it and/or modify
+ - it under the terms of the GNU General Public License as published by
+ - the Free Software Foundation, either version 3 of the License, or
+ - (at your option) any later version.
+ -
+ - This program is distributed in the hope that it will be useful,
+ - but WITHOUT ANY WARRANTY; without even the implied warranty of
+ - MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ - GNU General Public License for more details.
+ -
+ - You should have received a copy of the GNU General Public License
+ - along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ -----------------------------------------------------------------------------*/
+
+/**
+ * @brief A fixed size worker pool shared by all parallel operators (parallel sort, parallel scan, etc.)
+ *
+ */
+
+#ifndef WSDB_THREAD_POOL_H
+#define WSDB_THREAD_POOL_H
+
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <exception>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+#include "config.h"
+#include "../../common/micro.h"
+
+namespace wsdb {
+
+class ThreadPool
+{
+public:
+  explicit ThreadPool(size_t thread_num)
+  {
+    for (size_t i = 0; i < thread_num; i++) {
+      workers_.emplace_back([this] { WorkerLoop(); });
+    }
+  }
+
+  ~ThreadPool()
+  {
+    {
+      std::lock_guard<std::mutex> lock(mutex_);
+      stop_ = true;
+    }
+    cv_.notify_all();
+    for (auto &worker : workers_) {
+      worker.join();
+    }
+  }
+
+  DISABLE_COPY_MOVE_AND_ASSIGN(ThreadPool)
+
+  /// the pool shared by the whole server, WORKER_THREAD_NUM == 0 means one worker per hardware thread
+  static auto GetInstance() -> ThreadPool &
+  {
+    static ThreadPool pool(
+        WORKER_THREAD_NUM == 0 ? std::max<size_t>(1, std::thread::hardware_concurrency()) : WORKER_THREAD_NUM);
+    return pool;
+  }
+
+  [[nodiscard]] auto GetThreadNum() const -> size_t { return workers_.size(); }
+
+  /// resolve a requested degree of parallelism, 0 means DEFAULT_DOP, or the size of the shared pool if that is 0 too
+  static auto ResolveDop(size_t dop) -> size_t
+  {
+    if (dop == 0) {
+      dop = DEFAULT_DOP == 0 ? GetInstance().GetThreadNum() : DEFAULT_DOP;
+    }
+    return std::max<size_t>(dop, 1);
+  }
+
+  /// run task on a worker thread, the task must not throw
+  void Submit(std::function<void()> task)
+  {
+    {
+      std::lock_guard<std::mutex> lock(mutex_);
+      tasks_.push_back(std::move(task));
+    }
+    cv_.notify_one();
+  }
+
+  /**
+   * run func(i) for every i in [0, n) with at most dop threads, including the calling thread.
+   * the caller takes part in the work, so it is safe to call ParallelFor from a task running on the pool.
+   * the first exception thrown by func is rethrown to the caller after all started calls finish
+   */
+  void ParallelFor(size_t n, size_t dop, const std::function<void(size_t)> &func)
+  {
+    if (n == 0) {
+      return;
+    }
+    dop = std::min(std::max<size_t>(dop, 1), n);
+    if (dop == 1) {
+      for (size_t i = 0; i < n; i++) {
+        func(i);
+      }
+      return;
+    }
+    struct SharedState
+    {
+      std::atomic<size_t>     next_{0};
+      size_t                  finished_{0};
+      std::mutex              mutex_;
+      std::condition_variable cv_;
+      std::exception_ptr      error_;
+    };
+    auto state = std::make_shared<SharedState>();
+    // claim indexes until there is nothing left, helpers started after all indexes are claimed return at once
+    auto run = [state, n, &func]() {
+      size_t done = 0;
+      for (size_t i = state->next_++; i < n; i = state->next_++) {
+        try {
+          func(i);
+        } catch (...) {
+          std::lock_guard<std::mutex> lock(state->mutex_);
+          if (state->error_ == nullptr) {
+            state->error_ = std::current_exception();
+          }
+        }
+        done++;
+      }
+      if (done > 0) {
+        std::lock_guard<std::mutex> lock(state->mutex_);
+        state->finished_ += done;
+        if (state->finished_ == n) {
+          state->cv_.notify_all();
+        }
+      }
+    };
+    for (size_t i = 1; i < dop; i++) {
+      // func is only touched while an index is claimed, and the caller waits for all claimed indexes below
+      Submit(run);
+    }
+    run();
+    std::unique_lock<std::mutex> lock(state->mutex_);
+    state->cv_.wait(lock, [&state, n] { return state->finished_ == n; });
+    if (state->error_ != nullptr) {
+      std::rethrow_exception(state->error_);
+    }
+  }
+
+private:
+  void WorkerLoop()
+  {
+    while (true) {
+      std::function<void()> task;
+      {
+        std::unique_lock<std::mutex> lock(mutex_);
+        cv_.wait(lock, [this] { return stop_ || !tasks_.empty(); });
+        if (stop_ && tasks_.empty()) {
+          return;
+        }
+        task = std::move(tasks_.front());
+        tasks_.pop_front();
+      }
+      task();
+    }
+  }
+
+private:
+  std::vector<std::thread>          workers_;
+  std::deque<std::function<void()>> tasks_;
+  std::mutex                        mutex_;
+  std::condition_variable           cv_;
+  bool                              stop_{false};
+};
+
+}  // namespace wsdb
+
+#endif  // WSDB_THREAD_POOL_H
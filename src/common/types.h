@@ -109,7 +109,10 @@ ENUM_TO_STRING_BODY(JoinType)
 
 #define ENUM_ENTITIES \
   ENUM(NESTED_LOOP)   \
-  ENUM(SORT_MERGE)
+  ENUM(SORT_MERGE)    \
+  ENUM(INDEX_NESTED_LOOP) \
+  ENUM(HASH_JOIN)     \
+  ENUM(AUTO_JOIN)
 #define ENUM(ent) ENUMENTRY(ent)
 DECLARE_ENUM(JoinStrategy)
 #undef ENUM
@@ -156,4 +159,18 @@ inline auto CompOpToString(CompOp op) -> const char *{
   }
 }
 
+enum class IndexType
+{
+  NONE,
+  BPTREE,
+  HASH,
+};
+
+// file formats of COPY
+enum class CopyFormat
+{
+  CSV,
+  BINARY,
+};
+
 #endif  // WSDB_TYPES_H
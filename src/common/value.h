@@ -37,12 +37,14 @@ class FloatValue;
 class BoolValue;
 class StringValue;
 class ArrayValue;
+class ParamValue;
 DEFINE_SHARED_PTR(Value);
 DEFINE_SHARED_PTR(IntValue);
 DEFINE_SHARED_PTR(FloatValue);
 DEFINE_SHARED_PTR(BoolValue);
 DEFINE_SHARED_PTR(StringValue);
 DEFINE_SHARED_PTR(ArrayValue);
+DEFINE_SHARED_PTR(ParamValue);
 
 class ValueFactory;
 
@@ -546,6 +548,34 @@ private:
   std::vector<ValueSptr> values_;
 };
 
+/**
+ * the ? parameter of a prepared statement, it takes the place of a constant in the cached plan and is replaced by
+ * the argument of the same index when the statement is executed
+ */
+class ParamValue : public Value
+{
+public:
+  explicit ParamValue(size_t index) : Value(FieldType::TYPE_NULL, 0, false), index_(index) {}
+  ParamValue(const ParamValue &value)            = default;
+  ParamValue(ParamValue &&value)                 = default;
+  ParamValue &operator=(const ParamValue &value) = default;
+  ParamValue &operator=(ParamValue &&value)      = default;
+  ~ParamValue() override                         = default;
+
+  auto operator==(const Value &value) const -> bool override { WSDB_THROW(WSDB_UNSUPPORTED_OP, ToString()); }
+
+  auto operator<(const Value &value) const -> bool override { WSDB_THROW(WSDB_UNSUPPORTED_OP, ToString()); }
+
+  auto operator>(const Value &value) const -> bool override { WSDB_THROW(WSDB_UNSUPPORTED_OP, ToString()); }
+
+  [[nodiscard]] auto GetIndex() const -> size_t { return index_; }
+
+  [[nodiscard]] auto ToString() const -> std::string override { return fmt::format("?{}", index_ + 1); }
+
+private:
+  size_t index_;
+};
+
 class ValueFactory
 {
 public:
@@ -595,9 +625,11 @@ public:
     if (lval->GetType() == rval->GetType()) {
       return;
     } else if (lval->GetType() == FieldType::TYPE_INT && rval->GetType() == FieldType::TYPE_FLOAT) {
-      lval = CreateFloatValue(static_cast<float>(std::dynamic_pointer_cast<IntValue>(lval)->Get()));
+      lval = lval->IsNull() ? CreateNullValue(FieldType::TYPE_FLOAT)
+                            : CreateFloatValue(static_cast<float>(std::dynamic_pointer_cast<IntValue>(lval)->Get()));
     } else if (lval->GetType() == FieldType::TYPE_FLOAT && rval->GetType() == FieldType::TYPE_INT) {
-      rval = CreateFloatValue(static_cast<float>(std::dynamic_pointer_cast<IntValue>(rval)->Get()));
+      rval = rval->IsNull() ? CreateNullValue(FieldType::TYPE_FLOAT)
+                            : CreateFloatValue(static_cast<float>(std::dynamic_pointer_cast<IntValue>(rval)->Get()));
     } else {
       WSDB_THROW(WSDB_TYPE_MISSMATCH,
           fmt::format(
@@ -22,13 +22,93 @@
 #include "executor.h"
 #include "executor_defs.h"
 
-#include "expr/condition_expr.h"
+#include "expr/compiled_predicate.h"
 
 namespace wsdb {
 
 // translate the plan to executor
-auto Executor::Translate(const std::shared_ptr<AbstractPlan> &plan, DatabaseHandle *db) -> AbstractExecutorUptr
+auto Executor::Translate(
+    const std::shared_ptr<AbstractPlan> &plan, DatabaseHandle *db, ExecProfiles *profiles) -> AbstractExecutorUptr
 {
+  TranslateContext ctx{.db_ = db, .profiles_ = profiles, .params_ = nullptr, .filters_ = {}};
+  return Translate(plan, ctx);
+}
+
+auto Executor::Translate(const std::shared_ptr<AbstractPlan> &plan, TranslateContext &ctx) -> AbstractExecutorUptr
+{
+  auto executor = TranslatePlan(plan, ctx);
+  if (ctx.profiles_ == nullptr) {
+    return executor;
+  }
+  auto profiled                = std::make_unique<ProfileExecutor>(std::move(executor));
+  (*ctx.profiles_)[plan.get()] = profiled->GetStats();
+  return profiled;
+}
+
+auto Executor::BindValue(const ValueSptr &value, const TranslateContext &ctx) -> ValueSptr
+{
+  if (const auto param = std::dynamic_pointer_cast<ParamValue>(value)) {
+    if (ctx.params_ == nullptr || param->GetIndex() >= ctx.params_->size()) {
+      WSDB_THROW(WSDB_GRAMMAR_ERROR, fmt::format("no argument for parameter {}", param->ToString()));
+    }
+    return (*ctx.params_)[param->GetIndex()];
+  }
+  // parameters in an IN list
+  if (const auto list = std::dynamic_pointer_cast<ArrayValue>(value); list != nullptr && ctx.params_ != nullptr) {
+    std::vector<ValueSptr> values;
+    values.reserve(list->GetValueNum());
+    for (const auto &item : list->Get()) {
+      values.push_back(BindValue(item, ctx));
+    }
+    return ValueFactory::CreateArrayValue(values);
+  }
+  return value;
+}
+
+auto Executor::BindConditions(const ConditionVec &conds, const TranslateContext &ctx) -> ConditionVec
+{
+  if (ctx.params_ == nullptr) {
+    return conds;
+  }
+  ConditionVec bound;
+  bound.reserve(conds.size());
+  for (const auto &cond : conds) {
+    if (cond.GetRhsType() == kValue) {
+      auto val = BindValue(cond.GetRVal(), ctx);
+      bound.emplace_back(cond.GetOp(), cond.GetLCol(), val);
+    } else {
+      bound.push_back(cond);
+    }
+  }
+  return bound;
+}
+
+auto Executor::GetRuntimeFilter(const RuntimeFilterSptr &filter, TranslateContext &ctx) -> RuntimeFilterSptr
+{
+  if (filter == nullptr) {
+    return nullptr;
+  }
+  auto &copy = ctx.filters_[filter.get()];
+  if (copy == nullptr) {
+    copy = std::make_shared<RuntimeFilter>(filter->GetProbeFields(), filter->GetBuildFields());
+  }
+  return copy;
+}
+
+auto Executor::GetRuntimeFilters(
+    const std::vector<RuntimeFilterSptr> &filters, TranslateContext &ctx) -> std::vector<RuntimeFilterSptr>
+{
+  std::vector<RuntimeFilterSptr> copies;
+  copies.reserve(filters.size());
+  for (const auto &filter : filters) {
+    copies.push_back(GetRuntimeFilter(filter, ctx));
+  }
+  return copies;
+}
+
+auto Executor::TranslatePlan(const std::shared_ptr<AbstractPlan> &plan, TranslateContext &ctx) -> AbstractExecutorUptr
+{
+  auto db = ctx.db_;
   if (db == nullptr) {
     WSDB_THROW(WSDB_DB_NOT_OPEN, "");
   }
@@ -40,74 +120,222 @@ auto Executor::Translate(const std::shared_ptr<AbstractPlan> &plan, DatabaseHand
     return std::make_unique<DropTableExecutor>(drop_table->table_name_, db);
   } else if (const auto desc_table = std::dynamic_pointer_cast<DescTablePlan>(plan)) {
     return std::make_unique<DescTableExecutor>(db->GetTable(desc_table->table_name_));
+  } else if (const auto analyze = std::dynamic_pointer_cast<AnalyzePlan>(plan)) {
+    return std::make_unique<AnalyzeExecutor>(analyze->table_name_, db);
   } else if (const auto show_table = std::dynamic_pointer_cast<ShowTablesPlan>(plan)) {
     return std::make_unique<ShowTablesExecutor>(db);
+  } else if (const auto create_index = std::dynamic_pointer_cast<CreateIndexPlan>(plan)) {
+    return std::make_unique<CreateIndexExecutor>(create_index->table_name_,
+        create_index->key_fields_,
+        create_index->index_type_,
+        create_index->include_num_,
+        db);
+  } else if (const auto drop_index = std::dynamic_pointer_cast<DropIndexPlan>(plan)) {
+    return std::make_unique<DropIndexExecutor>(
+        drop_index->table_name_, drop_index->key_fields_, drop_index->include_num_, db);
+  } else if (const auto show_index = std::dynamic_pointer_cast<ShowIndexesPlan>(plan)) {
+    return std::make_unique<ShowIndexesExecutor>(show_index->table_name_, db);
   } else if (const auto insert = std::dynamic_pointer_cast<InsertPlan>(plan)) {
     if (db->GetTable(insert->table_name_) == nullptr) {
       WSDB_THROW(WSDB_TABLE_MISS, insert->table_name_);
     }
     auto                    tab = db->GetTable(insert->table_name_);
     std::vector<RecordUptr> inserts;
-    inserts.emplace_back(std::make_unique<Record>(&tab->GetSchema(), insert->values_, INVALID_RID));
-    return std::make_unique<InsertExecutor>(tab, db->GetIndexes(insert->table_name_), std::move(inserts));
+    inserts.reserve(insert->rows_.size());
+    for (const auto &row : insert->rows_) {
+      if (row.size() != tab->GetSchema().GetFieldCount()) {
+        WSDB_THROW(WSDB_GRAMMAR_ERROR,
+            fmt::format("{} values for {} columns", row.size(), tab->GetSchema().GetFieldCount()));
+      }
+      std::vector<ValueSptr> values;
+      values.reserve(row.size());
+      for (const auto &value : row) {
+        values.push_back(BindValue(value, ctx));
+      }
+      inserts.emplace_back(std::make_unique<Record>(&tab->GetSchema(), values, INVALID_RID));
+    }
+    return std::make_unique<InsertExecutor>(
+        tab, db->GetIndexes(insert->table_name_), std::move(inserts), ZoneMap::Get(db->GetName(), tab));
+  } else if (const auto copy_from = std::dynamic_pointer_cast<CopyFromPlan>(plan)) {
+    auto tab = db->GetTable(copy_from->table_name_);
+    if (tab == nullptr) {
+      WSDB_THROW(WSDB_TABLE_MISS, copy_from->table_name_);
+    }
+    return std::make_unique<CopyFromExecutor>(tab,
+        db->GetIndexes(copy_from->table_name_),
+        ZoneMap::Get(db->GetName(), tab),
+        copy_from->file_name_,
+        copy_from->format_);
+  } else if (const auto copy_to = std::dynamic_pointer_cast<CopyToPlan>(plan)) {
+    return std::make_unique<CopyToExecutor>(Translate(copy_to->child_, ctx), copy_to->file_name_, copy_to->format_);
   } else if (const auto update = std::dynamic_pointer_cast<UpdatePlan>(plan)) {
     auto tab = db->GetTable(update->table_name_);
     if (tab == nullptr) {
       WSDB_THROW(WSDB_TABLE_MISS, update->table_name_);
     }
-    return std::make_unique<UpdateExecutor>(
-        Translate(update->child_, db), tab, db->GetIndexes(update->table_name_), std::move(update->updates_));
+    auto updates = update->updates_;
+    for (auto &[field, value] : updates) {
+      value = BindValue(value, ctx);
+    }
+    return std::make_unique<UpdateExecutor>(Translate(update->child_, ctx),
+        tab,
+        db->GetIndexes(update->table_name_),
+        std::move(updates),
+        ZoneMap::Get(db->GetName(), tab));
   } else if (const auto del = std::dynamic_pointer_cast<DeletePlan>(plan)) {
     auto tab = db->GetTable(del->table_name_);
     if (tab == nullptr) {
       WSDB_THROW(WSDB_TABLE_MISS, del->table_name_);
     }
-    return std::make_unique<DeleteExecutor>(Translate(del->child_, db), tab, db->GetIndexes(del->table_name_));
+    return std::make_unique<DeleteExecutor>(
+        Translate(del->child_, ctx), tab, db->GetIndexes(del->table_name_));
   } else if (const auto filter = std::dynamic_pointer_cast<FilterPlan>(plan)) {
-    std::function<bool(const Record &)> filter_func = [filter](const Record &record) {
-      return ConditionExpr::Eval(filter->conds_, record);
+    auto predicate = std::make_shared<CompiledPredicate>(BindConditions(filter->conds_, ctx));
+    std::function<bool(const Record &)> filter_func = [predicate](const Record &record) {
+      return predicate->Eval(record);
     };
-    return std::make_unique<FilterExecutor>(Translate(filter->child_, db), std::move(filter_func));
+    return std::make_unique<FilterExecutor>(Translate(filter->child_, ctx), std::move(filter_func));
   } else if (const auto scan = std::dynamic_pointer_cast<ScanPlan>(plan)) {
     auto tab = db->GetTable(scan->table_name_);
     if (tab == nullptr) {
       WSDB_THROW(WSDB_TABLE_MISS, scan->table_name_);
     }
-    return std::make_unique<SeqScanExecutor>(tab);
+    return std::make_unique<SeqScanExecutor>(tab,
+        BindConditions(scan->conds_, ctx),
+        scan->proj_fields_,
+        nullptr,
+        ZoneMap::Get(db->GetName(), tab),
+        GetRuntimeFilters(scan->runtime_filters_, ctx));
   } else if (const auto idx_scan = std::dynamic_pointer_cast<IdxScanPlan>(plan)) {
     return std::make_unique<IdxScanExecutor>(db->GetTable(idx_scan->table_name_),
         db->GetIndex(idx_scan->idx_id_),
-        idx_scan->conds_,
-        idx_scan->matched_fields_);
+        BindConditions(idx_scan->conds_, ctx),
+        idx_scan->matched_fields_,
+        idx_scan->index_only_);
+  } else if (const auto bitmap_scan = std::dynamic_pointer_cast<BitmapScanPlan>(plan)) {
+    if (bitmap_scan->IsIndexOnly()) {
+      return Translate(bitmap_scan->index_scans_.front(), ctx);
+    }
+    std::vector<std::unique_ptr<IdxScanExecutor>> index_scans;
+    for (const auto &idx_scan : bitmap_scan->index_scans_) {
+      index_scans.push_back(std::make_unique<IdxScanExecutor>(db->GetTable(idx_scan->table_name_),
+          db->GetIndex(idx_scan->idx_id_),
+          BindConditions(idx_scan->conds_, ctx),
+          idx_scan->matched_fields_));
+    }
+    return std::make_unique<BitmapScanExecutor>(
+        db->GetTable(bitmap_scan->table_name_), std::move(index_scans), bitmap_scan->is_and_);
   } else if (const auto sort_plan = std::dynamic_pointer_cast<SortPlan>(plan)) {
-    return std::make_unique<SortExecutor>(
-        Translate(sort_plan->child_, db), std::move(sort_plan->key_schema_), sort_plan->is_desc_);
+    return std::make_unique<SortExecutor>(Translate(sort_plan->child_, ctx),
+        std::make_unique<RecordSchema>(sort_plan->key_schema_->GetFields()),
+        sort_plan->is_desc_);
   } else if (const auto proj_plan = std::dynamic_pointer_cast<ProjectPlan>(plan)) {
-    return std::make_unique<ProjectionExecutor>(Translate(proj_plan->child_, db), std::move(proj_plan->schema_));
+    return std::make_unique<ProjectionExecutor>(Translate(proj_plan->child_, ctx),
+        std::make_unique<RecordSchema>(proj_plan->schema_->GetFields()));
   } else if (const auto join_plan = std::dynamic_pointer_cast<JoinPlan>(plan)) {
     if (join_plan->strategy_ == NESTED_LOOP) {
-      return std::make_unique<NestedLoopJoinExecutor>(
-          join_plan->type_, Translate(join_plan->left_, db), Translate(join_plan->right_, db), join_plan->conds_);
+      return std::make_unique<NestedLoopJoinExecutor>(join_plan->type_,
+          Translate(join_plan->left_, ctx),
+          Translate(join_plan->right_, ctx),
+          BindConditions(join_plan->conds_, ctx));
     } else if (join_plan->strategy_ == SORT_MERGE) {
       return std::make_unique<SortMergeJoinExecutor>(join_plan->type_,
-          Translate(join_plan->left_, db),
-          Translate(join_plan->right_, db),
-          std::move(join_plan->left_key_schema_),
-          std::move(join_plan->right_key_schema_));
+          Translate(join_plan->left_, ctx),
+          Translate(join_plan->right_, ctx),
+          std::make_unique<RecordSchema>(join_plan->left_key_schema_->GetFields()),
+          std::make_unique<RecordSchema>(join_plan->right_key_schema_->GetFields()));
+    } else if (join_plan->strategy_ == HASH_JOIN) {
+      return std::make_unique<HashJoinExecutor>(join_plan->type_,
+          Translate(join_plan->left_, ctx),
+          Translate(join_plan->right_, ctx),
+          std::make_unique<RecordSchema>(join_plan->left_key_schema_->GetFields()),
+          std::make_unique<RecordSchema>(join_plan->right_key_schema_->GetFields()),
+          GetRuntimeFilter(join_plan->runtime_filter_, ctx));
+    } else if (join_plan->strategy_ == INDEX_NESTED_LOOP) {
+      auto inner = std::dynamic_pointer_cast<ScanPlan>(join_plan->right_);
+      WSDB_ASSERT(inner != nullptr, "the inner side of an index join should be a table scan");
+      return std::make_unique<IndexNestedLoopJoinExecutor>(join_plan->type_,
+          Translate(join_plan->left_, ctx),
+          Translate(join_plan->right_, ctx),
+          BindConditions(join_plan->conds_, ctx),
+          db->GetTable(inner->table_name_),
+          db->GetIndex(join_plan->inner_idx_id_),
+          join_plan->outer_key_fields_,
+          BindConditions(inner->conds_, ctx));
     }
   } else if (const auto agg_plan = std::dynamic_pointer_cast<AggregatePlan>(plan)) {
     auto agg_schema   = std::make_unique<RecordSchema>(agg_plan->agg_fields);
     auto group_schema = std::make_unique<RecordSchema>(agg_plan->group_fields_);
     return std::make_unique<AggregateExecutor>(
-        Translate(agg_plan->child_, db), std::move(agg_schema), std::move(group_schema));
+        Translate(agg_plan->child_, ctx), std::move(agg_schema), std::move(group_schema));
   } else if (const auto lim = std::dynamic_pointer_cast<LimitPlan>(plan)) {
-    return std::make_unique<LimitExecutor>(Translate(lim->child_, db), lim->limit_);
-
+    return std::make_unique<LimitExecutor>(Translate(lim->child_, ctx), lim->limit_);
+  } else if (const auto gather = std::dynamic_pointer_cast<GatherPlan>(plan)) {
+    auto tab = db->GetTable(gather->table_name_);
+    if (tab == nullptr) {
+      WSDB_THROW(WSDB_TABLE_MISS, gather->table_name_);
+    }
+    auto                              morsels = std::make_shared<MorselQueue>(tab);
+    std::vector<AbstractExecutorUptr> pipelines;
+    pipelines.reserve(gather->dop_);
+    for (size_t i = 0; i < gather->dop_; i++) {
+      pipelines.push_back(TranslatePipeline(gather->child_, ctx, morsels));
+    }
+    return std::make_unique<GatherExecutor>(std::move(pipelines), std::move(morsels));
+  } else if (const auto explain = std::dynamic_pointer_cast<ExplainPlan>(plan);
+             explain != nullptr && explain->analyze_) {
+    return std::make_unique<ExplainAnalyzeExecutor>(explain, db);
+  } else if (const auto set_var = std::dynamic_pointer_cast<SetVariablePlan>(plan)) {
+    return std::make_unique<SetVariableExecutor>(set_var->name_, set_var->value_);
+  } else if (const auto prepare = std::dynamic_pointer_cast<PreparePlan>(plan)) {
+    return std::make_unique<PrepareExecutor>(prepare->name_,
+        std::make_shared<PreparedStatement>(
+            PreparedStatement{prepare->sql_, prepare->plan_, prepare->param_num_, prepare->version_}));
+  } else if (const auto execute = std::dynamic_pointer_cast<ExecutePlan>(plan)) {
+    WSDB_ASSERT(execute->stmt_ != nullptr, fmt::format("EXECUTE {} is not planned by the plan cache", execute->name_));
+    const auto &stmt = execute->stmt_;
+    if (execute->params_.size() != stmt->param_num_) {
+      WSDB_THROW(WSDB_GRAMMAR_ERROR,
+          fmt::format("{} takes {} parameters, {} given", execute->name_, stmt->param_num_, execute->params_.size()));
+    }
+    // the cached plan is shared by all executions, the arguments only go into the executors built from it
+    TranslateContext bound{.db_ = db, .profiles_ = ctx.profiles_, .params_ = &execute->params_, .filters_ = {}};
+    return Translate(stmt->plan_, bound);
+  } else if (const auto dealloc = std::dynamic_pointer_cast<DeallocatePlan>(plan)) {
+    return std::make_unique<DeallocateExecutor>(dealloc->name_);
   } else {
     WSDB_FETAL("Unknown plan type");
   }
   return nullptr;
 }
+auto Executor::TranslatePipeline(const std::shared_ptr<AbstractPlan> &plan, TranslateContext &ctx,
+    const MorselQueueSptr &morsels) -> AbstractExecutorUptr
+{
+  auto db = ctx.db_;
+  if (const auto filter = std::dynamic_pointer_cast<FilterPlan>(plan)) {
+    auto predicate = std::make_shared<CompiledPredicate>(BindConditions(filter->conds_, ctx));
+    std::function<bool(const Record &)> filter_func = [predicate](const Record &record) {
+      return predicate->Eval(record);
+    };
+    return std::make_unique<FilterExecutor>(TranslatePipeline(filter->child_, ctx, morsels), std::move(filter_func));
+  } else if (const auto proj_plan = std::dynamic_pointer_cast<ProjectPlan>(plan)) {
+    return std::make_unique<ProjectionExecutor>(TranslatePipeline(proj_plan->child_, ctx, morsels),
+        std::make_unique<RecordSchema>(proj_plan->schema_->GetFields()));
+  } else if (const auto scan = std::dynamic_pointer_cast<ScanPlan>(plan)) {
+    auto tab = db->GetTable(scan->table_name_);
+    if (tab == nullptr) {
+      WSDB_THROW(WSDB_TABLE_MISS, scan->table_name_);
+    }
+    return std::make_unique<SeqScanExecutor>(tab,
+        BindConditions(scan->conds_, ctx),
+        scan->proj_fields_,
+        morsels,
+        ZoneMap::Get(db->GetName(), tab),
+        GetRuntimeFilters(scan->runtime_filters_, ctx));
+  }
+  WSDB_FETAL("Plan can not run in a parallel pipeline");
+}
+
 void Executor::Execute(const AbstractExecutorUptr &executor, Context *ctx)
 {
   if (executor->GetType() == TXN) {
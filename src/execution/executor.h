@@ -24,6 +24,8 @@
 
 #include "plan/plan.h"
 #include "executor_abstract.h"
+#include "executor_profile.h"
+#include "executor_seqscan.h"
 #include "system/context.h"
 
 namespace wsdb {
@@ -32,9 +34,43 @@ class Executor
 public:
   Executor() = default;
 
-  static auto Translate(const std::shared_ptr<AbstractPlan> &plan, DatabaseHandle *db) -> AbstractExecutorUptr;
+  /**
+   * @param profiles if not nullptr, every executor is measured for EXPLAIN ANALYZE and its statistics are added
+   */
+  static auto Translate(const std::shared_ptr<AbstractPlan> &plan, DatabaseHandle *db,
+      ExecProfiles *profiles = nullptr) -> AbstractExecutorUptr;
 
   static void Execute(const AbstractExecutorUptr &executor, Context *ctx);
+
+private:
+  /// what one translation needs besides the plan, the plan itself may be cached and is never changed by translating
+  struct TranslateContext
+  {
+    DatabaseHandle *db_;
+    ExecProfiles   *profiles_;
+    // arguments of the ? parameters of a prepared plan, nullptr if the plan has none
+    const std::vector<ValueSptr> *params_;
+    // every execution fills runtime filters of its own, mapped from the ones in the plan
+    std::unordered_map<const RuntimeFilter *, RuntimeFilterSptr> filters_;
+  };
+
+  static auto Translate(const std::shared_ptr<AbstractPlan> &plan, TranslateContext &ctx) -> AbstractExecutorUptr;
+
+  static auto TranslatePlan(const std::shared_ptr<AbstractPlan> &plan, TranslateContext &ctx) -> AbstractExecutorUptr;
+
+  /// translate one worker's copy of a parallel pipeline, its table scan only reads pages taken from morsels
+  static auto TranslatePipeline(const std::shared_ptr<AbstractPlan> &plan, TranslateContext &ctx,
+      const MorselQueueSptr &morsels) -> AbstractExecutorUptr;
+
+  /// value with parameters replaced by their arguments
+  static auto BindValue(const ValueSptr &value, const TranslateContext &ctx) -> ValueSptr;
+
+  static auto BindConditions(const ConditionVec &conds, const TranslateContext &ctx) -> ConditionVec;
+
+  static auto GetRuntimeFilter(const RuntimeFilterSptr &filter, TranslateContext &ctx) -> RuntimeFilterSptr;
+
+  static auto GetRuntimeFilters(
+      const std::vector<RuntimeFilterSptr> &filters, TranslateContext &ctx) -> std::vector<RuntimeFilterSptr>;
 };
 }  // namespace wsdb
 
@@ -0,0 +1,109 @@
+/*------------------------------------------------------------------------------
+ - Copyright (c) 2024. Websoft research group, Nanjing University.
+ -
+ - This program is free software: you can redistribute it and/or modify
+ - it under the terms of the GNU General Public License as published by
+ - the Free Software Foundation, either version 3 of the License, or
+ - (at your option) any later version.
+ -
+ - This program is distributed in the hope that it will be useful,
+ - but WITHOUT ANY WARRANTY; without even the implied warranty of
+ - MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ - GNU General Public License for more details.
+ -
+ - You should have received a copy of the GNU General Public License
+ - along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ -----------------------------------------------------------------------------*/
+
+#include "executor_bitmapscan.h"
+
+namespace wsdb {
+
+BitmapScanExecutor::BitmapScanExecutor(
+    TableHandle *tbl, std::vector<std::unique_ptr<IdxScanExecutor>> index_scans, bool is_and)
+    : AbstractExecutor(Basic),
+      tbl_(tbl),
+      index_scans_(std::move(index_scans)),
+      is_and_(is_and),
+      slot_num_(tbl_->GetTableHeader().rec_per_page_)
+{
+  WSDB_ASSERT(!index_scans_.empty(), "bitmap scan without index scans");
+}
+
+void BitmapScanExecutor::Init()
+{
+  bitmaps_ = BuildBitmaps(index_scans_.front()->GetAllRIDs(), slot_num_);
+  for (size_t i = 1; i < index_scans_.size(); i++) {
+    CombineBitmaps(bitmaps_, BuildBitmaps(index_scans_[i]->GetAllRIDs(), slot_num_), is_and_, slot_num_);
+  }
+  page_it_ = bitmaps_.begin();
+  slot_    = 0;
+  Seek();
+  LoadRecord();
+}
+
+void BitmapScanExecutor::Next()
+{
+  WSDB_ASSERT(!IsEnd(), "BitmapScanExecutor is end");
+  slot_++;
+  Seek();
+  LoadRecord();
+}
+
+auto BitmapScanExecutor::IsEnd() const -> bool { return page_it_ == bitmaps_.end(); }
+
+auto BitmapScanExecutor::BuildBitmaps(const std::vector<RID> &rids, size_t slot_num) -> PageBitmaps
+{
+  PageBitmaps bitmaps;
+  for (const auto &rid : rids) {
+    auto &bitmap = bitmaps.try_emplace(rid.PageID(), BITMAP_SIZE(slot_num), '\0').first->second;
+    BitMap::SetBit(bitmap.data(), rid.SlotID(), true);
+  }
+  return bitmaps;
+}
+
+void BitmapScanExecutor::CombineBitmaps(PageBitmaps &bitmaps, const PageBitmaps &other, bool is_and, size_t slot_num)
+{
+  if (is_and) {
+    // a page missing from either side has no slot left
+    for (auto it = bitmaps.begin(); it != bitmaps.end();) {
+      auto other_it = other.find(it->first);
+      if (other_it == other.end()) {
+        it = bitmaps.erase(it);
+        continue;
+      }
+      for (size_t byte = 0; byte < it->second.size(); byte++) {
+        it->second[byte] = static_cast<char>(it->second[byte] & other_it->second[byte]);
+      }
+      ++it;
+    }
+    return;
+  }
+  for (const auto &[page_id, bitmap] : other) {
+    auto &dst = bitmaps.try_emplace(page_id, BITMAP_SIZE(slot_num), '\0').first->second;
+    for (size_t byte = 0; byte < dst.size(); byte++) {
+      dst[byte] = static_cast<char>(dst[byte] | bitmap[byte]);
+    }
+  }
+}
+
+void BitmapScanExecutor::Seek()
+{
+  for (; page_it_ != bitmaps_.end(); ++page_it_, slot_ = 0) {
+    slot_ = BitMap::FindFirst(page_it_->second.data(), slot_num_, slot_, true);
+    if (slot_ < slot_num_) {
+      return;
+    }
+  }
+}
+
+void BitmapScanExecutor::LoadRecord()
+{
+  if (IsEnd()) {
+    record_ = nullptr;
+    return;
+  }
+  record_ = tbl_->GetRecord(RID(page_it_->first, static_cast<slot_id_t>(slot_)));
+}
+
+}  // namespace wsdb
@@ -0,0 +1,74 @@
+/*------------------------------------------------------------------------------
+ - Copyright (c) 2024. Websoft research group, Nanjing University.
+ -
+ - This program is free software: you can redistribute it and/or modify
+ - it under the terms of the GNU General Public License as published by
+ - the Free Software Foundation, either version 3 of the License, or
+ - (at your option) any later version.
+ -
+ - This program is distributed in the hope that it will be useful,
+ - but WITHOUT ANY WARRANTY; without even the implied warranty of
+ - MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ - GNU General Public License for more details.
+ -
+ - You should have received a copy of the GNU General Public License
+ - along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ -----------------------------------------------------------------------------*/
+
+/**
+ * @brief scan the table through a bitmap of rids. The rids of one or more index scans are set on a bitmap of the
+ * table slots, one bitmap per page, and the bitmaps are combined with AND or OR. The records are then fetched in
+ * page order, so every heap page is read once and sequentially instead of once per index entry in key order.
+ *
+ */
+
+#ifndef WSDB_EXECUTOR_BITMAPSCAN_H
+#define WSDB_EXECUTOR_BITMAPSCAN_H
+
+#include <map>
+#include "executor_abstract.h"
+#include "executor_idxscan.h"
+
+namespace wsdb {
+class BitmapScanExecutor : public AbstractExecutor
+{
+public:
+  BitmapScanExecutor(TableHandle *tbl, std::vector<std::unique_ptr<IdxScanExecutor>> index_scans, bool is_and);
+
+  void Init() override;
+
+  void Next() override;
+
+  [[nodiscard]] auto IsEnd() const -> bool override;
+
+  [[nodiscard]] auto GetOutSchema() const -> const RecordSchema * override { return &tbl_->GetSchema(); }
+
+  /// page id -> bitmap of BITMAP_SIZE(slot_num) bytes, only pages with a set slot are present
+  using PageBitmaps = std::map<page_id_t, std::string>;
+
+  /// set the rids on fresh bitmaps of slot_num slots per page
+  static auto BuildBitmaps(const std::vector<RID> &rids, size_t slot_num) -> PageBitmaps;
+
+  /// intersect bitmaps with other if is_and, otherwise unite them. A page missing from one side of an intersection is
+  /// dropped, an intersection may leave pages with no slot set
+  static void CombineBitmaps(PageBitmaps &bitmaps, const PageBitmaps &other, bool is_and, size_t slot_num);
+
+private:
+  /// move page_it_ and slot_ to the first set slot at or after them
+  void Seek();
+
+  /// fetch the record of the current slot into AbstractExecutor::record_
+  void LoadRecord();
+
+private:
+  TableHandle                                  *tbl_;
+  std::vector<std::unique_ptr<IdxScanExecutor>> index_scans_;
+  bool                                          is_and_;    // intersect the index scans, otherwise unite them
+  size_t                                        slot_num_;  // slots per page
+  PageBitmaps                                   bitmaps_;   // page id -> bitmap of the matched slots
+  PageBitmaps::iterator                         page_it_;   // page being read
+  size_t                                        slot_{0};   // slot being read in the page
+};
+}  // namespace wsdb
+
+#endif  // WSDB_EXECUTOR_BITMAPSCAN_H
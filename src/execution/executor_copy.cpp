@@ -0,0 +1,614 @@
+/*------------------------------------------------------------------------------
+ - Copyright (c) 2024. Websoft research group, Nanjing University.
+ -
+ - This program is free software: you can redistribute it and/or modify
+ - it under the terms of the GNU General Public License as published by
+ - the Free Software Foundation, either version 3 of the License, or
+ - (at your option) any later version.
+ -
+ - This program is distributed in the hope that it will be useful,
+ - but WITHOUT ANY WARRANTY; without even the implied warranty of
+ - MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ - GNU General Public License for more details.
+ -
+ - You should have received a copy of the GNU General Public License
+ - along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ -----------------------------------------------------------------------------*/
+
+#include "executor_copy.h"
+#include <fcntl.h>
+#include <unistd.h>
+#include <algorithm>
+#include <charconv>
+#include <cstring>
+#include "executor_insert.h"
+#include "common/thread_pool.h"
+#include "system/session.h"
+
+namespace wsdb {
+
+namespace {
+/// read until size bytes are read or the file ends, returns the bytes read
+auto ReadFull(int fd, char *dst, size_t size, const std::string &file_name) -> size_t
+{
+  size_t done = 0;
+  while (done < size) {
+    auto n = read(fd, dst + done, size - done);
+    if (n < 0) {
+      WSDB_THROW(WSDB_FILE_READ_ERROR, file_name);
+    }
+    if (n == 0) {
+      break;
+    }
+    done += static_cast<size_t>(n);
+  }
+  return done;
+}
+
+void WriteFull(int fd, const char *src, size_t size, const std::string &file_name)
+{
+  while (size > 0) {
+    auto n = write(fd, src, size);
+    if (n < 0) {
+      WSDB_THROW(WSDB_FILE_WRITE_ERROR, file_name);
+    }
+    src += n;
+    size -= static_cast<size_t>(n);
+  }
+}
+
+template <typename T>
+void AppendRaw(std::string &out, T value)
+{
+  out.append(reinterpret_cast<const char *>(&value), sizeof(T));
+}
+
+template <typename T>
+void ReadExact(int fd, T &value, const std::string &file_name)
+{
+  if (ReadFull(fd, reinterpret_cast<char *>(&value), sizeof(T), file_name) != sizeof(T)) {
+    WSDB_THROW(WSDB_FILE_READ_ERROR, fmt::format("{} is truncated", file_name));
+  }
+}
+
+auto ParseCsvField(const FieldSchema &field, const std::string &text, bool quoted) -> ValueSptr
+{
+  if (text.empty() && !quoted) {
+    if (!field.nullable_) {
+      WSDB_THROW(WSDB_UNEXPECTED_NULL, field.field_name_);
+    }
+    return ValueFactory::CreateNullValue(field.field_type_);
+  }
+  const char *end = text.data() + text.size();
+  switch (field.field_type_) {
+    case TYPE_INT: {
+      int  value = 0;
+      auto res   = std::from_chars(text.data(), end, value);
+      if (res.ec != std::errc() || res.ptr != end) {
+        WSDB_THROW(WSDB_TYPE_MISSMATCH, fmt::format("'{}' is not an INT for {}", text, field.field_name_));
+      }
+      return ValueFactory::CreateIntValue(value);
+    }
+    case TYPE_FLOAT: {
+      float value = 0;
+      auto  res   = std::from_chars(text.data(), end, value);
+      if (res.ec != std::errc() || res.ptr != end) {
+        WSDB_THROW(WSDB_TYPE_MISSMATCH, fmt::format("'{}' is not a FLOAT for {}", text, field.field_name_));
+      }
+      return ValueFactory::CreateFloatValue(value);
+    }
+    case TYPE_BOOL: {
+      if (text == "true" || text == "TRUE" || text == "1") {
+        return ValueFactory::CreateBoolValue(true);
+      }
+      if (text == "false" || text == "FALSE" || text == "0") {
+        return ValueFactory::CreateBoolValue(false);
+      }
+      WSDB_THROW(WSDB_TYPE_MISSMATCH, fmt::format("'{}' is not a BOOL for {}", text, field.field_name_));
+    }
+    case TYPE_STRING: {
+      if (text.size() > field.field_size_) {
+        WSDB_THROW(WSDB_STRING_OVERFLOW, fmt::format("'{}' is longer than {}", text, field.field_name_));
+      }
+      return ValueFactory::CreateStringValue(text.c_str(), text.size());
+    }
+    default: WSDB_FETAL(fmt::format("unsupported field type {}", FieldTypeToString(field.field_type_)));
+  }
+}
+}  // namespace
+
+auto CopyRowGroupSize(const RecordSchema &schema, size_t row_num) -> size_t
+{
+  size_t size = 0;
+  for (const auto &field : schema.GetFields()) {
+    size += BITMAP_SIZE(row_num) + row_num * field.field_.field_size_;
+  }
+  return size;
+}
+
+CopyFromExecutor::CopyFromExecutor(TableHandle *tbl, std::list<IndexHandle *> indexes, ZoneMapSptr zone_map,
+    std::string file_name, CopyFormat format)
+    : AbstractExecutor(DML),
+      tbl_(tbl),
+      indexes_(std::move(indexes)),
+      zone_map_(std::move(zone_map)),
+      file_name_(std::move(file_name)),
+      format_(format),
+      dop_(1),
+      index_entries_(indexes_.size()),
+      count_(0),
+      is_end_(false)
+{
+  std::vector<RTField> fields(1);
+  fields[0]   = RTField{.field_ = {.field_name_ = "copied", .field_size_ = sizeof(int), .field_type_ = TYPE_INT}};
+  out_schema_ = std::make_unique<RecordSchema>(fields);
+}
+
+void CopyFromExecutor::Init() { WSDB_FETAL("CopyFromExecutor does not support Init"); }
+
+void CopyFromExecutor::Next()
+{
+  if (is_end_) {
+    WSDB_FETAL("CopyFromExecutor is end");
+  }
+  int fd = open(file_name_.c_str(), O_RDONLY);
+  if (fd < 0) {
+    WSDB_THROW(WSDB_FILE_NOT_EXISTS, file_name_);
+  }
+  posix_fadvise(fd, 0, 0, POSIX_FADV_SEQUENTIAL);
+  dop_ = ThreadPool::ResolveDop(Session::Current().GetDop());
+  try {
+    if (format_ == CopyFormat::CSV) {
+      LoadCsv(fd);
+    } else {
+      LoadBinary(fd);
+    }
+  } catch (...) {
+    close(fd);
+    throw;
+  }
+  close(fd);
+
+  for (auto *index : indexes_) {
+    index->GetIndex()->Flush();
+  }
+  std::vector<ValueSptr> values{ValueFactory::CreateIntValue(static_cast<int>(count_))};
+  record_ = std::make_unique<Record>(out_schema_.get(), values, INVALID_RID);
+  is_end_ = true;
+}
+
+auto CopyFromExecutor::IsEnd() const -> bool { return is_end_; }
+
+auto CopyFromExecutor::ParseCsvLine(const RecordSchema &schema, std::string_view line) -> std::vector<ValueSptr>
+{
+  std::vector<ValueSptr> values;
+  values.reserve(schema.GetFieldCount());
+  std::string field;
+  size_t      pos = 0;
+  while (true) {
+    field.clear();
+    bool quoted = pos < line.size() && line[pos] == '"';
+    if (quoted) {
+      for (pos++;; pos++) {
+        auto quote = line.find('"', pos);
+        if (quote == std::string_view::npos) {
+          WSDB_THROW(WSDB_GRAMMAR_ERROR, fmt::format("unterminated quote: {}", line));
+        }
+        field.append(line.substr(pos, quote - pos));
+        pos = quote + 1;
+        if (pos == line.size() || line[pos] != '"') {
+          break;
+        }
+        field.push_back('"');
+      }
+      if (pos < line.size() && line[pos] != ',') {
+        WSDB_THROW(WSDB_GRAMMAR_ERROR, fmt::format("text after a closing quote: {}", line));
+      }
+    } else {
+      auto comma = std::min(line.find(',', pos), line.size());
+      field.assign(line.substr(pos, comma - pos));
+      pos = comma;
+    }
+    if (values.size() == schema.GetFieldCount()) {
+      WSDB_THROW(WSDB_GRAMMAR_ERROR, fmt::format("more than {} fields: {}", schema.GetFieldCount(), line));
+    }
+    values.push_back(ParseCsvField(schema.GetFieldAt(values.size()).field_, field, quoted));
+    if (pos == line.size()) {
+      break;
+    }
+    pos++;
+  }
+  if (values.size() != schema.GetFieldCount()) {
+    WSDB_THROW(WSDB_GRAMMAR_ERROR,
+        fmt::format("{} fields for {} columns: {}", values.size(), schema.GetFieldCount(), line));
+  }
+  return values;
+}
+
+auto CopyFromExecutor::FindCsvRecordEnd(const char *begin, const char *end) -> const char *
+{
+  // the quotes of a field come in pairs, "" included, so a line break is inside a field after an odd number of them
+  bool quoted = false;
+  for (const char *pos = begin; pos < end;) {
+    auto eol = static_cast<const char *>(memchr(pos, '\n', end - pos));
+    if (eol == nullptr) {
+      break;
+    }
+    quoted ^= std::count(pos, eol, '"') % 2 != 0;
+    if (!quoted) {
+      return eol;
+    }
+    pos = eol + 1;
+  }
+  return end;
+}
+
+void CopyFromExecutor::LoadCsv(int fd)
+{
+  std::vector<char> buf(COPY_CHUNK_SIZE);
+  size_t            len = 0;  // bytes in buf, starting with the partial record left by the previous chunk
+  bool              eof = false;
+  while (!eof) {
+    if (len == buf.size()) {
+      // no record ends in a whole chunk
+      buf.resize(buf.size() * 2);
+    }
+    len += ReadFull(fd, buf.data() + len, buf.size() - len, file_name_);
+    eof = len < buf.size();
+    // cut the chunk at record ends into a few pieces per thread, so that uneven lines still balance. Whether a line
+    // break ends a record depends on the quotes before it, so the record ends are found from the start of the chunk
+    size_t              piece_size = len / (dop_ * 4);
+    std::vector<size_t> bounds{0};
+    size_t              end = 0;
+    for (const char *pos = buf.data(), *last = buf.data() + len; pos < last;) {
+      auto eol = FindCsvRecordEnd(pos, last);
+      if (eol == last) {
+        break;
+      }
+      pos = eol + 1;
+      end = pos - buf.data();
+      if (end - bounds.back() >= piece_size) {
+        bounds.push_back(end);
+      }
+    }
+    if (eof) {
+      end = len;
+    } else if (end == 0) {
+      continue;
+    }
+    if (bounds.back() != end) {
+      bounds.push_back(end);
+    }
+    std::vector<std::vector<RecordUptr>> pieces(bounds.size() - 1);
+    ThreadPool::GetInstance().ParallelFor(pieces.size(), dop_, [&](size_t i) {
+      ParseCsv(buf.data() + bounds[i], buf.data() + bounds[i + 1], pieces[i]);
+    });
+    for (auto &records : pieces) {
+      Append(records);
+    }
+    InsertIndexEntries();
+    memmove(buf.data(), buf.data() + end, len - end);
+    len -= end;
+  }
+}
+
+void CopyFromExecutor::ParseCsv(const char *begin, const char *end, std::vector<RecordUptr> &records) const
+{
+  const auto &schema = tbl_->GetSchema();
+  while (begin < end) {
+    auto             eol = FindCsvRecordEnd(begin, end);
+    std::string_view line(begin, eol - begin);
+    if (!line.empty() && line.back() == '\r') {
+      line.remove_suffix(1);
+    }
+    if (!line.empty()) {
+      records.push_back(std::make_unique<Record>(&schema, ParseCsvLine(schema, line), INVALID_RID));
+    }
+    begin = eol + 1;
+  }
+}
+
+void CopyFromExecutor::LoadBinary(int fd)
+{
+  const auto &schema = tbl_->GetSchema();
+  char        magic[COPY_BINARY_MAGIC_SIZE];
+  if (ReadFull(fd, magic, sizeof(magic), file_name_) != sizeof(magic) ||
+      memcmp(magic, COPY_BINARY_MAGIC, sizeof(magic)) != 0) {
+    WSDB_THROW(WSDB_FILE_READ_ERROR, fmt::format("{} is not a binary copy file", file_name_));
+  }
+  uint32_t version = 0;
+  uint32_t col_num = 0;
+  ReadExact(fd, version, file_name_);
+  ReadExact(fd, col_num, file_name_);
+  if (version != COPY_BINARY_VERSION) {
+    WSDB_THROW(WSDB_FILE_READ_ERROR, fmt::format("{} has version {}", file_name_, version));
+  }
+  if (col_num != schema.GetFieldCount()) {
+    WSDB_THROW(WSDB_GRAMMAR_ERROR, fmt::format("{} columns for {} columns", col_num, schema.GetFieldCount()));
+  }
+  for (size_t i = 0; i < col_num; i++) {
+    uint8_t     type = 0;
+    uint32_t    size = 0;
+    const auto &field = schema.GetFieldAt(i).field_;
+    ReadExact(fd, type, file_name_);
+    ReadExact(fd, size, file_name_);
+    if (type != static_cast<uint8_t>(field.field_type_) || size != field.field_size_) {
+      WSDB_THROW(
+          WSDB_TYPE_MISSMATCH, fmt::format("column {} of {} does not match {}", i, file_name_, field.field_name_));
+    }
+  }
+
+  // read row groups until they make a chunk, then decode them in parallel
+  std::vector<std::string> groups;
+  std::vector<uint32_t>    row_nums;
+  size_t                   bytes = 0;
+
+  auto flush = [&]() {
+    std::vector<std::vector<RecordUptr>> decoded(groups.size());
+    ThreadPool::GetInstance().ParallelFor(groups.size(), dop_, [&](size_t i) {
+      DecodeRowGroup(groups[i].data(), row_nums[i], decoded[i]);
+    });
+    for (auto &records : decoded) {
+      Append(records);
+    }
+    InsertIndexEntries();
+    groups.clear();
+    row_nums.clear();
+    bytes = 0;
+  };
+  while (true) {
+    uint32_t row_num = 0;
+    auto     n       = ReadFull(fd, reinterpret_cast<char *>(&row_num), sizeof(row_num), file_name_);
+    if (n == 0) {
+      break;
+    }
+    if (n != sizeof(row_num)) {
+      WSDB_THROW(WSDB_FILE_READ_ERROR, fmt::format("{} is truncated", file_name_));
+    }
+    // the writer never makes larger groups, a larger count is a corrupt file and would allocate a huge group
+    if (row_num > COPY_ROW_GROUP_SIZE) {
+      WSDB_THROW(WSDB_FILE_READ_ERROR, fmt::format("{} has a row group of {} rows", file_name_, row_num));
+    }
+    auto &group = groups.emplace_back(CopyRowGroupSize(schema, row_num), '\0');
+    if (ReadFull(fd, group.data(), group.size(), file_name_) != group.size()) {
+      WSDB_THROW(WSDB_FILE_READ_ERROR, fmt::format("{} is truncated", file_name_));
+    }
+    row_nums.push_back(row_num);
+    bytes += group.size();
+    if (bytes >= COPY_CHUNK_SIZE) {
+      flush();
+    }
+  }
+  flush();
+}
+
+void CopyFromExecutor::DecodeRowGroup(const char *data, size_t row_num, std::vector<RecordUptr> &records) const
+{
+  const auto                         &schema  = tbl_->GetSchema();
+  size_t                              col_num = schema.GetFieldCount();
+  std::vector<std::vector<ValueSptr>> rows(row_num, std::vector<ValueSptr>(col_num));
+  for (size_t col = 0; col < col_num; col++) {
+    const auto &field   = schema.GetFieldAt(col).field_;
+    const char *nullmap = data;
+    data += BITMAP_SIZE(row_num);
+    for (size_t row = 0; row < row_num; row++, data += field.field_size_) {
+      if (BitMap::GetBit(nullmap, row)) {
+        rows[row][col] = ValueFactory::CreateNullValue(field.field_type_);
+        continue;
+      }
+      switch (field.field_type_) {
+        case TYPE_INT: {
+          int32_t value;
+          memcpy(&value, data, sizeof(value));
+          rows[row][col] = ValueFactory::CreateIntValue(value);
+          break;
+        }
+        case TYPE_FLOAT: {
+          float value;
+          memcpy(&value, data, sizeof(value));
+          rows[row][col] = ValueFactory::CreateFloatValue(value);
+          break;
+        }
+        case TYPE_BOOL: rows[row][col] = ValueFactory::CreateBoolValue(*data != 0); break;
+        case TYPE_STRING: {
+          std::string value(data, strnlen(data, field.field_size_));
+          rows[row][col] = ValueFactory::CreateStringValue(value.c_str(), value.size());
+          break;
+        }
+        default: WSDB_FETAL(fmt::format("unsupported field type {}", FieldTypeToString(field.field_type_)));
+      }
+    }
+  }
+  records.reserve(records.size() + row_num);
+  for (const auto &values : rows) {
+    records.push_back(std::make_unique<Record>(&schema, values, INVALID_RID));
+  }
+}
+
+void CopyFromExecutor::Append(std::vector<RecordUptr> &records)
+{
+  for (auto &record : records) {
+    auto rid = tbl_->InsertRecord(*record);
+    if (rid == INVALID_RID) {
+      WSDB_THROW(WSDB_RECORD_EXISTS, "Failed to insert record into table");
+    }
+    if (zone_map_ != nullptr) {
+      zone_map_->Add(rid.PageID(), *record);
+    }
+    auto entries = index_entries_.begin();
+    for (auto *index : indexes_) {
+      entries->emplace_back(std::make_unique<Record>(&index->GetKeySchema(), *record), rid);
+      ++entries;
+    }
+  }
+  count_ += records.size();
+  records.clear();
+}
+
+void CopyFromExecutor::InsertIndexEntries()
+{
+  auto entries = index_entries_.begin();
+  for (auto *index : indexes_) {
+    InsertExecutor::InsertIndex(index, *entries);
+    entries->clear();
+    ++entries;
+  }
+}
+
+/// CopyTo Executor
+CopyToExecutor::CopyToExecutor(AbstractExecutorUptr child, std::string file_name, CopyFormat format)
+    : AbstractExecutor(DML),
+      child_(std::move(child)),
+      file_name_(std::move(file_name)),
+      format_(format),
+      count_(0),
+      is_end_(false)
+{
+  std::vector<RTField> fields(1);
+  fields[0]   = RTField{.field_ = {.field_name_ = "copied", .field_size_ = sizeof(int), .field_type_ = TYPE_INT}};
+  out_schema_ = std::make_unique<RecordSchema>(fields);
+}
+
+void CopyToExecutor::Init() { WSDB_FETAL("CopyToExecutor does not support Init"); }
+
+void CopyToExecutor::Next()
+{
+  if (is_end_) {
+    WSDB_FETAL("CopyToExecutor is end");
+  }
+  int fd = open(file_name_.c_str(), O_WRONLY | O_CREAT | O_TRUNC, 0644);
+  if (fd < 0) {
+    WSDB_THROW(WSDB_FILE_NOT_OPEN, file_name_);
+  }
+  const auto &schema = *child_->GetOutSchema();
+  auto        dop    = ThreadPool::ResolveDop(Session::Current().GetDop());
+  try {
+    if (format_ == CopyFormat::BINARY) {
+      WriteHeader(fd);
+    }
+    child_->Init();
+    while (!child_->IsEnd()) {
+      // pull a group per thread, the child keeps its own workers busy meanwhile if the plan is parallel
+      std::vector<std::vector<RecordUptr>> groups;
+      while (!child_->IsEnd() && groups.size() < dop) {
+        auto &group = groups.emplace_back();
+        group.reserve(COPY_ROW_GROUP_SIZE);
+        for (; !child_->IsEnd() && group.size() < COPY_ROW_GROUP_SIZE; child_->Next()) {
+          group.push_back(child_->GetRecord());
+        }
+      }
+      std::vector<std::string> encoded(groups.size());
+      ThreadPool::GetInstance().ParallelFor(groups.size(), dop, [&](size_t i) {
+        if (format_ == CopyFormat::BINARY) {
+          AppendRowGroup(schema, groups[i], encoded[i]);
+          return;
+        }
+        for (const auto &record : groups[i]) {
+          AppendCsvLine(schema, *record, encoded[i]);
+        }
+      });
+      for (size_t i = 0; i < groups.size(); i++) {
+        WriteFull(fd, encoded[i].data(), encoded[i].size(), file_name_);
+        count_ += groups[i].size();
+      }
+    }
+  } catch (...) {
+    close(fd);
+    throw;
+  }
+  close(fd);
+  std::vector<ValueSptr> values{ValueFactory::CreateIntValue(static_cast<int>(count_))};
+  record_ = std::make_unique<Record>(out_schema_.get(), values, INVALID_RID);
+  is_end_ = true;
+}
+
+auto CopyToExecutor::IsEnd() const -> bool { return is_end_; }
+
+void CopyToExecutor::WriteHeader(int fd) const
+{
+  const auto &schema = *child_->GetOutSchema();
+  std::string header(COPY_BINARY_MAGIC, COPY_BINARY_MAGIC_SIZE);
+  AppendRaw(header, COPY_BINARY_VERSION);
+  AppendRaw(header, static_cast<uint32_t>(schema.GetFieldCount()));
+  for (const auto &field : schema.GetFields()) {
+    AppendRaw(header, static_cast<uint8_t>(field.field_.field_type_));
+    AppendRaw(header, static_cast<uint32_t>(field.field_.field_size_));
+  }
+  WriteFull(fd, header.data(), header.size(), file_name_);
+}
+
+void CopyToExecutor::AppendCsvLine(const RecordSchema &schema, const Record &record, std::string &out)
+{
+  const char *data    = record.GetData();
+  const char *nullmap = record.GetNullMap();
+  char        buf[32];
+  for (size_t i = 0; i < schema.GetFieldCount(); data += schema.GetFieldAt(i).field_.field_size_, i++) {
+    const auto &field = schema.GetFieldAt(i).field_;
+    if (i > 0) {
+      out.push_back(',');
+    }
+    if (BitMap::GetBit(nullmap, i)) {
+      continue;
+    }
+    switch (field.field_type_) {
+      case TYPE_INT: {
+        int32_t value;
+        memcpy(&value, data, sizeof(value));
+        out.append(buf, std::to_chars(buf, buf + sizeof(buf), value).ptr);
+        break;
+      }
+      case TYPE_FLOAT: {
+        float value;
+        memcpy(&value, data, sizeof(value));
+        out.append(buf, std::to_chars(buf, buf + sizeof(buf), value).ptr);
+        break;
+      }
+      case TYPE_BOOL: out.append(*data != 0 ? "true" : "false"); break;
+      case TYPE_STRING: {
+        std::string_view value(data, strnlen(data, field.field_size_));
+        // quote empty strings so that they are not read back as null
+        if (!value.empty() && value.find_first_of(",\"\r\n") == std::string_view::npos) {
+          out.append(value);
+          break;
+        }
+        out.push_back('"');
+        for (auto c : value) {
+          if (c == '"') {
+            out.push_back('"');
+          }
+          out.push_back(c);
+        }
+        out.push_back('"');
+        break;
+      }
+      default: WSDB_FETAL(fmt::format("unsupported field type {}", FieldTypeToString(field.field_type_)));
+    }
+  }
+  out.push_back('\n');
+}
+
+void CopyToExecutor::AppendRowGroup(
+    const RecordSchema &schema, const std::vector<RecordUptr> &records, std::string &out)
+{
+  size_t row_num = records.size();
+  size_t begin   = out.size();
+  AppendRaw(out, static_cast<uint32_t>(row_num));
+  out.resize(out.size() + CopyRowGroupSize(schema, row_num), '\0');
+  char  *pos    = out.data() + begin + sizeof(uint32_t);
+  size_t offset = 0;
+  for (size_t col = 0; col < schema.GetFieldCount(); col++) {
+    auto  size    = schema.GetFieldAt(col).field_.field_size_;
+    char *nullmap = pos;
+    pos += BITMAP_SIZE(row_num);
+    for (size_t row = 0; row < row_num; row++, pos += size) {
+      if (BitMap::GetBit(records[row]->GetNullMap(), col)) {
+        BitMap::SetBit(nullmap, row, true);
+      } else {
+        memcpy(pos, records[row]->GetData() + offset, size);
+      }
+    }
+    offset += size;
+  }
+}
+
+}  // namespace wsdb
@@ -0,0 +1,140 @@
+/*------------------------------------------------------------------------------
+ - Copyright (c) 2024. Websoft research group, Nanjing University.
+ -
+ - This program is free software: you can redistribute it and/or modify
+ - it under the terms of the GNU General Public License as published by
+ - the Free Software Foundation, either version 3 of the License, or
+ - (at your option) any later version.
+ -
+ - This program is distributed in the hope that it will be useful,
+ - but WITHOUT ANY WARRANTY; without even the implied warranty of
+ - MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ - GNU General Public License for more details.
+ -
+ - You should have received a copy of the GNU General Public License
+ - along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ -----------------------------------------------------------------------------*/
+
+/**
+ * @brief Bulk load tables from files and export query results to files on the server side.
+ *
+ * CSV: one record per line, fields separated by ',', and an empty unquoted field is null. A field may be quoted with
+ * '"', a '"' inside the quotes is written as '""', and a quoted field may span lines. A chunk of the file is cut at
+ * the line breaks outside of quotes into pieces parsed in parallel, those are found by counting the quotes.
+ *
+ * BINARY: a header followed by row groups, all integers are little endian
+ *  - header: the magic "WSDBCOPY", uint32 version, uint32 column count, then a uint8 FieldType and a uint32 field size
+ *    per column
+ *  - row group: uint32 row count n, then per column a null bitmap of BITMAP_SIZE(n) bytes and the n values, each as
+ *    wide as the field and stored the way records store it, nulls are zero filled
+ * The size of a row group follows from its row count, so the row groups are found without decoding them and decoded
+ * in parallel.
+ *
+ * COPY FROM parses the records a chunk at a time and appends them to the table in file order. The keys of a chunk go
+ * into the indexes before the next chunk is read: an empty B+ tree is bulk loaded from the first chunk, and the keys
+ * of the later chunks are inserted in key order.
+ *
+ * COPY TO pulls the records of the query in groups of COPY_ROW_GROUP_SIZE, encodes a group per thread, and writes the
+ * encoded groups in order with one large write each. A parallel plan produces the records on the worker pool too.
+ */
+
+#ifndef WSDB_EXECUTOR_COPY_H
+#define WSDB_EXECUTOR_COPY_H
+
+#include <string_view>
+#include "executor_abstract.h"
+#include "system/handle/table_handle.h"
+#include "system/handle/index_handle.h"
+#include "expr/zone_map.h"
+
+namespace wsdb {
+
+constexpr char     COPY_BINARY_MAGIC[]    = "WSDBCOPY";
+constexpr size_t   COPY_BINARY_MAGIC_SIZE = sizeof(COPY_BINARY_MAGIC) - 1;
+constexpr uint32_t COPY_BINARY_VERSION    = 1;
+
+/// bytes of a binary row group of row_num records of schema, excluding the row count
+auto CopyRowGroupSize(const RecordSchema &schema, size_t row_num) -> size_t;
+
+class CopyFromExecutor : public AbstractExecutor
+{
+public:
+  CopyFromExecutor(TableHandle *tbl, std::list<IndexHandle *> indexes, ZoneMapSptr zone_map, std::string file_name,
+      CopyFormat format);
+
+  void Init() override;
+
+  void Next() override;
+
+  [[nodiscard]] auto IsEnd() const -> bool override;
+
+  /// parse a csv line without its line break into values of the fields of schema
+  static auto ParseCsvLine(const RecordSchema &schema, std::string_view line) -> std::vector<ValueSptr>;
+
+  /**
+   * the line break ending the csv record that starts at begin, a line break in a quoted field belongs to the field
+   * @return end if the record does not end in [begin, end)
+   */
+  static auto FindCsvRecordEnd(const char *begin, const char *end) -> const char *;
+
+private:
+  void LoadCsv(int fd);
+
+  void LoadBinary(int fd);
+
+  /// parse the records in [begin, end), the range holds whole records only
+  void ParseCsv(const char *begin, const char *end, std::vector<RecordUptr> &records) const;
+
+  /// decode a row group of row_num records, data starts behind the row count
+  void DecodeRowGroup(const char *data, size_t row_num, std::vector<RecordUptr> &records) const;
+
+  /// append the records to the table in order and keep their index keys
+  void Append(std::vector<RecordUptr> &records);
+
+  /// add the keys kept by Append to the indexes, see InsertExecutor::InsertIndex
+  void InsertIndexEntries();
+
+  TableHandle             *tbl_;
+  std::list<IndexHandle *> indexes_;
+  ZoneMapSptr              zone_map_;
+  std::string              file_name_;
+  CopyFormat               format_;
+  size_t                   dop_;
+
+  // keys of the records of the current chunk, one vector per index in the order of indexes_
+  std::vector<std::vector<std::pair<RecordUptr, RID>>> index_entries_;
+
+  size_t count_;
+  bool   is_end_;
+};
+
+class CopyToExecutor : public AbstractExecutor
+{
+public:
+  CopyToExecutor(AbstractExecutorUptr child, std::string file_name, CopyFormat format);
+
+  void Init() override;
+
+  void Next() override;
+
+  [[nodiscard]] auto IsEnd() const -> bool override;
+
+  /// append record as a csv line, fields of schema are read from the record data
+  static void AppendCsvLine(const RecordSchema &schema, const Record &record, std::string &out);
+
+  /// append a binary row group of records, including its row count
+  static void AppendRowGroup(const RecordSchema &schema, const std::vector<RecordUptr> &records, std::string &out);
+
+private:
+  void WriteHeader(int fd) const;
+
+  AbstractExecutorUptr child_;
+  std::string          file_name_;
+  CopyFormat           format_;
+  size_t               count_;
+  bool                 is_end_;
+};
+
+}  // namespace wsdb
+
+#endif  // WSDB_EXECUTOR_COPY_H
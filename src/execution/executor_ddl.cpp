@@ -20,8 +20,12 @@
 //
 
 #define MAX_TABNAME_LEN 128
+#define MAX_IDXNAME_LEN 256
 
 #include "executor_ddl.h"
+#include "common/catalog_version.h"
+#include "system/session.h"
+#include "expr/zone_map.h"
 namespace wsdb {
 
 static auto MakeTableDescOutSchema(size_t sz_db_name, size_t sz_tb_name) -> std::unique_ptr<RecordSchema>
@@ -68,6 +72,72 @@ static auto MakeTableDescValue(const std::string &db_name, const std::string &tb
   return values;
 }
 
+static auto MakeIndexDescOutSchema() -> std::unique_ptr<RecordSchema>
+{
+  // 4 fields, table name, index name, index type, key field num
+  std::vector<RTField> fields(4);
+  fields[0] = RTField{.field_ = {.table_id_ = INVALID_TABLE_ID,
+                          .field_name_      = "Table",
+                          .field_size_      = MAX_TABNAME_LEN,
+                          .field_type_      = TYPE_STRING}};
+  fields[1] = RTField{.field_ = {.table_id_ = INVALID_TABLE_ID,
+                          .field_name_      = "Index",
+                          .field_size_      = MAX_IDXNAME_LEN,
+                          .field_type_      = TYPE_STRING}};
+  fields[2] = RTField{
+      .field_ = {.table_id_ = INVALID_TABLE_ID, .field_name_ = "Type", .field_size_ = 10, .field_type_ = TYPE_STRING}};
+  fields[3] = RTField{.field_ = {.table_id_ = INVALID_TABLE_ID,
+                          .field_name_      = "KeyFieldNum",
+                          .field_size_      = sizeof(size_t),
+                          .field_type_      = TYPE_INT}};
+  return std::make_unique<RecordSchema>(fields);
+}
+
+static auto IndexTypeToString(IndexType type) -> const char *
+{
+  switch (type) {
+    case IndexType::BPTREE: return "BPTREE";
+    case IndexType::HASH: return "HASH";
+    default: return "NONE";
+  }
+}
+
+static auto MakeIndexDescValue(const std::string &tb_name, IndexHandle *idx) -> std::vector<ValueSptr>
+{
+  auto                   idx_name = idx->GetIndexName();
+  const char            *idx_type = IndexTypeToString(idx->GetIndexType());
+  std::vector<ValueSptr> values(4);
+  values[0] = ValueFactory::CreateStringValue(tb_name.c_str(), tb_name.size());
+  values[1] = ValueFactory::CreateStringValue(idx_name.c_str(), idx_name.size());
+  values[2] = ValueFactory::CreateStringValue(idx_type, strlen(idx_type));
+  values[3] = ValueFactory::CreateIntValue(static_cast<int>(idx->GetKeySchema().GetFieldCount()));
+  return values;
+}
+
+/**
+ * the index of tab_name on exactly the fields of key_schema, of which the first key_field_num are its key and the rest
+ * are included, nullptr if there is none. t(a) INCLUDE (b) and t(a, b) are different indexes
+ */
+static auto FindIndex(DatabaseHandle *db, const std::string &tab_name, const RecordSchema &key_schema,
+    size_t key_field_num) -> IndexHandle *
+{
+  for (auto idx : db->GetIndexes(tab_name)) {
+    const auto &idx_schema = idx->GetKeySchema();
+    if (idx_schema.GetFieldCount() != key_schema.GetFieldCount() ||
+        idx->GetIndex()->GetKeyFieldNum() != key_field_num) {
+      continue;
+    }
+    bool same = true;
+    for (size_t i = 0; i < key_schema.GetFieldCount() && same; i++) {
+      same = idx_schema.GetFieldAt(i).field_.field_name_ == key_schema.GetFieldAt(i).field_.field_name_;
+    }
+    if (same) {
+      return idx;
+    }
+  }
+  return nullptr;
+}
+
 /// CreateTableExecutor
 CreateTableExecutor::CreateTableExecutor(
     std::string table_name, wsdb::RecordSchemaUptr schema, wsdb::DatabaseHandle *db, StorageModel storage)
@@ -91,6 +161,8 @@ void CreateTableExecutor::Next()
     WSDB_THROW(WSDB_TABLE_EXIST, tab_name_);
   }
   db_->CreateTable(tab_name_, *schema_, storage_);
+  ZoneMap::Drop(db_->GetName(), tab_name_);
+  TableStats::Drop(db_->GetName(), tab_name_);
   auto values = MakeTableDescValue(db_->GetName(),
       tab_name_,
       schema_->GetFieldCount(),
@@ -127,6 +199,8 @@ void DropTableExecutor::Next()
       db_->GetIndexNum(tab->GetTableId()));
   record_     = std::make_unique<Record>(out_schema_.get(), values, INVALID_RID);
   db_->DropTable(tab_name_);
+  ZoneMap::Drop(db_->GetName(), tab_name_);
+  TableStats::Drop(db_->GetName(), tab_name_);
   is_end_ = true;
 }
 auto DropTableExecutor::IsEnd() const -> bool { return is_end_; }
@@ -176,6 +250,67 @@ void DescTableExecutor::Next()
 }
 auto DescTableExecutor::IsEnd() const -> bool { return is_end_; }
 
+/// Analyze Executor
+AnalyzeExecutor::AnalyzeExecutor(std::string table_name, wsdb::DatabaseHandle *db)
+    : AbstractExecutor(DDL), tab_name_(std::move(table_name)), db_(db), is_end_(false), cursor_(0)
+{
+  // analyze header is | Field | Rows | Distinct | NullFrac | MCVNum | BucketNum
+  std::vector<RTField> fields(6);
+  fields[0] = RTField{
+      .field_ = {
+          .table_id_ = INVALID_TABLE_ID, .field_name_ = "Field", .field_size_ = 128, .field_type_ = TYPE_STRING}};
+  fields[1] = RTField{
+      .field_ = {.table_id_ = INVALID_TABLE_ID, .field_name_ = "Rows", .field_size_ = 4, .field_type_ = TYPE_INT}};
+  fields[2] = RTField{
+      .field_ = {.table_id_ = INVALID_TABLE_ID, .field_name_ = "Distinct", .field_size_ = 4, .field_type_ = TYPE_INT}};
+  fields[3] = RTField{
+      .field_ = {
+          .table_id_ = INVALID_TABLE_ID, .field_name_ = "NullFrac", .field_size_ = 4, .field_type_ = TYPE_FLOAT}};
+  fields[4] = RTField{
+      .field_ = {.table_id_ = INVALID_TABLE_ID, .field_name_ = "MCVNum", .field_size_ = 4, .field_type_ = TYPE_INT}};
+  fields[5] = RTField{
+      .field_ = {.table_id_ = INVALID_TABLE_ID, .field_name_ = "BucketNum", .field_size_ = 4, .field_type_ = TYPE_INT}};
+  out_schema_ = std::make_unique<RecordSchema>(fields);
+}
+
+void AnalyzeExecutor::Init() { WSDB_FETAL("AnalyzeExecutor does not support Init"); }
+void AnalyzeExecutor::Next()
+{
+  if (IsEnd()) {
+    WSDB_FETAL("AnalyzeExecutor is end");
+  }
+  auto tab = db_->GetTable(tab_name_);
+  if (tab == nullptr) {
+    WSDB_THROW(WSDB_TABLE_MISS, tab_name_);
+  }
+  if (stats_ == nullptr) {
+    TableStatsBuilder builder(tab->GetSchema());
+    for (auto rid = tab->GetFirstRID(); rid != INVALID_RID; rid = tab->GetNextRID(rid)) {
+      builder.Add(*tab->GetRecord(rid));
+    }
+    stats_ = builder.Finish();
+    TableStats::Save(db_->GetName(), tab_name_, stats_);
+  }
+  if (cursor_ >= tab->GetSchema().GetFieldCount()) {
+    is_end_ = true;
+    return;
+  }
+  const auto            &name = tab->GetSchema().GetFieldAt(cursor_).field_.field_name_;
+  const auto            &col  = stats_->GetColumn(cursor_);
+  std::vector<ValueSptr> values;
+  values.reserve(out_schema_->GetFieldCount());
+  values.push_back(ValueFactory::CreateStringValue(name.c_str(), name.size()));
+  values.push_back(ValueFactory::CreateIntValue(static_cast<int>(stats_->GetRowNum())));
+  values.push_back(ValueFactory::CreateIntValue(static_cast<int>(std::lround(col.ndv_))));
+  values.push_back(ValueFactory::CreateFloatValue(static_cast<float>(col.null_frac_)));
+  values.push_back(ValueFactory::CreateIntValue(static_cast<int>(col.mcvs_.size())));
+  values.push_back(ValueFactory::CreateIntValue(static_cast<int>(col.bounds_.empty() ? 0 : col.bounds_.size() - 1)));
+  WSDB_ASSERT(values.size() == out_schema_->GetFieldCount(), "Value size not match");
+  record_ = std::make_unique<Record>(out_schema_.get(), values, INVALID_RID);
+  cursor_++;
+}
+auto AnalyzeExecutor::IsEnd() const -> bool { return is_end_; }
+
 /// ShowTables Executor
 ShowTablesExecutor::ShowTablesExecutor(wsdb::DatabaseHandle *db)
     : AbstractExecutor(DDL), db_(db), is_end_(false), cursor_(0)
@@ -208,4 +343,230 @@ void ShowTablesExecutor::Next()
 }
 auto ShowTablesExecutor::IsEnd() const -> bool { return is_end_; }
 
+/// CreateIndex Executor
+CreateIndexExecutor::CreateIndexExecutor(std::string table_name, std::vector<RTField> key_fields,
+    IndexType index_type, size_t include_num, DatabaseHandle *db)
+    : AbstractExecutor(DDL),
+      tab_name_(std::move(table_name)),
+      key_schema_(std::make_unique<RecordSchema>(key_fields)),
+      index_type_(index_type),
+      include_num_(include_num),
+      db_(db),
+      is_end_(false)
+{
+  out_schema_ = MakeIndexDescOutSchema();
+}
+
+void CreateIndexExecutor::Init() { WSDB_FETAL("CreateIndexExecutor does not support Init"); }
+void CreateIndexExecutor::Next()
+{
+  if (is_end_) {
+    WSDB_FETAL("CreateIndexExecutor is end");
+  }
+  auto tab = db_->GetTable(tab_name_);
+  if (tab == nullptr) {
+    WSDB_THROW(WSDB_TABLE_MISS, tab_name_);
+  }
+  auto key_field_num = key_schema_->GetFieldCount() - include_num_;
+  if (FindIndex(db_, tab_name_, *key_schema_, key_field_num) != nullptr) {
+    WSDB_THROW(WSDB_INDEX_EXIST, tab_name_);
+  }
+  if (include_num_ > 0 && index_type_ == IndexType::HASH) {
+    WSDB_THROW(WSDB_UNSUPPORTED_OP, "INCLUDE columns on a hash index");
+  }
+  // the new index keys all of its fields until its included ones are set, look for it among the ones not there before
+  auto old_indexes = db_->GetIndexes(tab_name_);
+  db_->CreateIndex(tab_name_, *key_schema_, index_type_);
+  IndexHandle *idx = nullptr;
+  for (auto handle : db_->GetIndexes(tab_name_)) {
+    if (std::find(old_indexes.begin(), old_indexes.end(), handle) == old_indexes.end()) {
+      idx = handle;
+    }
+  }
+  WSDB_ASSERT(idx != nullptr, fmt::format("index on {} is not created", tab_name_));
+  if (include_num_ > 0) {
+    auto tree = dynamic_cast<BPTreeIndex *>(idx->GetIndex());
+    WSDB_ASSERT(tree != nullptr, fmt::format("index on {} is not a B+ tree", tab_name_));
+    tree->SetIncludeFieldNum(include_num_);
+  }
+  BulkLoad(tab, idx);
+  idx->GetIndex()->Flush();
+  CatalogVersion::Bump();
+  record_ = std::make_unique<Record>(out_schema_.get(), MakeIndexDescValue(tab_name_, idx), INVALID_RID);
+  is_end_ = true;
+}
+auto CreateIndexExecutor::IsEnd() const -> bool { return is_end_; }
+
+void CreateIndexExecutor::BulkLoad(TableHandle *tab, IndexHandle *idx)
+{
+  const auto &key_schema = idx->GetKeySchema();
+  if (auto hash = dynamic_cast<HashIndex *>(idx->GetIndex()); hash != nullptr && hash->GetEntryNum() == 0) {
+    for (auto rid = tab->GetFirstRID(); rid != INVALID_RID; rid = tab->GetNextRID(rid)) {
+      auto rec = tab->GetRecord(rid);
+      hash->Insert(Record(&key_schema, *rec), rid);
+    }
+    return;
+  }
+  auto tree = dynamic_cast<BPTreeIndex *>(idx->GetIndex());
+  if (tree == nullptr || !tree->IsEmpty()) {
+    return;
+  }
+  // build the tree bottom up instead of inserting the records one by one
+  std::vector<std::pair<RecordUptr, RID>> entries;
+  for (auto rid = tab->GetFirstRID(); rid != INVALID_RID; rid = tab->GetNextRID(rid)) {
+    auto rec = tab->GetRecord(rid);
+    entries.emplace_back(std::make_unique<Record>(&key_schema, *rec), rid);
+  }
+  tree->BulkLoad(entries, BPTREE_FILL_FACTOR, Session::Current().GetDop());
+}
+
+/// DropIndex Executor
+DropIndexExecutor::DropIndexExecutor(
+    std::string table_name, std::vector<RTField> key_fields, size_t include_num, DatabaseHandle *db)
+    : AbstractExecutor(DDL),
+      tab_name_(std::move(table_name)),
+      key_schema_(std::make_unique<RecordSchema>(key_fields)),
+      include_num_(include_num),
+      db_(db),
+      is_end_(false)
+{
+  out_schema_ = MakeIndexDescOutSchema();
+}
+
+void DropIndexExecutor::Init() { WSDB_FETAL("DropIndexExecutor does not support Init"); }
+void DropIndexExecutor::Next()
+{
+  if (is_end_) {
+    WSDB_FETAL("DropIndexExecutor is end");
+  }
+  if (db_->GetTable(tab_name_) == nullptr) {
+    WSDB_THROW(WSDB_TABLE_MISS, tab_name_);
+  }
+  auto idx = FindIndex(db_, tab_name_, *key_schema_, key_schema_->GetFieldCount() - include_num_);
+  if (idx == nullptr) {
+    WSDB_THROW(WSDB_INDEX_MISS, tab_name_);
+  }
+  record_ = std::make_unique<Record>(out_schema_.get(), MakeIndexDescValue(tab_name_, idx), INVALID_RID);
+  db_->DropIndex(tab_name_, *key_schema_);
+  CatalogVersion::Bump();
+  is_end_ = true;
+}
+auto DropIndexExecutor::IsEnd() const -> bool { return is_end_; }
+
+/// ShowIndexes Executor
+ShowIndexesExecutor::ShowIndexesExecutor(std::string table_name, DatabaseHandle *db)
+    : AbstractExecutor(DDL), tab_name_(std::move(table_name)), db_(db), is_end_(false), cursor_(0)
+{
+  out_schema_ = MakeIndexDescOutSchema();
+}
+
+void ShowIndexesExecutor::Init() { WSDB_FETAL("ShowIndexesExecutor does not support Init"); }
+void ShowIndexesExecutor::Next()
+{
+  if (is_end_) {
+    WSDB_FETAL("ShowIndexesExecutor is end");
+  }
+  if (cursor_ == 0) {
+    indexes_ = db_->GetIndexes(tab_name_);
+  }
+  if (cursor_ >= indexes_.size()) {
+    is_end_ = true;
+    return;
+  }
+  auto it = indexes_.begin();
+  std::advance(it, cursor_);
+  record_ = std::make_unique<Record>(out_schema_.get(), MakeIndexDescValue(tab_name_, *it), INVALID_RID);
+  cursor_++;
+}
+auto ShowIndexesExecutor::IsEnd() const -> bool { return is_end_; }
+
+/// SetVariable Executor
+SetVariableExecutor::SetVariableExecutor(std::string name, ValueSptr value)
+    : AbstractExecutor(DDL), name_(std::move(name)), value_(std::move(value)), is_end_(false)
+{
+  // header is | Variable | Value
+  std::vector<RTField> fields(2);
+  fields[0] = RTField{
+      .field_ = {
+          .table_id_ = INVALID_TABLE_ID, .field_name_ = "Variable", .field_size_ = 64, .field_type_ = TYPE_STRING}};
+  fields[1] = RTField{
+      .field_ = {.table_id_ = INVALID_TABLE_ID, .field_name_ = "Value", .field_size_ = 64, .field_type_ = TYPE_STRING}};
+  out_schema_ = std::make_unique<RecordSchema>(fields);
+}
+
+void SetVariableExecutor::Init() { WSDB_FETAL("SetVariableExecutor does not support Init"); }
+void SetVariableExecutor::Next()
+{
+  if (is_end_) {
+    WSDB_FETAL("SetVariableExecutor is end");
+  }
+  Session::Current().SetVariable(name_, value_);
+  auto value = Session::Current().GetVariable(name_)->ToString();
+  record_    = std::make_unique<Record>(out_schema_.get(),
+      std::vector<ValueSptr>{ValueFactory::CreateStringValue(name_.c_str(), name_.size()),
+          ValueFactory::CreateStringValue(value.c_str(), value.size())},
+      INVALID_RID);
+  is_end_    = true;
+}
+auto SetVariableExecutor::IsEnd() const -> bool { return is_end_; }
+
+static auto MakeStatementOutSchema() -> std::unique_ptr<RecordSchema>
+{
+  // header is | Statement | Parameters
+  std::vector<RTField> fields(2);
+  fields[0] = RTField{.field_ = {.table_id_ = INVALID_TABLE_ID,
+                          .field_name_      = "Statement",
+                          .field_size_      = 64,
+                          .field_type_      = TYPE_STRING}};
+  fields[1] = RTField{.field_ = {.table_id_ = INVALID_TABLE_ID,
+                          .field_name_      = "Parameters",
+                          .field_size_      = sizeof(int),
+                          .field_type_      = TYPE_INT}};
+  return std::make_unique<RecordSchema>(fields);
+}
+
+/// Prepare Executor
+PrepareExecutor::PrepareExecutor(std::string name, PreparedStatementSptr stmt)
+    : AbstractExecutor(DDL), name_(std::move(name)), stmt_(std::move(stmt)), is_end_(false)
+{
+  out_schema_ = MakeStatementOutSchema();
+}
+
+void PrepareExecutor::Init() { WSDB_FETAL("PrepareExecutor does not support Init"); }
+void PrepareExecutor::Next()
+{
+  if (is_end_) {
+    WSDB_FETAL("PrepareExecutor is end");
+  }
+  Session::Current().Prepare(name_, stmt_);
+  record_ = std::make_unique<Record>(out_schema_.get(),
+      std::vector<ValueSptr>{ValueFactory::CreateStringValue(name_.c_str(), name_.size()),
+          ValueFactory::CreateIntValue(static_cast<int>(stmt_->param_num_))},
+      INVALID_RID);
+  is_end_ = true;
+}
+auto PrepareExecutor::IsEnd() const -> bool { return is_end_; }
+
+/// Deallocate Executor
+DeallocateExecutor::DeallocateExecutor(std::string name) : AbstractExecutor(DDL), name_(std::move(name)), is_end_(false)
+{
+  out_schema_ = MakeStatementOutSchema();
+}
+
+void DeallocateExecutor::Init() { WSDB_FETAL("DeallocateExecutor does not support Init"); }
+void DeallocateExecutor::Next()
+{
+  if (is_end_) {
+    WSDB_FETAL("DeallocateExecutor is end");
+  }
+  auto stmt = Session::Current().GetPrepared(name_);
+  Session::Current().Deallocate(name_);
+  record_ = std::make_unique<Record>(out_schema_.get(),
+      std::vector<ValueSptr>{ValueFactory::CreateStringValue(name_.c_str(), name_.size()),
+          ValueFactory::CreateIntValue(static_cast<int>(stmt->param_num_))},
+      INVALID_RID);
+  is_end_ = true;
+}
+auto DeallocateExecutor::IsEnd() const -> bool { return is_end_; }
+
 }  // namespace wsdb
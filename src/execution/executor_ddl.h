@@ -25,6 +25,8 @@
 #include <utility>
 
 #include "system/handle/database_handle.h"
+#include "expr/statistics.h"
+#include "plan/plan.h"
 #include "executor_abstract.h"
 
 namespace wsdb {
@@ -87,6 +89,28 @@ private:
   size_t cursor_;
 };
 
+/// collects the statistics of a table for the optimizer and shows them, one row per field
+class AnalyzeExecutor : public AbstractExecutor
+{
+public:
+  AnalyzeExecutor(std::string table_name, DatabaseHandle *db);
+
+  void Init() override;
+
+  void Next() override;
+
+  [[nodiscard]] auto IsEnd() const -> bool override;
+
+private:
+  std::string     tab_name_;
+  DatabaseHandle *db_;
+
+private:
+  TableStatsSptr stats_;
+  bool           is_end_;
+  size_t         cursor_;
+};
+
 class ShowTablesExecutor : public AbstractExecutor
 {
 public:
@@ -106,6 +130,131 @@ private:
   size_t cursor_;
 };
 
+class CreateIndexExecutor : public AbstractExecutor
+{
+public:
+  CreateIndexExecutor(std::string table_name, std::vector<RTField> key_fields, IndexType index_type,
+      size_t include_num, DatabaseHandle *db);
+
+  void Init() override;
+
+  void Next() override;
+
+  [[nodiscard]] auto IsEnd() const -> bool override;
+
+private:
+  /// fill an empty index from the records already in the table, a B+ tree is built bottom up
+  void BulkLoad(TableHandle *tab, IndexHandle *idx);
+
+private:
+  std::string      tab_name_;
+  RecordSchemaUptr key_schema_;
+  IndexType        index_type_;
+  size_t           include_num_;  // trailing non-key columns of key_schema_
+  DatabaseHandle  *db_;
+
+private:
+  bool is_end_;
+};
+
+class DropIndexExecutor : public AbstractExecutor
+{
+public:
+  DropIndexExecutor(std::string table_name, std::vector<RTField> key_fields, size_t include_num, DatabaseHandle *db);
+
+  void Init() override;
+
+  void Next() override;
+
+  [[nodiscard]] auto IsEnd() const -> bool override;
+
+private:
+  std::string      tab_name_;
+  RecordSchemaUptr key_schema_;
+  size_t           include_num_;  // trailing non-key columns of key_schema_
+  DatabaseHandle  *db_;
+
+private:
+  bool is_end_;
+};
+
+class ShowIndexesExecutor : public AbstractExecutor
+{
+public:
+  ShowIndexesExecutor(std::string table_name, DatabaseHandle *db);
+
+  void Init() override;
+
+  void Next() override;
+
+  [[nodiscard]] auto IsEnd() const -> bool override;
+
+private:
+  std::string              tab_name_;
+  DatabaseHandle          *db_;
+  std::list<IndexHandle *> indexes_;
+
+private:
+  bool   is_end_;
+  size_t cursor_;
+};
+
+class SetVariableExecutor : public AbstractExecutor
+{
+public:
+  SetVariableExecutor(std::string name, ValueSptr value);
+
+  void Init() override;
+
+  void Next() override;
+
+  [[nodiscard]] auto IsEnd() const -> bool override;
+
+private:
+  std::string name_;
+  ValueSptr   value_;
+
+private:
+  bool is_end_;
+};
+
+class PrepareExecutor : public AbstractExecutor
+{
+public:
+  PrepareExecutor(std::string name, PreparedStatementSptr stmt);
+
+  void Init() override;
+
+  void Next() override;
+
+  [[nodiscard]] auto IsEnd() const -> bool override;
+
+private:
+  std::string           name_;
+  PreparedStatementSptr stmt_;
+
+private:
+  bool is_end_;
+};
+
+class DeallocateExecutor : public AbstractExecutor
+{
+public:
+  explicit DeallocateExecutor(std::string name);
+
+  void Init() override;
+
+  void Next() override;
+
+  [[nodiscard]] auto IsEnd() const -> bool override;
+
+private:
+  std::string name_;
+
+private:
+  bool is_end_;
+};
+
 }  // namespace wsdb
 
 #endif  // WSDB_EXECUTOR_DDL_H
@@ -23,11 +23,17 @@
 #define WSDB_EXECUTOR_DEFS_H
 
 #include "executor_aggregate.h"
+#include "executor_bitmapscan.h"
+#include "executor_copy.h"
 #include "executor_ddl.h"
 #include "executor_delete.h"
+#include "executor_explain.h"
 #include "executor_filter.h"
+#include "executor_gather.h"
 #include "executor_idxscan.h"
 #include "executor_insert.h"
+#include "executor_join_hash.h"
+#include "executor_join_index.h"
 #include "executor_join_nestedloop.h"
 #include "executor_join_sortmerge.h"
 #include "executor_limit.h"
@@ -59,6 +59,10 @@ void DeleteExecutor::Next()
       // Move to the next record in the child executor
       child_->Next();
   }
+  // the indexes write what they keep in memory, e.g. their entry number, once per statement
+  for (auto *index : indexes_) {
+    index->GetIndex()->Flush();
+  }
 
   std::vector<ValueSptr> values{ValueFactory::CreateIntValue(count)};
   record_ = std::make_unique<Record>(out_schema_.get(), values, INVALID_RID);
@@ -0,0 +1,140 @@
+/*------------------------------------------------------------------------------
+ - Copyright (c) 2024. Websoft research group, Nanjing University.
+ -
+ - This program is free software: you can redistribute it and/or modify
+ - it under the terms of the GNU General Public License as published by
+ - the Free Software Foundation, either version 3 of the License, or
+ - (at your option) any later version.
+ -
+ - This program is distributed in the hope that it will be useful,
+ - but WITHOUT ANY WARRANTY; without even the implied warranty of
+ - MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ - GNU General Public License for more details.
+ -
+ - You should have received a copy of the GNU General Public License
+ - along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ -----------------------------------------------------------------------------*/
+
+#include "executor_explain.h"
+#include "executor.h"
+
+namespace wsdb {
+
+ExplainAnalyzeExecutor::ExplainAnalyzeExecutor(std::shared_ptr<ExplainPlan> explain, DatabaseHandle *db)
+    : AbstractExecutor(DDL), explain_(std::move(explain)), is_run_(false), is_end_(false), cursor_(0)
+{
+  // explain analyze header is | Operator | EstRows | EstCost | Rows | Loops | TimeMs | ChildMs | Hits | Misses | Reads
+  // | Writes, an estimate or a measure that is not known is null
+  auto make_field = [](const std::string &name, FieldType type, size_t size) {
+    return RTField{
+        .field_ = {.table_id_ = INVALID_TABLE_ID, .field_name_ = name, .field_size_ = size, .field_type_ = type}};
+  };
+  std::vector<RTField> fields;
+  fields.push_back(make_field("Operator", TYPE_STRING, 256));
+  fields.push_back(make_field("EstRows", TYPE_FLOAT, 4));
+  fields.push_back(make_field("EstCost", TYPE_FLOAT, 4));
+  fields.push_back(make_field("Rows", TYPE_INT, 4));
+  fields.push_back(make_field("Loops", TYPE_INT, 4));
+  fields.push_back(make_field("TimeMs", TYPE_FLOAT, 4));
+  fields.push_back(make_field("ChildMs", TYPE_FLOAT, 4));
+  fields.push_back(make_field("Hits", TYPE_INT, 4));
+  fields.push_back(make_field("Misses", TYPE_INT, 4));
+  fields.push_back(make_field("Reads", TYPE_INT, 4));
+  fields.push_back(make_field("Writes", TYPE_INT, 4));
+  out_schema_ = std::make_unique<RecordSchema>(fields);
+  Describe(explain_->logical_plan_, 0);
+  child_ = Executor::Translate(explain_->logical_plan_, db, &profiles_);
+}
+
+void ExplainAnalyzeExecutor::Init() { WSDB_FETAL("ExplainAnalyzeExecutor does not support Init"); }
+
+void ExplainAnalyzeExecutor::Next()
+{
+  if (IsEnd()) {
+    WSDB_FETAL("ExplainAnalyzeExecutor is end");
+  }
+  if (!is_run_) {
+    Run();
+    is_run_ = true;
+  }
+  if (cursor_ >= lines_.size()) {
+    is_end_ = true;
+    return;
+  }
+  const auto &[name, node] = lines_[cursor_];
+  auto        est          = explain_->estimates_.find(node);
+  auto        prof         = profiles_.find(node);
+  // the optimizer does not know the size of some plans, e.g. an aggregation
+  bool has_est  = est != explain_->estimates_.end() && est->second.first < static_cast<double>(SIZE_MAX / 2);
+  bool has_prof = prof != profiles_.end();
+  auto as_int   = [has_prof](size_t val) {
+    return has_prof ? ValueFactory::CreateIntValue(static_cast<int>(val)) : ValueFactory::CreateNullValue(TYPE_INT);
+  };
+  auto as_float = [](bool known, double val) {
+    return known ? ValueFactory::CreateFloatValue(static_cast<float>(val)) : ValueFactory::CreateNullValue(TYPE_FLOAT);
+  };
+  ExecStats              stats = has_prof ? *prof->second : ExecStats{};
+  std::vector<ValueSptr> values;
+  values.reserve(out_schema_->GetFieldCount());
+  values.push_back(ValueFactory::CreateStringValue(name.c_str(), name.size()));
+  values.push_back(as_float(has_est, has_est ? est->second.first : 0));
+  values.push_back(as_float(has_est, has_est ? est->second.second : 0));
+  values.push_back(as_int(stats.rows_));
+  values.push_back(as_int(stats.loops_));
+  values.push_back(as_float(has_prof, stats.time_ms_));
+  values.push_back(as_float(has_prof, stats.child_time_ms_));
+  values.push_back(as_int(stats.io_.hits_));
+  values.push_back(as_int(stats.io_.misses_));
+  values.push_back(as_int(stats.io_.reads_));
+  values.push_back(as_int(stats.io_.writes_));
+  WSDB_ASSERT(values.size() == out_schema_->GetFieldCount(), "Value size not match");
+  record_ = std::make_unique<Record>(out_schema_.get(), values, INVALID_RID);
+  cursor_++;
+}
+
+auto ExplainAnalyzeExecutor::IsEnd() const -> bool { return is_end_; }
+
+void ExplainAnalyzeExecutor::Describe(const std::shared_ptr<AbstractPlan> &plan, int level)
+{
+  auto str = plan->ToString(level);
+  lines_.emplace_back(str.substr(0, str.find('\n')), plan.get());
+  if (auto filter = std::dynamic_pointer_cast<FilterPlan>(plan)) {
+    Describe(filter->child_, level + 1);
+  } else if (auto bitmap_scan = std::dynamic_pointer_cast<BitmapScanPlan>(plan)) {
+    for (const auto &idx_scan : bitmap_scan->index_scans_) {
+      Describe(idx_scan, level + 1);
+    }
+  } else if (auto sort = std::dynamic_pointer_cast<SortPlan>(plan)) {
+    Describe(sort->child_, level + 1);
+  } else if (auto proj = std::dynamic_pointer_cast<ProjectPlan>(plan)) {
+    Describe(proj->child_, level + 1);
+  } else if (auto join = std::dynamic_pointer_cast<JoinPlan>(plan)) {
+    Describe(join->left_, level + 1);
+    Describe(join->right_, level + 1);
+  } else if (auto agg = std::dynamic_pointer_cast<AggregatePlan>(plan)) {
+    Describe(agg->child_, level + 1);
+  } else if (auto lim = std::dynamic_pointer_cast<LimitPlan>(plan)) {
+    Describe(lim->child_, level + 1);
+  } else if (auto gather = std::dynamic_pointer_cast<GatherPlan>(plan)) {
+    Describe(gather->child_, level + 1);
+  } else if (auto upd = std::dynamic_pointer_cast<UpdatePlan>(plan)) {
+    Describe(upd->child_, level + 1);
+  } else if (auto del = std::dynamic_pointer_cast<DeletePlan>(plan)) {
+    Describe(del->child_, level + 1);
+  }
+}
+
+void ExplainAnalyzeExecutor::Run()
+{
+  // the records are dropped, only the work to produce them is measured
+  if (child_->GetType() == Basic) {
+    for (child_->Init(); !child_->IsEnd(); child_->Next()) {}
+    return;
+  }
+  child_->Next();
+  while (!child_->IsEnd()) {
+    child_->Next();
+  }
+}
+
+}  // namespace wsdb
@@ -0,0 +1,67 @@
+/*------------------------------------------------------------------------------
+ - Copyright (c) 2024. Websoft research group, Nanjing University.
+ -
+ - This program is free software: you can redistribute it and/or modify
+ - it under the terms of the GNU General Public License as published by
+ - the Free Software Foundation, either version 3 of the License, or
+ - (at your option) any later version.
+ -
+ - This program is distributed in the hope that it will be useful,
+ - but WITHOUT ANY WARRANTY; without even the implied warranty of
+ - MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ - GNU General Public License for more details.
+ -
+ - You should have received a copy of the GNU General Public License
+ - along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ -----------------------------------------------------------------------------*/
+
+/**
+ * @brief EXPLAIN ANALYZE, run the plan to the end without returning its records, then show one row per plan node
+ * with the estimates of the optimizer next to what its executor did: the records it produced, the calls of Init, the
+ * time and page accesses of all calls and the part of them spent in its children. A node without an executor of its
+ * own, e.g. a worker pipeline of a gather or an index scan inside a bitmap scan, only shows its estimates
+ *
+ */
+
+#ifndef WSDB_EXECUTOR_EXPLAIN_H
+#define WSDB_EXECUTOR_EXPLAIN_H
+
+#include "executor_abstract.h"
+#include "executor_profile.h"
+#include "plan/plan.h"
+#include "system/handle/database_handle.h"
+
+namespace wsdb {
+class ExplainAnalyzeExecutor : public AbstractExecutor
+{
+public:
+  ExplainAnalyzeExecutor(std::shared_ptr<ExplainPlan> explain, DatabaseHandle *db);
+
+  void Init() override;
+
+  void Next() override;
+
+  [[nodiscard]] auto IsEnd() const -> bool override;
+
+private:
+  /// add the lines of the plan and its children, translating a plan moves some of its fields so this comes first
+  void Describe(const std::shared_ptr<AbstractPlan> &plan, int level);
+
+  /// run the profiled executors the same way as a query is executed
+  void Run();
+
+private:
+  std::shared_ptr<ExplainPlan> explain_;
+
+  // the first line of the plan string of every node and the node, in the order of the plan string
+  std::vector<std::pair<std::string, const AbstractPlan *>> lines_;
+  ExecProfiles                                             profiles_;
+  AbstractExecutorUptr                                     child_;
+
+  bool   is_run_;
+  bool   is_end_;
+  size_t cursor_;
+};
+}  // namespace wsdb
+
+#endif  // WSDB_EXECUTOR_EXPLAIN_H
@@ -0,0 +1,207 @@
+/*------------------------------------------------------------------------------
+ - Copyright (c) 2024. Websoft research group, Nanjing University.
+ -
+ - This program is free software: you can redistribute it and/or modify
+ - it under the terms of the GNU General Public License as published by
+ - the Free Software Foundation, either version 3 of the License, or
+ - (at your option) any later version.
+ -
+ - This program is distributed in the hope that it will be useful,
+ - but WITHOUT ANY WARRANTY; without even the implied warranty of
+ - MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ - GNU General Public License for more details.
+ -
+ - You should have received a copy of the GNU General Public License
+ - along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ -----------------------------------------------------------------------------*/
+
+#include "executor_gather.h"
+#include "common/thread_pool.h"
+
+namespace wsdb {
+
+GatherExecutor::GatherExecutor(std::vector<AbstractExecutorUptr> pipelines, MorselQueueSptr morsels)
+    : AbstractExecutor(Basic), pipelines_(std::move(pipelines)), morsels_(std::move(morsels))
+{
+  WSDB_ASSERT(!pipelines_.empty(), "gather needs at least one pipeline");
+}
+
+GatherExecutor::~GatherExecutor() { Stop(); }
+
+void GatherExecutor::Init()
+{
+  Stop();
+  if (morsels_ != nullptr) {
+    morsels_->Reset();
+  }
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    queue_.clear();
+    stopped_  = false;
+    error_    = nullptr;
+    finished_ = 0;
+  }
+  batch_.clear();
+  batch_idx_ = 0;
+  local_     = pipelines_.size();
+  is_end_    = false;
+  next_      = std::make_shared<std::atomic<size_t>>(0);
+  // the consumer runs a pipeline too, more tasks than workers would only wait in the pool
+  auto task_num = std::min(pipelines_.size() - 1, ThreadPool::GetInstance().GetThreadNum());
+  for (size_t i = 0; i < task_num; i++) {
+    // a task touches the executor only while it runs a pipeline it has taken, which Stop waits for
+    ThreadPool::GetInstance().Submit([this, next = next_, n = pipelines_.size()] {
+      for (size_t idx = (*next)++; idx < n; idx = (*next)++) {
+        RunPipeline(idx);
+      }
+    });
+  }
+  Fetch();
+}
+
+void GatherExecutor::Next()
+{
+  WSDB_ASSERT(!is_end_, "GatherExecutor is end");
+  Fetch();
+}
+
+auto GatherExecutor::IsEnd() const -> bool { return is_end_; }
+
+auto GatherExecutor::GetOutSchema() const -> const RecordSchema * { return pipelines_.front()->GetOutSchema(); }
+
+void GatherExecutor::RunPipeline(size_t idx)
+{
+  auto &pipeline = pipelines_[idx];
+  try {
+    Batch batch;
+    batch.reserve(GATHER_BATCH_SIZE);
+    bool stopped = false;
+    for (pipeline->Init(); !pipeline->IsEnd() && !stopped; pipeline->Next()) {
+      if (stopped_.load(std::memory_order_relaxed)) {
+        break;
+      }
+      batch.push_back(pipeline->GetRecord());
+      if (batch.size() == GATHER_BATCH_SIZE) {
+        stopped = !Push(std::move(batch));
+        batch   = Batch();
+        batch.reserve(GATHER_BATCH_SIZE);
+      }
+    }
+    if (!batch.empty() && !stopped) {
+      Push(std::move(batch));
+    }
+  } catch (...) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (error_ == nullptr) {
+      error_ = std::current_exception();
+    }
+  }
+  std::lock_guard<std::mutex> lock(mutex_);
+  finished_++;
+  // notify under the lock, the executor may be destroyed as soon as the last pipeline is seen finished
+  not_empty_.notify_all();
+}
+
+auto GatherExecutor::RunLocal() -> bool
+{
+  auto n     = pipelines_.size();
+  bool start = local_ == n;
+  if (start) {
+    local_ = std::min((*next_)++, n);
+    if (local_ == n) {
+      return false;
+    }
+  }
+  batch_.clear();
+  batch_idx_     = 0;
+  auto &pipeline = pipelines_[local_];
+  bool  end      = true;
+  try {
+    if (start) {
+      pipeline->Init();
+    }
+    for (; !pipeline->IsEnd() && batch_.size() < GATHER_BATCH_SIZE; pipeline->Next()) {
+      batch_.push_back(pipeline->GetRecord());
+    }
+    end = pipeline->IsEnd();
+  } catch (...) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (error_ == nullptr) {
+      error_ = std::current_exception();
+    }
+  }
+  if (end) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    finished_++;
+    local_ = n;
+  }
+  return true;
+}
+
+auto GatherExecutor::Push(Batch batch) -> bool
+{
+  std::unique_lock<std::mutex> lock(mutex_);
+  not_full_.wait(lock, [this] { return stopped_ || queue_.size() < GATHER_QUEUE_SIZE; });
+  if (stopped_) {
+    return false;
+  }
+  queue_.push_back(std::move(batch));
+  not_empty_.notify_one();
+  return true;
+}
+
+void GatherExecutor::Stop()
+{
+  if (next_ == nullptr) {
+    return;
+  }
+  auto                         n       = pipelines_.size();
+  auto                         started = std::min(next_->exchange(n), n);
+  std::unique_lock<std::mutex> lock(mutex_);
+  if (local_ < n) {
+    finished_++;
+    local_ = n;
+  }
+  stopped_ = true;
+  not_full_.notify_all();
+  not_empty_.wait(lock, [this, started] { return finished_ == started; });
+  queue_.clear();
+  next_ = nullptr;
+}
+
+void GatherExecutor::Fetch()
+{
+  while (batch_idx_ >= batch_.size()) {
+    std::unique_lock<std::mutex> lock(mutex_);
+    if (error_ != nullptr) {
+      auto error = error_;
+      lock.unlock();
+      Stop();
+      is_end_ = true;
+      record_.reset();
+      std::rethrow_exception(error);
+    }
+    if (!queue_.empty()) {
+      batch_     = std::move(queue_.front());
+      batch_idx_ = 0;
+      queue_.pop_front();
+      not_full_.notify_one();
+      continue;
+    }
+    lock.unlock();
+    // nothing is ready, run the pipeline of the consumer rather than wait for the tasks
+    if (RunLocal()) {
+      continue;
+    }
+    lock.lock();
+    not_empty_.wait(lock, [this] { return !queue_.empty() || finished_ == pipelines_.size() || error_ != nullptr; });
+    if (queue_.empty() && error_ == nullptr) {
+      is_end_ = true;
+      record_.reset();
+      return;
+    }
+  }
+  record_ = std::move(batch_[batch_idx_++]);
+}
+
+}  // namespace wsdb
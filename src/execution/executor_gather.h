@@ -0,0 +1,98 @@
+/*------------------------------------------------------------------------------
+ - Copyright (c) 2024. Websoft research group, Nanjing University.
+ -
+ - This program is free software: you can redistribute it and/or modify
+ - it under the terms of the GNU General Public License as published by
+ - the Free Software Foundation, either version 3 of the License, or
+ - (at your option) any later version.
+ -
+ - This program is distributed in the hope that it will be useful,
+ - but WITHOUT ANY WARRANTY; without even the implied warranty of
+ - MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ - GNU General Public License for more details.
+ -
+ - You should have received a copy of the GNU General Public License
+ - along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ -----------------------------------------------------------------------------*/
+
+/**
+ * @brief Run several copies of a pipeline (e.g. scan -> filter -> projection) in parallel and combine their output.
+ * The copies usually share a MorselQueue so that each of them scans part of a table. The consumer thread runs a copy
+ * itself, a batch at a time whenever no other batch is ready, and at most one task per thread of the shared worker
+ * pool runs the others, taking the copies no one has started yet. So the gather makes progress even when every
+ * worker is busy, e.g. with the consumers of other gathers. Records of the tasks are passed in batches through a
+ * bounded queue, the order of the output is not defined.
+ *
+ * Any executor tree that is safe to run concurrently with its copies can be a pipeline, e.g. partial aggregations or
+ * hash join probes over a shared build side.
+ *
+ */
+
+#ifndef WSDB_EXECUTOR_GATHER_H
+#define WSDB_EXECUTOR_GATHER_H
+
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <exception>
+#include <memory>
+#include <mutex>
+#include "executor_abstract.h"
+#include "executor_seqscan.h"
+
+namespace wsdb {
+class GatherExecutor : public AbstractExecutor
+{
+public:
+  GatherExecutor(std::vector<AbstractExecutorUptr> pipelines, MorselQueueSptr morsels);
+
+  ~GatherExecutor() override;
+
+  void Init() override;
+
+  void Next() override;
+
+  [[nodiscard]] auto IsEnd() const -> bool override;
+
+  [[nodiscard]] auto GetOutSchema() const -> const RecordSchema * override;
+
+private:
+  using Batch = std::vector<RecordUptr>;
+
+  void RunPipeline(size_t idx);
+
+  /// run the pipeline of the consumer into batch_, taking the next one if it has ended. false if none is left
+  auto RunLocal() -> bool;
+
+  /// hand a batch over to the consumer, return false if the gather has been stopped
+  auto Push(Batch batch) -> bool;
+
+  /// stop all started pipelines and wait for them, the others are not started any more
+  void Stop();
+
+  /// load the next record into record_
+  void Fetch();
+
+private:
+  std::vector<AbstractExecutorUptr> pipelines_;
+  MorselQueueSptr                   morsels_;
+
+  std::mutex              mutex_;
+  std::condition_variable not_empty_;  // notified when a batch is pushed or a pipeline finishes
+  std::condition_variable not_full_;   // notified when a batch is popped or the gather is stopped
+  std::deque<Batch>       queue_;
+  size_t                  finished_{0};     // started pipelines that have ended
+  std::atomic<bool>       stopped_{false};  // also polled by the pipelines without holding mutex_
+  std::exception_ptr      error_;
+  // index of the next pipeline to start, shared with the tasks so that those starting after Stop see all are taken
+  std::shared_ptr<std::atomic<size_t>> next_;
+
+  // only touched by the consumer
+  Batch  batch_;  // batch being consumed
+  size_t batch_idx_{0};
+  size_t local_{0};  // pipeline run by the consumer, pipelines_.size() if none
+  bool   is_end_{true};
+};
+}  // namespace wsdb
+
+#endif  // WSDB_EXECUTOR_GATHER_H
@@ -23,14 +23,130 @@
 
 namespace wsdb {
 
-IdxScanExecutor::IdxScanExecutor(TableHandle *tbl, IndexHandle *idx, ConditionVec conds, int cmp_field_num)
-    : AbstractExecutor(Basic), tbl_(tbl), idx_(idx), conds_(std::move(conds)), cmp_field_num_(cmp_field_num)
+IdxScanExecutor::IdxScanExecutor(
+    TableHandle *tbl, IndexHandle *idx, ConditionVec conds, int cmp_field_num, bool index_only)
+    : AbstractExecutor(Basic),
+      tbl_(tbl),
+      idx_(idx),
+      conds_(std::move(conds)),
+      cmp_field_num_(cmp_field_num),
+      index_only_(index_only)
 {
-  // TODO: generate low key and high key using conds, conds has been rearranged to match the index key prefix
+  // conds has been rearranged to match the index key prefix, equalities or IN lists on the first fields, then the
+  // ranges on the field after them. Every combination of the equal values gives a range, the ranges are in key order.
+  // The optimizer leaves the IN lists that would make more than INDEX_SCAN_MAX_RANGES of them to a filter. Without
+  // conditions the whole index is read in key order
+  const auto &key_schema = idx_->GetKeySchema();
+  size_t      eq_num     = 0;
+  while (eq_num < conds_.size() && (conds_[eq_num].GetOp() == OP_EQ || conds_[eq_num].GetOp() == OP_IN)) {
+    eq_num++;
+  }
+  WSDB_ASSERT(cmp_field_num_ >= 0 && static_cast<size_t>(cmp_field_num_) <= key_schema.GetFieldCount() &&
+                  (eq_num == conds_.size() ? eq_num : eq_num + 1) == static_cast<size_t>(cmp_field_num_),
+      fmt::format("invalid index scan prefix {}", cmp_field_num_));
+  std::vector<std::vector<ValueSptr>> keys(1);
+  for (size_t i = 0; i < eq_num; i++) {
+    auto                   type = key_schema.GetFieldAt(i).field_.field_type_;
+    std::vector<ValueSptr> values;
+    if (conds_[i].GetOp() == OP_IN) {
+      auto list = std::dynamic_pointer_cast<ArrayValue>(conds_[i].GetRVal());
+      WSDB_ASSERT(list != nullptr, "index scan expects a value list for IN");
+      for (const auto &val : list->Get()) {
+        values.push_back(ValueFactory::CastTo(val, type));
+      }
+      // probe in key order, where nulls come first, and probe a repeated value once
+      std::sort(values.begin(), values.end(), [](const ValueSptr &lhs, const ValueSptr &rhs) {
+        return lhs->IsNull() ? !rhs->IsNull() : *lhs < *rhs;
+      });
+      values.erase(std::unique(values.begin(),
+                       values.end(),
+                       [](const ValueSptr &lhs, const ValueSptr &rhs) { return *lhs == *rhs; }),
+          values.end());
+    } else {
+      WSDB_ASSERT(conds_[i].GetRhsType() == kValue, "index scan expects constants");
+      values.push_back(ValueFactory::CastTo(conds_[i].GetRVal(), type));
+    }
+    std::vector<std::vector<ValueSptr>> next_keys;
+    for (const auto &key : keys) {
+      for (const auto &val : values) {
+        next_keys.push_back(key);
+        next_keys.back().push_back(val);
+      }
+    }
+    keys = std::move(next_keys);
+  }
+  // the tightest bounds of the range field, a missing bound leaves the range open on that side
+  ValueSptr lower, upper;
+  for (size_t i = eq_num; i < conds_.size(); i++) {
+    WSDB_ASSERT(conds_[i].GetRhsType() == kValue, "index scan expects constants");
+    auto val = ValueFactory::CastTo(conds_[i].GetRVal(), key_schema.GetFieldAt(eq_num).field_.field_type_);
+    switch (conds_[i].GetOp()) {
+      case OP_GT:
+      case OP_GE: lower = lower == nullptr || *lower < *val ? val : lower; break;
+      case OP_LT:
+      case OP_LE: upper = upper == nullptr || *val < *upper ? val : upper; break;
+      default: WSDB_FETAL(fmt::format("index scan does not support {}", CompOpToString(conds_[i].GetOp())));
+    }
+  }
+  low_field_num_  = eq_num + (lower != nullptr ? 1 : 0);
+  high_field_num_ = eq_num + (upper != nullptr ? 1 : 0);
+  for (auto &key : keys) {
+    auto low  = key;
+    auto high = key;
+    for (size_t i = eq_num; i < key_schema.GetFieldCount(); i++) {
+      auto null = ValueFactory::CreateNullValue(key_schema.GetFieldAt(i).field_.field_type_);
+      low.push_back(i == eq_num && lower != nullptr ? lower : null);
+      high.push_back(i == eq_num && upper != nullptr ? upper : null);
+    }
+    ranges_.emplace_back(std::make_unique<Record>(&key_schema, low, INVALID_RID),
+        std::make_unique<Record>(&key_schema, high, INVALID_RID));
+  }
 }
-// TODO(ziqi): implement the following functions to support index scan
-void IdxScanExecutor::Init() {}
-void IdxScanExecutor::Next() {}
-auto IdxScanExecutor::IsEnd() const -> bool { return false; }
 
-}  // namespace wsdb
\ No newline at end of file
+void IdxScanExecutor::Init()
+{
+  range_idx_ = 0;
+  iter_      = nullptr;
+  NextRange();
+  LoadRecord();
+}
+
+void IdxScanExecutor::Next()
+{
+  WSDB_ASSERT(!IsEnd(), "IdxScanExecutor is end");
+  iter_->Next();
+  NextRange();
+  LoadRecord();
+}
+
+auto IdxScanExecutor::IsEnd() const -> bool { return iter_ == nullptr || iter_->IsEnd(); }
+
+auto IdxScanExecutor::GetAllRIDs() -> std::vector<RID>
+{
+  std::vector<RID> rids;
+  range_idx_ = 0;
+  iter_      = nullptr;
+  for (NextRange(); !IsEnd(); iter_->Next(), NextRange()) {
+    rids.push_back(iter_->GetRID());
+  }
+  return rids;
+}
+
+void IdxScanExecutor::NextRange()
+{
+  while (IsEnd() && range_idx_ < ranges_.size()) {
+    const auto &[low, high] = ranges_[range_idx_++];
+    iter_                   = idx_->GetIndex()->Scan(*low, low_field_num_, *high, high_field_num_);
+  }
+}
+
+void IdxScanExecutor::LoadRecord()
+{
+  if (IsEnd()) {
+    record_ = nullptr;
+    return;
+  }
+  record_ = index_only_ ? iter_->GetRecord() : tbl_->GetRecord(iter_->GetRID());
+}
+
+}  // namespace wsdb
@@ -36,7 +36,7 @@ namespace wsdb {
 class IdxScanExecutor : public AbstractExecutor
 {
 public:
-  IdxScanExecutor(TableHandle *tbl, IndexHandle *idx, ConditionVec conds, int cmp_field_num);
+  IdxScanExecutor(TableHandle *tbl, IndexHandle *idx, ConditionVec conds, int cmp_field_num, bool index_only = false);
 
   void Init() override;
 
@@ -44,20 +44,36 @@ public:
 
   [[nodiscard]] auto IsEnd() const -> bool override;
 
+  [[nodiscard]] auto GetOutSchema() const -> const RecordSchema * override
+  {
+    return index_only_ ? &idx_->GetKeySchema() : &tbl_->GetSchema();
+  }
+
+  /// the rids of all the entries in the ranges without reading the table, used by the bitmap scan
+  auto GetAllRIDs() -> std::vector<RID>;
+
+private:
+  /// open the iterator of the next range that has entries, iter_ stays at its end after the last range
+  void NextRange();
+
+  /// fetch the record of the current index entry into AbstractExecutor::record_, an index only scan decodes the entry
+  /// into a record of the index schema instead of reading the table
+  void LoadRecord();
+
 private:
-  /// Index scan should find all the records in the range [low, high),
-  /// where the comparison is based on the first cmp_field_num fields.
-  /// low, high should be generated using conds. Both the schema of
-  /// record low and record high are the same as the index key
-  /// schema. Store the record fetched from the table handle with the
-  /// indexed rid into AbstractExecutor::record_. Remove [[maybe_unused]]
-  /// when you implement this executor
-  TableHandle *tbl_;            // table handle
-  IndexHandle *idx_;            // index handle
-  ConditionVec conds_;          // conditions
-  RecordUptr   low_;            // low key
-  RecordUptr   high_;           // high key
-  int          cmp_field_num_;  // number of field to be compared from the 0th field
+  /// Index scan finds all the records in the ranges [low, high],
+  /// where low is compared on the first low_field_num fields and high on the first high_field_num fields.
+  /// low, high are generated from conds and have the index key schema, an IN list gives one range per value.
+  TableHandle                                    *tbl_;            // table handle
+  IndexHandle                                    *idx_;            // index handle
+  ConditionVec                                   conds_;           // conditions
+  std::vector<std::pair<RecordUptr, RecordUptr>> ranges_;          // low and high keys
+  size_t                                         range_idx_{0};    // next range to scan
+  int                                            cmp_field_num_;   // number of field to be compared from the 0th field
+  size_t                                         low_field_num_;   // number of fields of low, 0 if unbounded
+  size_t                                         high_field_num_;  // number of fields of high, 0 if unbounded
+  IndexIteratorUptr                              iter_;            // iterator over the rids in the current range
+  bool                                           index_only_;      // build the records from the index entries
 };
 }  // namespace wsdb
 
@@ -20,11 +20,19 @@
  //
 
 #include "executor_insert.h"
+#include <algorithm>
+#include "system/session.h"
 
 namespace wsdb {
 
-  InsertExecutor::InsertExecutor(TableHandle* tbl, std::list<IndexHandle*> indexes, std::vector<RecordUptr> inserts)
-    : AbstractExecutor(DML), tbl_(tbl), indexes_(std::move(indexes)), inserts_(std::move(inserts)), is_end_(false)
+  InsertExecutor::InsertExecutor(
+    TableHandle* tbl, std::list<IndexHandle*> indexes, std::vector<RecordUptr> inserts, ZoneMapSptr zone_map)
+    : AbstractExecutor(DML),
+    tbl_(tbl),
+    indexes_(std::move(indexes)),
+    inserts_(std::move(inserts)),
+    zone_map_(std::move(zone_map)),
+    is_end_(false)
   {
     std::vector<RTField> fields(1);
     fields[0] = RTField{ .field_ = {.field_name_ = "inserted", .field_size_ = sizeof(int), .field_type_ = TYPE_INT} };
@@ -35,51 +43,69 @@ namespace wsdb {
 
   void InsertExecutor::Next()
   {
-    // number of inserted records
-    int count = 0;
-
-    //TODO:
-    // Number of successfully inserted records
-    int count = 0;
-
-    // Iterate through the list of records to be inserted
+    // insert all the records into the table first, the indexes are maintained per index afterwards
     for (auto& record : inserts_) {
-      // Step 1: Insert the record into the table
-      RID new_rid = tbl_->InsertRecord(*record); // Insert the record into the table and get its RID
+      RID new_rid = tbl_->InsertRecord(*record);
       if (new_rid == INVALID_RID) {
         WSDB_THROW(WSDB_RECORD_EXISTS, "Failed to insert record into table");
       }
-
-      // Step 2: Update the RID in the record
       record->SetRID(new_rid);
-
-      // Step 3: Insert the record into all associated indexes
-      for (auto& index_handle : indexes_) {
-        try {
-          // Get the key schema for the index
-          const RecordSchema& key_schema = index_handle->GetKeySchema();
-          // Generate the index entry key using the current record
-          Record key_record(&key_schema, *record);
-          // Insert the key record into the index
-          index_handle->InsertRecord(key_record);
-        }
-        catch (const std::exception& e) {
-          // Handle index insertion failure
-          WSDB_THROW(WSDB_RECORD_EXISTS,
-            "Failed to insert record into index: " + index_handle->GetIndexName());
-        }
+      if (zone_map_ != nullptr) {
+        zone_map_->Add(new_rid.PageID(), *record);
       }
-
-      // Increment the count of successfully inserted records
-      count++;
+    }
+    for (auto& index_handle : indexes_) {
+      const auto& key_schema = index_handle->GetKeySchema();
+      std::vector<std::pair<RecordUptr, RID>> entries;
+      entries.reserve(inserts_.size());
+      for (auto& record : inserts_) {
+        entries.emplace_back(std::make_unique<Record>(&key_schema, *record), record->GetRID());
+      }
+      InsertIndex(index_handle, entries);
+      // the index writes what it keeps in memory, e.g. its entry number, once per statement
+      index_handle->GetIndex()->Flush();
     }
 
-    // Prepare the result record with the number of inserted records
-    std::vector<ValueSptr> values{ ValueFactory::CreateIntValue(count) };
+    std::vector<ValueSptr> values{ ValueFactory::CreateIntValue(static_cast<int>(inserts_.size())) };
     record_ = std::make_unique<Record>(out_schema_.get(), values, INVALID_RID);
     is_end_ = true;
   }
 
   auto InsertExecutor::IsEnd() const -> bool { return is_end_; }
 
+  void InsertExecutor::InsertIndex(IndexHandle* index_handle, const std::vector<std::pair<RecordUptr, RID>>& entries)
+  {
+    auto tree = dynamic_cast<BPTreeIndex*>(index_handle->GetIndex());
+    if (tree == nullptr || entries.size() == 1) {
+      for (const auto& [key, rid] : entries) {
+        index_handle->GetIndex()->Insert(*key, rid);
+      }
+      return;
+    }
+    const auto& key_schema = index_handle->GetKeySchema();
+    // loading into an empty tree builds it bottom up, the tree rejects the load if another session got there first
+    if (tree->IsEmpty()) {
+      try {
+        tree->BulkLoad(entries, BPTREE_FILL_FACTOR, Session::Current().GetDop());
+        return;
+      }
+      catch (const WSDBException_&) {
+        if (tree->IsEmpty()) {
+          throw;
+        }
+      }
+    }
+    // otherwise insert in key order, so that consecutive inserts descend to the same or adjacent leaves
+    SortKeyEncoder encoder(&key_schema, &key_schema);
+    std::vector<std::pair<std::string, size_t>> order;
+    order.reserve(entries.size());
+    for (size_t i = 0; i < entries.size(); i++) {
+      order.emplace_back(encoder.Encode(*entries[i].first), i);
+    }
+    std::sort(order.begin(), order.end());
+    for (const auto& [key, i] : order) {
+      tree->Insert(*entries[i].first, entries[i].second);
+    }
+  }
+
 }  // namespace wsdb
@@ -21,12 +21,15 @@
 
 /**
  * @brief Insert the records into the table and the indexes
- * 
+ *
+ * The records of a multi-row insert go into the table first, then each index is maintained in one pass: an empty
+ * B+ tree is bulk loaded, otherwise the keys are inserted in sorted order.
  */
 
 #include "executor_abstract.h"
 #include "system/handle/table_handle.h"
 #include "system/handle/index_handle.h"
+#include "expr/zone_map.h"
 
 #ifndef WSDB_EXECUTOR_INSERT_H
 #define WSDB_EXECUTOR_INSERT_H
@@ -35,7 +38,8 @@ namespace wsdb {
 class InsertExecutor : public AbstractExecutor
 {
 public:
-  InsertExecutor(TableHandle *tbl, std::list<IndexHandle *> indexes, std::vector<RecordUptr> inserts);
+  InsertExecutor(TableHandle *tbl, std::list<IndexHandle *> indexes, std::vector<RecordUptr> inserts,
+      ZoneMapSptr zone_map = nullptr);
 
   void Init() override;
 
@@ -43,10 +47,14 @@ public:
 
   [[nodiscard]] auto IsEnd() const -> bool override;
 
+  /// add the (key, rid) entries of new records to an index, shared with the bulk loader of COPY
+  static void InsertIndex(IndexHandle *index, const std::vector<std::pair<RecordUptr, RID>> &entries);
+
 private:
   TableHandle             *tbl_;
   std::list<IndexHandle *> indexes_;
   std::vector<RecordUptr>  inserts_;
+  ZoneMapSptr              zone_map_;  // widened by the inserted records
   bool                     is_end_;
 };
 }  // namespace wsdb
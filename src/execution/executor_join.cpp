@@ -71,4 +71,19 @@ auto JoinExecutor::IsEnd() const -> bool
   }
 }
 
+auto JoinExecutor::MakeJoinRecord(const Record &left, const Record *right) const -> RecordUptr
+{
+  const auto            *right_schema = right_->GetOutSchema();
+  std::vector<ValueSptr> values;
+  values.reserve(out_schema_->GetFieldCount());
+  for (size_t i = 0; i < left.GetSchema()->GetFieldCount(); i++) {
+    values.push_back(left.GetValueAt(i));
+  }
+  for (size_t i = 0; i < right_schema->GetFieldCount(); i++) {
+    values.push_back(right != nullptr ? right->GetValueAt(i)
+                                      : ValueFactory::CreateNullValue(right_schema->GetFieldAt(i).field_.field_type_));
+  }
+  return std::make_unique<Record>(out_schema_.get(), values, INVALID_RID);
+}
+
 }  // namespace wsdb
\ No newline at end of file
@@ -56,6 +56,9 @@ protected:
 
   [[nodiscard]] virtual auto IsEndOuterJoin() const -> bool = 0;
 
+  /// concatenate the left and right records, a null right record gives nulls for the right fields
+  [[nodiscard]] auto MakeJoinRecord(const Record &left, const Record *right) const -> RecordUptr;
+
 protected:
   JoinType             join_type_;
   AbstractExecutorUptr left_;
@@ -0,0 +1,114 @@
+/*------------------------------------------------------------------------------
+ - Copyright (c) 2024. Websoft research group, Nanjing University.
+ -
+ - This program is free software: you can redistribute it and/or modify
+ - it under the terms of the GNU General Public License as published by
+ - the Free Software Foundation, either version 3 of the License, or
+ - (at your option) any later version.
+ -
+ - This program is distributed in the hope that it will be useful,
+ - but WITHOUT ANY WARRANTY; without even the implied warranty of
+ - MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ - GNU General Public License for more details.
+ -
+ - You should have received a copy of the GNU General Public License
+ - along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ -----------------------------------------------------------------------------*/
+
+#include "executor_join_hash.h"
+
+namespace wsdb {
+HashJoinExecutor::HashJoinExecutor(JoinType join_type, AbstractExecutorUptr left, AbstractExecutorUptr right,
+    RecordSchemaUptr left_key_schema, RecordSchemaUptr right_key_schema, RuntimeFilterSptr runtime_filter)
+    // the conditions have been converted to key schemas
+    : JoinExecutor(join_type, std::move(left), std::move(right), {}),
+      left_key_schema_(std::move(left_key_schema)),
+      right_key_schema_(std::move(right_key_schema)),
+      left_key_encoder_(left_key_schema_.get(), left_->GetOutSchema()),
+      right_key_encoder_(right_key_schema_.get(), right_->GetOutSchema()),
+      runtime_filter_(std::move(runtime_filter))
+{
+  SortKeyEncoder::AlignWith(left_key_encoder_, right_key_encoder_);
+}
+
+/// inner join
+void HashJoinExecutor::InitInnerJoin()
+{
+  Build();
+  left_->Init();
+  LoadLeft();
+  Advance();
+}
+
+void HashJoinExecutor::NextInnerJoin()
+{
+  WSDB_ASSERT(!IsEndInnerJoin(), "HashJoinExecutor is end");
+  Advance();
+}
+
+auto HashJoinExecutor::IsEndInnerJoin() const -> bool { return record_ == nullptr; }
+
+/// outer join, Advance pads the left records without a match
+void HashJoinExecutor::InitOuterJoin() { InitInnerJoin(); }
+
+void HashJoinExecutor::NextOuterJoin() { NextInnerJoin(); }
+
+auto HashJoinExecutor::IsEndOuterJoin() const -> bool { return IsEndInnerJoin(); }
+
+void HashJoinExecutor::Build()
+{
+  hash_table_.clear();
+  std::vector<uint64_t> hashes;
+  for (right_->Init(); !right_->IsEnd(); right_->Next()) {
+    auto rec = right_->GetRecord();
+    if (right_key_encoder_.HasNull(*rec)) {
+      continue;
+    }
+    auto  key     = right_key_encoder_.Encode(*rec);
+    auto &records = hash_table_[key];
+    // equal keys are added to the filter once
+    if (runtime_filter_ != nullptr && records.empty()) {
+      hashes.push_back(RuntimeFilter::HashKey(key));
+    }
+    records.push_back(std::move(rec));
+  }
+  if (runtime_filter_ != nullptr) {
+    runtime_filter_->Build(hashes);
+  }
+}
+
+void HashJoinExecutor::LoadLeft()
+{
+  matches_   = nullptr;
+  match_idx_ = 0;
+  matched_   = false;
+  left_rec_  = left_->IsEnd() ? nullptr : left_->GetRecord();
+  if (left_rec_ == nullptr || left_key_encoder_.HasNull(*left_rec_)) {
+    return;
+  }
+  auto it = hash_table_.find(left_key_encoder_.Encode(*left_rec_));
+  if (it != hash_table_.end()) {
+    matches_ = &it->second;
+  }
+}
+
+void HashJoinExecutor::Advance()
+{
+  while (left_rec_ != nullptr) {
+    if (matches_ != nullptr && match_idx_ < matches_->size()) {
+      matched_ = true;
+      record_  = MakeJoinRecord(*left_rec_, (*matches_)[match_idx_++].get());
+      return;
+    }
+    if (join_type_ == OUTER_JOIN && !matched_) {
+      matched_ = true;
+      record_  = MakeJoinRecord(*left_rec_, nullptr);
+      return;
+    }
+    left_->Next();
+    LoadLeft();
+  }
+  record_ = nullptr;
+}
+
+}  // namespace wsdb
@@ -0,0 +1,81 @@
+/*------------------------------------------------------------------------------
+ - Copyright (c) 2024. Websoft research group, Nanjing University.
+ -
+ - This program is free software: you can redistribute it and/or modify
+ - it under the terms of the GNU General Public License as published by
+ - the Free Software Foundation, either version 3 of the License, or
+ - (at your option) any later version.
+ -
+ - This program is distributed in the hope that it will be useful,
+ - but WITHOUT ANY WARRANTY; without even the implied warranty of
+ - MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ - GNU General Public License for more details.
+ -
+ - You should have received a copy of the GNU General Public License
+ - along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ -----------------------------------------------------------------------------*/
+
+/**
+ * @brief Join by building a hash table on the join keys of the right (build) table and probing it with every record
+ * of the left (probe) table. Keys of both sides are encoded by aligned sort key encoders, so equal int and float
+ * values have the same key. For outer join, the left table is preserved.
+ * If a runtime filter is given, it is filled with the build keys before the left side is initialized, so a scan
+ * below the left side can drop the records that find no match
+ *
+ */
+
+#ifndef WSDB_EXECUTOR_JOIN_HASH_H
+#define WSDB_EXECUTOR_JOIN_HASH_H
+
+#include <unordered_map>
+#include "executor_join.h"
+#include "expr/runtime_filter.h"
+#include "expr/sort_key.h"
+
+namespace wsdb {
+class HashJoinExecutor : public JoinExecutor
+{
+public:
+  HashJoinExecutor(JoinType join_type, AbstractExecutorUptr left, AbstractExecutorUptr right,
+      RecordSchemaUptr left_key_schema, RecordSchemaUptr right_key_schema, RuntimeFilterSptr runtime_filter = nullptr);
+
+private:
+  void InitInnerJoin() override;
+
+  void NextInnerJoin() override;
+
+  [[nodiscard]] auto IsEndInnerJoin() const -> bool override;
+
+  void InitOuterJoin() override;
+
+  void NextOuterJoin() override;
+
+  [[nodiscard]] auto IsEndOuterJoin() const -> bool override;
+
+  /// read the right side into the hash table, and fill the runtime filter with its keys
+  void Build();
+
+  /// take the current left record and look up its matches
+  void LoadLeft();
+
+  /// move to the next joined record, it is stored in record_
+  void Advance();
+
+private:
+  RecordSchemaUptr  left_key_schema_;
+  RecordSchemaUptr  right_key_schema_;
+  SortKeyEncoder    left_key_encoder_;
+  SortKeyEncoder    right_key_encoder_;
+  RuntimeFilterSptr runtime_filter_;
+
+  // right records by their encoded join keys, records with null keys match nothing and are not kept
+  std::unordered_map<std::string, std::vector<RecordUptr>> hash_table_;
+
+  RecordUptr                     left_rec_;
+  const std::vector<RecordUptr> *matches_{nullptr};  // right records matching left_rec_
+  size_t                         match_idx_{0};
+  bool                           matched_{false};  // left_rec_ has been joined
+};
+}  // namespace wsdb
+
+#endif  // WSDB_EXECUTOR_JOIN_HASH_H
@@ -0,0 +1,142 @@
+/*------------------------------------------------------------------------------
+ - Copyright (c) 2024. Websoft research group, Nanjing University.
+ -
+ - This program is free software: you can redistribute it and/or modify
+ - it under the terms of the GNU General Public License as published by
+ - the Free Software Foundation, either version 3 of the License, or
+ - (at your option) any later version.
+ -
+ - This program is distributed in the hope that it will be useful,
+ - but WITHOUT ANY WARRANTY; without even the implied warranty of
+ - MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ - GNU General Public License for more details.
+ -
+ - You should have received a copy of the GNU General Public License
+ - along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ -----------------------------------------------------------------------------*/
+
+#include "executor_join_index.h"
+#include "common/config.h"
+
+namespace wsdb {
+IndexNestedLoopJoinExecutor::IndexNestedLoopJoinExecutor(JoinType join_type, AbstractExecutorUptr left,
+    AbstractExecutorUptr right, ConditionVec conditions, TableHandle *inner_tab, IndexHandle *inner_idx,
+    std::vector<RTField> outer_key_fields, ConditionVec inner_conds)
+    : JoinExecutor(join_type, std::move(left), std::move(right), std::move(conditions)),
+      inner_tab_(inner_tab),
+      inner_idx_(inner_idx),
+      outer_key_schema_(std::make_unique<RecordSchema>(outer_key_fields)),
+      outer_key_encoder_(outer_key_schema_.get(), left_->GetOutSchema()),
+      join_predicate_(conditions_),
+      inner_predicate_(std::move(inner_conds))
+{
+  WSDB_ASSERT(!outer_key_fields.empty() && outer_key_fields.size() <= inner_idx_->GetIndex()->GetKeyFieldNum(),
+      fmt::format("invalid index join key of {} fields", outer_key_fields.size()));
+}
+
+/// inner join
+void IndexNestedLoopJoinExecutor::InitInnerJoin()
+{
+  left_->Init();
+  LoadBatch();
+  Advance();
+}
+
+void IndexNestedLoopJoinExecutor::NextInnerJoin()
+{
+  WSDB_ASSERT(!IsEndInnerJoin(), "IndexNestedLoopJoinExecutor is end");
+  Advance();
+}
+
+auto IndexNestedLoopJoinExecutor::IsEndInnerJoin() const -> bool { return batch_idx_ >= batch_.size(); }
+
+/// outer join, Advance pads the outer records without a match
+void IndexNestedLoopJoinExecutor::InitOuterJoin() { InitInnerJoin(); }
+
+void IndexNestedLoopJoinExecutor::NextOuterJoin() { NextInnerJoin(); }
+
+auto IndexNestedLoopJoinExecutor::IsEndOuterJoin() const -> bool { return IsEndInnerJoin(); }
+
+void IndexNestedLoopJoinExecutor::LoadBatch()
+{
+  batch_.clear();
+  batch_idx_ = 0;
+  for (; !left_->IsEnd() && batch_.size() < INLJ_BATCH_SIZE; left_->Next()) {
+    auto rec = left_->GetRecord();
+    auto key = outer_key_encoder_.Encode(*rec);
+    batch_.emplace_back(std::move(key), std::move(rec));
+  }
+  std::stable_sort(
+      batch_.begin(), batch_.end(), [](const auto &lhs, const auto &rhs) { return lhs.first < rhs.first; });
+  if (!batch_.empty()) {
+    Probe(0);
+  }
+}
+
+void IndexNestedLoopJoinExecutor::Probe(size_t pos)
+{
+  matched_   = false;
+  match_idx_ = 0;
+  // equal keys are next to each other in the batch, they share the records found by the first of them
+  if (pos > 0 && batch_[pos - 1].first == batch_[pos].first) {
+    return;
+  }
+  matches_.clear();
+  const auto            &outer      = *batch_[pos].second;
+  const auto            &key_schema = inner_idx_->GetKeySchema();
+  auto                   key_num    = outer_key_schema_->GetFieldCount();
+  std::vector<ValueSptr> values;
+  values.reserve(key_schema.GetFieldCount());
+  for (size_t i = 0; i < key_schema.GetFieldCount(); i++) {
+    auto type = key_schema.GetFieldAt(i).field_.field_type_;
+    if (i >= key_num) {
+      values.push_back(ValueFactory::CreateNullValue(type));
+      continue;
+    }
+    auto val = outer.GetValueAt(outer.GetSchema()->GetRTFieldIndex(outer_key_schema_->GetFieldAt(i)));
+    // null equals nothing
+    if (val->IsNull()) {
+      return;
+    }
+    values.push_back(ValueFactory::CastTo(val, type));
+  }
+  Record      probe(&key_schema, values, INVALID_RID);
+  const auto *inner_schema = right_->GetOutSchema();
+  for (auto it = inner_idx_->GetIndex()->Scan(probe, key_num, probe, key_num); !it->IsEnd(); it->Next()) {
+    auto rec = inner_tab_->GetRecord(it->GetRID());
+    if (!inner_predicate_.Eval(*rec)) {
+      continue;
+    }
+    matches_.push_back(
+        inner_schema == &inner_tab_->GetSchema() ? std::move(rec) : std::make_unique<Record>(inner_schema, *rec));
+  }
+}
+
+void IndexNestedLoopJoinExecutor::Advance()
+{
+  while (batch_idx_ < batch_.size()) {
+    const auto &outer = *batch_[batch_idx_].second;
+    // the probe key may lose precision when cast to the index key, all conditions are checked on the joined record
+    while (match_idx_ < matches_.size()) {
+      auto rec = MakeJoinRecord(outer, matches_[match_idx_++].get());
+      if (join_predicate_.Eval(*rec)) {
+        matched_ = true;
+        record_  = std::move(rec);
+        return;
+      }
+    }
+    if (join_type_ == OUTER_JOIN && !matched_) {
+      matched_ = true;
+      record_  = MakeJoinRecord(outer, nullptr);
+      return;
+    }
+    if (++batch_idx_ < batch_.size()) {
+      Probe(batch_idx_);
+    } else {
+      LoadBatch();
+    }
+  }
+  record_ = nullptr;
+}
+
+}  // namespace wsdb
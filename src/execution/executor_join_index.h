@@ -0,0 +1,86 @@
+/*------------------------------------------------------------------------------
+ - Copyright (c) 2024. Websoft research group, Nanjing University.
+ -
+ - This program is free software: you can redistribute it and/or modify
+ - it under the terms of the GNU General Public License as published by
+ - the Free Software Foundation, either version 3 of the License, or
+ - (at your option) any later version.
+ -
+ - This program is distributed in the hope that it will be useful,
+ - but WITHOUT ANY WARRANTY; without even the implied warranty of
+ - MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ - GNU General Public License for more details.
+ -
+ - You should have received a copy of the GNU General Public License
+ - along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ -----------------------------------------------------------------------------*/
+
+/**
+ * @brief Join by probing an index of the inner (right) table for every record of the outer (left) table. The outer
+ * records are read in batches and sorted by their join key, so equal keys are probed once and the probes visit the
+ * index in key order. For outer join, the left table is the outer table
+ *
+ */
+
+#ifndef WSDB_EXECUTOR_JOIN_INDEX_H
+#define WSDB_EXECUTOR_JOIN_INDEX_H
+
+#include "executor_join.h"
+#include "expr/compiled_predicate.h"
+#include "expr/sort_key.h"
+#include "system/handle/index_handle.h"
+#include "system/handle/table_handle.h"
+
+namespace wsdb {
+class IndexNestedLoopJoinExecutor : public JoinExecutor
+{
+public:
+  /**
+   * @param right scan of the inner table, only its output schema is used
+   * @param conditions all join conditions, checked again on the joined records
+   * @param outer_key_fields outer fields whose values probe the first fields of the inner index key
+   * @param inner_conds predicates on the inner table alone
+   */
+  IndexNestedLoopJoinExecutor(JoinType join_type, AbstractExecutorUptr left, AbstractExecutorUptr right,
+      ConditionVec conditions, TableHandle *inner_tab, IndexHandle *inner_idx, std::vector<RTField> outer_key_fields,
+      ConditionVec inner_conds);
+
+private:
+  void InitInnerJoin() override;
+
+  void NextInnerJoin() override;
+
+  [[nodiscard]] auto IsEndInnerJoin() const -> bool override;
+
+  void InitOuterJoin() override;
+
+  void NextOuterJoin() override;
+
+  [[nodiscard]] auto IsEndOuterJoin() const -> bool override;
+
+  /// read and sort the next batch of outer records, and probe the index for the first of them
+  void LoadBatch();
+
+  /// find the inner records matching the key of the outer record at pos of the batch
+  void Probe(size_t pos);
+
+  /// move to the next joined record, it is stored in record_
+  void Advance();
+
+private:
+  TableHandle      *inner_tab_;
+  IndexHandle      *inner_idx_;
+  RecordSchemaUptr  outer_key_schema_;
+  SortKeyEncoder    outer_key_encoder_;
+  CompiledPredicate join_predicate_;
+  CompiledPredicate inner_predicate_;
+
+  std::vector<std::pair<std::string, RecordUptr>> batch_;  // encoded join key and outer record, sorted by the key
+  size_t                                          batch_idx_{0};
+  std::vector<RecordUptr>                         matches_;  // inner records of the current outer record
+  size_t                                          match_idx_{0};
+  bool                                            matched_{false};  // the current outer record has been joined
+};
+}  // namespace wsdb
+
+#endif  // WSDB_EXECUTOR_JOIN_INDEX_H
@@ -27,14 +27,18 @@ SortMergeJoinExecutor::SortMergeJoinExecutor(JoinType join_type, AbstractExecuto
     // condition vec is not used in sort merge join, it has been converted to key schemas
     : JoinExecutor(join_type, std::move(left), std::move(right), {}),
       left_key_schema_(std::move(left_key_schema)),
-      right_key_schema_(std::move(right_key_schema))
-{}
+      right_key_schema_(std::move(right_key_schema)),
+      left_key_encoder_(left_key_schema_.get(), left_->GetOutSchema()),
+      right_key_encoder_(right_key_schema_.get(), right_->GetOutSchema())
+{
+  SortKeyEncoder::AlignWith(left_key_encoder_, right_key_encoder_);
+}
 
 auto SortMergeJoinExecutor::Compare(const wsdb::Record &left, const wsdb::Record &right) const -> int
 {
-  auto left_key  = std::make_unique<Record>(left_key_schema_.get(), left);
-  auto right_key = std::make_unique<Record>(right_key_schema_.get(), right);
-  return Record::Compare(*left_key, *right_key);
+  auto left_key  = left_key_encoder_.Encode(left);
+  auto right_key = right_key_encoder_.Encode(right);
+  return SortKeyEncoder::Compare(left_key.data(), right_key.data(), left_key.size());
 }
 
 void SortMergeJoinExecutor::InitInnerJoin() { WSDB_STUDENT_TODO(l3, f1); }
@@ -28,6 +28,7 @@
 #define WSDB_EXECUTOR_JOIN_SORTMERGE_H
 
 #include "executor_join.h"
+#include "expr/sort_key.h"
 
 namespace wsdb {
 class SortMergeJoinExecutor : public JoinExecutor
@@ -54,6 +55,9 @@ private:
 private:
   RecordSchemaUptr left_key_schema_;
   RecordSchemaUptr right_key_schema_;
+  // encoders of the join keys, aligned so that the keys of both sides compare with memcmp
+  SortKeyEncoder left_key_encoder_;
+  SortKeyEncoder right_key_encoder_;
 
   // temporarily store record from the left executor
   RecordUptr left_rec_;
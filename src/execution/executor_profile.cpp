@@ -0,0 +1,92 @@
+/*------------------------------------------------------------------------------
+ - Copyright (c) 2024. Websoft research group, Nanjing University.
+ -
+ - This program is free software: you can redistribute it and/or modify
+ - it under the terms of the GNU General Public License as published by
+ - the Free Software Foundation, either version 3 of the License, or
+ - (at your option) any later version.
+ -
+ - This program is distributed in the hope that it will be useful,
+ - but WITHOUT ANY WARRANTY; without even the implied warranty of
+ - MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ - GNU General Public License for more details.
+ -
+ - You should have received a copy of the GNU General Public License
+ - along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ -----------------------------------------------------------------------------*/
+
+#include "executor_profile.h"
+#include <chrono>
+
+namespace wsdb {
+
+namespace {
+/// the statistics of the profiled executor whose call is running on this thread
+thread_local ExecStats *running_stats = nullptr;
+
+/// measure one call of an executor, the parent is restored even if the call throws
+class ProfileScope
+{
+public:
+  explicit ProfileScope(ExecStats *stats)
+      : stats_(stats), parent_(running_stats), start_(std::chrono::steady_clock::now()), io_(IoStats::Local())
+  {
+    running_stats = stats_;
+  }
+
+  ~ProfileScope()
+  {
+    auto elapsed = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start_).count();
+    auto io      = IoStats::Local() - io_;
+    stats_->time_ms_ += elapsed;
+    stats_->io_ += io;
+    if (parent_ != nullptr) {
+      parent_->child_time_ms_ += elapsed;
+      parent_->child_io_ += io;
+    }
+    running_stats = parent_;
+  }
+
+  DISABLE_COPY_MOVE_AND_ASSIGN(ProfileScope)
+
+private:
+  ExecStats                            *stats_;
+  ExecStats                            *parent_;
+  std::chrono::steady_clock::time_point start_;
+  IoStats                               io_;
+};
+}  // namespace
+
+ProfileExecutor::ProfileExecutor(AbstractExecutorUptr child)
+    : AbstractExecutor(child->GetType()), child_(std::move(child)), stats_(std::make_shared<ExecStats>())
+{}
+
+void ProfileExecutor::Init()
+{
+  ProfileScope scope(stats_.get());
+  stats_->loops_++;
+  child_->Init();
+  LoadRecord();
+}
+
+void ProfileExecutor::Next()
+{
+  ProfileScope scope(stats_.get());
+  child_->Next();
+  LoadRecord();
+}
+
+auto ProfileExecutor::IsEnd() const -> bool { return child_->IsEnd(); }
+
+auto ProfileExecutor::GetOutSchema() const -> const RecordSchema * { return child_->GetOutSchema(); }
+
+void ProfileExecutor::LoadRecord()
+{
+  record_ = child_->GetRecord();
+  // a record is produced while the executor is not end, except for a dml executor that ends with its summary
+  if (record_ != nullptr && (!child_->IsEnd() || GetType() == DML)) {
+    stats_->rows_++;
+  }
+}
+
+}  // namespace wsdb
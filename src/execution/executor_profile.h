@@ -0,0 +1,77 @@
+/*------------------------------------------------------------------------------
+ - Copyright (c) 2024. Websoft research group, Nanjing University.
+ -
+ - This program is free software: you can redistribute it and/or modify
+ - it under the terms of the GNU General Public License as published by
+ - the Free Software Foundation, either version 3 of the License, or
+ - (at your option) any later version.
+ -
+ - This program is distributed in the hope that it will be useful,
+ - but WITHOUT ANY WARRANTY; without even the implied warranty of
+ - MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ - GNU General Public License for more details.
+ -
+ - You should have received a copy of the GNU General Public License
+ - along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ -----------------------------------------------------------------------------*/
+
+/**
+ * @brief Measure an executor for EXPLAIN ANALYZE. It forwards every call to the wrapped executor and records the
+ * produced records, the calls of Init, the wall time and the page accesses of the calls. Times and page accesses
+ * include the children, the part spent in profiled children is recorded separately so that the operator's own share
+ * is the difference. Only the calling thread is measured, the workers of a parallel pipeline are not
+ *
+ */
+
+#ifndef WSDB_EXECUTOR_PROFILE_H
+#define WSDB_EXECUTOR_PROFILE_H
+
+#include <unordered_map>
+#include "common/io_stats.h"
+#include "executor_abstract.h"
+
+namespace wsdb {
+
+class AbstractPlan;
+
+struct ExecStats
+{
+  size_t  rows_{0};           // records produced
+  size_t  loops_{0};          // calls of Init, e.g. the inner side of a nested loop join is started for every record
+  double  time_ms_{0};        // wall time of all calls
+  double  child_time_ms_{0};  // part of time_ms_ spent in the profiled children
+  IoStats io_;                // page accesses of all calls
+  IoStats child_io_;          // part of io_ made by the profiled children
+};
+
+DEFINE_SHARED_PTR(ExecStats);
+
+/// the statistics of every executor of a profiled plan, by the plan node it is translated from
+using ExecProfiles = std::unordered_map<const AbstractPlan *, ExecStatsSptr>;
+
+class ProfileExecutor : public AbstractExecutor
+{
+public:
+  explicit ProfileExecutor(AbstractExecutorUptr child);
+
+  void Init() override;
+
+  void Next() override;
+
+  [[nodiscard]] auto IsEnd() const -> bool override;
+
+  [[nodiscard]] auto GetOutSchema() const -> const RecordSchema * override;
+
+  [[nodiscard]] auto GetStats() const -> const ExecStatsSptr & { return stats_; }
+
+private:
+  /// take the record of the child after a call, and count it
+  void LoadRecord();
+
+private:
+  AbstractExecutorUptr child_;
+  ExecStatsSptr        stats_;
+};
+}  // namespace wsdb
+
+#endif  // WSDB_EXECUTOR_PROFILE_H
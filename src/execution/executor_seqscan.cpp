@@ -20,65 +20,230 @@
  //
 
 #include "executor_seqscan.h"
+#include <algorithm>
+#include <numeric>
 
 namespace wsdb {
 
-  SeqScanExecutor::SeqScanExecutor(TableHandle* tab) : AbstractExecutor(Basic), tab_(tab) {}
+  SeqScanExecutor::SeqScanExecutor(TableHandle* tab) : SeqScanExecutor(tab, {}, {}, nullptr) {}
 
-  void SeqScanExecutor::Init()
+  SeqScanExecutor::SeqScanExecutor(TableHandle* tab, ConditionVec conds, const std::vector<RTField>& proj_fields,
+    MorselQueueSptr morsels, ZoneMapSptr zone_map, std::vector<RuntimeFilterSptr> runtime_filters)
+    : AbstractExecutor(Basic),
+    tab_(tab),
+    conds_(std::move(conds)),
+    predicate_(conds_),
+    morsels_(std::move(morsels)),
+    zone_map_(std::move(zone_map)),
+    runtime_filters_(std::move(runtime_filters))
   {
-    rid_ = tab_->GetFirstRID();
-
-    //WSDB_STUDENT_TODO(l2, t1);
-    //TODO:
-    // 初始化 record_ 为第一个有效记录
-    if (rid_ != INVALID_RID) {
-      auto record = tab_->GetRecord(rid_);
-      if (record) {
-        record_ = std::make_unique<Record>(*record);
+    by_page_ = !conds_.empty() || !runtime_filters_.empty();
+    // without predicates there is nothing to skip
+    if (conds_.empty()) {
+      zone_map_ = nullptr;
+    }
+    if (proj_fields.empty()) {
+      return;
+    }
+    out_schema_ = std::make_unique<RecordSchema>(proj_fields);
+    if (tab_->GetStorageModel() == PAX_MODEL) {
+      // the chunk holds the fields referenced by the projection or the predicates, in the order of the table
+      std::vector<RTField> chunk_fields;
+      for (const auto& field : tab_->GetSchema().GetFields()) {
+        bool referenced = out_schema_->GetRTFieldIndex(field) != out_schema_->GetFieldCount();
+        for (const auto& cond : conds_) {
+          referenced = referenced || cond.GetLCol() == field || (cond.GetRhsType() == kColumn && cond.GetRCol() == field);
+        }
+        for (const auto& filter : runtime_filters_) {
+          const auto& keys = filter->GetProbeFields();
+          referenced       = referenced || std::find(keys.begin(), keys.end(), field) != keys.end();
+        }
+        if (referenced) {
+          chunk_fields.push_back(field);
+        }
       }
-      else {
-        record_.reset();
+      use_chunk_    = true;
+      by_page_      = true;
+      chunk_schema_ = std::make_unique<RecordSchema>(chunk_fields);
+    }
+  }
+
+  void SeqScanExecutor::Init()
+  {
+    page_records_.clear();
+    pruned_pages_     = 0;
+    filtered_records_ = 0;
+    filter_encoders_.clear();
+    for (const auto& filter : runtime_filters_) {
+      filter_encoders_.push_back(filter->MakeProbeEncoder(use_chunk_ ? chunk_schema_.get() : &tab_->GetSchema()));
+    }
+    if (morsels_ != nullptr) {
+      morsel_end_ = INVALID_PAGE_ID;
+      rid_        = SkipToMorsel(INVALID_RID);
+    }
+    else {
+      rid_ = tab_->GetFirstRID();
+    }
+    if (by_page_) {
+      LoadPage();
+    }
+    else {
+      LoadRecord();
+    }
+  }
+
+  void SeqScanExecutor::Next()
+  {
+    WSDB_ASSERT(!IsEnd(), "SeqScanExecutor is end");
+    if (by_page_) {
+      if (!page_records_.empty()) {
+        record_ = std::move(page_records_.front());
+        page_records_.pop_front();
+        return;
       }
+      rid_ = NextPageRID(rid_);
+      LoadPage();
     }
     else {
-      record_.reset(); // 如果没有记录，初始化为空
+      rid_ = NextRID(rid_);
+      LoadRecord();
     }
   }
 
-  void SeqScanExecutor::Next() {
-    //WSDB_STUDENT_TODO(l2, t1);
-    //TODO:
-    // 检查当前是否已经结束
-    if (rid_ == INVALID_RID) {
-      record_.reset();
-      return;
+  auto SeqScanExecutor::IsEnd() const -> bool { return rid_ == INVALID_RID; }
+
+  auto SeqScanExecutor::GetOutSchema() const -> const RecordSchema*
+  {
+    return out_schema_ != nullptr ? out_schema_.get() : &tab_->GetSchema();
+  }
+
+  auto SeqScanExecutor::SkipToMorsel(RID rid) -> RID
+  {
+    while (rid == INVALID_RID || rid.PageID() >= morsel_end_) {
+      page_id_t begin;
+      if (!morsels_->Next(begin, morsel_end_)) {
+        morsel_end_ = INVALID_PAGE_ID;
+        return INVALID_RID;
+      }
+      // RID(begin, INVALID_SLOT_ID) is the position right before the first slot of page begin
+      rid = tab_->GetNextRID(RID(begin, INVALID_SLOT_ID));
+    }
+    return rid;
+  }
+
+  auto SeqScanExecutor::NextRID(const RID& rid) -> RID
+  {
+    auto next = tab_->GetNextRID(rid);
+    return morsels_ != nullptr ? SkipToMorsel(next) : next;
+  }
+
+  auto SeqScanExecutor::NextPageRID(const RID& rid) -> RID
+  {
+    if (zone_map_ == nullptr) {
+      auto last_slot = static_cast<slot_id_t>(tab_->GetTableHeader().rec_per_page_) - 1;
+      return NextRID(RID(rid.PageID(), last_slot));
+    }
+    // the skipped pages are not fetched at all, the page after them is the first one to be read
+    auto end = static_cast<page_id_t>(tab_->GetTableHeader().page_num_);
+    if (morsels_ != nullptr) {
+      end = std::min(end, morsel_end_);
+    }
+    auto page_id = rid.PageID() + 1;
+    for (; page_id < end && zone_map_->CanSkip(page_id, conds_); page_id++) {
+      pruned_pages_++;
     }
-    // 获取下一个记录的 RID
-    RID next_rid = tab_->GetNextRID(rid_);
-    // 如果没有下一个记录，设置为结束状态
-    if (next_rid == INVALID_RID) {
-      rid_ = INVALID_RID;
+    if (page_id >= end) {
+      return morsels_ != nullptr ? SkipToMorsel(INVALID_RID) : INVALID_RID;
+    }
+    return NextRID(RID(page_id, INVALID_SLOT_ID));
+  }
+
+  void SeqScanExecutor::LoadRecord()
+  {
+    if (rid_ == INVALID_RID) {
       record_.reset();
       return;
     }
-    // 更新当前 RID
-    rid_ = next_rid;
-    // 获取当前记录
     auto record = tab_->GetRecord(rid_);
-    if (record) {
-      record_ = std::make_unique<Record>(*record);
-    }
-    else {
-      record_.reset();
+    record_     = out_schema_ != nullptr ? std::make_unique<Record>(out_schema_.get(), *record) : std::move(record);
+  }
+
+  void SeqScanExecutor::LoadPage()
+  {
+    std::vector<RecordUptr> batch;
+    for (; rid_ != INVALID_RID; rid_ = NextPageRID(rid_)) {
+      auto page_id = rid_.PageID();
+      if (zone_map_ != nullptr && zone_map_->CanSkip(page_id, conds_)) {
+        pruned_pages_++;
+        continue;
+      }
+      auto version = zone_map_ != nullptr ? zone_map_->GetVersion() : 0;
+      batch.clear();
+      if (use_chunk_) {
+        ReadChunk(batch);
+      }
+      else {
+        ReadPage(batch);
+      }
+      // the whole page has been read, its zone is exact
+      if (zone_map_ != nullptr && !zone_map_->HasZone(page_id, use_chunk_ ? chunk_schema_.get() : &tab_->GetSchema())) {
+        zone_map_->BuildZone(page_id, batch, version);
+      }
+      if (conds_.empty()) {
+        sel_.resize(batch.size());
+        std::iota(sel_.begin(), sel_.end(), 0);
+      }
+      else {
+        predicate_.Filter(batch, sel_);
+      }
+      if (!runtime_filters_.empty()) {
+        FilterByRuntimeFilters(batch);
+      }
+      for (auto idx : sel_) {
+        page_records_.push_back(
+          out_schema_ != nullptr ? std::make_unique<Record>(out_schema_.get(), *batch[idx]) : std::move(batch[idx]));
+      }
+      if (!page_records_.empty()) {
+        record_ = std::move(page_records_.front());
+        page_records_.pop_front();
+        return;
+      }
     }
+    record_.reset();
   }
 
-  auto SeqScanExecutor::IsEnd() const -> bool {
-    //WSDB_STUDENT_TODO(l2, t1);
-    //TODO:
-    return rid_ == INVALID_RID;
+  void SeqScanExecutor::FilterByRuntimeFilters(const std::vector<RecordUptr>& batch)
+  {
+    auto end = std::remove_if(sel_.begin(), sel_.end(), [this, &batch](size_t idx) {
+      for (size_t i = 0; i < runtime_filters_.size(); i++) {
+        if (!runtime_filters_[i]->MayContain(filter_encoders_[i], *batch[idx])) {
+          return true;
+        }
+      }
+      return false;
+    });
+    filtered_records_ += sel_.end() - end;
+    sel_.erase(end, sel_.end());
   }
 
-  auto SeqScanExecutor::GetOutSchema() const -> const RecordSchema* { return &tab_->GetSchema(); }
-}  // namespace wsdb
\ No newline at end of file
+  void SeqScanExecutor::ReadPage(std::vector<RecordUptr>& batch)
+  {
+    // rid_ stays on the page, the next page is found from it by NextPageRID
+    for (auto rid = rid_; rid != INVALID_RID && rid.PageID() == rid_.PageID(); rid = tab_->GetNextRID(rid)) {
+      batch.push_back(tab_->GetRecord(rid));
+    }
+  }
+
+  void SeqScanExecutor::ReadChunk(std::vector<RecordUptr>& batch)
+  {
+    auto chunk = tab_->GetChunk(rid_.PageID(), chunk_schema_.get());
+    auto rows  = chunk->GetColCount() == 0 ? 0 : chunk->GetCol(0)->GetValueNum();
+    std::vector<ValueSptr> values(chunk->GetColCount());
+    for (size_t row = 0; row < rows; row++) {
+      for (size_t col = 0; col < values.size(); col++) {
+        values[col] = chunk->GetCol(col)->Get()[row];
+      }
+      batch.push_back(std::make_unique<Record>(chunk_schema_.get(), values, INVALID_RID));
+    }
+  }
+}  // namespace wsdb
@@ -20,21 +20,87 @@
 //
 
 /**
- * @brief Iterate over all records in the table, check TableHandle for more details
- * 
+ * @brief Iterate over all records in the table, check TableHandle for more details.
+ * Predicates pushed down into the scan are compiled and checked on a whole page of records before the output records
+ * are built, and only the projected fields are kept. PAX tables are read through chunks of the referenced columns only.
+ * In a parallel pipeline, the executor only scans the page ranges (morsels) it takes from a MorselQueue shared with
+ * the other workers of the same scan. Runtime filters built by joins above the scan drop the records that cannot be
+ * joined together with the predicates
+ *
  */
 
 #ifndef WSDB_EXECUTOR_SEQSCAN_H
 #define WSDB_EXECUTOR_SEQSCAN_H
+#include <atomic>
+#include <limits>
+#include "common/config.h"
+#include "common/page.h"
+#include <deque>
+#include "common/condition.h"
+#include "expr/compiled_predicate.h"
+#include "expr/runtime_filter.h"
+#include "expr/zone_map.h"
 #include "executor_abstract.h"
 #include "system/handle/table_handle.h"
 
 namespace wsdb {
+
+/**
+ * hands out ranges of MORSEL_PAGE_NUM data pages of a table to the workers of a parallel scan, the last morsel is
+ * open ended so pages appended during the scan are not missed
+ */
+class MorselQueue
+{
+public:
+  explicit MorselQueue(TableHandle *tab) : tab_(tab) { Reset(); }
+
+  DISABLE_COPY_MOVE_AND_ASSIGN(MorselQueue)
+
+  /// start handing out morsels from the first data page again
+  void Reset()
+  {
+    page_num_ = static_cast<page_id_t>(tab_->GetTableHeader().page_num_);
+    next_.store(FILE_HEADER_PAGE_ID + 1);
+  }
+
+  /// take the next morsel [begin, end), return false if all pages have been handed out
+  auto Next(page_id_t &begin, page_id_t &end) -> bool
+  {
+    begin = next_.fetch_add(static_cast<page_id_t>(MORSEL_PAGE_NUM));
+    if (begin >= page_num_) {
+      return false;
+    }
+    end = begin + static_cast<page_id_t>(MORSEL_PAGE_NUM);
+    if (end >= page_num_) {
+      end = std::numeric_limits<page_id_t>::max();
+    }
+    return true;
+  }
+
+private:
+  TableHandle           *tab_;
+  page_id_t              page_num_{0};
+  std::atomic<page_id_t> next_{0};
+};
+
+DEFINE_SHARED_PTR(MorselQueue);
+
 class SeqScanExecutor : public AbstractExecutor
 {
 public:
   explicit SeqScanExecutor(TableHandle *tab);
 
+  /**
+   * @param conds predicates on the fields of the table, records not satisfying them are skipped
+   * @param proj_fields fields of the output records, empty means all fields. Output records of a projected scan do not
+   * carry valid RIDs, so DML should not project
+   * @param morsels if not nullptr, only scan the morsels taken from it, used by the workers of a parallel scan
+   * @param zone_map if not nullptr, pages whose zones rule out conds are skipped, and the pages read build zones
+   * @param runtime_filters filters on fields of the table, records whose keys miss any of them are skipped
+   */
+  SeqScanExecutor(TableHandle *tab, ConditionVec conds, const std::vector<RTField> &proj_fields,
+      MorselQueueSptr morsels, ZoneMapSptr zone_map = nullptr, std::vector<RuntimeFilterSptr> runtime_filters = {});
+
   void Init() override;
 
   void Next() override;
@@ -43,9 +109,63 @@ public:
 
   [[nodiscard]] auto GetOutSchema() const -> const RecordSchema * override;
 
+  /// number of pages skipped by the zone map so far
+  [[nodiscard]] auto GetPrunedPages() const -> size_t { return pruned_pages_; }
+
+  /// number of records satisfying the predicates but dropped by the runtime filters so far
+  [[nodiscard]] auto GetFilteredRecords() const -> size_t { return filtered_records_; }
+
+private:
+  /// the first record at or after rid that belongs to a morsel of this worker, taking new morsels as needed
+  auto SkipToMorsel(RID rid) -> RID;
+
+  /// the record after rid
+  auto NextRID(const RID &rid) -> RID;
+
+  /// the first record on a page after the page of rid, passing over the pages skipped by the zone map
+  auto NextPageRID(const RID &rid) -> RID;
+
+  /// load the record at rid_ into record_, used when there are no predicates and the table is read record by record
+  void LoadRecord();
+
+  /**
+   * starting from the page of rid_, read pages until one has records satisfying the predicates, the predicates are
+   * evaluated on the whole page at once
+   */
+  void LoadPage();
+
+  /// keep in sel_ the records of batch whose keys hit all runtime filters
+  void FilterByRuntimeFilters(const std::vector<RecordUptr> &batch);
+
+  /// read all records on the page of rid_
+  void ReadPage(std::vector<RecordUptr> &batch);
+
+  /// read the page of rid_ as a chunk of the referenced fields
+  void ReadChunk(std::vector<RecordUptr> &batch);
+
 private:
-  TableHandle *tab_;
-  RID          rid_;
+  TableHandle      *tab_;
+  RID               rid_;
+  ConditionVec      conds_;
+  CompiledPredicate predicate_;
+
+  // the table is read page by page when there are predicates, or it is a PAX table with a projection, in which case
+  // chunk_schema_ holds the projected and predicate fields
+  bool                   by_page_{false};
+  bool                   use_chunk_{false};
+  RecordSchemaUptr       chunk_schema_;
+  std::vector<size_t>    sel_;
+  std::deque<RecordUptr> page_records_;
+
+  MorselQueueSptr morsels_;
+  page_id_t       morsel_end_{INVALID_PAGE_ID};
+
+  ZoneMapSptr zone_map_;
+  size_t      pruned_pages_{0};
+
+  std::vector<RuntimeFilterSptr> runtime_filters_;
+  std::vector<SortKeyEncoder>    filter_encoders_;  // probe keys of the runtime filters from the records read
+  size_t                         filtered_records_{0};
 };
 }  // namespace wsdb
 
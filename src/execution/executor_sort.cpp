@@ -20,6 +20,8 @@
  //
 #include <unistd.h>
 #include "common/config.h"
+#include "common/parallel_sort.h"
+#include "system/session.h"
 #include "executor_sort.h"
 
 static long long sort_result_fresh_id_ = 0;
@@ -30,6 +32,7 @@ namespace wsdb {
     : AbstractExecutor(Basic),
     child_(std::move(child)),
     key_schema_(std::move(key_schema)),
+    key_encoder_(key_schema_.get(), child_->GetOutSchema(), is_desc),
     buf_idx_(0),
     is_desc_(is_desc),
     is_sorted_(false),
@@ -42,13 +45,13 @@ namespace wsdb {
     //  max_rec_num_ = 10;
   }
 
-  // SortExecutor::~SortExecutor()
-  // {
-  //   // if (is_merge_sort_) {
-  //   //   // TODO: do some clean up, e.g. close the result file
-  //   //   WSDB_STUDENT_TODO(l2, f1);
-  //   // }
-  // }
+  SortExecutor::~SortExecutor()
+  {
+    // if (is_merge_sort_) {
+    //   // TODO: do some clean up, e.g. close the result file
+    //   WSDB_STUDENT_TODO(l2, f1);
+    // }
+  }
 
   void SortExecutor::Init()
   {
@@ -63,12 +66,16 @@ namespace wsdb {
     // Initialize the child executor to start reading its records
     child_->Init();
 
-    // Load all records into the buffer for in-memory sorting
+    // Load all records into the buffer for in-memory sorting, the key of each record is encoded once here
     sort_buffer_.clear();
+    key_buffer_.clear();
+    auto key_size = key_encoder_.GetKeySize();
     while (!child_->IsEnd()) {
       child_->Next();
       auto record = child_->GetRecord();
       if (record) {
+        key_buffer_.resize(key_buffer_.size() + key_size);
+        key_encoder_.Encode(*record, key_buffer_.data() + key_buffer_.size() - key_size);
         sort_buffer_.push_back(std::make_unique<Record>(*record));
       }
     }
@@ -93,7 +100,7 @@ namespace wsdb {
       return;
     }
     // Retrieve the next record from the sorted buffer
-    record_ = std::make_unique<Record>(*sort_buffer_[buf_idx_]);
+    record_ = std::make_unique<Record>(*sort_buffer_[sort_idx_[buf_idx_].idx_]);
     buf_idx_++;
   }
 
@@ -107,11 +114,19 @@ namespace wsdb {
     return buf_idx_ >= sort_buffer_.size();
   }
 
-  auto SortExecutor::Compare(const Record& lhs, const Record& rhs) const -> bool
+  auto SortExecutor::Compare(const SortEntry& lhs, const SortEntry& rhs) const -> bool
   {
-    auto lkey = std::make_unique<Record>(key_schema_.get(), lhs);
-    auto rkey = std::make_unique<Record>(key_schema_.get(), rhs);
-    return is_desc_ ? Record::Compare(*lkey, *rkey) > 0 : lkey->Compare(*lkey, *rkey) < 0;
+    // descending order is already encoded in the keys
+    if (lhs.prefix_ != rhs.prefix_) {
+      return lhs.prefix_ < rhs.prefix_;
+    }
+    auto key_size = key_encoder_.GetKeySize();
+    if (key_size <= sizeof(uint64_t)) {
+      return false;
+    }
+    return memcmp(key_buffer_.data() + lhs.idx_ * key_size + sizeof(uint64_t),
+               key_buffer_.data() + rhs.idx_ * key_size + sizeof(uint64_t),
+               key_size - sizeof(uint64_t)) < 0;
   }
 
   auto SortExecutor::GetOutSchema() const -> const RecordSchema* { return child_->GetOutSchema(); }
@@ -126,11 +141,17 @@ namespace wsdb {
   void SortExecutor::SortBuffer() {
     //WSDB_STUDENT_TODO(L2, t1);
     //TODO:
-    // Sort the record buffer using the Compare function
-    std::sort(sort_buffer_.begin(), sort_buffer_.end(),
-      [this](const std::unique_ptr<Record>& lhs, const std::unique_ptr<Record>& rhs) {
-        return Compare(*lhs, *rhs);
-      });
+    // Sort the record indexes by the normalized keys, stable to keep the input order of equal keys.
+    // large buffers are sorted by the shared worker pool
+    auto key_size = key_encoder_.GetKeySize();
+    sort_idx_.resize(sort_buffer_.size());
+    for (size_t i = 0; i < sort_idx_.size(); i++) {
+      char prefix[sizeof(uint64_t)] = {0};
+      memcpy(prefix, key_buffer_.data() + i * key_size, std::min(key_size, sizeof(uint64_t)));
+      sort_idx_[i] = {SortKeyEncoder::LoadPrefix(prefix), i};
+    }
+    ParallelSort(
+      sort_idx_, [this](const SortEntry& lhs, const SortEntry& rhs) { return Compare(lhs, rhs); }, Session::Current().GetDop());
   }
 
 
@@ -30,6 +30,7 @@
 #include <fstream>
 #include <utility>
 #include "executor_abstract.h"
+#include "expr/sort_key.h"
 
 namespace wsdb {
 
@@ -120,7 +121,15 @@ namespace wsdb {
   private:
     [[nodiscard]] inline auto GetSortFileName(size_t file_group, size_t file_idx) const->std::string;
 
-    [[nodiscard]] inline auto Compare(const Record& lhs, const Record& rhs) const -> bool;
+    /// sort entry of a record in sort_buffer_, the first 8 bytes of its key are kept inline so that most
+    /// comparisons are resolved without touching key_buffer_
+    struct SortEntry
+    {
+      uint64_t prefix_;
+      size_t   idx_;
+    };
+
+    [[nodiscard]] inline auto Compare(const SortEntry& lhs, const SortEntry& rhs) const -> bool;
 
     void SortBuffer();
 
@@ -133,7 +142,12 @@ namespace wsdb {
   private:
     AbstractExecutorUptr    child_;
     RecordSchemaUptr        key_schema_;
+    SortKeyEncoder          key_encoder_;
     std::vector<RecordUptr> sort_buffer_;
+    // normalized keys of the records in sort_buffer_, each key takes key_encoder_.GetKeySize() bytes
+    std::vector<char>       key_buffer_;
+    // sorted order of sort_buffer_
+    std::vector<SortEntry>  sort_idx_;
     size_t                  buf_idx_;
     bool                    is_desc_;
     bool                    is_sorted_;
@@ -25,12 +25,13 @@
 namespace wsdb {
 
 UpdateExecutor::UpdateExecutor(AbstractExecutorUptr child, TableHandle *tbl, std::list<IndexHandle *> indexes,
-    std::vector<std::pair<RTField, ValueSptr>> updates)
+    std::vector<std::pair<RTField, ValueSptr>> updates, ZoneMapSptr zone_map)
     : AbstractExecutor(DML),
       child_(std::move(child)),
       tbl_(tbl),
       indexes_(std::move(indexes)),
       updates_(std::move(updates)),
+      zone_map_(std::move(zone_map)),
       is_end_(false)
 {
   std::vector<RTField> fields(1);
@@ -71,6 +72,9 @@ void UpdateExecutor::Next()
       Record updated_record(tbl_->GetSchema().GetFields(), updated_values, rid);
       // Update the table
       tbl_->UpdateRecord(rid, updated_record);
+      if (zone_map_ != nullptr) {
+          zone_map_->Add(rid.PageID(), updated_record);
+      }
 
       // Update the indexes
       for (auto *index : indexes_) {
@@ -83,6 +87,10 @@ void UpdateExecutor::Next()
       // Move to the next record in the child executor
       child_->Next();
   }
+  // the indexes write what they keep in memory, e.g. their entry number, once per statement
+  for (auto *index : indexes_) {
+    index->GetIndex()->Flush();
+  }
 
   std::vector<ValueSptr> values{ValueFactory::CreateIntValue(count)};
   record_ = std::make_unique<Record>(out_schema_.get(), values, INVALID_RID);
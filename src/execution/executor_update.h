@@ -29,13 +29,14 @@
 #include "executor_abstract.h"
 #include "system/handle/table_handle.h"
 #include "system/handle/index_handle.h"
+#include "expr/zone_map.h"
 
 namespace wsdb {
 class UpdateExecutor : public AbstractExecutor
 {
 public:
   UpdateExecutor(AbstractExecutorUptr child, TableHandle *tbl, std::list<IndexHandle *> indexes,
-      std::vector<std::pair<RTField, ValueSptr>> updates);
+      std::vector<std::pair<RTField, ValueSptr>> updates, ZoneMapSptr zone_map = nullptr);
 
   void Init() override;
 
@@ -48,6 +49,7 @@ private:
   TableHandle                               *tbl_;
   std::list<IndexHandle *>                   indexes_;
   std::vector<std::pair<RTField, ValueSptr>> updates_;
+  ZoneMapSptr                                zone_map_;  // widened by the new values
   bool                                       is_end_;
 };
 }  // namespace wsdb
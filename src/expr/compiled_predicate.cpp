@@ -0,0 +1,270 @@
+/*------------------------------------------------------------------------------
+ - Copyright (c) 2024. Websoft research group, Nanjing University.
+ -
+ - This program is free software: you can redistribute it and/or modify
+ - it under the terms of the GNU General Public License as published by
+ - the Free Software Foundation, either version 3 of the License, or
+ - (at your option) any later version.
+ -
+ - This program is distributed in the hope that it will be useful,
+ - but WITHOUT ANY WARRANTY; without even the implied warranty of
+ - MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ - GNU General Public License for more details.
+ -
+ - You should have received a copy of the GNU General Public License
+ - along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ -----------------------------------------------------------------------------*/
+
+#include "compiled_predicate.h"
+#include <cstring>
+#include "condition_expr.h"
+
+namespace wsdb {
+
+namespace {
+
+template <typename T>
+inline auto Load(const char *src, size_t size) -> T
+{
+  T val;
+  memcpy(&val, src, sizeof(T));
+  return val;
+}
+
+template <>
+inline auto Load<std::string_view>(const char *src, size_t size) -> std::string_view
+{
+  // strings are padded with '\0' to the field size, the same as StringValue
+  return {src, strnlen(src, size)};
+}
+
+template <typename C>
+inline auto Constant(const auto &term) -> C
+{
+  if constexpr (std::is_same_v<C, int32_t>) {
+    return term.int_;
+  } else if constexpr (std::is_same_v<C, float>) {
+    return term.float_;
+  } else if constexpr (std::is_same_v<C, bool>) {
+    return term.bool_;
+  } else {
+    return std::string_view(term.str_);
+  }
+}
+
+template <CompOp Op, typename C>
+inline auto Compare(const C &lhs, const C &rhs) -> bool
+{
+  if constexpr (Op == OP_EQ) {
+    return lhs == rhs;
+  } else if constexpr (Op == OP_NE) {
+    return lhs != rhs;
+  } else if constexpr (Op == OP_LT) {
+    return lhs < rhs;
+  } else if constexpr (Op == OP_LE) {
+    return lhs <= rhs;
+  } else if constexpr (Op == OP_GT) {
+    return lhs > rhs;
+  } else {
+    return lhs >= rhs;
+  }
+}
+
+}  // namespace
+
+CompiledPredicate::CompiledPredicate(ConditionVec conds, const RecordSchema *schema) : conds_(std::move(conds))
+{
+  if (schema != nullptr) {
+    Compile(schema);
+  }
+}
+
+auto CompiledPredicate::Eval(const Record &record) -> bool
+{
+  if (record.GetSchema() != schema_) {
+    Compile(record.GetSchema());
+  }
+  const char *nullmap = record.GetNullMap();
+  const char *data    = record.GetData();
+  for (const auto &term : terms_) {
+    if (!term.eval_(term, nullmap, data)) {
+      return false;
+    }
+  }
+  return rest_.empty() || ConditionExpr::Eval(rest_, record);
+}
+
+auto CompiledPredicate::Filter(const std::vector<RecordUptr> &records, std::vector<size_t> &sel) -> size_t
+{
+  sel.resize(records.size());
+  for (size_t i = 0; i < records.size(); i++) {
+    sel[i] = i;
+  }
+  if (records.empty()) {
+    return 0;
+  }
+  if (records.front()->GetSchema() != schema_) {
+    Compile(records.front()->GetSchema());
+  }
+  for (const auto &term : terms_) {
+    if (sel.empty()) {
+      return 0;
+    }
+    term.filter_(term, records, sel);
+  }
+  if (!rest_.empty()) {
+    size_t n = 0;
+    for (auto i : sel) {
+      if (ConditionExpr::Eval(rest_, *records[i])) {
+        sel[n++] = i;
+      }
+    }
+    sel.resize(n);
+  }
+  return sel.size();
+}
+
+void CompiledPredicate::Compile(const RecordSchema *schema)
+{
+  WSDB_ASSERT(schema != nullptr, "schema is nullptr");
+  schema_ = schema;
+  terms_.clear();
+  rest_.clear();
+  std::vector<size_t> offsets(schema->GetFieldCount(), 0);
+  for (size_t i = 1; i < schema->GetFieldCount(); i++) {
+    offsets[i] = offsets[i - 1] + schema->GetFieldAt(i - 1).field_.field_size_;
+  }
+  for (const auto &cond : conds_) {
+    if (cond.GetRhsType() != kValue && cond.GetRhsType() != kColumn) {
+      rest_.push_back(cond);
+      continue;
+    }
+    auto l_idx = schema->GetRTFieldIndex(cond.GetLCol());
+    WSDB_ASSERT(l_idx != schema->GetFieldCount(), "Invalid field");
+    const auto &l_field = schema->GetFieldAt(l_idx).field_;
+    Term        term;
+    term.l_idx_  = l_idx;
+    term.l_off_  = offsets[l_idx];
+    term.l_size_ = l_field.field_size_;
+    bool      r_col  = cond.GetRhsType() == kColumn;
+    FieldType r_type = TYPE_NULL;
+    ValueSptr r_val;
+    if (r_col) {
+      auto r_idx = schema->GetRTFieldIndex(cond.GetRCol());
+      WSDB_ASSERT(r_idx != schema->GetFieldCount(), "Invalid field");
+      const auto &r_field = schema->GetFieldAt(r_idx).field_;
+      term.r_idx_         = r_idx;
+      term.r_off_         = offsets[r_idx];
+      term.r_size_        = r_field.field_size_;
+      r_type              = r_field.field_type_;
+    } else {
+      r_val  = cond.GetRVal();
+      r_type = r_val->IsNull() ? TYPE_NULL : r_val->GetType();
+    }
+    if (!BindTerm(term, l_field.field_type_, r_type, r_col, cond.GetOp())) {
+      // leave the condition to ConditionExpr, which also reports type mismatches as before
+      rest_.push_back(cond);
+      continue;
+    }
+    if (!r_col) {
+      auto c_type = l_field.field_type_ == r_type ? r_type : TYPE_FLOAT;
+      r_val       = ValueFactory::CastTo(r_val, c_type);
+      switch (c_type) {
+        case TYPE_INT: term.int_ = std::dynamic_pointer_cast<IntValue>(r_val)->Get(); break;
+        case TYPE_FLOAT: term.float_ = std::dynamic_pointer_cast<FloatValue>(r_val)->Get(); break;
+        case TYPE_BOOL: term.bool_ = std::dynamic_pointer_cast<BoolValue>(r_val)->Get(); break;
+        case TYPE_STRING: term.str_ = std::dynamic_pointer_cast<StringValue>(r_val)->Get(); break;
+        default: WSDB_FETAL(FieldTypeToString(c_type));
+      }
+    }
+    terms_.push_back(std::move(term));
+  }
+}
+
+auto CompiledPredicate::BindTerm(Term &term, FieldType l_type, FieldType r_type, bool r_col, CompOp op) -> bool
+{
+  if (op == OP_IN || op == OP_RNG) {
+    return false;
+  }
+  // the constant is cast to the type of comparison beforehand
+#define BIND(L, R, C)                 \
+  if (r_col) {                        \
+    BindOp<L, R, C, true>(term, op);  \
+  } else {                            \
+    BindOp<L, C, C, false>(term, op); \
+  }                                   \
+  return true
+  if (l_type == TYPE_INT && r_type == TYPE_INT) {
+    BIND(int32_t, int32_t, int32_t);
+  } else if (l_type == TYPE_INT && r_type == TYPE_FLOAT) {
+    BIND(int32_t, float, float);
+  } else if (l_type == TYPE_FLOAT && r_type == TYPE_INT) {
+    BIND(float, int32_t, float);
+  } else if (l_type == TYPE_FLOAT && r_type == TYPE_FLOAT) {
+    BIND(float, float, float);
+  } else if (l_type == TYPE_BOOL && r_type == TYPE_BOOL) {
+    BIND(bool, bool, bool);
+  } else if (l_type == TYPE_STRING && r_type == TYPE_STRING) {
+    BIND(std::string_view, std::string_view, std::string_view);
+  }
+#undef BIND
+  return false;
+}
+
+template <typename L, typename R, typename C, bool RCol>
+void CompiledPredicate::BindOp(Term &term, CompOp op)
+{
+  switch (op) {
+#define BIND_OP(OP)                                    \
+  case OP:                                             \
+    term.eval_   = &EvalTerm<L, R, C, OP, RCol>;       \
+    term.filter_ = &FilterTerm<L, R, C, OP, RCol>;     \
+    break
+    BIND_OP(OP_EQ);
+    BIND_OP(OP_NE);
+    BIND_OP(OP_LT);
+    BIND_OP(OP_LE);
+    BIND_OP(OP_GT);
+    BIND_OP(OP_GE);
+#undef BIND_OP
+    default: WSDB_FETAL(CompOpToString(op));
+  }
+}
+
+template <typename L, typename R, typename C, CompOp Op, bool RCol>
+auto CompiledPredicate::EvalTerm(const Term &term, const char *nullmap, const char *data) -> bool
+{
+  // same null semantics as Value: null equals null, and no ordering with null
+  bool l_null = BitMap::GetBit(nullmap, term.l_idx_);
+  bool r_null = RCol && BitMap::GetBit(nullmap, term.r_idx_);
+  if (l_null || r_null) {
+    if constexpr (Op == OP_EQ) {
+      return l_null && r_null;
+    } else if constexpr (Op == OP_NE) {
+      return !(l_null && r_null);
+    } else {
+      return false;
+    }
+  }
+  auto lhs = static_cast<C>(Load<L>(data + term.l_off_, term.l_size_));
+  if constexpr (RCol) {
+    return Compare<Op, C>(lhs, static_cast<C>(Load<R>(data + term.r_off_, term.r_size_)));
+  } else {
+    return Compare<Op, C>(lhs, Constant<C>(term));
+  }
+}
+
+template <typename L, typename R, typename C, CompOp Op, bool RCol>
+void CompiledPredicate::FilterTerm(const Term &term, const std::vector<RecordUptr> &records, std::vector<size_t> &sel)
+{
+  size_t n = 0;
+  for (auto i : sel) {
+    const auto &record = *records[i];
+    if (EvalTerm<L, R, C, Op, RCol>(term, record.GetNullMap(), record.GetData())) {
+      sel[n++] = i;
+    }
+  }
+  sel.resize(n);
+}
+
+}  // namespace wsdb
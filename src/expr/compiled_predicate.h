@@ -0,0 +1,104 @@
+/*------------------------------------------------------------------------------
+ - Copyright (c) 2024. Websoft research group, Nanjing University.
+ -
+ - This program is free software: you can redistribute it and/or modify
+ - it under the terms of the GNU General Public License as published by
+ - the Free Software Foundation, either version 3 of the License, or
+ - (at your option) any later version.
+ -
+ - This program is distributed in the hope that it will be useful,
+ - but WITHOUT ANY WARRANTY; without even the implied warranty of
+ - MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ - GNU General Public License for more details.
+ -
+ - You should have received a copy of the GNU General Public License
+ - along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ -----------------------------------------------------------------------------*/
+
+/**
+ * @brief A ConditionVec compiled against a fixed record schema. Field offsets are resolved once, and every condition
+ * on fixed width fields is bound to a function instantiated for its field types and operator, which reads the values
+ * straight from the record buffer without building Values. Conditions that cannot be compiled (IN, NULL constants,
+ * sub queries) fall back to ConditionExpr::Eval.
+ * Filter evaluates a whole batch condition by condition and narrows a selection vector of the qualifying positions.
+ */
+
+#ifndef WSDB_COMPILED_PREDICATE_H
+#define WSDB_COMPILED_PREDICATE_H
+
+#include <string_view>
+#include "common/condition.h"
+#include "system/handle/record_handle.h"
+
+namespace wsdb {
+
+class CompiledPredicate
+{
+public:
+  /**
+   * @param conds conjunction of conditions
+   * @param schema schema of the records to evaluate, if nullptr, compile on the schema of the first record
+   */
+  explicit CompiledPredicate(ConditionVec conds, const RecordSchema *schema = nullptr);
+
+  /// compile again if the record comes with another schema
+  auto Eval(const Record &record) -> bool;
+
+  /**
+   * evaluate all records of a batch
+   * @param records batch of records with the same schema
+   * @param sel output selection vector, positions of the records satisfying all conditions in ascending order
+   * @return number of selected records
+   */
+  auto Filter(const std::vector<RecordUptr> &records, std::vector<size_t> &sel) -> size_t;
+
+  [[nodiscard]] auto GetCompiledCount() const -> size_t { return terms_.size(); }
+
+private:
+  struct Term;
+
+  using EvalFunc   = bool (*)(const Term &term, const char *nullmap, const char *data);
+  using FilterFunc = void (*)(const Term &term, const std::vector<RecordUptr> &records, std::vector<size_t> &sel);
+
+  struct Term
+  {
+    EvalFunc   eval_{nullptr};
+    FilterFunc filter_{nullptr};
+    size_t     l_idx_{0};
+    size_t     l_off_{0};
+    size_t     l_size_{0};
+    size_t     r_idx_{0};
+    size_t     r_off_{0};
+    size_t     r_size_{0};
+    // constant of the right hand side, already cast to the type of comparison
+    int32_t     int_{0};
+    float       float_{0};
+    bool        bool_{false};
+    std::string str_;
+  };
+
+  void Compile(const RecordSchema *schema);
+
+  /// bind the functions for the field types, return false if the condition can not be compiled
+  static auto BindTerm(Term &term, FieldType l_type, FieldType r_type, bool r_col, CompOp op) -> bool;
+
+  template <typename L, typename R, typename C, bool RCol>
+  static void BindOp(Term &term, CompOp op);
+
+  template <typename L, typename R, typename C, CompOp Op, bool RCol>
+  static auto EvalTerm(const Term &term, const char *nullmap, const char *data) -> bool;
+
+  template <typename L, typename R, typename C, CompOp Op, bool RCol>
+  static void FilterTerm(const Term &term, const std::vector<RecordUptr> &records, std::vector<size_t> &sel);
+
+private:
+  ConditionVec        conds_;
+  const RecordSchema *schema_{nullptr};
+  std::vector<Term>   terms_;
+  // conditions evaluated by ConditionExpr
+  ConditionVec rest_;
+};
+
+}  // namespace wsdb
+
+#endif  // WSDB_COMPILED_PREDICATE_H
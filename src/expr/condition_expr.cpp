@@ -44,6 +44,9 @@ auto ConditionExpr::EvalCond(const Condition &condition, const wsdb::Record &rec
     WSDB_ASSERT(idx != record.GetSchema()->GetFieldCount(), "Invalid field");
     rhs = record.GetValueAt(idx);
   }
+  if (condition.GetOp() == OP_IN) {
+    return std::dynamic_pointer_cast<ArrayValue>(rhs)->Contains(lhs);
+  }
   ValueFactory::AlignTypes(lhs, rhs);
   switch (condition.GetOp()) {
     case OP_EQ: return *lhs == *rhs;
@@ -52,7 +55,6 @@ auto ConditionExpr::EvalCond(const Condition &condition, const wsdb::Record &rec
     case OP_LE: return *lhs <= *rhs;
     case OP_GT: return *lhs > *rhs;
     case OP_GE: return *lhs >= *rhs;
-    case OP_IN: return std::dynamic_pointer_cast<ArrayValue>(rhs)->Contains(lhs);
     default: WSDB_FETAL(CompOpToString(condition.GetOp()));
   }
   // should never reach here
@@ -0,0 +1,71 @@
+/*------------------------------------------------------------------------------
+ - Copyright (c) 2024. Websoft research group, Nanjing University.
+ -
+ - This program is free software: you can redistribute it and/or modify
+ - it under the terms of the GNU General Public License as published by
+ - the Free Software Foundation, either version 3 of the License, or
+ - (at your option) any later version.
+ -
+ - This program is distributed in the hope that it will be useful,
+ - but WITHOUT ANY WARRANTY; without even the implied warranty of
+ - MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ - GNU General Public License for more details.
+ -
+ - You should have received a copy of the GNU General Public License
+ - along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ -----------------------------------------------------------------------------*/
+
+#include "runtime_filter.h"
+#include "common/config.h"
+
+namespace wsdb {
+
+RuntimeFilter::RuntimeFilter(std::vector<RTField> probe_fields, std::vector<RTField> build_fields)
+    : probe_fields_(std::move(probe_fields)),
+      build_fields_(std::move(build_fields)),
+      probe_schema_(std::make_unique<RecordSchema>(probe_fields_)),
+      build_schema_(std::make_unique<RecordSchema>(build_fields_))
+{
+  WSDB_ASSERT(!probe_fields_.empty() && probe_fields_.size() == build_fields_.size(),
+      fmt::format(
+          "invalid runtime filter of {} probe and {} build fields", probe_fields_.size(), build_fields_.size()));
+}
+
+auto RuntimeFilter::MakeProbeEncoder(const RecordSchema *rec_schema) const -> SortKeyEncoder
+{
+  SortKeyEncoder probe(probe_schema_.get(), rec_schema);
+  // the key schema holds all of its fields, so it serves as the record schema of the build side
+  SortKeyEncoder build(build_schema_.get(), build_schema_.get());
+  SortKeyEncoder::AlignWith(probe, build);
+  return probe;
+}
+
+void RuntimeFilter::Reset() { ready_.store(false, std::memory_order_release); }
+
+void RuntimeFilter::Build(const std::vector<uint64_t> &hashes)
+{
+  Reset();
+  filter_ = BloomFilter(hashes.size(), BLOOM_FILTER_FPR, BLOOM_FILTER_MAX_BITS);
+  // a filter letting most records through costs more than it saves
+  if (filter_.EstimateFpr(hashes.size()) > BLOOM_FILTER_MAX_FPR) {
+    filter_ = BloomFilter();
+    return;
+  }
+  for (auto hash : hashes) {
+    filter_.Add(hash);
+  }
+  ready_.store(true, std::memory_order_release);
+}
+
+auto RuntimeFilter::MayContain(const SortKeyEncoder &encoder, const Record &record) const -> bool
+{
+  if (!IsReady()) {
+    return true;
+  }
+  if (encoder.HasNull(record)) {
+    return false;
+  }
+  return filter_.MayContain(HashKey(encoder.Encode(record)));
+}
+
+}  // namespace wsdb
@@ -0,0 +1,85 @@
+/*------------------------------------------------------------------------------
+ - Copyright (c) 2024. Websoft research group, Nanjing University.
+ -
+ - This program is free software: you can redistribute it and/or modify
+ - it under the terms of the GNU General Public License as published by
+ - the Free Software Foundation, either version 3 of the License, or
+ - (at your option) any later version.
+ -
+ - This program is distributed in the hope that it will be useful,
+ - but WITHOUT ANY WARRANTY; without even the implied warranty of
+ - MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ - GNU General Public License for more details.
+ -
+ - You should have received a copy of the GNU General Public License
+ - along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ -----------------------------------------------------------------------------*/
+
+/**
+ * @brief Bloom filter on the join keys of the build (right) side of an inner join, checked by a table scan on the
+ * probe (left) side so that records which cannot be joined are dropped before they are materialized, sorted or passed
+ * up the pipeline. The join fills the filter with all build keys before the probe side starts reading. Until then, or
+ * when the build side is too large for a useful filter, every record passes.
+ *
+ * The filter held by the join plan and the scan plan only describes the keys. Every execution gets its own copy from
+ * Executor::GetRuntimeFilter, shared by the join executor and the scan executor of that execution, so a cached plan
+ * can be run by several sessions at once. The copy is filled again whenever the join builds its hash table.
+ */
+
+#ifndef WSDB_RUNTIME_FILTER_H
+#define WSDB_RUNTIME_FILTER_H
+
+#include <atomic>
+#include "common/bloom_filter.h"
+#include "expr/sort_key.h"
+
+namespace wsdb {
+
+class RuntimeFilter
+{
+public:
+  /**
+   * @param probe_fields key fields of the probe side
+   * @param build_fields key fields of the build side, in the order of probe_fields
+   */
+  RuntimeFilter(std::vector<RTField> probe_fields, std::vector<RTField> build_fields);
+
+  DISABLE_COPY_MOVE_AND_ASSIGN(RuntimeFilter)
+
+  [[nodiscard]] auto GetProbeFields() const -> const std::vector<RTField> & { return probe_fields_; }
+
+  [[nodiscard]] auto GetBuildFields() const -> const std::vector<RTField> & { return build_fields_; }
+
+  /// encoder of the probe key of records of rec_schema, aligned with the build key like the encoders of the join
+  [[nodiscard]] auto MakeProbeEncoder(const RecordSchema *rec_schema) const -> SortKeyEncoder;
+
+  /// records pass until the filter is built again
+  void Reset();
+
+  /**
+   * size the filter for the build keys and publish it to the probe side
+   * @param hashes HashKey of every non-null build key, encoded by an encoder aligned with the probe key
+   */
+  void Build(const std::vector<uint64_t> &hashes);
+
+  [[nodiscard]] auto IsReady() const -> bool { return ready_.load(std::memory_order_acquire); }
+
+  /// false if the probe key of record cannot equal any build key, a null key equals nothing
+  [[nodiscard]] auto MayContain(const SortKeyEncoder &encoder, const Record &record) const -> bool;
+
+  static auto HashKey(const std::string &key) -> uint64_t { return BloomFilter::Hash(key.data(), key.size()); }
+
+private:
+  std::vector<RTField> probe_fields_;
+  std::vector<RTField> build_fields_;
+  RecordSchemaUptr     probe_schema_;
+  RecordSchemaUptr     build_schema_;
+  BloomFilter          filter_;
+  std::atomic<bool>    ready_{false};
+};
+
+DEFINE_SHARED_PTR(RuntimeFilter);
+
+}  // namespace wsdb
+
+#endif  // WSDB_RUNTIME_FILTER_H
@@ -0,0 +1,229 @@
+/*------------------------------------------------------------------------------
+ - Copyright (c) 2024. Websoft research group, Nanjing University.
+ -
+ - This program is free software: you can redistribute it and/or modify
+ - it under the terms of the GNU General Public License as published by
+ - the Free Software Foundation, either version 3 of the License, or
+ - (at your option) any later version.
+ -
+ - This program is distributed in the hope that it will be useful,
+ - but WITHOUT ANY WARRANTY; without even the implied warranty of
+ - MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ - GNU General Public License for more details.
+ -
+ - You should have received a copy of the GNU General Public License
+ - along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ -----------------------------------------------------------------------------*/
+
+#include "sort_key.h"
+#include <algorithm>
+
+namespace wsdb {
+
+SortKeyEncoder::SortKeyEncoder(const RecordSchema *key_schema, const RecordSchema *rec_schema, bool is_desc)
+    : is_desc_(is_desc)
+{
+  WSDB_ASSERT(key_schema != nullptr && rec_schema != nullptr, "schema is nullptr");
+  std::vector<size_t> offsets(rec_schema->GetFieldCount(), 0);
+  for (size_t i = 1; i < rec_schema->GetFieldCount(); i++) {
+    offsets[i] = offsets[i - 1] + rec_schema->GetFieldAt(i - 1).field_.field_size_;
+  }
+  fields_.reserve(key_schema->GetFieldCount());
+  for (size_t i = 0; i < key_schema->GetFieldCount(); i++) {
+    auto idx = rec_schema->GetRTFieldIndex(key_schema->GetFieldAt(i));
+    WSDB_ASSERT(idx != rec_schema->GetFieldCount(), "Invalid key field");
+    const auto &field = rec_schema->GetFieldAt(idx).field_;
+    fields_.push_back({idx,
+        offsets[idx],
+        field.field_type_,
+        field.field_size_,
+        field.field_type_,
+        EncodedSize(field.field_type_, field.field_size_)});
+  }
+  ResetKeySize();
+}
+
+void SortKeyEncoder::AlignWith(SortKeyEncoder &lhs, SortKeyEncoder &rhs)
+{
+  WSDB_ASSERT(lhs.fields_.size() == rhs.fields_.size(), "key field number mismatch");
+  for (size_t i = 0; i < lhs.fields_.size(); i++) {
+    auto &l = lhs.fields_[i];
+    auto &r = rhs.fields_[i];
+    if (l.enc_type_ != r.enc_type_) {
+      if ((l.enc_type_ == TYPE_INT && r.enc_type_ == TYPE_FLOAT) ||
+          (l.enc_type_ == TYPE_FLOAT && r.enc_type_ == TYPE_INT)) {
+        l.enc_type_ = r.enc_type_ = TYPE_FLOAT;
+      } else {
+        WSDB_THROW(WSDB_TYPE_MISSMATCH,
+            fmt::format("Type mismatch: {} != {}", FieldTypeToString(l.enc_type_), FieldTypeToString(r.enc_type_)));
+      }
+    }
+    l.enc_size_ = r.enc_size_ = std::max(l.enc_size_, r.enc_size_);
+  }
+  lhs.ResetKeySize();
+  rhs.ResetKeySize();
+}
+
+auto SortKeyEncoder::GetPrefixSize(size_t field_num) const -> size_t
+{
+  WSDB_ASSERT(field_num <= fields_.size(), "prefix is longer than the key");
+  size_t size = 0;
+  for (size_t i = 0; i < field_num; i++) {
+    size += 1 + fields_[i].enc_size_;
+  }
+  return size;
+}
+
+auto SortKeyEncoder::HasNull(const Record &record) const -> bool
+{
+  const char *nullmap = record.GetNullMap();
+  return std::any_of(fields_.begin(), fields_.end(), [nullmap](const KeyField &field) {
+    return BitMap::GetBit(nullmap, field.rec_idx_);
+  });
+}
+
+void SortKeyEncoder::Encode(const Record &record, char *dst) const
+{
+  const char *data    = record.GetData();
+  const char *nullmap = record.GetNullMap();
+  char       *pos     = dst;
+  for (const auto &field : fields_) {
+    if (BitMap::GetBit(nullmap, field.rec_idx_)) {
+      memset(pos, 0, 1 + field.enc_size_);
+    } else {
+      *pos = 1;
+      EncodeField(field, data + field.rec_offset_, pos + 1);
+    }
+    pos += 1 + field.enc_size_;
+  }
+  InvertIfDesc(dst, key_size_);
+}
+
+auto SortKeyEncoder::Encode(const Record &record) const -> std::string
+{
+  std::string key(key_size_, '\0');
+  Encode(record, key.data());
+  return key;
+}
+
+void SortKeyEncoder::EncodeValues(const std::vector<ValueSptr> &values, char *dst) const
+{
+  WSDB_ASSERT(values.size() <= fields_.size(), "too many values for the key");
+  char *pos = dst;
+  for (size_t i = 0; i < values.size(); i++) {
+    const auto &field = fields_[i];
+    if (values[i]->IsNull()) {
+      memset(pos, 0, 1 + field.enc_size_);
+    } else {
+      *pos = 1;
+      EncodeValue(field, *values[i], pos + 1);
+    }
+    pos += 1 + field.enc_size_;
+  }
+  InvertIfDesc(dst, static_cast<size_t>(pos - dst));
+}
+
+auto SortKeyEncoder::EncodeValues(const std::vector<ValueSptr> &values) const -> std::string
+{
+  std::string key(GetPrefixSize(values.size()), '\0');
+  EncodeValues(values, key.data());
+  return key;
+}
+
+auto SortKeyEncoder::DecodeValues(const char *src) const -> std::vector<ValueSptr>
+{
+  std::string key(src, key_size_);
+  InvertIfDesc(key.data(), key_size_);
+  std::vector<ValueSptr> values;
+  values.reserve(fields_.size());
+  const char *pos = key.data();
+  for (const auto &field : fields_) {
+    ValueSptr value;
+    if (*pos == 0) {
+      value = ValueFactory::CreateNullValue(field.src_type_);
+    } else {
+      switch (field.enc_type_) {
+        case TYPE_INT: value = ValueFactory::CreateIntValue(DecodeInt(pos + 1)); break;
+        case TYPE_FLOAT: value = ValueFactory::CreateFloatValue(DecodeFloat(pos + 1)); break;
+        case TYPE_BOOL: value = ValueFactory::CreateBoolValue(pos[1] != 0); break;
+        case TYPE_STRING: value = ValueFactory::CreateStringValue(pos + 1, strnlen(pos + 1, field.enc_size_)); break;
+        default: WSDB_FETAL(FieldTypeToString(field.enc_type_));
+      }
+      value = ValueFactory::CastTo(value, field.src_type_);
+    }
+    values.push_back(std::move(value));
+    pos += 1 + field.enc_size_;
+  }
+  return values;
+}
+
+auto SortKeyEncoder::EncodedSize(FieldType type, size_t field_size) -> size_t
+{
+  switch (type) {
+    case TYPE_INT: return sizeof(int32_t);
+    case TYPE_FLOAT: return sizeof(float);
+    case TYPE_BOOL: return sizeof(bool);
+    case TYPE_STRING: return field_size;
+    default: WSDB_THROW(WSDB_UNSUPPORTED_OP, fmt::format("sort key of {}", FieldTypeToString(type)));
+  }
+}
+
+void SortKeyEncoder::EncodeField(const KeyField &field, const char *src, char *dst) const
+{
+  switch (field.src_type_) {
+    case TYPE_INT: {
+      int32_t v;
+      memcpy(&v, src, sizeof(v));
+      if (field.enc_type_ == TYPE_FLOAT) {
+        EncodeFloat(static_cast<float>(v), dst);
+      } else {
+        EncodeInt(v, dst);
+      }
+      break;
+    }
+    case TYPE_FLOAT: {
+      float v;
+      memcpy(&v, src, sizeof(v));
+      EncodeFloat(v, dst);
+      break;
+    }
+    case TYPE_BOOL: EncodeBool(*src != 0, dst); break;
+    case TYPE_STRING: EncodeString(src, strnlen(src, field.src_size_), field.enc_size_, dst); break;
+    default: WSDB_FETAL(FieldTypeToString(field.src_type_));
+  }
+}
+
+void SortKeyEncoder::EncodeValue(const KeyField &field, const Value &value, char *dst) const
+{
+  switch (value.GetType()) {
+    case TYPE_INT: {
+      auto v = dynamic_cast<const IntValue &>(value).Get();
+      if (field.enc_type_ == TYPE_FLOAT) {
+        EncodeFloat(static_cast<float>(v), dst);
+      } else if (field.enc_type_ == TYPE_INT) {
+        EncodeInt(v, dst);
+      } else {
+        WSDB_THROW(WSDB_TYPE_MISSMATCH, fmt::format("{} != INT", FieldTypeToString(field.enc_type_)));
+      }
+      break;
+    }
+    case TYPE_FLOAT: {
+      if (field.enc_type_ != TYPE_FLOAT) {
+        WSDB_THROW(WSDB_TYPE_MISSMATCH, fmt::format("{} != FLOAT", FieldTypeToString(field.enc_type_)));
+      }
+      EncodeFloat(dynamic_cast<const FloatValue &>(value).Get(), dst);
+      break;
+    }
+    case TYPE_BOOL: EncodeBool(dynamic_cast<const BoolValue &>(value).Get(), dst); break;
+    case TYPE_STRING: {
+      const auto &s = dynamic_cast<const StringValue &>(value).Get();
+      EncodeString(s.data(), s.size(), field.enc_size_, dst);
+      break;
+    }
+    default: WSDB_FETAL(FieldTypeToString(value.GetType()));
+  }
+}
+
+void SortKeyEncoder::ResetKeySize() { key_size_ = GetPrefixSize(fields_.size()); }
+
+}  // namespace wsdb
@@ -0,0 +1,188 @@
+/*------------------------------------------------------------------------------
+ - Copyright (c) 2024. Websoft research group, Nanjing University.
+ -
+ - This program is free software: you can redistribute it and/or modify
+ - it under the terms of the GNU General Public License as published by
+ - the Free Software Foundation, either version 3 of the License, or
+ - (at your option) any later version.
+ -
+ - This program is distributed in the hope that it will be useful,
+ - but WITHOUT ANY WARRANTY; without even the implied warranty of
+ - MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ - GNU General Public License for more details.
+ -
+ - You should have received a copy of the GNU General Public License
+ - along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ -----------------------------------------------------------------------------*/
+
+/**
+ * @brief Normalized binary sort keys.
+ *
+ * A key is encoded field by field into a fixed width byte string whose memcmp order equals the logical order of the
+ * key, so sort, merge join and index code can compare keys with a single memcmp instead of building key records and
+ * comparing them through virtual Value operators. Each field is encoded as a null flag byte followed by the payload:
+ *  - INT:    sign bit flipped, big endian
+ *  - FLOAT:  IEEE 754 bits, sign bit flipped for positives and all bits flipped for negatives, big endian
+ *  - BOOL:   one byte
+ *  - STRING: the fixed width field, padded with '\0'
+ * Nulls are ordered before any non-null value. For descending keys every byte of the key is inverted.
+ */
+
+#ifndef WSDB_SORT_KEY_H
+#define WSDB_SORT_KEY_H
+
+#include <cstring>
+#include <string>
+#include <vector>
+#include "system/handle/record_handle.h"
+
+namespace wsdb {
+
+class SortKeyEncoder
+{
+public:
+  SortKeyEncoder() = default;
+
+  /**
+   * @param key_schema fields of the key, all of them should appear in rec_schema
+   * @param rec_schema schema of the records to be encoded
+   * @param is_desc whether the key is sorted in descending order
+   */
+  SortKeyEncoder(const RecordSchema *key_schema, const RecordSchema *rec_schema, bool is_desc = false);
+
+  /**
+   * make the encoders of two key schemas produce comparable keys, e.g. the left and right keys of a merge join.
+   * int fields compared with float fields are encoded as float, strings are padded to the longer width
+   */
+  static void AlignWith(SortKeyEncoder &lhs, SortKeyEncoder &rhs);
+
+  [[nodiscard]] auto GetKeySize() const -> size_t { return key_size_; }
+
+  [[nodiscard]] auto GetFieldCount() const -> size_t { return fields_.size(); }
+
+  /// size of the encoded prefix made of the first field_num fields
+  [[nodiscard]] auto GetPrefixSize(size_t field_num) const -> size_t;
+
+  /// whether any field of the key is null in record
+  [[nodiscard]] auto HasNull(const Record &record) const -> bool;
+
+  /// encode the key of record into dst, dst should hold at least GetKeySize() bytes
+  void Encode(const Record &record, char *dst) const;
+
+  [[nodiscard]] auto Encode(const Record &record) const -> std::string;
+
+  /// encode the first values.size() fields of the key from literal values, used for bounds of index scans
+  void EncodeValues(const std::vector<ValueSptr> &values, char *dst) const;
+
+  [[nodiscard]] auto EncodeValues(const std::vector<ValueSptr> &values) const -> std::string;
+
+  /// decode a key back into values of the record field types, strings lose their trailing '\0's
+  [[nodiscard]] auto DecodeValues(const char *src) const -> std::vector<ValueSptr>;
+
+  /// compare two encoded keys, the first 8 bytes are compared as an integer before falling back to memcmp
+  static auto Compare(const char *lhs, const char *rhs, size_t size) -> int
+  {
+    if (size >= sizeof(uint64_t)) {
+      auto l = LoadPrefix(lhs);
+      auto r = LoadPrefix(rhs);
+      if (l != r) {
+        return l < r ? -1 : 1;
+      }
+      return memcmp(lhs + sizeof(uint64_t), rhs + sizeof(uint64_t), size - sizeof(uint64_t));
+    }
+    return memcmp(lhs, rhs, size);
+  }
+
+  /// the first 8 bytes of a key as a big endian integer, keys with different prefixes compare like their prefixes
+  static auto LoadPrefix(const char *key) -> uint64_t
+  {
+    uint64_t v;
+    memcpy(&v, key, sizeof(uint64_t));
+    return __builtin_bswap64(v);
+  }
+
+  /// encoded width of a field, excluding the null flag byte
+  static auto EncodedSize(FieldType type, size_t field_size) -> size_t;
+
+  static void EncodeInt(int32_t value, char *dst)
+  {
+    auto u = static_cast<uint32_t>(value) ^ 0x80000000u;
+    u      = __builtin_bswap32(u);
+    memcpy(dst, &u, sizeof(u));
+  }
+
+  static auto DecodeInt(const char *src) -> int32_t
+  {
+    uint32_t u;
+    memcpy(&u, src, sizeof(u));
+    return static_cast<int32_t>(__builtin_bswap32(u) ^ 0x80000000u);
+  }
+
+  static void EncodeFloat(float value, char *dst)
+  {
+    // -0.0 and 0.0 are equal, encode them the same way
+    if (value == 0.0f) {
+      value = 0.0f;
+    }
+    uint32_t u;
+    memcpy(&u, &value, sizeof(u));
+    u = (u & 0x80000000u) ? ~u : (u | 0x80000000u);
+    u = __builtin_bswap32(u);
+    memcpy(dst, &u, sizeof(u));
+  }
+
+  static auto DecodeFloat(const char *src) -> float
+  {
+    uint32_t u;
+    memcpy(&u, src, sizeof(u));
+    u = __builtin_bswap32(u);
+    u = (u & 0x80000000u) ? (u & ~0x80000000u) : ~u;
+    float value;
+    memcpy(&value, &u, sizeof(u));
+    return value;
+  }
+
+  static void EncodeBool(bool value, char *dst) { *dst = value ? 1 : 0; }
+
+  static void EncodeString(const char *value, size_t len, size_t width, char *dst)
+  {
+    len = std::min(len, width);
+    memcpy(dst, value, len);
+    memset(dst + len, 0, width - len);
+  }
+
+private:
+  struct KeyField
+  {
+    size_t    rec_idx_;     // index of the field in the record schema
+    size_t    rec_offset_;  // offset of the field in the record data
+    FieldType src_type_;    // type of the field in the record
+    size_t    src_size_;    // size of the field in the record
+    FieldType enc_type_;    // type of the field in the key, may differ from src_type_ after alignment
+    size_t    enc_size_;    // size of the encoded field, excluding the null flag byte
+  };
+
+  void EncodeField(const KeyField &field, const char *src, char *dst) const;
+
+  void EncodeValue(const KeyField &field, const Value &value, char *dst) const;
+
+  void ResetKeySize();
+
+  void InvertIfDesc(char *dst, size_t size) const
+  {
+    if (is_desc_) {
+      for (size_t i = 0; i < size; i++) {
+        dst[i] = static_cast<char>(~dst[i]);
+      }
+    }
+  }
+
+private:
+  std::vector<KeyField> fields_;
+  size_t                key_size_{0};
+  bool                  is_desc_{false};
+};
+
+}  // namespace wsdb
+
+#endif  // WSDB_SORT_KEY_H
@@ -0,0 +1,482 @@
+/*------------------------------------------------------------------------------
+ - Copyright (c) 2024. Websoft research group, Nanjing University.
+ -
+ - This program is free software: you can redistribute it and/or modify
+ - it under the terms of the GNU General Public License as published by
+ - the Free Software Foundation, either version 3 of the License, or
+ - (at your option) any later version.
+ -
+ - This program is distributed in the hope that it will be useful,
+ - but WITHOUT ANY WARRANTY; without even the implied warranty of
+ - MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ - GNU General Public License for more details.
+ -
+ - You should have received a copy of the GNU General Public License
+ - along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ -----------------------------------------------------------------------------*/
+
+#include "statistics.h"
+#include <algorithm>
+#include <filesystem>
+#include <fstream>
+#include <map>
+#include <mutex>
+#include <set>
+#include "common/bloom_filter.h"
+#include "common/catalog_version.h"
+
+namespace wsdb {
+
+namespace {
+constexpr uint32_t STATS_MAGIC   = 0x54535357;  // "WSST"
+constexpr uint32_t STATS_VERSION = 1;
+
+struct TableStatsRegistry
+{
+  std::mutex                            mutex_;
+  std::map<std::string, TableStatsSptr> stats_;  // "db.table" -> statistics, nullptr if there is no file
+
+  static auto Instance() -> TableStatsRegistry &
+  {
+    static TableStatsRegistry registry;
+    return registry;
+  }
+};
+
+auto IsNumber(FieldType type) -> bool { return type == TYPE_INT || type == TYPE_FLOAT; }
+
+auto NumberKey(double value) -> std::string
+{
+  // -0.0 and 0.0 are equal, encode them the same way
+  if (value == 0.0) {
+    value = 0.0;
+  }
+  uint64_t u;
+  memcpy(&u, &value, sizeof(u));
+  u = (u & (uint64_t{1} << 63)) ? ~u : (u | (uint64_t{1} << 63));
+  u = __builtin_bswap64(u);
+  return {reinterpret_cast<const char *>(&u), sizeof(u)};
+}
+
+auto DecodeNumberKey(const std::string &key) -> double
+{
+  uint64_t u;
+  memcpy(&u, key.data(), sizeof(u));
+  u = __builtin_bswap64(u);
+  u = (u & (uint64_t{1} << 63)) ? (u & ~(uint64_t{1} << 63)) : ~u;
+  double value;
+  memcpy(&value, &u, sizeof(u));
+  return value;
+}
+
+template <typename T>
+void WritePod(std::ostream &out, const T &value)
+{
+  out.write(reinterpret_cast<const char *>(&value), sizeof(T));
+}
+
+template <typename T>
+auto ReadPod(std::istream &in) -> T
+{
+  T value{};
+  in.read(reinterpret_cast<char *>(&value), sizeof(T));
+  return value;
+}
+
+void WriteString(std::ostream &out, const std::string &str)
+{
+  WritePod(out, static_cast<uint32_t>(str.size()));
+  out.write(str.data(), static_cast<std::streamsize>(str.size()));
+}
+
+auto ReadString(std::istream &in) -> std::string
+{
+  auto        size = ReadPod<uint32_t>(in);
+  std::string str;
+  // a corrupted size should not allocate gigabytes
+  if (!in || size > MAX_REC_SIZE * 64) {
+    in.setstate(std::ios::failbit);
+    return str;
+  }
+  str.resize(size);
+  in.read(str.data(), size);
+  return str;
+}
+}  // namespace
+
+TableStats::TableStats(const RecordSchema &schema)
+    : schema_(std::make_unique<RecordSchema>(schema.GetFields())), columns_(schema.GetFieldCount())
+{}
+
+auto TableStats::Get(const std::string &db_name, TableHandle *tab) -> TableStatsSptr
+{
+  auto            &registry = TableStatsRegistry::Instance();
+  std::scoped_lock lock(registry.mutex_);
+  auto             key = db_name + "." + tab->GetTableName();
+  auto             it  = registry.stats_.find(key);
+  if (it == registry.stats_.end()) {
+    std::ifstream in(FILE_NAME(db_name, tab->GetTableName(), STAT_SUFFIX), std::ios::binary);
+    it = registry.stats_.emplace(key, in ? Deserialize(in, tab->GetSchema()) : nullptr).first;
+  }
+  if (it->second == nullptr || it->second->schema_->GetFields() != tab->GetSchema().GetFields()) {
+    return nullptr;
+  }
+  return it->second;
+}
+
+void TableStats::Save(const std::string &db_name, const std::string &tab_name, TableStatsSptr stats)
+{
+  auto path     = FILE_NAME(db_name, tab_name, STAT_SUFFIX);
+  auto tmp_path = path + TMP_SUFFIX;
+  {
+    std::ofstream out(tmp_path, std::ios::binary | std::ios::trunc);
+    stats->Serialize(out);
+    out.flush();
+    if (!out) {
+      WSDB_THROW(WSDB_FILE_WRITE_ERROR, tmp_path);
+    }
+  }
+  // readers see either the old or the new file
+  std::error_code ec;
+  std::filesystem::rename(tmp_path, path, ec);
+  if (ec) {
+    WSDB_THROW(WSDB_FILE_WRITE_ERROR, path);
+  }
+  auto            &registry = TableStatsRegistry::Instance();
+  std::scoped_lock lock(registry.mutex_);
+  registry.stats_[db_name + "." + tab_name] = std::move(stats);
+  // plans chosen with the old statistics are optimized again
+  CatalogVersion::Bump();
+}
+
+void TableStats::Drop(const std::string &db_name, const std::string &tab_name)
+{
+  auto            &registry = TableStatsRegistry::Instance();
+  std::scoped_lock lock(registry.mutex_);
+  registry.stats_.erase(db_name + "." + tab_name);
+  std::error_code ec;
+  std::filesystem::remove(FILE_NAME(db_name, tab_name, STAT_SUFFIX), ec);
+  CatalogVersion::Bump();
+}
+
+auto TableStats::GetColumn(const RTField &field) const -> const ColumnStats *
+{
+  auto col = schema_->GetRTFieldIndex(field);
+  return col == schema_->GetFieldCount() ? nullptr : &columns_[col];
+}
+
+auto TableStats::StatKey(const Value &value) -> std::optional<std::string>
+{
+  switch (value.GetType()) {
+    case TYPE_INT: return NumberKey(dynamic_cast<const IntValue &>(value).Get());
+    case TYPE_FLOAT: return NumberKey(dynamic_cast<const FloatValue &>(value).Get());
+    case TYPE_BOOL: return std::string(1, dynamic_cast<const BoolValue &>(value).Get() ? 1 : 0);
+    case TYPE_STRING: {
+      // fixed width fields are padded with '\0'
+      const auto &str = dynamic_cast<const StringValue &>(value).Get();
+      return str.substr(0, str.find_last_not_of('\0') + 1);
+    }
+    default: return std::nullopt;
+  }
+}
+
+auto TableStats::DefaultSelectivity(const Condition &cond) -> double
+{
+  switch (cond.GetOp()) {
+    case OP_EQ: return DEFAULT_EQ_SELECTIVITY;
+    case OP_NE: return 1 - DEFAULT_EQ_SELECTIVITY;
+    case OP_IN: {
+      auto list = cond.GetRhsType() == kValue ? std::dynamic_pointer_cast<ArrayValue>(cond.GetRVal()) : nullptr;
+      return list == nullptr ? DEFAULT_RANGE_SELECTIVITY
+                             : std::min(1.0, DEFAULT_EQ_SELECTIVITY * static_cast<double>(list->Get().size()));
+    }
+    default: return DEFAULT_RANGE_SELECTIVITY;
+  }
+}
+
+auto TableStats::EstimateJoinSelectivity(const ColumnStats *lhs, const ColumnStats *rhs) -> double
+{
+  double ndv = std::max(lhs == nullptr ? 0 : lhs->ndv_, rhs == nullptr ? 0 : rhs->ndv_);
+  if (ndv < 1) {
+    return DEFAULT_EQ_SELECTIVITY;
+  }
+  // every value of the side with fewer distinct values is assumed to find its match on the other side
+  double non_null = (lhs == nullptr ? 1 : 1 - lhs->null_frac_) * (rhs == nullptr ? 1 : 1 - rhs->null_frac_);
+  return non_null / ndv;
+}
+
+auto TableStats::EstimateSelectivity(const Condition &cond) const -> double
+{
+  auto col_idx = schema_->GetRTFieldIndex(cond.GetLCol());
+  if (col_idx == schema_->GetFieldCount() || cond.GetRhsType() == kSubquery) {
+    return DefaultSelectivity(cond);
+  }
+  const auto &col       = columns_[col_idx];
+  bool        is_number = IsNumber(schema_->GetFieldAt(col_idx).field_.field_type_);
+  if (cond.GetRhsType() == kColumn) {
+    auto eq = EstimateJoinSelectivity(&col, GetColumn(cond.GetRCol()));
+    switch (cond.GetOp()) {
+      case OP_EQ: return eq;
+      case OP_NE: return 1 - eq;
+      default: return DEFAULT_RANGE_SELECTIVITY;
+    }
+  }
+  const auto &val = cond.GetRVal();
+  // the key of a constant, nullopt if it cannot be compared with the column
+  auto const_key = [is_number, this, col_idx](const Value &value) -> std::optional<std::string> {
+    auto key = StatKey(value);
+    if (!key.has_value() || (IsNumber(value.GetType()) != is_number) ||
+        (!is_number && value.GetType() != schema_->GetFieldAt(col_idx).field_.field_type_)) {
+      return std::nullopt;
+    }
+    return key;
+  };
+  if (cond.GetOp() == OP_IN) {
+    auto list = std::dynamic_pointer_cast<ArrayValue>(val);
+    if (list == nullptr) {
+      return DefaultSelectivity(cond);
+    }
+    double sel = 0;
+    for (const auto &item : list->Get()) {
+      if (item->IsNull()) {
+        continue;
+      }
+      auto key = const_key(*item);
+      sel += key.has_value() ? EqualFrac(col, *key) : DEFAULT_EQ_SELECTIVITY;
+    }
+    return std::min(sel, 1.0);
+  }
+  // null only equals null
+  if (val->IsNull()) {
+    switch (cond.GetOp()) {
+      case OP_EQ: return col.null_frac_;
+      case OP_NE: return 1 - col.null_frac_;
+      default: return 0;
+    }
+  }
+  auto key = const_key(*val);
+  if (!key.has_value()) {
+    return DefaultSelectivity(cond);
+  }
+  double non_null = 1 - col.null_frac_;
+  double sel      = 0;
+  switch (cond.GetOp()) {
+    case OP_EQ: sel = EqualFrac(col, *key); break;
+    // a null differs from any constant
+    case OP_NE: sel = 1 - EqualFrac(col, *key); break;
+    case OP_LT: sel = LessFrac(col, *key, false, is_number); break;
+    case OP_LE: sel = LessFrac(col, *key, true, is_number); break;
+    case OP_GT: sel = non_null - LessFrac(col, *key, true, is_number); break;
+    case OP_GE: sel = non_null - LessFrac(col, *key, false, is_number); break;
+    default: return DefaultSelectivity(cond);
+  }
+  return std::clamp(sel, 0.0, 1.0);
+}
+
+auto TableStats::EqualFrac(const ColumnStats &col, const std::string &key) -> double
+{
+  for (const auto &[value, freq] : col.mcvs_) {
+    if (value == key) {
+      return freq;
+    }
+  }
+  if (col.bounds_.empty() || key < col.bounds_.front() || col.bounds_.back() < key) {
+    return 0;
+  }
+  // the values of the histogram are assumed to be equally frequent
+  return col.hist_frac_ / std::max(col.ndv_ - static_cast<double>(col.mcvs_.size()), 1.0);
+}
+
+auto TableStats::LessFrac(const ColumnStats &col, const std::string &key, bool inclusive, bool is_number) -> double
+{
+  double frac = 0;
+  bool   mcv  = false;
+  for (const auto &[value, freq] : col.mcvs_) {
+    if (value < key || (inclusive && value == key)) {
+      frac += freq;
+    }
+    mcv = mcv || value == key;
+  }
+  frac += col.hist_frac_ * HistFrac(col, key, is_number);
+  if (inclusive && !mcv) {
+    frac += EqualFrac(col, key);
+  }
+  return frac;
+}
+
+auto TableStats::HistFrac(const ColumnStats &col, const std::string &key, bool is_number) -> double
+{
+  const auto &bounds = col.bounds_;
+  if (bounds.empty() || key <= bounds.front()) {
+    return 0;
+  }
+  if (bounds.back() < key) {
+    return 1;
+  }
+  auto bucket_num = bounds.size() - 1;
+  auto bucket     = static_cast<size_t>(std::upper_bound(bounds.begin(), bounds.end(), key) - bounds.begin()) - 1;
+  if (bucket >= bucket_num) {
+    return 1;
+  }
+  // values are assumed to be spread evenly inside a bucket
+  double within = 0.5;
+  if (is_number) {
+    auto lo = DecodeNumberKey(bounds[bucket]);
+    auto hi = DecodeNumberKey(bounds[bucket + 1]);
+    if (hi > lo) {
+      within = (DecodeNumberKey(key) - lo) / (hi - lo);
+    }
+  }
+  return (static_cast<double>(bucket) + within) / static_cast<double>(bucket_num);
+}
+
+void TableStats::Serialize(std::ostream &out) const
+{
+  WritePod(out, STATS_MAGIC);
+  WritePod(out, STATS_VERSION);
+  WritePod(out, static_cast<uint64_t>(row_num_));
+  WritePod(out, static_cast<uint32_t>(columns_.size()));
+  for (size_t i = 0; i < columns_.size(); i++) {
+    const auto &col = columns_[i];
+    WriteString(out, schema_->GetFieldAt(i).field_.field_name_);
+    WritePod(out, col.null_frac_);
+    WritePod(out, col.ndv_);
+    WritePod(out, col.hist_frac_);
+    WritePod(out, static_cast<uint32_t>(col.mcvs_.size()));
+    for (const auto &[value, freq] : col.mcvs_) {
+      WriteString(out, value);
+      WritePod(out, freq);
+    }
+    WritePod(out, static_cast<uint32_t>(col.bounds_.size()));
+    for (const auto &bound : col.bounds_) {
+      WriteString(out, bound);
+    }
+  }
+}
+
+auto TableStats::Deserialize(std::istream &in, const RecordSchema &schema) -> TableStatsSptr
+{
+  if (ReadPod<uint32_t>(in) != STATS_MAGIC || ReadPod<uint32_t>(in) != STATS_VERSION) {
+    return nullptr;
+  }
+  auto stats      = std::make_shared<TableStats>(schema);
+  stats->row_num_ = ReadPod<uint64_t>(in);
+  if (ReadPod<uint32_t>(in) != schema.GetFieldCount()) {
+    return nullptr;
+  }
+  for (size_t i = 0; i < schema.GetFieldCount() && in; i++) {
+    auto &col = stats->columns_[i];
+    if (ReadString(in) != schema.GetFieldAt(i).field_.field_name_) {
+      return nullptr;
+    }
+    col.null_frac_ = ReadPod<double>(in);
+    col.ndv_       = ReadPod<double>(in);
+    col.hist_frac_ = ReadPod<double>(in);
+    auto mcv_num   = ReadPod<uint32_t>(in);
+    for (uint32_t k = 0; k < mcv_num && in; k++) {
+      auto value = ReadString(in);
+      col.mcvs_.emplace_back(std::move(value), ReadPod<double>(in));
+    }
+    auto bound_num = ReadPod<uint32_t>(in);
+    for (uint32_t k = 0; k < bound_num && in; k++) {
+      col.bounds_.push_back(ReadString(in));
+    }
+  }
+  return in ? stats : nullptr;
+}
+
+TableStatsBuilder::TableStatsBuilder(const RecordSchema &schema, size_t sample_size)
+    : stats_(std::make_shared<TableStats>(schema)), sample_size_(sample_size), samples_(schema.GetFieldCount())
+{}
+
+void TableStatsBuilder::Add(const Record &record)
+{
+  stats_->row_num_++;
+  for (size_t i = 0; i < samples_.size(); i++) {
+    auto &sample = samples_[i];
+    auto  value  = record.GetValueAt(i);
+    auto  key    = value->IsNull() ? std::nullopt : TableStats::StatKey(*value);
+    if (!key.has_value()) {
+      sample.null_num_ += value->IsNull();
+      continue;
+    }
+    sample.hll_.Add(BloomFilter::Hash(key->data(), key->size()));
+    sample.value_num_++;
+    // reservoir sampling, every value is kept with the same probability
+    if (sample.sample_.size() < sample_size_) {
+      sample.sample_.push_back(std::move(*key));
+    } else if (auto pos = gen_() % sample.value_num_; pos < sample_size_) {
+      sample.sample_[pos] = std::move(*key);
+    }
+  }
+}
+
+auto TableStatsBuilder::Finish() -> TableStatsSptr
+{
+  for (size_t i = 0; i < samples_.size(); i++) {
+    FinishColumn(samples_[i], stats_->columns_[i]);
+  }
+  return std::move(stats_);
+}
+
+void TableStatsBuilder::FinishColumn(const ColumnSample &sample, ColumnStats &stats) const
+{
+  auto rows = static_cast<double>(stats_->row_num_);
+  if (sample.value_num_ == 0) {
+    stats.null_frac_ = rows == 0 ? 0 : static_cast<double>(sample.null_num_) / rows;
+    return;
+  }
+  stats.null_frac_ = static_cast<double>(sample.null_num_) / rows;
+  auto non_null    = 1 - stats.null_frac_;
+
+  auto values = sample.sample_;
+  std::sort(values.begin(), values.end());
+  std::vector<std::pair<size_t, size_t>> runs;  // count and position of each distinct value in values
+  for (size_t pos = 0; pos < values.size();) {
+    auto end = pos + 1;
+    while (end < values.size() && values[end] == values[pos]) {
+      end++;
+    }
+    runs.emplace_back(end - pos, pos);
+    pos = end;
+  }
+  bool complete = sample.value_num_ <= sample_size_;
+  stats.ndv_    = complete ? static_cast<double>(runs.size())
+                           : std::clamp(sample.hll_.Estimate(),
+                              static_cast<double>(runs.size()),
+                              static_cast<double>(sample.value_num_));
+
+  // values clearly more frequent than the average one are kept as most common values
+  std::stable_sort(runs.begin(), runs.end(), [](const auto &lhs, const auto &rhs) { return lhs.first > rhs.first; });
+  auto                  avg      = static_cast<double>(values.size()) / static_cast<double>(runs.size());
+  bool                  take_all = complete && runs.size() <= STATS_MCV_NUM;
+  std::set<std::string> mcv_values;
+  double                mcv_frac = 0;
+  for (size_t k = 0; k < runs.size() && k < STATS_MCV_NUM; k++) {
+    auto [count, pos] = runs[k];
+    if (!take_all && (count < 2 || static_cast<double>(count) <= 1.25 * avg)) {
+      break;
+    }
+    auto freq = static_cast<double>(count) / static_cast<double>(values.size()) * non_null;
+    stats.mcvs_.emplace_back(values[pos], freq);
+    mcv_values.insert(values[pos]);
+    mcv_frac += freq;
+  }
+  stats.hist_frac_ = std::max(non_null - mcv_frac, 0.0);
+
+  std::vector<std::string> rest;
+  for (auto &value : values) {
+    if (mcv_values.count(value) == 0) {
+      rest.push_back(std::move(value));
+    }
+  }
+  if (rest.empty()) {
+    return;
+  }
+  auto bucket_num = std::min(STATS_BUCKET_NUM, rest.size());
+  for (size_t k = 0; k <= bucket_num; k++) {
+    stats.bounds_.push_back(rest[k * (rest.size() - 1) / bucket_num]);
+  }
+}
+
+}  // namespace wsdb
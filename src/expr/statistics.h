@@ -0,0 +1,146 @@
+/*------------------------------------------------------------------------------
+ - Copyright (c) 2024. Websoft research group, Nanjing University.
+ -
+ - This program is free software: you can redistribute it and/or modify
+ - it under the terms of the GNU General Public License as published by
+ - the Free Software Foundation, either version 3 of the License, or
+ - (at your option) any later version.
+ -
+ - This program is distributed in the hope that it will be useful,
+ - but WITHOUT ANY WARRANTY; without even the implied warranty of
+ - MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ - GNU General Public License for more details.
+ -
+ - You should have received a copy of the GNU General Public License
+ - along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ -----------------------------------------------------------------------------*/
+
+/**
+ * @brief Table and column statistics collected by ANALYZE, used by the optimizer to estimate the selectivity of
+ * predicates and the sizes of intermediate results. For every column it keeps the null fraction, the number of
+ * distinct values estimated by HyperLogLog, the most common values with their frequencies and an equi-depth
+ * histogram of the other values. Histograms and most common values are built from a reservoir sample.
+ *
+ * Values are kept as keys of StatKey: numbers as ordered doubles, so int and float values compare with each other,
+ * and strings as their bytes. The statistics of a table are stored in a file next to the table and cached.
+ */
+
+#ifndef WSDB_STATISTICS_H
+#define WSDB_STATISTICS_H
+
+#include <istream>
+#include <optional>
+#include <ostream>
+#include <random>
+#include "common/condition.h"
+#include "common/config.h"
+#include "common/hyperloglog.h"
+#include "system/handle/table_handle.h"
+
+namespace wsdb {
+
+struct ColumnStats
+{
+  double null_frac_{0};  // fraction of the rows holding null
+  double ndv_{0};        // estimated number of distinct non-null values
+  // most common values and the fractions of the rows holding them
+  std::vector<std::pair<std::string, double>> mcvs_;
+  // fraction of the rows described by the histogram, i.e. non-null rows not holding a most common value
+  double hist_frac_{0};
+  // bounds of the equi-depth histogram, bucket i holds about the same number of values in [bounds_[i], bounds_[i+1]]
+  std::vector<std::string> bounds_;
+};
+
+class TableStats
+{
+public:
+  /// @param schema schema of the table, columns are in its order
+  explicit TableStats(const RecordSchema &schema);
+
+  DISABLE_COPY_MOVE_AND_ASSIGN(TableStats)
+
+  /// statistics of a table loaded from its file, nullptr if the table has not been analyzed or its schema changed
+  static auto Get(const std::string &db_name, TableHandle *tab) -> std::shared_ptr<TableStats>;
+
+  /// store the statistics of a table in its file, replacing the old ones
+  static void Save(const std::string &db_name, const std::string &tab_name, std::shared_ptr<TableStats> stats);
+
+  /// remove the statistics of a table, e.g. the table has been dropped or created again
+  static void Drop(const std::string &db_name, const std::string &tab_name);
+
+  /// number of rows when the table was analyzed
+  [[nodiscard]] auto GetRowNum() const -> size_t { return row_num_; }
+
+  /// statistics of a field of the table, nullptr if the field is not in the table
+  [[nodiscard]] auto GetColumn(const RTField &field) const -> const ColumnStats *;
+
+  [[nodiscard]] auto GetColumn(size_t col) const -> const ColumnStats & { return columns_[col]; }
+
+  /// estimated fraction of the rows satisfying cond, cond compares a field of the table with a constant or a field
+  [[nodiscard]] auto EstimateSelectivity(const Condition &cond) const -> double;
+
+  /// estimated fraction of the rows satisfying two columns equal to each other, each belonging to some table
+  static auto EstimateJoinSelectivity(const ColumnStats *lhs, const ColumnStats *rhs) -> double;
+
+  /// selectivity assumed for cond when there are no statistics
+  static auto DefaultSelectivity(const Condition &cond) -> double;
+
+  /// key of a non-null value ordered like the values, nullopt for types without statistics
+  static auto StatKey(const Value &value) -> std::optional<std::string>;
+
+  void Serialize(std::ostream &out) const;
+
+  /// statistics read by Serialize, nullptr if they are corrupted or do not match schema
+  static auto Deserialize(std::istream &in, const RecordSchema &schema) -> std::shared_ptr<TableStats>;
+
+private:
+  friend class TableStatsBuilder;
+
+  /// fraction of the rows whose values are less than key, or equal to key if inclusive
+  static auto LessFrac(const ColumnStats &col, const std::string &key, bool inclusive, bool is_number) -> double;
+
+  /// fraction of the rows whose values equal key
+  static auto EqualFrac(const ColumnStats &col, const std::string &key) -> double;
+
+  /// fraction of the histogram values less than key
+  static auto HistFrac(const ColumnStats &col, const std::string &key, bool is_number) -> double;
+
+private:
+  RecordSchemaUptr         schema_;
+  size_t                   row_num_{0};
+  std::vector<ColumnStats> columns_;
+};
+
+DEFINE_SHARED_PTR(TableStats);
+
+/// collects the statistics of a table from all of its records
+class TableStatsBuilder
+{
+public:
+  /// @param sample_size number of values kept per column for histograms and most common values
+  explicit TableStatsBuilder(const RecordSchema &schema, size_t sample_size = ANALYZE_SAMPLE_SIZE);
+
+  void Add(const Record &record);
+
+  [[nodiscard]] auto Finish() -> TableStatsSptr;
+
+private:
+  struct ColumnSample
+  {
+    size_t                   null_num_{0};
+    size_t                   value_num_{0};  // non-null values seen
+    HyperLogLog              hll_;
+    std::vector<std::string> sample_;  // reservoir of non-null values
+  };
+
+  void FinishColumn(const ColumnSample &sample, ColumnStats &stats) const;
+
+  TableStatsSptr            stats_;
+  size_t                    sample_size_;
+  std::vector<ColumnSample> samples_;
+  std::mt19937_64           gen_{42};
+};
+
+}  // namespace wsdb
+
+#endif  // WSDB_STATISTICS_H
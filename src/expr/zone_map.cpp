@@ -0,0 +1,242 @@
+/*------------------------------------------------------------------------------
+ - Copyright (c) 2024. Websoft research group, Nanjing University.
+ -
+ - This program is free software: you can redistribute it and/or modify
+ - it under the terms of the GNU General Public License as published by
+ - the Free Software Foundation, either version 3 of the License, or
+ - (at your option) any later version.
+ -
+ - This program is distributed in the hope that it will be useful,
+ - but WITHOUT ANY WARRANTY; without even the implied warranty of
+ - MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ - GNU General Public License for more details.
+ -
+ - You should have received a copy of the GNU General Public License
+ - along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ -----------------------------------------------------------------------------*/
+
+#include "zone_map.h"
+#include <map>
+#include <mutex>
+
+namespace wsdb {
+
+namespace {
+struct ZoneMapRegistry
+{
+  std::mutex                         mutex_;
+  std::map<std::string, ZoneMapSptr> zone_maps_;  // "db.table" -> zone map
+
+  static auto Instance() -> ZoneMapRegistry &
+  {
+    static ZoneMapRegistry registry;
+    return registry;
+  }
+};
+}  // namespace
+
+ZoneMap::ZoneMap(const RecordSchema &schema) : schema_(std::make_unique<RecordSchema>(schema.GetFields()))
+{
+  col_schemas_.reserve(schema_->GetFieldCount());
+  encoders_.reserve(schema_->GetFieldCount());
+  for (const auto &field : schema_->GetFields()) {
+    col_schemas_.push_back(std::make_unique<RecordSchema>(std::vector<RTField>{field}));
+    encoders_.emplace_back(col_schemas_.back().get(), schema_.get());
+  }
+}
+
+auto ZoneMap::Get(const std::string &db_name, TableHandle *tab) -> ZoneMapSptr
+{
+  auto            &registry = ZoneMapRegistry::Instance();
+  std::scoped_lock lock(registry.mutex_);
+  auto            &zone_map = registry.zone_maps_[db_name + "." + tab->GetTableName()];
+  if (zone_map == nullptr || zone_map->schema_->GetFields() != tab->GetSchema().GetFields()) {
+    zone_map = std::make_shared<ZoneMap>(tab->GetSchema());
+  }
+  return zone_map;
+}
+
+void ZoneMap::Drop(const std::string &db_name, const std::string &tab_name)
+{
+  auto            &registry = ZoneMapRegistry::Instance();
+  std::scoped_lock lock(registry.mutex_);
+  registry.zone_maps_.erase(db_name + "." + tab_name);
+}
+
+auto ZoneMap::HasZone(page_id_t page_id, const RecordSchema *schema) const -> bool
+{
+  std::shared_lock lock(latch_);
+  auto             it = zones_.find(page_id);
+  if (it == zones_.end()) {
+    return false;
+  }
+  return std::all_of(schema->GetFields().begin(), schema->GetFields().end(), [this, &it](const RTField &field) {
+    auto col = schema_->GetRTFieldIndex(field);
+    return col == schema_->GetFieldCount() || it->second[col].valid_;
+  });
+}
+
+void ZoneMap::BuildZone(page_id_t page_id, const std::vector<RecordUptr> &records, uint64_t version)
+{
+  // an empty page has empty zones for all columns, any predicate skips it until a record is added
+  PageZone zone(schema_->GetFieldCount());
+  if (records.empty()) {
+    for (auto &col_zone : zone) {
+      col_zone.valid_ = true;
+    }
+  } else {
+    const auto *schema = records.front()->GetSchema();
+    for (size_t i = 0; i < schema->GetFieldCount(); i++) {
+      auto col = schema_->GetRTFieldIndex(schema->GetFieldAt(i));
+      if (col == schema_->GetFieldCount()) {
+        continue;
+      }
+      zone[col].valid_ = true;
+      for (const auto &rec : records) {
+        Widen(zone[col], col, rec->GetValueAt(i));
+      }
+    }
+  }
+  std::unique_lock lock(latch_);
+  if (version_.load() != version) {
+    return;
+  }
+  auto &page_zone = zones_[page_id];
+  if (page_zone.empty()) {
+    page_zone = std::move(zone);
+    return;
+  }
+  for (size_t col = 0; col < zone.size(); col++) {
+    if (zone[col].valid_) {
+      page_zone[col] = std::move(zone[col]);
+    }
+  }
+}
+
+void ZoneMap::Add(page_id_t page_id, const Record &record)
+{
+  std::unique_lock lock(latch_);
+  version_++;
+  auto it = zones_.find(page_id);
+  if (it == zones_.end()) {
+    return;
+  }
+  auto                &page_zone = it->second;
+  const auto          *schema    = record.GetSchema();
+  std::vector<uint8_t> seen(page_zone.size(), 0);
+  for (size_t i = 0; i < schema->GetFieldCount(); i++) {
+    auto col = schema_->GetRTFieldIndex(schema->GetFieldAt(i));
+    if (col == schema_->GetFieldCount()) {
+      continue;
+    }
+    seen[col] = 1;
+    if (page_zone[col].valid_) {
+      Widen(page_zone[col], col, record.GetValueAt(i));
+    }
+  }
+  // a column missing from the record may have any value now
+  for (size_t col = 0; col < page_zone.size(); col++) {
+    if (seen[col] == 0) {
+      page_zone[col] = ColumnZone{};
+    }
+  }
+}
+
+auto ZoneMap::CanSkip(page_id_t page_id, const ConditionVec &conds) const -> bool
+{
+  std::shared_lock lock(latch_);
+  auto             it = zones_.find(page_id);
+  return it != zones_.end() && CanSkip(it->second, conds);
+}
+
+auto ZoneMap::CountSkipped(const ConditionVec &conds) const -> size_t
+{
+  std::shared_lock lock(latch_);
+  return static_cast<size_t>(std::count_if(
+      zones_.begin(), zones_.end(), [this, &conds](const auto &page) { return CanSkip(page.second, conds); }));
+}
+
+void ZoneMap::Widen(ColumnZone &zone, size_t col, const ValueSptr &value) const
+{
+  if (value->IsNull()) {
+    zone.null_num_++;
+    return;
+  }
+  auto key = encoders_[col].EncodeValues({value});
+  if (zone.min_.empty() || key < zone.min_) {
+    zone.min_ = key;
+  }
+  if (zone.max_.empty() || zone.max_ < key) {
+    zone.max_ = key;
+  }
+}
+
+auto ZoneMap::CanSkip(const PageZone &zone, const ConditionVec &conds) const -> bool
+{
+  // the conditions are a conjunction, one of them failing on the whole page is enough
+  return std::any_of(conds.begin(), conds.end(), [this, &zone](const Condition &cond) {
+    auto col = schema_->GetRTFieldIndex(cond.GetLCol());
+    return col != schema_->GetFieldCount() && CanSkip(zone[col], col, cond);
+  });
+}
+
+auto ZoneMap::CanSkip(const ColumnZone &zone, size_t col, const Condition &cond) const -> bool
+{
+  if (!zone.valid_ || cond.GetRhsType() != kValue) {
+    return false;
+  }
+  // encoded keys compare as unsigned bytes, the same as std::string
+  if (cond.GetOp() == OP_IN) {
+    auto list = std::dynamic_pointer_cast<ArrayValue>(cond.GetRVal());
+    if (list == nullptr) {
+      return false;
+    }
+    for (const auto &val : list->Get()) {
+      std::string key;
+      if (!EncodeConstant(col, val, key) || (!zone.min_.empty() && zone.min_ <= key && key <= zone.max_)) {
+        return false;
+      }
+    }
+    return true;
+  }
+  std::string key;
+  if (!EncodeConstant(col, cond.GetRVal(), key)) {
+    return false;
+  }
+  // a null differs from any constant, and satisfies no other comparison
+  if (cond.GetOp() == OP_NE) {
+    return zone.null_num_ == 0 && (zone.min_.empty() || (zone.min_ == key && zone.max_ == key));
+  }
+  if (zone.min_.empty()) {
+    return true;
+  }
+  switch (cond.GetOp()) {
+    case OP_EQ: return key < zone.min_ || zone.max_ < key;
+    case OP_LT: return zone.min_ >= key;
+    case OP_LE: return zone.min_ > key;
+    case OP_GT: return zone.max_ <= key;
+    case OP_GE: return zone.max_ < key;
+    default: return false;
+  }
+}
+
+auto ZoneMap::EncodeConstant(size_t col, const ValueSptr &value, std::string &key) const -> bool
+{
+  if (value == nullptr || value->IsNull()) {
+    return false;
+  }
+  const auto &field = schema_->GetFieldAt(col).field_;
+  auto        type  = value->GetType();
+  // an int column compared with a float constant is compared as float, so its int bounds are not comparable
+  if (type != field.field_type_ && !(type == TYPE_INT && field.field_type_ == TYPE_FLOAT)) {
+    return false;
+  }
+  // a longer string would be truncated to the field width
+  if (type == TYPE_STRING && std::dynamic_pointer_cast<StringValue>(value)->Get().size() > field.field_size_) {
+    return false;
+  }
+  key = encoders_[col].EncodeValues({value});
+  return true;
+}
+
+}  // namespace wsdb
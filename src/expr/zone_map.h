@@ -0,0 +1,109 @@
+/*------------------------------------------------------------------------------
+ - Copyright (c) 2024. Websoft research group, Nanjing University.
+ -
+ - This program is free software: you can redistribute it and/or modify
+ - it under the terms of the GNU General Public License as published by
+ - the Free Software Foundation, either version 3 of the License, or
+ - (at your option) any later version.
+ -
+ - This program is distributed in the hope that it will be useful,
+ - but WITHOUT ANY WARRANTY; without even the implied warranty of
+ - MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ - GNU General Public License for more details.
+ -
+ - You should have received a copy of the GNU General Public License
+ - along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ -----------------------------------------------------------------------------*/
+
+/**
+ * @brief Per page min/max and null counts of every column of a table. A page whose zone shows that no record can
+ * satisfy a pushed-down predicate is skipped by the table scan without being read.
+ *
+ * A zone is a superset of the values on its page: inserts and updates widen it, deletes leave it as it is. Zones are
+ * built by the scans from pages they read completely, a page without a zone is never skipped. The bounds are stored as
+ * sort keys (see SortKeyEncoder), so they compare with memcmp. Writers to a table other than the dml executors should
+ * call Add as well, or Drop the zone map of the table.
+ */
+
+#ifndef WSDB_ZONE_MAP_H
+#define WSDB_ZONE_MAP_H
+
+#include <atomic>
+#include <shared_mutex>
+#include <unordered_map>
+#include "common/condition.h"
+#include "expr/sort_key.h"
+#include "system/handle/table_handle.h"
+
+namespace wsdb {
+
+class ZoneMap
+{
+public:
+  /// @param schema schema of the table
+  explicit ZoneMap(const RecordSchema &schema);
+
+  DISABLE_COPY_MOVE_AND_ASSIGN(ZoneMap)
+
+  /// the zone map of a table of a database, created empty at the first call or when the schema has changed
+  static auto Get(const std::string &db_name, TableHandle *tab) -> std::shared_ptr<ZoneMap>;
+
+  /// forget the zone map of a table, e.g. the table has been dropped or created again
+  static void Drop(const std::string &db_name, const std::string &tab_name);
+
+  /// changes of the zones so far, taken before a page is read and passed to BuildZone
+  [[nodiscard]] auto GetVersion() const -> uint64_t { return version_.load(); }
+
+  /// whether the page has zones for all fields of schema
+  [[nodiscard]] auto HasZone(page_id_t page_id, const RecordSchema *schema) const -> bool;
+
+  /**
+   * set the zones of the fields of the records from all records of a page, the records share a schema made of fields
+   * of the table. Ignored if the zone map has been changed since version was taken, the page may have changed too
+   */
+  void BuildZone(page_id_t page_id, const std::vector<RecordUptr> &records, uint64_t version);
+
+  /// widen the zones of the page by an inserted or updated record
+  void Add(page_id_t page_id, const Record &record);
+
+  /// whether no record of the page can satisfy all conds
+  [[nodiscard]] auto CanSkip(page_id_t page_id, const ConditionVec &conds) const -> bool;
+
+  /// number of pages with zones that can be skipped for conds
+  [[nodiscard]] auto CountSkipped(const ConditionVec &conds) const -> size_t;
+
+private:
+  struct ColumnZone
+  {
+    bool        valid_{false};
+    std::string min_;  // encoded bounds of the non-null values, empty if there is none
+    std::string max_;
+    size_t      null_num_{0};
+  };
+
+  using PageZone = std::vector<ColumnZone>;
+
+  void Widen(ColumnZone &zone, size_t col, const ValueSptr &value) const;
+
+  [[nodiscard]] auto CanSkip(const PageZone &zone, const ConditionVec &conds) const -> bool;
+
+  /// whether no value in the zone satisfies cond, false if it can not be told
+  [[nodiscard]] auto CanSkip(const ColumnZone &zone, size_t col, const Condition &cond) const -> bool;
+
+  /// encode a constant compared with column col, false if its order can not be kept, e.g. a truncated string
+  [[nodiscard]] auto EncodeConstant(size_t col, const ValueSptr &value, std::string &key) const -> bool;
+
+private:
+  RecordSchemaUptr                        schema_;
+  std::vector<RecordSchemaUptr>           col_schemas_;  // one schema per column for its encoder
+  std::vector<SortKeyEncoder>             encoders_;
+  mutable std::shared_mutex               latch_;
+  std::unordered_map<page_id_t, PageZone> zones_;
+  std::atomic<uint64_t>                   version_{0};
+};
+
+DEFINE_SHARED_PTR(ZoneMap);
+
+}  // namespace wsdb
+
+#endif  // WSDB_ZONE_MAP_H
@@ -21,14 +21,30 @@
 
 #include "net_controller.h"
 
+#include <sys/epoll.h>
+#include <sys/eventfd.h>
+#include <sys/resource.h>
 #include <sys/socket.h>
 #include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <fcntl.h>
+#include <poll.h>
+#include <cerrno>
 
 namespace wsdb {
-NetController::NetController()
+
+// events taken from epoll at a time
+static constexpr int EPOLL_EVENT_NUM = 256;
+// bytes of requests buffered for a connection before the loop stops reading from it
+static constexpr size_t READ_BUFFER_LIMIT = 2 * net::NET_BUFFER_SIZE;
+
+thread_local int                        NetController::current_fd_   = -1;
+thread_local NetController::Connection *NetController::current_conn_ = nullptr;
+
+NetController::NetController(int port)
 {
   max_client_  = net::MAX_CLIENTS;
-  listen_port_ = net::SERVER_PORT;
+  listen_port_ = port;
 }
 
 auto NetController::Listen() -> int
@@ -44,6 +60,9 @@ auto NetController::Listen() -> int
     WSDB_LOG("ERROR opening socket");
     return -1;
   }
+  // connections closed by the server stay in TIME_WAIT, which must not keep a restarted server from binding
+  int reuse = 1;
+  setsockopt(server_fd_, SOL_SOCKET, SO_REUSEADDR, &reuse, sizeof(reuse));
   bzero((char *)&serv_addr, sizeof(serv_addr));
   serv_addr.sin_family      = AF_INET;
   serv_addr.sin_addr.s_addr = INADDR_ANY;
@@ -52,10 +71,14 @@ auto NetController::Listen() -> int
     WSDB_LOG("ERROR on binding");
     return -1;
   }
-  if (listen(server_fd_, max_client_) < 0) {
+  if (listen(server_fd_, SOMAXCONN) < 0) {
     WSDB_LOG("ERROR on listen");
     return -1;
   }
+  socklen_t len = sizeof(serv_addr);
+  if (listen_port_ == 0 && getsockname(server_fd_, (struct sockaddr *)&serv_addr, &len) == 0) {
+    listen_port_ = ntohs(serv_addr.sin_port);
+  }
   return 0;
 }
 auto NetController::Accept() const -> int
@@ -72,9 +95,84 @@ auto NetController::Accept() const -> int
   return client_sock;
 }
 void NetController::Close() const { close(server_fd_); }
+
+void NetController::Serve(size_t worker_num, QueryHandler on_query, CloseHandler on_close)
+{
+  WSDB_ASSERT(server_fd_ > 0, "Listen before Serve");
+  on_query_ = std::move(on_query);
+  on_close_ = std::move(on_close);
+  // every connection takes a file descriptor
+  rlimit limit{};
+  auto   fd_num = static_cast<rlim_t>(max_client_) + 64;
+  if (getrlimit(RLIMIT_NOFILE, &limit) == 0 && limit.rlim_cur < fd_num) {
+    limit.rlim_cur = std::min(limit.rlim_max, fd_num);
+    setrlimit(RLIMIT_NOFILE, &limit);
+  }
+  fcntl(server_fd_, F_SETFL, fcntl(server_fd_, F_GETFL) | O_NONBLOCK);
+  epoll_fd_ = epoll_create1(EPOLL_CLOEXEC);
+  wake_fd_  = eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+  if (epoll_fd_ < 0 || wake_fd_ < 0) {
+    WSDB_FETAL(fmt::format("cannot create epoll instance: {}", strerror(errno)));
+  }
+  epoll_event ev{};
+  ev.events  = EPOLLIN;
+  ev.data.fd = server_fd_;
+  epoll_ctl(epoll_fd_, EPOLL_CTL_ADD, server_fd_, &ev);
+  ev.data.fd = wake_fd_;
+  epoll_ctl(epoll_fd_, EPOLL_CTL_ADD, wake_fd_, &ev);
+  read_buf_.resize(net::NET_BUFFER_SIZE);
+  max_waiting_ = std::max<size_t>(1, worker_num / 2);
+  {
+    ThreadPool workers(worker_num);
+    workers_ = &workers;
+    std::vector<epoll_event> events(EPOLL_EVENT_NUM);
+    while (!stop_) {
+      int n = epoll_wait(epoll_fd_, events.data(), EPOLL_EVENT_NUM, -1);
+      if (n < 0 && errno != EINTR) {
+        WSDB_FETAL(fmt::format("epoll_wait failed: {}", strerror(errno)));
+      }
+      for (int i = 0; i < n; i++) {
+        int fd = events[i].data.fd;
+        if (fd == server_fd_) {
+          AcceptAll();
+        } else if (fd != wake_fd_) {
+          HandleEvent(fd, events[i].events);
+        }
+      }
+    }
+    // the running statements finish here, and do not start the next ones
+  }
+  workers_ = nullptr;
+  std::vector<int> fds;
+  {
+    std::scoped_lock lock(conns_mutex_);
+    for (auto &[fd, conn] : conns_) {
+      if (conn->evented_) {
+        fds.push_back(fd);
+      }
+    }
+  }
+  for (auto fd : fds) {
+    CloseConnection(fd);
+  }
+  close(wake_fd_);
+  close(epoll_fd_);
+  wake_fd_  = -1;
+  epoll_fd_ = -1;
+  stop_     = false;
+}
+
+void NetController::Stop()
+{
+  stop_ = true;
+  if (wake_fd_ >= 0) {
+    uint64_t one = 1;
+    [[maybe_unused]] auto n = write(wake_fd_, &one, sizeof(one));
+  }
+}
 auto NetController::ReadSQL(int fd) -> std::string
 {
-  auto &pkg_ = client_buffer_[fd];
+  auto &pkg_ = GetConnection(fd).Pkg();
   auto  err  = net::ReadNetPkg(fd, pkg_);
   if (err <= 0) {
     WSDB_THROW(WSDB_CLIENT_DOWN, "");
@@ -88,104 +186,434 @@ auto NetController::ReadSQL(int fd) -> std::string
 
 void NetController::SendRecHeader(int fd, const RecordSchema *header)
 {
-  // header format: {field_name}\t{field_name}\t ...
-  auto &pkg_ = client_buffer_[fd];
-  pkg_.type_ = net::NET_PKG_REC_HEADER;
-  std::string header_str;
-  for (int i = 0; i < static_cast<int>(header->GetFieldCount()); ++i) {
+  std::vector<net::NetColumn> columns(header->GetFieldCount());
+  for (size_t i = 0; i < header->GetFieldCount(); ++i) {
     auto &field = header->GetFieldAt(i);
+    auto &name  = columns[i].name_;
     // check alias
     if (field.alias_.empty()) {
       if (field.is_agg_) {
         if (field.agg_type_ == AGG_COUNT_STAR) {
-          header_str += AggTypeToString(field.agg_type_);
+          name = AggTypeToString(field.agg_type_);
         } else {
-          header_str += fmt::format("{}({})", AggTypeToString(field.agg_type_), field.field_.field_name_);
+          name = fmt::format("{}({})", AggTypeToString(field.agg_type_), field.field_.field_name_);
         }
       } else {
-        header_str += field.field_.field_name_;
+        name = field.field_.field_name_;
       }
     } else {
-      header_str += field.alias_;
+      name = field.alias_;
+    }
+    switch (field.field_.field_type_) {
+      case TYPE_INT: columns[i].type_ = net::NET_FIELD_INT; break;
+      case TYPE_FLOAT: columns[i].type_ = net::NET_FIELD_FLOAT; break;
+      case TYPE_BOOL: columns[i].type_ = net::NET_FIELD_BOOL; break;
+      case TYPE_STRING: columns[i].type_ = net::NET_FIELD_STRING; break;
+      default: WSDB_FETAL(fmt::format("unsupported field type {}", FieldTypeToString(field.field_.field_type_)));
     }
-    header_str += '\t';
   }
-  pkg_.len_ = header_str.size();
-  memcpy(pkg_.buf_, header_str.c_str(), pkg_.len_);
-  FlushSend(fd);
+  net::EncodeRecHeader(columns, GetConnection(fd).Pkg());
+  QueueSend(fd);
 }
 void NetController::SendRec(int fd, const Record *rec)
 {
-  // append record to buffer and flush if buffer is full
-  auto &pkg_ = client_buffer_[fd];
-  pkg_.type_ = net::NET_PKG_REC_BODY;
-  // record format: {field_value}\t{field_value}\t ...
-  std::string rec_str;
-  for (int i = 0; i < static_cast<int>(rec->GetSchema()->GetFieldCount()); ++i) {
-    auto v = rec->GetValueAt(i);
-    rec_str += v->ToString();
-    rec_str += '\t';
-  }
-  // FIXME: accumulate records and send, may cause client waiting sometimes
-  //  if (pkg_.len_ + rec_str.size() > net::NET_BUFFER_SIZE) {
-  //    FlushSend(fd);
-  //  }
-  memcpy(pkg_.buf_ + pkg_.len_, rec_str.c_str(), rec_str.size());
-  // add '\0' to separate records
-  pkg_.len_ += rec_str.size();
-  pkg_.buf_[pkg_.len_++] = '\0';
-  FlushSend(fd);
+  auto &conn = GetConnection(fd);
+  auto &pkg_ = conn.Pkg();
+  auto  now  = std::chrono::steady_clock::now();
+  if (pkg_.type_ != net::NET_PKG_REC_BODY || pkg_.len_ == 0) {
+    pkg_.type_  = net::NET_PKG_REC_BODY;
+    pkg_.len_   = 0;
+    conn.since_ = now;
+  }
+  size_t len = 0;
+  if (!EncodeRec(*rec, pkg_.buf_ + pkg_.len_, net::NET_BUFFER_SIZE - pkg_.len_, len)) {
+    WSDB_ASSERT(pkg_.len_ > 0, "record does not fit in an empty package");
+    QueueSend(fd);
+    pkg_.type_  = net::NET_PKG_REC_BODY;
+    conn.since_ = now;
+    EncodeRec(*rec, pkg_.buf_, net::NET_BUFFER_SIZE, len);
+  }
+  pkg_.len_ += len;
+  if (now - conn.since_ >= std::chrono::milliseconds(net::NET_FLUSH_INTERVAL_MS)) {
+    FlushSend(fd);
+  }
 }
 void NetController::SendRecFinish(int fd)
 {
-  auto &pkg_ = client_buffer_[fd];
-  //  if (pkg_.type_ == net::NET_PKG_REC_BODY) {
-  //    FlushSend(fd);
-  //  }
+  auto &pkg_ = GetConnection(fd).Pkg();
+  if (pkg_.type_ == net::NET_PKG_REC_BODY && pkg_.len_ > 0) {
+    QueueSend(fd);
+  }
   pkg_.type_ = net::NET_PKG_REC_END;
   pkg_.len_  = 0;
-  FlushSend(fd);
+  QueueSend(fd);
 }
 void NetController::SendError(int fd, const std::string &error_msg)
 {
-  auto &pkg_ = client_buffer_[fd];
+  auto &pkg_ = GetConnection(fd).Pkg();
   pkg_.type_ = net::NET_PKG_ERROR;
   pkg_.len_  = error_msg.size();
   memcpy(pkg_.buf_, error_msg.c_str(), pkg_.len_);
-  FlushSend(fd);
+  QueueSend(fd);
 }
 
 void NetController::SendOK(int fd)
 {
-  auto &pkg_ = client_buffer_[fd];
+  auto &pkg_ = GetConnection(fd).Pkg();
   pkg_.type_ = net::NET_PKG_OK;
   pkg_.len_  = 0;
-  FlushSend(fd);
+  QueueSend(fd);
 }
 
 void NetController::SendRawString(int fd, const std::string &str)
 {
-  auto &pkg_ = client_buffer_[fd];
+  auto &pkg_ = GetConnection(fd).Pkg();
   pkg_.type_ = net::NET_PKG_RAW_STRING;
   pkg_.len_  = str.size();
   memcpy(pkg_.buf_, str.c_str(), pkg_.len_);
-  FlushSend(fd);
+  QueueSend(fd);
 }
 
 void NetController::FlushSend(int fd)
 {
-  auto err = net::WriteNetPkg(fd, client_buffer_[fd]);
-  if (err <= 0) {
+  auto &conn = GetConnection(fd);
+  auto &pkg_ = conn.Pkg();
+  net::AppendNetPkg(pkg_, conn.wbuf_);
+  pkg_.len_ = 0;
+  // a blocking socket has no one else to send the rest
+  if (!WriteOut(fd, conn, conn.evented_ ? net::NET_WRITE_BUFFER_LIMIT : 0)) {
     WSDB_THROW(WSDB_CLIENT_DOWN, "");
   }
-  client_buffer_[fd].len_ = 0;
+}
+
+void NetController::QueueSend(int fd)
+{
+  auto &conn = GetConnection(fd);
+  if (conn.evented_ && conn.Pending() + conn.Pkg().len_ < net::NET_BUFFER_SIZE) {
+    // sent together with the rest of the response when the statement ends
+    net::AppendNetPkg(conn.Pkg(), conn.wbuf_);
+    conn.Pkg().len_ = 0;
+    return;
+  }
+  FlushSend(fd);
+}
+
+auto NetController::EncodeRec(const Record &rec, char *dst, size_t size, size_t &len) -> bool
+{
+  const auto *schema       = rec.GetSchema();
+  size_t      nullmap_size = BITMAP_SIZE(schema->GetFieldCount());
+  if (nullmap_size > size) {
+    return false;
+  }
+  const char *data    = rec.GetData();
+  const char *nullmap = rec.GetNullMap();
+  memset(dst, 0, nullmap_size);
+  len = nullmap_size;
+  for (size_t i = 0; i < schema->GetFieldCount(); data += schema->GetFieldAt(i).field_.field_size_, ++i) {
+    const auto &field = schema->GetFieldAt(i).field_;
+    if (BitMap::GetBit(nullmap, i)) {
+      BitMap::SetBit(dst, i, true);
+      continue;
+    }
+    switch (field.field_type_) {
+      case TYPE_INT:
+      case TYPE_FLOAT:
+        if (len + 4 > size) {
+          return false;
+        }
+        memcpy(dst + len, data, 4);
+        len += 4;
+        break;
+      case TYPE_BOOL:
+        if (len + 1 > size) {
+          return false;
+        }
+        dst[len++] = *data != 0 ? 1 : 0;
+        break;
+      case TYPE_STRING: {
+        auto str_len = static_cast<uint16_t>(strnlen(data, field.field_size_));
+        if (len + sizeof(str_len) + str_len > size) {
+          return false;
+        }
+        memcpy(dst + len, &str_len, sizeof(str_len));
+        memcpy(dst + len + sizeof(str_len), data, str_len);
+        len += sizeof(str_len) + str_len;
+        break;
+      }
+      default: WSDB_FETAL(fmt::format("unsupported field type {}", FieldTypeToString(field.field_type_)));
+    }
+  }
+  return true;
 }
 
 void NetController::Remove(int fd)
 {
-  if (client_buffer_.find(fd) != client_buffer_.end()) {
-    client_buffer_.erase(fd);
+  std::scoped_lock lock(conns_mutex_);
+  auto             it = conns_.find(fd);
+  if (it != conns_.end()) {
+    buffered_ -= it->second->buffered_;
+    conns_.erase(it);
+  }
+}
+
+void NetController::Account(Connection &conn)
+{
+  auto pending = conn.Pending();
+  auto old     = conn.buffered_.exchange(pending);
+  buffered_ += pending;
+  buffered_ -= old;
+}
+
+auto NetController::DropLargest(int fd) -> bool
+{
+  std::scoped_lock lock(conns_mutex_);
+  int              victim = fd;
+  size_t           size   = 0;
+  for (auto &[conn_fd, conn] : conns_) {
+    if (conn->buffered_ > size) {
+      victim = conn_fd;
+      size   = conn->buffered_;
+    }
+  }
+  WSDB_LOG(fmt::format("{} bytes are pending in all, drop client {} with {} of them", buffered_.load(), victim, size));
+  if (victim == fd) {
+    return true;
+  }
+  // the socket is open while it is in conns_, the owner of the connection closes it once sending to it fails. its
+  // bytes are not counted till then, so that it is not dropped again
+  buffered_ -= conns_[victim]->buffered_.exchange(0);
+  shutdown(victim, SHUT_RDWR);
+  return false;
+}
+
+auto NetController::GetConnection(int fd) -> Connection &
+{
+  if (fd == current_fd_) {
+    return *current_conn_;
+  }
+  std::scoped_lock lock(conns_mutex_);
+  auto &conn = conns_[fd];
+  if (conn == nullptr) {
+    conn = std::make_unique<Connection>();
+  }
+  return *conn;
+}
+
+auto NetController::WriteOut(int fd, Connection &conn, size_t limit) -> bool
+{
+  while (true) {
+    while (conn.Pending() > 0) {
+      auto n = send(fd, conn.wbuf_.data() + conn.wpos_, conn.Pending(), MSG_DONTWAIT | MSG_NOSIGNAL);
+      if (n > 0) {
+        conn.wpos_ += n;
+      } else if (n < 0 && errno == EAGAIN) {
+        break;
+      } else if (n == 0 || errno != EINTR) {
+        return false;
+      }
+    }
+    if (conn.Pending() == 0) {
+      conn.wbuf_.clear();
+      conn.wpos_ = 0;
+      // do not keep the memory of a large result with an idle connection
+      if (conn.wbuf_.capacity() > 2 * net::NET_BUFFER_SIZE) {
+        conn.wbuf_.shrink_to_fit();
+      }
+    } else if (conn.wpos_ >= net::NET_BUFFER_SIZE && conn.wpos_ >= conn.Pending()) {
+      conn.wbuf_.erase(0, conn.wpos_);
+      conn.wpos_ = 0;
+    }
+    Account(conn);
+    if (conn.Pending() <= limit) {
+      return true;
+    }
+    if (!conn.evented_) {
+      // a blocking socket has no one else to send the rest, wait as long as the client reads
+      pollfd pfd{fd, POLLOUT, 0};
+      int    ready = poll(&pfd, 1, net::NET_WRITE_TIMEOUT_MS);
+      if (ready == 0) {
+        WSDB_LOG(fmt::format("client {} read no results for {}ms", fd, net::NET_WRITE_TIMEOUT_MS));
+        return false;
+      }
+      if (ready < 0 && errno != EINTR) {
+        return false;
+      }
+      continue;
+    }
+    // backpressure, the statement waits for its client if that leaves enough workers to the other connections
+    auto budget = std::chrono::milliseconds(net::NET_WRITE_TIMEOUT_MS) - conn.waited_;
+    if (budget.count() <= 0 || waiting_.fetch_add(1) >= max_waiting_) {
+      if (budget.count() > 0) {
+        waiting_--;
+      }
+      if (conn.Pending() > net::NET_WRITE_BUFFER_MAX) {
+        WSDB_LOG(fmt::format("client {} reads too slowly, {} bytes are pending", fd, conn.Pending()));
+        return false;
+      }
+      return buffered_ <= net::NET_WRITE_BUFFER_TOTAL || !DropLargest(fd);
+    }
+    // Stop wakes the waiting workers up through wake_fd_
+    pollfd pfds[2]{{fd, POLLOUT, 0}, {wake_fd_, POLLIN, 0}};
+    auto   start = std::chrono::steady_clock::now();
+    int    ready = poll(pfds, 2, static_cast<int>(budget.count()));
+    waiting_--;
+    conn.waited_ += std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now() - start);
+    if (stop_ || (ready < 0 && errno != EINTR)) {
+      return false;
+    }
+  }
+}
+
+auto NetController::ReadIn(int fd, Connection &conn) -> bool
+{
+  while (conn.rbuf_.size() < READ_BUFFER_LIMIT) {
+    auto n = recv(fd, read_buf_.data(), read_buf_.size(), MSG_DONTWAIT);
+    if (n > 0) {
+      conn.rbuf_.append(read_buf_.data(), n);
+    } else if (n < 0 && errno == EAGAIN) {
+      break;
+    } else if (n == 0 || errno != EINTR) {
+      return false;
+    }
+  }
+  return true;
+}
+
+void NetController::AcceptAll()
+{
+  while (true) {
+    int fd = accept4(server_fd_, nullptr, nullptr, SOCK_NONBLOCK | SOCK_CLOEXEC);
+    if (fd < 0) {
+      if (errno == EINTR) {
+        continue;
+      }
+      if (errno != EAGAIN) {
+        WSDB_LOG(fmt::format("ERROR on accept: {}", strerror(errno)));
+      }
+      return;
+    }
+    {
+      std::scoped_lock lock(conns_mutex_);
+      if (conns_.size() >= static_cast<size_t>(max_client_)) {
+        WSDB_LOG(fmt::format("refuse connection {}, {} clients connected", fd, conns_.size()));
+        close(fd);
+        continue;
+      }
+      auto &conn     = conns_[fd];
+      conn           = std::make_unique<Connection>();
+      conn->evented_ = true;
+    }
+    // responses are packed into packages already
+    int one = 1;
+    setsockopt(fd, IPPROTO_TCP, TCP_NODELAY, &one, sizeof(one));
+    epoll_event ev{};
+    ev.events  = EPOLLIN | EPOLLRDHUP | EPOLLONESHOT;
+    ev.data.fd = fd;
+    epoll_ctl(epoll_fd_, EPOLL_CTL_ADD, fd, &ev);
+  }
+}
+
+void NetController::HandleEvent(int fd, uint32_t events)
+{
+  // the connection is not armed while a worker owns it, so the loop thread owns it here
+  auto &conn  = GetConnection(fd);
+  bool  alive = (events & EPOLLERR) == 0 && !conn.closing_;
+  if (alive && (events & EPOLLOUT) != 0) {
+    alive = WriteOut(fd, conn, SIZE_MAX);
+  }
+  if (alive && (events & (EPOLLIN | EPOLLRDHUP | EPOLLHUP)) != 0) {
+    alive = ReadIn(fd, conn);
+  }
+  if (!alive || !Dispatch(fd, conn)) {
+    CloseConnection(fd);
+  }
+}
+
+auto NetController::Dispatch(int fd, Connection &conn) -> bool
+{
+  if (stop_) {
+    return true;
+  }
+  uint32_t events = EPOLLRDHUP | EPOLLONESHOT;
+  // a client not reading its results sends no more statements either
+  if (conn.Pending() <= net::NET_WRITE_BUFFER_LIMIT) {
+    net::NetPkgType  type;
+    std::string_view body;
+    ssize_t          len;
+    while ((len = net::ParseNetPkg(conn.rbuf_.data(), conn.rbuf_.size(), type, body)) > 0) {
+      if (type == net::NET_PKG_QUERY) {
+        std::string sql(body);
+        conn.rbuf_.erase(0, len);
+        workers_->Submit([this, fd, sql = std::move(sql)] { RunQuery(fd, sql); });
+        return true;
+      }
+      WSDB_LOG("ERROR: not a query package");
+      conn.rbuf_.erase(0, len);
+    }
+    if (len < 0) {
+      WSDB_LOG(fmt::format("package from {} is too large", fd));
+      return false;
+    }
+    events |= EPOLLIN;
+  }
+  if (conn.Pending() > 0) {
+    events |= EPOLLOUT;
+  }
+  epoll_event ev{};
+  ev.events  = events;
+  ev.data.fd = fd;
+  epoll_ctl(epoll_fd_, EPOLL_CTL_MOD, fd, &ev);
+  return true;
+}
+
+void NetController::RunQuery(int fd, const std::string &sql)
+{
+  auto       &conn  = GetConnection(fd);
+  bool        alive = true;
+  std::string error;
+  current_fd_   = fd;
+  current_conn_ = &conn;
+  conn.waited_  = {};
+  Session::Bind(&conn.session_);
+  try {
+    on_query_(fd, sql);
+  } catch (WSDBException_ &e) {
+    alive = e.type_ != WSDB_CLIENT_DOWN;
+    error = e.short_what();
+  } catch (std::exception &e) {
+    error = e.what();
+  }
+  if (alive && !error.empty()) {
+    try {
+      SendError(fd, error);
+    } catch (WSDBException_ &) {
+      alive = false;
+    }
+  }
+  Session::Bind(nullptr);
+  current_fd_   = -1;
+  current_conn_ = nullptr;
+  // an idle connection keeps no package
+  conn.pkg_.reset();
+  if (!alive || !WriteOut(fd, conn, SIZE_MAX) || !Dispatch(fd, conn)) {
+    // wake the loop thread up to close it
+    conn.closing_ = true;
+    shutdown(fd, SHUT_RDWR);
+    epoll_event ev{};
+    ev.events  = EPOLLIN | EPOLLONESHOT;
+    ev.data.fd = fd;
+    epoll_ctl(epoll_fd_, EPOLL_CTL_MOD, fd, &ev);
+  }
+}
+
+void NetController::CloseConnection(int fd)
+{
+  if (on_close_ != nullptr) {
+    on_close_(fd);
   }
+  epoll_ctl(epoll_fd_, EPOLL_CTL_DEL, fd, nullptr);
+  Remove(fd);
+  close(fd);
 }
 
 }  // namespace wsdb
\ No newline at end of file
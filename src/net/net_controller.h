@@ -19,11 +19,37 @@
 // Created by ziqi on 2024/8/7.
 //
 
+/**
+ * @brief Connections of the server. Serve runs an epoll loop over non-blocking sockets: the loop thread accepts
+ * connections, reads requests into per-connection buffers and writes out what is left of the responses, while a fixed
+ * pool of workers runs the statements, so an idle connection holds no thread. A connection has at most one statement
+ * running and owns its Session, which is bound to the worker running the statement.
+ *
+ * The Send functions append packages to the write buffer of the connection, which is sent once a package's worth of
+ * bytes is pending, a REC_BODY is flushed or the statement ends. A statement whose client lets more than
+ * NET_WRITE_BUFFER_LIMIT bytes pile up waits for the client to read them, and the next request of a connection is not
+ * started until its pending output is below the limit either. A waiting worker serves no other connection, so at most
+ * half of the workers wait at once, and a statement waits for NET_WRITE_TIMEOUT_MS in all. A statement that may not
+ * wait goes on and leaves its output to the loop thread, up to NET_WRITE_BUFFER_MAX bytes. When the output left by all
+ * connections passes NET_WRITE_BUFFER_TOTAL bytes, the client with the most of it is dropped.
+ *
+ * Accept and ReadSQL serve a blocking socket on the calling thread instead, the Send functions then block until the
+ * whole package is sent.
+ *
+ */
+
 #ifndef WSDB_NET_CONTROLLER_H
 #define WSDB_NET_CONTROLLER_H
+#include <atomic>
+#include <chrono>
+#include <functional>
+#include <memory>
+#include <mutex>
 #include <unordered_map>
 
+#include "common/thread_pool.h"
 #include "system/handle/record_handle.h"
+#include "system/session.h"
 #include "../common/net/net.h"
 
 namespace wsdb {
@@ -31,18 +57,37 @@ namespace wsdb {
 class NetController
 {
 public:
-  NetController();
+  /// runs sql of the connection fd on a worker, and answers through the Send functions
+  using QueryHandler = std::function<void(int fd, const std::string &sql)>;
+  /// called on the loop thread before the connection fd is closed
+  using CloseHandler = std::function<void(int fd)>;
+
+  /// port 0 listens on a port chosen by the system, see GetPort
+  explicit NetController(int port = net::SERVER_PORT);
+
   auto Listen() -> int;
 
+  [[nodiscard]] auto GetPort() const -> int { return listen_port_; }
+
   auto Accept() const -> int;
 
   void Close() const;
 
+  /**
+   * serve the connections to the listening socket with worker_num workers until Stop is called, the statements
+   * still running then are finished, except for those waiting for their clients, and all connections are closed
+   * before returning
+   */
+  void Serve(size_t worker_num, QueryHandler on_query, CloseHandler on_close = nullptr);
+
+  /// make Serve return, may be called from any thread
+  void Stop();
+
   auto ReadSQL(int fd) -> std::string;
 
   void SendRecHeader(int fd, const RecordSchema *header);
 
-  /// record will be stored until buffer is full and flush to socket
+  /// records are packed into a REC_BODY that is sent when it is full or NET_FLUSH_INTERVAL_MS after its first record
   void SendRec(int fd, const Record *rec);
 
   void SendRecFinish(int fd);
@@ -58,11 +103,87 @@ public:
   void Remove(int fd);
 
 private:
+  struct Connection
+  {
+    /// the package being filled, allocated while a statement runs only
+    auto Pkg() -> net::NetPkg &
+    {
+      if (pkg_ == nullptr) {
+        pkg_ = std::make_unique<net::NetPkg>();
+      }
+      return *pkg_;
+    }
+
+    [[nodiscard]] auto Pending() const -> size_t { return wbuf_.size() - wpos_; }
+
+    std::unique_ptr<net::NetPkg>          pkg_;
+    std::chrono::steady_clock::time_point since_;  // when the first record of a pending REC_BODY was packed
+    std::chrono::milliseconds             waited_{0};  // for the client to read, by the running statement
+    std::atomic<size_t>                   buffered_{0};  // Pending() when last counted in NetController::buffered_
+    std::string                           rbuf_;   // received bytes of requests not started yet
+    std::string                           wbuf_;   // packages not sent yet start at wpos_
+    size_t                                wpos_{0};
+    bool                                  evented_{false};  // served by Serve
+    bool                                  closing_{false};  // to be closed by the loop thread
+    Session                               session_;
+  };
+
+  auto GetConnection(int fd) -> Connection &;
+
+  /// like FlushSend, but packages of a connection served by Serve wait until a package's worth of bytes is pending
+  void QueueSend(int fd);
+
+  /// encode rec into the REC_BODY format, returns false if it does not fit in size bytes
+  static auto EncodeRec(const Record &rec, char *dst, size_t size, size_t &len) -> bool;
+
+  /**
+   * send until at most limit bytes are pending, waiting for the client while more are if the worker may wait
+   * @return false if the client is down, or is too slow to be waited for
+   */
+  auto WriteOut(int fd, Connection &conn, size_t limit) -> bool;
+
+  /// count the pending bytes of the connection in buffered_
+  void Account(Connection &conn);
+
+  /// drop the connection with the most pending bytes, true if that is fd, which the caller closes
+  auto DropLargest(int fd) -> bool;
+
+  /// read what the socket holds, false if the client closed the connection or is down
+  auto ReadIn(int fd, Connection &conn) -> bool;
+
+  void AcceptAll();
+
+  void HandleEvent(int fd, uint32_t events);
+
+  /// start the next request of the connection on a worker, or wait for the socket. false if the request is malformed
+  auto Dispatch(int fd, Connection &conn) -> bool;
+
+  void RunQuery(int fd, const std::string &sql);
+
+  void CloseConnection(int fd);
+
+  // the connection whose statement the calling worker runs, saves a lookup for every record sent
+  static thread_local int         current_fd_;
+  static thread_local Connection *current_conn_;
+
   // currently receive and send use the same pkg_
-  int                                  server_fd_{0};
-  int                                  listen_port_{0};
-  int                                  max_client_{0};
-  std::unordered_map<int, net::NetPkg> client_buffer_;
+  int                                                  server_fd_{0};
+  int                                                  listen_port_{0};
+  int                                                  max_client_{0};
+  std::mutex                                           conns_mutex_;
+  std::unordered_map<int, std::unique_ptr<Connection>> conns_;
+
+  // used by Serve
+  int                 epoll_fd_{-1};
+  int                 wake_fd_{-1};
+  std::atomic<bool>   stop_{false};
+  QueryHandler        on_query_;
+  CloseHandler        on_close_;
+  ThreadPool         *workers_{nullptr};
+  size_t              max_waiting_{0};  // workers that may wait for their clients at once
+  std::atomic<size_t> waiting_{0};
+  std::atomic<size_t> buffered_{0};  // pending bytes of all connections, as last counted
+  std::vector<char>   read_buf_;  // the loop thread reads into it
 };
 
 }  // namespace wsdb
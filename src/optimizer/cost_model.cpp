@@ -0,0 +1,106 @@
+/*------------------------------------------------------------------------------
+ - Copyright (c) 2024. Websoft research group, Nanjing University.
+ -
+ - This program is free software: you can redistribute it and/or modify
+ - it under the terms of the GNU General Public License as published by
+ - the Free Software Foundation, either version 3 of the License, or
+ - (at your option) any later version.
+ -
+ - This program is distributed in the hope that it will be useful,
+ - but WITHOUT ANY WARRANTY; without even the implied warranty of
+ - MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ - GNU General Public License for more details.
+ -
+ - You should have received a copy of the GNU General Public License
+ - along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ -----------------------------------------------------------------------------*/
+
+#include "cost_model.h"
+#include <algorithm>
+#include <cmath>
+#include "common/config.h"
+
+namespace wsdb {
+
+namespace {
+// keys in an inner node of an index, decides its height
+constexpr double INDEX_FANOUT = 128;
+}  // namespace
+
+auto CostModel::Pages(const PlanCost &input) -> double
+{
+  return std::ceil(input.rows_ * std::max(input.width_, 1.0) / PAGE_SIZE);
+}
+
+auto CostModel::IndexDepth(double rows) -> double
+{
+  return std::max(1.0, std::ceil(std::log(rows + 1) / std::log(INDEX_FANOUT)));
+}
+
+auto CostModel::SeqScanCost(double pages, double rows, size_t cond_num) -> double
+{
+  return pages * SEQ_PAGE_COST + rows * (CPU_TUPLE_COST + static_cast<double>(cond_num) * CPU_OPERATOR_COST);
+}
+
+auto CostModel::IndexScanCost(double table_rows, double matched_rows, bool index_only) -> double
+{
+  // the heap records of neighbouring keys are assumed to be on different pages
+  return IndexDepth(table_rows) * RANDOM_PAGE_COST +
+         matched_rows * (CPU_TUPLE_COST + (index_only ? 0 : RANDOM_PAGE_COST));
+}
+
+auto CostModel::BitmapHeapCost(double pages, double matched_rows) -> double
+{
+  if (pages <= 0) {
+    return 0;
+  }
+  // expected number of distinct pages holding the records, they are read in page order so a dense bitmap costs no
+  // more than reading the whole table
+  auto touched = pages * (1 - std::pow(1 - 1 / pages, matched_rows));
+  return std::min(touched * RANDOM_PAGE_COST, pages * SEQ_PAGE_COST) + matched_rows * CPU_TUPLE_COST;
+}
+
+auto CostModel::SortCost(const PlanCost &input) -> double
+{
+  auto rows = std::max(input.rows_, 1.0);
+  auto cost = rows * std::log2(rows + 1) * CPU_OPERATOR_COST;
+  auto runs = std::ceil(input.rows_ * input.width_ / static_cast<double>(SORT_BUFFER_SIZE));
+  if (runs > 1) {
+    // every merge pass writes and reads all the pages
+    auto passes = std::ceil(std::log(runs) / std::log(static_cast<double>(SORT_WAY_NUM)));
+    cost += 2 * Pages(input) * passes * SEQ_PAGE_COST;
+  }
+  return cost;
+}
+
+auto CostModel::NestedLoopJoinCost(const PlanCost &left, const PlanCost &right, double rows, size_t cond_num) -> double
+{
+  return left.cost_ + std::max(left.rows_, 1.0) * right.cost_ +
+         left.rows_ * right.rows_ * static_cast<double>(std::max<size_t>(cond_num, 1)) * CPU_OPERATOR_COST +
+         rows * CPU_TUPLE_COST;
+}
+
+auto CostModel::IndexJoinCost(const PlanCost &left, double inner_rows, double rows) -> double
+{
+  return left.cost_ + left.rows_ * IndexDepth(inner_rows) * RANDOM_PAGE_COST +
+         rows * (RANDOM_PAGE_COST + CPU_TUPLE_COST);
+}
+
+auto CostModel::HashJoinCost(const PlanCost &left, const PlanCost &right, double rows) -> double
+{
+  auto cost = left.cost_ + right.cost_ + right.rows_ * CPU_TUPLE_COST + left.rows_ * CPU_OPERATOR_COST +
+              rows * CPU_TUPLE_COST;
+  if (right.rows_ * right.width_ > static_cast<double>(HASH_JOIN_BUFFER_SIZE)) {
+    cost += 2 * (Pages(left) + Pages(right)) * SEQ_PAGE_COST;
+  }
+  return cost;
+}
+
+auto CostModel::SortMergeJoinCost(
+    const PlanCost &left, const PlanCost &right, double rows, bool sort_left, bool sort_right) -> double
+{
+  return left.cost_ + right.cost_ + (sort_left ? SortCost(left) : 0) + (sort_right ? SortCost(right) : 0) +
+         (left.rows_ + right.rows_) * CPU_OPERATOR_COST + rows * CPU_TUPLE_COST;
+}
+
+}  // namespace wsdb
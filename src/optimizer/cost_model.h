@@ -0,0 +1,77 @@
+/*------------------------------------------------------------------------------
+ - Copyright (c) 2024. Websoft research group, Nanjing University.
+ -
+ - This program is free software: you can redistribute it and/or modify
+ - it under the terms of the GNU General Public License as published by
+ - the Free Software Foundation, either version 3 of the License, or
+ - (at your option) any later version.
+ -
+ - This program is distributed in the hope that it will be useful,
+ - but WITHOUT ANY WARRANTY; without even the implied warranty of
+ - MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ - GNU General Public License for more details.
+ -
+ - You should have received a copy of the GNU General Public License
+ - along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ -----------------------------------------------------------------------------*/
+
+/**
+ * @brief Cost model of the optimizer. A cost adds up page accesses, a sequential page read costs SEQ_PAGE_COST and a
+ * random one RANDOM_PAGE_COST, and cpu work, CPU_TUPLE_COST per record produced and CPU_OPERATOR_COST per predicate
+ * or comparison. Operators whose input does not fit in their memory budget are charged the pages they spill.
+ */
+
+#ifndef WSDB_COST_MODEL_H
+#define WSDB_COST_MODEL_H
+
+#include <cstddef>
+
+namespace wsdb {
+
+/// estimated output of a plan
+struct PlanCost
+{
+  double rows_{0};   // records produced
+  double cost_{0};   // cost of producing all of them once
+  double width_{0};  // bytes of a record
+};
+
+class CostModel
+{
+public:
+  /// read every page of a table and check cond_num predicates on each record
+  static auto SeqScanCost(double pages, double rows, size_t cond_num) -> double;
+
+  /// descend an index of a table with table_rows records and fetch matched_rows of them from the heap
+  static auto IndexScanCost(double table_rows, double matched_rows, bool index_only) -> double;
+
+  /// fetch matched_rows records of a table collected from its indexes, in page order
+  static auto BitmapHeapCost(double pages, double matched_rows) -> double;
+
+  /// sort the records of input, spilling runs of SORT_BUFFER_SIZE bytes to disk if needed
+  static auto SortCost(const PlanCost &input) -> double;
+
+  /// the right side is run again for every left record
+  static auto NestedLoopJoinCost(const PlanCost &left, const PlanCost &right, double rows, size_t cond_num) -> double;
+
+  /// every left record probes an index of the inner table holding inner_rows records
+  static auto IndexJoinCost(const PlanCost &left, double inner_rows, double rows) -> double;
+
+  /// the right side is built into a hash table probed by the left records
+  static auto HashJoinCost(const PlanCost &left, const PlanCost &right, double rows) -> double;
+
+  /// both sides are merged in key order, sorting the sides that are not ordered yet
+  static auto SortMergeJoinCost(
+      const PlanCost &left, const PlanCost &right, double rows, bool sort_left, bool sort_right) -> double;
+
+private:
+  /// pages taken by the records of input
+  static auto Pages(const PlanCost &input) -> double;
+
+  /// pages read from the root to a leaf of an index over rows records
+  static auto IndexDepth(double rows) -> double;
+};
+
+}  // namespace wsdb
+
+#endif  // WSDB_COST_MODEL_H
@@ -20,14 +20,273 @@
 //
 
 #include "optimizer.h"
+#include <bit>
+#include <cmath>
+#include <functional>
+#include <limits>
+#include <map>
+#include <set>
+#include "common/catalog_version.h"
+#include "common/thread_pool.h"
+#include "expr/statistics.h"
+#include "expr/zone_map.h"
 namespace wsdb {
 auto Optimizer::Optimize(std::shared_ptr<AbstractPlan> plan, DatabaseHandle *db) -> std::shared_ptr<AbstractPlan>
 {
+  // EXPLAIN ANALYZE runs the plan, keep the estimates to show them next to what happened
+  if (auto explain = std::dynamic_pointer_cast<ExplainPlan>(plan); explain != nullptr && explain->analyze_) {
+    explain->logical_plan_ = Optimize(explain->logical_plan_, db);
+    explain->estimates_.clear();
+    CollectEstimates(explain->logical_plan_, db, explain->estimates_);
+    return explain;
+  }
+  // a prepared plan is optimized once with its parameters unknown, the arguments are bound by every execution
+  if (auto prepare = std::dynamic_pointer_cast<PreparePlan>(plan)) {
+    prepare->version_ = CatalogVersion::Get();
+    prepare->plan_    = Optimize(prepare->plan_, db);
+    return prepare;
+  }
+  // the query of COPY TO is optimized like any other, including parallel scans
+  if (auto copy = std::dynamic_pointer_cast<CopyToPlan>(plan)) {
+    copy->child_ = Optimize(copy->child_, db);
+    return copy;
+  }
+  if (std::dynamic_pointer_cast<ExecutePlan>(plan) != nullptr ||
+      std::dynamic_pointer_cast<DeallocatePlan>(plan) != nullptr) {
+    return plan;
+  }
+  plan = PushDownPredicates(plan, {}, db);
   plan = LogicalOptimize(plan, db);
+  PruneScanColumns(plan, nullptr, db);
   plan = PhysicalOptimize(plan, db);
   return plan;
 }
 
+namespace {
+/// conditions on aggregates or subqueries stay where the planner put them
+auto IsMovable(const Condition &cond) -> bool
+{
+  return cond.GetRhsType() != kSubquery && !cond.GetLCol().is_agg_ &&
+         (cond.GetRhsType() != kColumn || !cond.GetRCol().is_agg_);
+}
+
+/// true if the fields of cond all come from tables
+auto IsCoveredBy(const Condition &cond, const std::set<table_id_t> &tables) -> bool
+{
+  return tables.count(cond.GetLCol().field_.table_id_) != 0 &&
+         (cond.GetRhsType() != kColumn || tables.count(cond.GetRCol().field_.table_id_) != 0);
+}
+
+auto SameField(const RTField &lhs, const RTField &rhs) -> bool
+{
+  return lhs.field_.table_id_ == rhs.field_.table_id_ && lhs.field_.field_name_ == rhs.field_.field_name_;
+}
+
+auto AddFilter(std::shared_ptr<AbstractPlan> plan, ConditionVec conds) -> std::shared_ptr<AbstractPlan>
+{
+  if (conds.empty()) {
+    return plan;
+  }
+  if (auto filter = std::dynamic_pointer_cast<FilterPlan>(plan)) {
+    filter->conds_.insert(filter->conds_.end(), conds.begin(), conds.end());
+    return filter;
+  }
+  return std::make_shared<FilterPlan>(std::move(plan), std::move(conds));
+}
+}  // namespace
+
+auto Optimizer::PushDownPredicates(
+    std::shared_ptr<AbstractPlan> plan, ConditionVec conds, DatabaseHandle *db) -> std::shared_ptr<AbstractPlan>
+{
+  auto table_ids = [db](const std::shared_ptr<AbstractPlan> &side) {
+    std::vector<TableHandle *> tables;
+    CollectTables(side, db, tables);
+    std::set<table_id_t> ids;
+    for (auto tab : tables) {
+      ids.insert(tab->GetTableId());
+    }
+    return ids;
+  };
+  if (auto filter = std::dynamic_pointer_cast<FilterPlan>(plan)) {
+    ConditionVec kept;
+    for (const auto &cond : filter->conds_) {
+      (IsMovable(cond) ? conds : kept).push_back(cond);
+    }
+    auto child = PushDownPredicates(filter->child_, std::move(conds), db);
+    if (kept.empty()) {
+      return child;
+    }
+    filter->child_ = child;
+    filter->conds_ = std::move(kept);
+    return filter;
+  } else if (auto join = std::dynamic_pointer_cast<JoinPlan>(plan)) {
+    if (join->type_ == INNER_JOIN) {
+      CollectJoinConditions(join, conds);
+      InferConditions(conds);
+      return PlaceJoinConditions(join, std::move(conds), db);
+    }
+    // an outer join keeps the left records without a match: conditions above it only go down to the left side, and
+    // its own conditions only go down to the right side
+    auto         left_ids  = table_ids(join->left_);
+    auto         right_ids = table_ids(join->right_);
+    ConditionVec to_left, to_right, above, on;
+    for (const auto &cond : conds) {
+      (IsCoveredBy(cond, left_ids) ? to_left : above).push_back(cond);
+    }
+    for (const auto &cond : join->conds_) {
+      (IsCoveredBy(cond, right_ids) ? to_right : on).push_back(cond);
+    }
+    join->conds_ = std::move(on);
+    join->left_  = PushDownPredicates(join->left_, std::move(to_left), db);
+    join->right_ = PushDownPredicates(join->right_, std::move(to_right), db);
+    return AddFilter(join, std::move(above));
+  } else if (auto proj = std::dynamic_pointer_cast<ProjectPlan>(plan)) {
+    proj->child_ = PushDownPredicates(proj->child_, std::move(conds), db);
+    return proj;
+  } else if (auto sort = std::dynamic_pointer_cast<SortPlan>(plan)) {
+    sort->child_ = PushDownPredicates(sort->child_, std::move(conds), db);
+    return sort;
+  } else if (auto agg = std::dynamic_pointer_cast<AggregatePlan>(plan)) {
+    agg->child_ = PushDownPredicates(agg->child_, {}, db);
+  } else if (auto lim = std::dynamic_pointer_cast<LimitPlan>(plan)) {
+    lim->child_ = PushDownPredicates(lim->child_, {}, db);
+  } else if (auto upd = std::dynamic_pointer_cast<UpdatePlan>(plan)) {
+    upd->child_ = PushDownPredicates(upd->child_, {}, db);
+  } else if (auto del = std::dynamic_pointer_cast<DeletePlan>(plan)) {
+    del->child_ = PushDownPredicates(del->child_, {}, db);
+  }
+  return AddFilter(plan, std::move(conds));
+}
+
+void Optimizer::CollectJoinConditions(const std::shared_ptr<JoinPlan> &join, ConditionVec &conds)
+{
+  conds.insert(conds.end(), join->conds_.begin(), join->conds_.end());
+  join->conds_.clear();
+  for (auto side : {&join->left_, &join->right_}) {
+    if (auto child = std::dynamic_pointer_cast<JoinPlan>(*side); child != nullptr && child->type_ == INNER_JOIN) {
+      CollectJoinConditions(child, conds);
+    } else if (auto filter = std::dynamic_pointer_cast<FilterPlan>(*side)) {
+      if (std::dynamic_pointer_cast<ScanPlan>(filter->child_) == nullptr) {
+        continue;
+      }
+      ConditionVec kept;
+      for (const auto &cond : filter->conds_) {
+        (IsMovable(cond) ? conds : kept).push_back(cond);
+      }
+      filter->conds_ = std::move(kept);
+      if (filter->conds_.empty()) {
+        *side = filter->child_;
+      }
+    }
+  }
+}
+
+auto Optimizer::PlaceJoinConditions(
+    std::shared_ptr<AbstractPlan> plan, ConditionVec conds, DatabaseHandle *db) -> std::shared_ptr<AbstractPlan>
+{
+  auto join = std::dynamic_pointer_cast<JoinPlan>(plan);
+  if (join == nullptr || join->type_ != INNER_JOIN) {
+    return PushDownPredicates(plan, std::move(conds), db);
+  }
+  std::vector<TableHandle *> left_tables, right_tables;
+  CollectTables(join->left_, db, left_tables);
+  CollectTables(join->right_, db, right_tables);
+  std::set<table_id_t> left_ids, right_ids;
+  for (auto tab : left_tables) {
+    left_ids.insert(tab->GetTableId());
+  }
+  for (auto tab : right_tables) {
+    right_ids.insert(tab->GetTableId());
+  }
+  ConditionVec to_left, to_right;
+  for (const auto &cond : conds) {
+    if (IsCoveredBy(cond, left_ids)) {
+      to_left.push_back(cond);
+    } else if (IsCoveredBy(cond, right_ids)) {
+      to_right.push_back(cond);
+    } else if (cond.GetRhsType() == kColumn && right_ids.count(cond.GetLCol().field_.table_id_) != 0 &&
+               left_ids.count(cond.GetRCol().field_.table_id_) != 0) {
+      // the left field of a join condition comes from the left side
+      join->conds_.push_back(cond.Swap());
+    } else {
+      join->conds_.push_back(cond);
+    }
+  }
+  join->left_  = PlaceJoinConditions(join->left_, std::move(to_left), db);
+  join->right_ = PlaceJoinConditions(join->right_, std::move(to_right), db);
+  return join;
+}
+
+void Optimizer::InferConditions(ConditionVec &conds)
+{
+  // equal columns form classes, kept by a union find over "table id.field name"
+  auto                               key = [](const RTField &field) {
+    return fmt::format("{}.{}", field.field_.table_id_, field.field_.field_name_);
+  };
+  std::map<std::string, std::string> parent;
+  std::map<std::string, RTField>     fields;
+  std::function<std::string(const std::string &)> find = [&](const std::string &k) -> std::string {
+    auto it = parent.find(k);
+    if (it == parent.end() || it->second == k) {
+      return k;
+    }
+    return it->second = find(it->second);
+  };
+  for (const auto &cond : conds) {
+    if (cond.GetOp() != OP_EQ || cond.GetRhsType() != kColumn || !IsMovable(cond)) {
+      continue;
+    }
+    auto lhs = key(cond.GetLCol()), rhs = key(cond.GetRCol());
+    fields.emplace(lhs, cond.GetLCol());
+    fields.emplace(rhs, cond.GetRCol());
+    parent.emplace(lhs, lhs);
+    parent.emplace(rhs, rhs);
+    parent[find(lhs)] = find(rhs);
+  }
+  if (fields.empty()) {
+    return;
+  }
+  std::map<std::string, std::vector<RTField>> classes;
+  for (const auto &[k, field] : fields) {
+    classes[find(k)].push_back(field);
+  }
+  std::set<std::string> known;
+  for (const auto &cond : conds) {
+    known.insert(cond.ToString());
+  }
+  ConditionVec derived;
+  auto         add = [&known, &derived](Condition cond) {
+    if (known.insert(cond.ToString()).second) {
+      derived.push_back(std::move(cond));
+    }
+  };
+  // a comparison with a constant holds for every column equal to the compared one
+  for (const auto &cond : conds) {
+    if (cond.GetRhsType() != kValue || !IsMovable(cond) || fields.count(key(cond.GetLCol())) == 0) {
+      continue;
+    }
+    for (const auto &field : classes[find(key(cond.GetLCol()))]) {
+      if (key(field) != key(cond.GetLCol())) {
+        auto val = cond.GetRVal();
+        add(Condition(cond.GetOp(), field, val));
+      }
+    }
+  }
+  // any two columns of a class from different tables are equal, so the tables can be joined directly
+  for (const auto &[root, members] : classes) {
+    for (size_t i = 0; i < members.size(); i++) {
+      for (size_t j = i + 1; j < members.size(); j++) {
+        if (members[i].field_.table_id_ == members[j].field_.table_id_ ||
+            known.count(Condition(OP_EQ, members[j], members[i]).ToString()) != 0) {
+          continue;
+        }
+        add(Condition(OP_EQ, members[i], members[j]));
+      }
+    }
+  }
+  conds.insert(conds.end(), derived.begin(), derived.end());
+}
+
 auto Optimizer::LogicalOptimize(std::shared_ptr<AbstractPlan> plan, DatabaseHandle *db) -> std::shared_ptr<AbstractPlan>
 {
   if (auto upd = std::dynamic_pointer_cast<UpdatePlan>(plan)) {
@@ -38,26 +297,44 @@ auto Optimizer::LogicalOptimize(std::shared_ptr<AbstractPlan> plan, DatabaseHand
     return del;
   } else if (auto filter = std::dynamic_pointer_cast<FilterPlan>(plan)) {
     if (auto scan = std::dynamic_pointer_cast<ScanPlan>(filter->child_)) {
-      filter->child_ = LogicalOptimizeScan(scan, filter->conds_, db);
+      auto new_scan = LogicalOptimizeScan(scan, filter->conds_, db);
+      // no index can be used, evaluate the predicates inside the table scan
+      if (new_scan == scan) {
+        scan->conds_        = std::move(filter->conds_);
+        scan->pruned_pages_ = ZoneMap::Get(db->GetName(), db->GetTable(scan->table_name_))->CountSkipped(scan->conds_);
+        return scan;
+      }
+      filter->child_ = new_scan;
     } else {
       filter->child_ = LogicalOptimize(filter->child_, db);
     }
     return filter;
   } else if (auto sort = std::dynamic_pointer_cast<SortPlan>(plan)) {
-    sort->child_ = LogicalOptimize(sort->child_, db);
-    return sort;
+    return LogicalOptimizeSort(sort, std::numeric_limits<size_t>::max(), db);
   } else if (auto proj = std::dynamic_pointer_cast<ProjectPlan>(plan)) {
     proj->child_ = LogicalOptimize(proj->child_, db);
     return proj;
   } else if (auto join = std::dynamic_pointer_cast<JoinPlan>(plan)) {
+    if (join->type_ == INNER_JOIN && join->strategy_ == AUTO_JOIN) {
+      return ReorderJoins(join, db);
+    }
     join->left_  = LogicalOptimize(join->left_, db);
     join->right_ = LogicalOptimize(join->right_, db);
-    return LogicalOptimizeJoin(join);
+    return LogicalOptimizeJoin(join, db);
   } else if (auto agg = std::dynamic_pointer_cast<AggregatePlan>(plan)) {
     agg->child_ = LogicalOptimize(agg->child_, db);
     return agg;
   } else if (auto lim = std::dynamic_pointer_cast<LimitPlan>(plan)) {
-    lim->child_ = LogicalOptimize(lim->child_, db);
+    // the sort of ORDER BY is below the projection of the select list
+    auto proj = std::dynamic_pointer_cast<ProjectPlan>(lim->child_);
+    auto sort = std::dynamic_pointer_cast<SortPlan>(proj != nullptr ? proj->child_ : lim->child_);
+    if (sort == nullptr) {
+      lim->child_ = LogicalOptimize(lim->child_, db);
+    } else if (proj != nullptr) {
+      proj->child_ = LogicalOptimizeSort(sort, lim->limit_, db);
+    } else {
+      lim->child_ = LogicalOptimizeSort(sort, lim->limit_, db);
+    }
     return lim;
   }
   return plan;
@@ -69,29 +346,457 @@ auto Optimizer::LogicalOptimizeScan(const std::shared_ptr<ScanPlan> &scan, Condi
   // try to make index scan
   size_t       max_matched_fields = 0;
   ConditionVec index_conds;
-  auto         index = CanIndexScan(conds, index_conds, db->GetIndexes(scan->table_name_), max_matched_fields);
-  std::shared_ptr<AbstractPlan> new_scan = scan;
-  if (index != nullptr) {
-    new_scan = std::make_shared<IdxScanPlan>(scan->table_name_, index->GetIndexId(), index_conds, max_matched_fields);
+  auto         indexes = db->GetIndexes(scan->table_name_);
+  auto         index   = CanIndexScan(conds, index_conds, indexes, max_matched_fields);
+  if (index == nullptr) {
+    return scan;
+  }
+  // the index only pays off if it skips enough of the table
+  auto tab      = db->GetTable(scan->table_name_);
+  auto seq_cost = CostModel::SeqScanCost(static_cast<double>(tab->GetTableHeader().page_num_),
+      static_cast<double>(tab->GetTableHeader().rec_num_),
+      conds.size() + index_conds.size());
+  auto idx_scan =
+      std::make_shared<IdxScanPlan>(scan->table_name_, index->GetIndexId(), index_conds, max_matched_fields);
+  // a lookup of one full key fetches a few records, reading them in key order is fine
+  bool is_point = max_matched_fields == index->GetIndex()->GetKeyFieldNum() &&
+                  std::all_of(index_conds.begin(), index_conds.end(), [](const auto &cond) {
+                    return cond.GetOp() == OP_EQ;
+                  });
+  if (is_point) {
+    if (EstimateCost(idx_scan, db).cost_ >= seq_cost) {
+      return scan;
+    }
+    return idx_scan;
+  }
+  // otherwise collect the rids first and read the table page by page. Other indexes on the fields not used yet narrow
+  // the rids down, their conditions stay in conds and are checked again on the records
+  std::vector<std::shared_ptr<IdxScanPlan>> idx_scans{idx_scan};
+  indexes.remove(index);
+  while (!indexes.empty()) {
+    ConditionVec rest_conds;
+    std::copy_if(conds.begin(), conds.end(), std::back_inserter(rest_conds), [&idx_scans](const Condition &cond) {
+      return std::none_of(idx_scans.begin(), idx_scans.end(), [&cond](const auto &used) {
+        return std::any_of(used->conds_.begin(), used->conds_.end(), [&cond](const Condition &used_cond) {
+          return used_cond.GetLCol() == cond.GetLCol();
+        });
+      });
+    });
+    size_t       matched_fields = 0;
+    ConditionVec more_conds;
+    auto         more = CanIndexScan(rest_conds, more_conds, indexes, matched_fields);
+    if (more == nullptr) {
+      break;
+    }
+    idx_scans.push_back(
+        std::make_shared<IdxScanPlan>(scan->table_name_, more->GetIndexId(), more_conds, matched_fields));
+    indexes.remove(more);
   }
-  return new_scan;
+  auto bitmap_scan = std::make_shared<BitmapScanPlan>(scan->table_name_, std::move(idx_scans), true);
+  if (EstimateCost(bitmap_scan, db).cost_ >= seq_cost) {
+    return scan;
+  }
+  return bitmap_scan;
 }
 
-auto Optimizer::LogicalOptimizeJoin(std::shared_ptr<JoinPlan> join) -> std::shared_ptr<AbstractPlan>
+auto Optimizer::LogicalOptimizeJoin(std::shared_ptr<JoinPlan> join, DatabaseHandle *db) -> std::shared_ptr<AbstractPlan>
 {
+  if (join->strategy_ == AUTO_JOIN) {
+    // the sides of an outer join cannot be swapped, only its strategy is chosen
+    ChooseJoinStrategy(join,
+        EstimateCost(join->left_, db),
+        EstimateCost(join->right_, db),
+        static_cast<double>(EstimateRows(join, db)),
+        db);
+    return FinishJoin(join, db);
+  }
   if (join->strategy_ == NESTED_LOOP) {
+    // probing an index beats rescanning the inner table for every outer record
+    CanIndexJoin(join, db, false);
+    return join;
+  }
+  if (CanIndexJoin(join, db, true)) {
+    return join;
+  }
+  return FinishJoin(join, db);
+}
+
+auto Optimizer::LogicalOptimizeSort(
+    const std::shared_ptr<SortPlan> &sort, size_t limit, DatabaseHandle *db) -> std::shared_ptr<AbstractPlan>
+{
+  // remember the table before its scan is optimized, the conditions may also be matched by an index in key order
+  auto         filter = std::dynamic_pointer_cast<FilterPlan>(sort->child_);
+  auto         scan   = std::dynamic_pointer_cast<ScanPlan>(filter != nullptr ? filter->child_ : sort->child_);
+  ConditionVec conds;
+  if (scan != nullptr) {
+    conds = filter != nullptr ? filter->conds_ : scan->conds_;
+  }
+  sort->child_ = LogicalOptimize(sort->child_, db);
+  // index scans only run forward, a descending order is always sorted
+  if (sort->is_desc_) {
+    return sort;
+  }
+  const auto &keys = sort->key_schema_->GetFields();
+  if (IsOrderedOn(sort->child_, keys, db)) {
+    return sort->child_;
+  }
+  if (scan == nullptr) {
+    return sort;
+  }
+  // an ordered scan stops after the records the limit takes, the sort has to read all of them first
+  auto                          best_cost = EstimateCost(sort, db).cost_;
+  std::shared_ptr<AbstractPlan> best      = sort;
+  for (const auto idx : db->GetIndexes(scan->table_name_)) {
+    if (idx->GetIndexType() != IndexType::BPTREE) {
+      continue;
+    }
+    ConditionVec rest_conds = conds;
+    ConditionVec index_conds;
+    size_t       matched_fields = 0;
+    CanIndexScan(rest_conds, index_conds, {idx}, matched_fields);
+    std::shared_ptr<AbstractPlan> ordered = std::make_shared<IdxScanPlan>(
+        scan->table_name_, idx->GetIndexId(), index_conds, static_cast<int>(matched_fields));
+    if (!rest_conds.empty()) {
+      ordered = std::make_shared<FilterPlan>(ordered, rest_conds);
+    }
+    if (!IsOrderedOn(ordered, keys, db)) {
+      continue;
+    }
+    auto est  = EstimateCost(ordered, db);
+    auto cost = est.cost_;
+    if (limit < est.rows_) {
+      cost *= static_cast<double>(limit) / est.rows_;
+    }
+    if (cost < best_cost) {
+      best_cost = cost;
+      best      = ordered;
+    }
+  }
+  return best;
+}
+
+void Optimizer::GetOrder(const std::shared_ptr<AbstractPlan> &plan, DatabaseHandle *db, std::vector<RTField> &order,
+    std::vector<RTField> &pinned)
+{
+  auto add_pinned = [&pinned](const ConditionVec &conds) {
+    for (const auto &cond : conds) {
+      if (cond.GetOp() == OP_EQ && cond.GetRhsType() == kValue) {
+        pinned.push_back(cond.GetLCol());
+      }
+    }
+  };
+  if (auto scan = std::dynamic_pointer_cast<ScanPlan>(plan)) {
+    add_pinned(scan->conds_);
+  } else if (auto idx_scan = std::dynamic_pointer_cast<IdxScanPlan>(plan)) {
+    // the entries of a b+ tree are read in key order, a hash index has none
+    auto idx = db->GetIndex(idx_scan->idx_id_);
+    if (idx != nullptr && idx->GetIndexType() == IndexType::BPTREE) {
+      const auto &key_fields = idx->GetKeySchema().GetFields();
+      order.assign(key_fields.begin(), key_fields.begin() + idx->GetIndex()->GetKeyFieldNum());
+    }
+    add_pinned(idx_scan->conds_);
+  } else if (auto filter = std::dynamic_pointer_cast<FilterPlan>(plan)) {
+    GetOrder(filter->child_, db, order, pinned);
+    add_pinned(filter->conds_);
+  } else if (auto proj = std::dynamic_pointer_cast<ProjectPlan>(plan)) {
+    GetOrder(proj->child_, db, order, pinned);
+  } else if (auto lim = std::dynamic_pointer_cast<LimitPlan>(plan)) {
+    GetOrder(lim->child_, db, order, pinned);
+  } else if (auto sort = std::dynamic_pointer_cast<SortPlan>(plan)) {
+    GetOrder(sort->child_, db, order, pinned);
+    order.clear();
+    if (!sort->is_desc_) {
+      order = sort->key_schema_->GetFields();
+    }
+  } else if (auto join = std::dynamic_pointer_cast<JoinPlan>(plan)) {
+    // nested loop and hash joins read the left side once and keep its order, a sort merge join is ordered on its
+    // keys. an index nested loop join sorts each batch of outer records by key, which loses the order of the left side
+    GetOrder(join->left_, db, order, pinned);
+    if (join->strategy_ == INDEX_NESTED_LOOP) {
+      order.clear();
+    } else if (join->strategy_ == SORT_MERGE) {
+      order.clear();
+      for (const auto &cond : join->conds_) {
+        order.push_back(cond.GetLCol());
+      }
+    }
+    // the right fields of an outer join may be null
+    if (join->type_ == INNER_JOIN) {
+      std::vector<RTField> right_order;
+      GetOrder(join->right_, db, right_order, pinned);
+    }
+  }
+}
+
+auto Optimizer::IsOrderedOn(
+    const std::shared_ptr<AbstractPlan> &plan, const std::vector<RTField> &keys, DatabaseHandle *db) -> bool
+{
+  std::vector<RTField> order;
+  std::vector<RTField> pinned;
+  GetOrder(plan, db, order, pinned);
+  auto is_pinned = [&pinned](const RTField &field) {
+    return std::any_of(pinned.begin(), pinned.end(), [&field](const RTField &f) { return SameField(f, field); });
+  };
+  // a field with a single value does not change the order, it can be skipped on both sides
+  size_t pos = 0;
+  for (const auto &key : keys) {
+    while (pos < order.size() && !SameField(order[pos], key) && is_pinned(order[pos])) {
+      pos++;
+    }
+    if (pos < order.size() && SameField(order[pos], key)) {
+      pos++;
+    } else if (!is_pinned(key)) {
+      return false;
+    }
+  }
+  return true;
+}
+
+void Optimizer::OrderJoinKeys(const std::shared_ptr<JoinPlan> &join, DatabaseHandle *db)
+{
+  std::vector<RTField> order;
+  std::vector<RTField> pinned;
+  auto                 position = [&order](const RTField &field) {
+    return std::find_if(order.begin(), order.end(), [&field](const RTField &f) { return SameField(f, field); }) -
+           order.begin();
+  };
+  auto by_side = [&](const std::shared_ptr<AbstractPlan> &side, bool is_left) {
+    order.clear();
+    GetOrder(side, db, order, pinned);
+    auto key_of = [is_left](const Condition &cond) { return is_left ? cond.GetLCol() : cond.GetRCol(); };
+    if (std::none_of(join->conds_.begin(), join->conds_.end(), [&](const Condition &cond) {
+          return !order.empty() && SameField(order.front(), key_of(cond));
+        })) {
+      return false;
+    }
+    std::stable_sort(join->conds_.begin(), join->conds_.end(), [&](const Condition &lhs, const Condition &rhs) {
+      return position(key_of(lhs)) < position(key_of(rhs));
+    });
+    return true;
+  };
+  if (join->conds_.size() > 1 && !by_side(join->left_, true)) {
+    by_side(join->right_, false);
+  }
+}
+
+auto Optimizer::ReorderJoins(const std::shared_ptr<JoinPlan> &join, DatabaseHandle *db) -> std::shared_ptr<AbstractPlan>
+{
+  std::vector<std::shared_ptr<AbstractPlan>> leaves;
+  ConditionVec                               conds;
+  FlattenJoins(join, leaves, conds);
+  // a leaf is identified by a bit of the masks
+  if (leaves.size() > 64) {
+    join->left_     = LogicalOptimize(join->left_, db);
+    join->right_    = LogicalOptimize(join->right_, db);
+    join->strategy_ = NESTED_LOOP;
+    return LogicalOptimizeJoin(join, db);
+  }
+  std::vector<std::vector<TableHandle *>> leaf_tables(leaves.size());
+  std::vector<TableHandle *>              tables;
+  for (size_t i = 0; i < leaves.size(); i++) {
+    leaves[i] = LogicalOptimize(leaves[i], db);
+    CollectTables(leaves[i], db, leaf_tables[i]);
+    tables.insert(tables.end(), leaf_tables[i].begin(), leaf_tables[i].end());
+  }
+  auto leaf_mask = [&leaf_tables](const RTField &field) -> uint64_t {
+    for (size_t i = 0; i < leaf_tables.size(); i++) {
+      for (auto tab : leaf_tables[i]) {
+        if (tab->GetTableId() == field.field_.table_id_) {
+          return uint64_t{1} << i;
+        }
+      }
+    }
+    return 0;
+  };
+  // conditions on one leaf are checked right above it, the others join the leaves they refer to
+  ConditionVec              join_conds;
+  ConditionVec              root_conds;
+  std::vector<uint64_t>     cond_masks;
+  std::vector<double>       cond_sels;
+  std::vector<ConditionVec> leaf_conds(leaves.size());
+  for (const auto &cond : conds) {
+    auto lmask = leaf_mask(cond.GetLCol());
+    auto rmask = cond.GetRhsType() == kColumn ? leaf_mask(cond.GetRCol()) : lmask;
+    if (lmask == 0 || rmask == 0) {
+      root_conds.push_back(cond);
+    } else if (lmask == rmask) {
+      leaf_conds[std::countr_zero(lmask)].push_back(cond);
+    } else {
+      join_conds.push_back(cond);
+      cond_masks.push_back(lmask | rmask);
+      cond_sels.push_back(EstimateSelectivity({cond}, tables, db));
+    }
+  }
+  std::vector<JoinEntry> entries;
+  for (size_t i = 0; i < leaves.size(); i++) {
+    if (!leaf_conds[i].empty()) {
+      leaves[i] = std::make_shared<FilterPlan>(leaves[i], std::move(leaf_conds[i]));
+    }
+    entries.push_back({leaves[i], uint64_t{1} << i, EstimateCost(leaves[i], db)});
+  }
+
+  auto connects = [&cond_masks](uint64_t lhs, uint64_t rhs) {
+    return std::any_of(cond_masks.begin(), cond_masks.end(), [lhs, rhs](uint64_t mask) {
+      return (mask & ~(lhs | rhs)) == 0 && (mask & lhs) != 0 && (mask & rhs) != 0;
+    });
+  };
+  auto make_join = [&](const JoinEntry &left, const JoinEntry &right) -> JoinEntry {
+    ConditionVec between;
+    double       sel = 1;
+    for (size_t k = 0; k < join_conds.size(); k++) {
+      auto mask = cond_masks[k];
+      if ((mask & ~(left.mask_ | right.mask_)) != 0 || (mask & left.mask_) == 0 || (mask & right.mask_) == 0) {
+        continue;
+      }
+      sel *= cond_sels[k];
+      // the left field of a join condition comes from the left side
+      const auto &cond = join_conds[k];
+      between.push_back((leaf_mask(cond.GetLCol()) & left.mask_) != 0 ? cond : cond.Swap());
+    }
+    auto     plan = std::make_shared<JoinPlan>(left.plan_, right.plan_, between, INNER_JOIN, AUTO_JOIN);
+    PlanCost cost{left.cost_.rows_ * right.cost_.rows_ * sel, 0, left.cost_.width_ + right.cost_.width_};
+    cost.cost_ = ChooseJoinStrategy(plan, left.cost_, right.cost_, cost.rows_, db);
+    return {plan, left.mask_ | right.mask_, cost};
+  };
+
+  JoinEntry best;
+  if (leaves.size() <= DP_JOIN_MAX_TABLES) {
+    // every subset of a set is a smaller number, so it has been planned before the set
+    uint64_t               full = (uint64_t{1} << leaves.size()) - 1;
+    std::vector<JoinEntry> plans(full + 1);
+    for (const auto &entry : entries) {
+      plans[entry.mask_] = entry;
+    }
+    for (uint64_t set = 1; set <= full; set++) {
+      if (std::popcount(set) < 2) {
+        continue;
+      }
+      for (int allow_cross = 0; allow_cross < 2 && plans[set].plan_ == nullptr; allow_cross++) {
+        for (uint64_t left = (set - 1) & set; left > 0; left = (left - 1) & set) {
+          auto right = set ^ left;
+          if (!allow_cross && !connects(left, right)) {
+            continue;
+          }
+          auto entry = make_join(plans[left], plans[right]);
+          if (plans[set].plan_ == nullptr || entry.cost_.cost_ < plans[set].cost_.cost_) {
+            plans[set] = std::move(entry);
+          }
+        }
+      }
+    }
+    best = std::move(plans[full]);
+  } else {
+    while (entries.size() > 1) {
+      JoinEntry pick;
+      size_t    pick_left = 0, pick_right = 0;
+      bool      pick_connected = false;
+      for (size_t i = 0; i < entries.size(); i++) {
+        for (size_t j = 0; j < entries.size(); j++) {
+          bool connected = connects(entries[i].mask_, entries[j].mask_);
+          if (i == j || (pick_connected && !connected)) {
+            continue;
+          }
+          auto entry = make_join(entries[i], entries[j]);
+          if (pick.plan_ == nullptr || (connected && !pick_connected) || entry.cost_.cost_ < pick.cost_.cost_) {
+            pick           = std::move(entry);
+            pick_left      = i;
+            pick_right     = j;
+            pick_connected = connected;
+          }
+        }
+      }
+      entries.erase(entries.begin() + static_cast<std::ptrdiff_t>(std::max(pick_left, pick_right)));
+      entries.erase(entries.begin() + static_cast<std::ptrdiff_t>(std::min(pick_left, pick_right)));
+      entries.push_back(std::move(pick));
+    }
+    best = std::move(entries.front());
+  }
+
+  // only the joins of the chosen plan get their sorts and filters, the leaves have been optimized already
+  std::function<std::shared_ptr<AbstractPlan>(const std::shared_ptr<AbstractPlan> &)> finish =
+      [&](const std::shared_ptr<AbstractPlan> &plan) -> std::shared_ptr<AbstractPlan> {
+    if (std::find(leaves.begin(), leaves.end(), plan) != leaves.end()) {
+      return plan;
+    }
+    auto new_join = std::dynamic_pointer_cast<JoinPlan>(plan);
+    WSDB_ASSERT(new_join != nullptr, "a reordered join tree should only contain joins and leaves");
+    new_join->left_ = finish(new_join->left_);
+    if (new_join->strategy_ != INDEX_NESTED_LOOP) {
+      new_join->right_ = finish(new_join->right_);
+    }
+    return FinishJoin(new_join, db);
+  };
+  auto plan = finish(best.plan_);
+  if (!root_conds.empty()) {
+    plan = std::make_shared<FilterPlan>(plan, std::move(root_conds));
+  }
+  return plan;
+}
+
+void Optimizer::FlattenJoins(
+    const std::shared_ptr<AbstractPlan> &plan, std::vector<std::shared_ptr<AbstractPlan>> &leaves, ConditionVec &conds)
+{
+  auto join = std::dynamic_pointer_cast<JoinPlan>(plan);
+  if (join == nullptr || join->type_ != INNER_JOIN || join->strategy_ != AUTO_JOIN) {
+    leaves.push_back(plan);
+    return;
+  }
+  conds.insert(conds.end(), join->conds_.begin(), join->conds_.end());
+  FlattenJoins(join->left_, leaves, conds);
+  FlattenJoins(join->right_, leaves, conds);
+}
+
+auto Optimizer::ChooseJoinStrategy(const std::shared_ptr<JoinPlan> &join, const PlanCost &left, const PlanCost &right,
+    double rows, DatabaseHandle *db) -> double
+{
+  const auto &conds = join->conds_;
+  join->strategy_   = NESTED_LOOP;
+  auto cost         = CostModel::NestedLoopJoinCost(left, right, rows, conds.size());
+  auto all_eq       = !conds.empty() && std::all_of(conds.begin(), conds.end(), [](const auto &cond) {
+    return cond.GetOp() == OP_EQ && cond.GetRhsType() == kColumn;
+  });
+  if (all_eq) {
+    // the right side is the build side of a hash join
+    // sort merge join is only used when USING SORT_MERGE_JOIN asks for it, its inner join is not implemented yet
+    if (auto hash_cost = CostModel::HashJoinCost(left, right, rows); hash_cost < cost) {
+      cost            = hash_cost;
+      join->strategy_ = HASH_JOIN;
+    }
+  }
+  // probing an index of the right table replaces reading it, undo the change if it is more expensive
+  auto strategy = join->strategy_;
+  auto right_plan = join->right_;
+  if (CanIndexJoin(join, db, false)) {
+    auto inner      = db->GetTable(std::dynamic_pointer_cast<ScanPlan>(join->right_)->table_name_);
+    auto index_cost = CostModel::IndexJoinCost(left, static_cast<double>(inner->GetTableHeader().rec_num_), rows);
+    if (index_cost < cost) {
+      return index_cost;
+    }
+    join->strategy_     = strategy;
+    join->right_        = right_plan;
+    join->inner_idx_id_ = -1;
+    join->outer_key_fields_.clear();
+  }
+  return cost;
+}
+
+auto Optimizer::FinishJoin(std::shared_ptr<JoinPlan> join, DatabaseHandle *db) -> std::shared_ptr<AbstractPlan>
+{
+  if (join->strategy_ == NESTED_LOOP || join->strategy_ == INDEX_NESTED_LOOP) {
     return join;
   }
-  WSDB_ASSERT(join->strategy_ == SORT_MERGE, "Unknown join strategy");
-  // try to generate SortMergeJoin
+  WSDB_ASSERT(join->strategy_ == SORT_MERGE || join->strategy_ == HASH_JOIN, "Unknown join strategy");
+  // try to generate SortMergeJoin or HashJoin
   // check if all conditions are equality comparison
-  auto all_eq =
-      std::all_of(join->conds_.begin(), join->conds_.end(), [](const auto &cond) { return cond.GetOp() == OP_EQ; });
+  auto all_eq = !join->conds_.empty() && std::all_of(join->conds_.begin(), join->conds_.end(), [](const auto &cond) {
+    return cond.GetOp() == OP_EQ && cond.GetRhsType() == kColumn;
+  });
   if (!all_eq) {
     join->strategy_ = NESTED_LOOP;
     return join;
   }
   // generate key schema from conditions
+  OrderJoinKeys(join, db);
   std::vector<RTField> left_key_fields;
   std::vector<RTField> right_key_fields;
   const auto          &conditions = join->conds_;
@@ -101,70 +806,624 @@ auto Optimizer::LogicalOptimizeJoin(std::shared_ptr<JoinPlan> join) -> std::shar
     left_key_fields.push_back(cond.GetLCol());
     right_key_fields.push_back(cond.GetRCol());
   }
-  std::shared_ptr<AbstractPlan> left = std::dynamic_pointer_cast<IdxScanPlan>(join->left_);
-  // generate sort plan
-  if (left == nullptr) {
-    left = std::make_shared<SortPlan>(std::move(join->left_), std::make_unique<RecordSchema>(left_key_fields), false);
+  join->left_key_schema_  = std::make_unique<RecordSchema>(left_key_fields);
+  join->right_key_schema_ = std::make_unique<RecordSchema>(right_key_fields);
+  if (join->strategy_ == HASH_JOIN) {
+    AddRuntimeFilter(join, left_key_fields, right_key_fields, db);
+    return join;
   }
-  std::shared_ptr<AbstractPlan> right = std::dynamic_pointer_cast<IdxScanPlan>(join->right_);
-  if (right == nullptr) {
-    right =
+  // generate sort plan for the sides not in key order yet
+  if (!IsOrderedOn(join->left_, left_key_fields, db)) {
+    join->left_ =
+        std::make_shared<SortPlan>(std::move(join->left_), std::make_unique<RecordSchema>(left_key_fields), false);
+  }
+  if (!IsOrderedOn(join->right_, right_key_fields, db)) {
+    join->right_ =
         std::make_shared<SortPlan>(std::move(join->right_), std::make_unique<RecordSchema>(right_key_fields), false);
   }
-  join->left_             = left;
-  join->right_            = right;
-  join->left_key_schema_  = std::make_unique<RecordSchema>(left_key_fields);
-  join->right_key_schema_ = std::make_unique<RecordSchema>(right_key_fields);
   return join;
 }
 
+void Optimizer::AddRuntimeFilter(const std::shared_ptr<JoinPlan> &join, const std::vector<RTField> &left_key_fields,
+    const std::vector<RTField> &right_key_fields, DatabaseHandle *db)
+{
+  // an outer join keeps the left records without a match
+  if (join->type_ != INNER_JOIN || left_key_fields.empty()) {
+    return;
+  }
+  // the filter pays off when a small build side drops most of a large probe side, e.g. a dimension and a fact table
+  if (EstimateRows(join->right_, db) >= EstimateRows(join->left_, db)) {
+    return;
+  }
+  auto table_id = left_key_fields.front().field_.table_id_;
+  if (std::any_of(left_key_fields.begin(), left_key_fields.end(), [table_id](const RTField &field) {
+        return field.field_.table_id_ != table_id;
+      })) {
+    return;
+  }
+  auto scan = FindTableScan(join->left_, table_id, db);
+  if (scan == nullptr) {
+    return;
+  }
+  join->runtime_filter_ = std::make_shared<RuntimeFilter>(left_key_fields, right_key_fields);
+  scan->runtime_filters_.push_back(join->runtime_filter_);
+}
+
+auto Optimizer::FindTableScan(const std::shared_ptr<AbstractPlan> &plan, table_id_t table_id,
+    DatabaseHandle *db) -> std::shared_ptr<ScanPlan>
+{
+  if (auto scan = std::dynamic_pointer_cast<ScanPlan>(plan)) {
+    auto tab = db->GetTable(scan->table_name_);
+    return tab != nullptr && tab->GetTableId() == table_id ? scan : nullptr;
+  } else if (auto filter = std::dynamic_pointer_cast<FilterPlan>(plan)) {
+    return FindTableScan(filter->child_, table_id, db);
+  } else if (auto proj = std::dynamic_pointer_cast<ProjectPlan>(plan)) {
+    return FindTableScan(proj->child_, table_id, db);
+  } else if (auto sort = std::dynamic_pointer_cast<SortPlan>(plan)) {
+    return FindTableScan(sort->child_, table_id, db);
+  } else if (auto join = std::dynamic_pointer_cast<JoinPlan>(plan)) {
+    // a record dropped below a join cannot produce a joined record that passes the filter either, the inner side of
+    // an index join is probed instead of scanned
+    if (auto scan = FindTableScan(join->left_, table_id, db)) {
+      return scan;
+    }
+    return join->strategy_ == INDEX_NESTED_LOOP ? nullptr : FindTableScan(join->right_, table_id, db);
+  }
+  return nullptr;
+}
+
+auto Optimizer::CanIndexJoin(const std::shared_ptr<JoinPlan> &join, DatabaseHandle *db, bool small_outer) -> bool
+{
+  // the inner side should be a table, the predicates on it are checked on the probed records
+  std::shared_ptr<ScanPlan> inner = std::dynamic_pointer_cast<ScanPlan>(join->right_);
+  if (auto filter = std::dynamic_pointer_cast<FilterPlan>(join->right_)) {
+    std::string table_name;
+    if (auto idx_scan = std::dynamic_pointer_cast<IdxScanPlan>(filter->child_)) {
+      table_name = idx_scan->table_name_;
+    } else if (auto bitmap_scan = std::dynamic_pointer_cast<BitmapScanPlan>(filter->child_)) {
+      table_name = bitmap_scan->table_name_;
+    }
+    if (!table_name.empty()) {
+      inner         = std::make_shared<ScanPlan>(table_name);
+      inner->conds_ = filter->conds_;
+    }
+  }
+  auto tab = inner == nullptr ? nullptr : db->GetTable(inner->table_name_);
+  if (tab == nullptr) {
+    return false;
+  }
+  // every outer record costs a descent of the index, a sort merge join reads the inner table once
+  if (small_outer) {
+    auto inner_rows = tab->GetTableHeader().rec_num_;
+    auto probe_cost = static_cast<size_t>(std::log2(inner_rows + 1)) + 1;
+    if (EstimateRows(join->left_, db) * probe_cost >= inner_rows) {
+      return false;
+    }
+  }
+  // match a key prefix of an inner index with equalities on outer fields
+  IndexHandle         *best_index = nullptr;
+  std::vector<RTField> best_outer_fields;
+  for (const auto idx : db->GetIndexes(inner->table_name_)) {
+    const auto          &key_fields = idx->GetKeySchema().GetFields();
+    auto                 key_num    = idx->GetIndex()->GetKeyFieldNum();
+    std::vector<RTField> outer_fields;
+    for (size_t i = 0; i < key_num; i++) {
+      const auto &field = key_fields[i].field_;
+      auto        it = std::find_if(join->conds_.begin(), join->conds_.end(), [&field](const Condition &cond) {
+        return cond.GetOp() == OP_EQ && cond.GetRhsType() == kColumn &&
+               ((cond.GetLCol().field_.table_id_ == field.table_id_ &&
+                    cond.GetLCol().field_.field_name_ == field.field_name_) ||
+                   (cond.GetRCol().field_.table_id_ == field.table_id_ &&
+                       cond.GetRCol().field_.field_name_ == field.field_name_));
+      });
+      if (it == join->conds_.end()) {
+        break;
+      }
+      outer_fields.push_back(it->GetLCol().field_.table_id_ == field.table_id_ ? it->GetRCol() : it->GetLCol());
+    }
+    // a hash index can only probe the full key
+    if (outer_fields.empty() || (idx->GetIndexType() == IndexType::HASH && outer_fields.size() != key_num)) {
+      continue;
+    }
+    if (outer_fields.size() > best_outer_fields.size() ||
+        (outer_fields.size() == best_outer_fields.size() && idx->GetIndexType() == IndexType::HASH)) {
+      best_index        = idx;
+      best_outer_fields = std::move(outer_fields);
+    }
+  }
+  if (best_index == nullptr) {
+    return false;
+  }
+  join->strategy_         = INDEX_NESTED_LOOP;
+  join->right_            = inner;
+  join->inner_idx_id_     = best_index->GetIndexId();
+  join->outer_key_fields_ = std::move(best_outer_fields);
+  return true;
+}
+
+auto Optimizer::EstimateRows(const std::shared_ptr<AbstractPlan> &plan, DatabaseHandle *db) -> size_t
+{
+  auto table_rows = [db](const std::string &table_name, const ConditionVec &conds) -> double {
+    auto tab = db->GetTable(table_name);
+    if (tab == nullptr) {
+      return 0;
+    }
+    return static_cast<double>(tab->GetTableHeader().rec_num_) * EstimateSelectivity(conds, {tab}, db);
+  };
+  double rows;
+  if (auto scan = std::dynamic_pointer_cast<ScanPlan>(plan)) {
+    rows = table_rows(scan->table_name_, scan->conds_);
+  } else if (auto idx_scan = std::dynamic_pointer_cast<IdxScanPlan>(plan)) {
+    rows = table_rows(idx_scan->table_name_, idx_scan->conds_);
+  } else if (auto bitmap_scan = std::dynamic_pointer_cast<BitmapScanPlan>(plan)) {
+    auto tab = db->GetTable(bitmap_scan->table_name_);
+    if (tab == nullptr) {
+      return 0;
+    }
+    // AND keeps the rows matching every index scan, OR drops the rows matching none of them
+    double sel = 1;
+    for (const auto &idx_scan : bitmap_scan->index_scans_) {
+      auto idx_sel = EstimateSelectivity(idx_scan->conds_, {tab}, db);
+      sel *= bitmap_scan->is_and_ ? idx_sel : 1 - idx_sel;
+    }
+    rows = static_cast<double>(tab->GetTableHeader().rec_num_) * (bitmap_scan->is_and_ ? sel : 1 - sel);
+  } else if (auto filter = std::dynamic_pointer_cast<FilterPlan>(plan)) {
+    std::vector<TableHandle *> tables;
+    CollectTables(filter->child_, db, tables);
+    rows = static_cast<double>(EstimateRows(filter->child_, db)) * EstimateSelectivity(filter->conds_, tables, db);
+  } else if (auto sort = std::dynamic_pointer_cast<SortPlan>(plan)) {
+    return EstimateRows(sort->child_, db);
+  } else if (auto proj = std::dynamic_pointer_cast<ProjectPlan>(plan)) {
+    return EstimateRows(proj->child_, db);
+  } else if (auto lim = std::dynamic_pointer_cast<LimitPlan>(plan)) {
+    return std::min(EstimateRows(lim->child_, db), lim->limit_);
+  } else if (auto join = std::dynamic_pointer_cast<JoinPlan>(plan)) {
+    std::vector<TableHandle *> tables;
+    CollectTables(join, db, tables);
+    auto left  = static_cast<double>(EstimateRows(join->left_, db));
+    auto right = static_cast<double>(EstimateRows(join->right_, db));
+    rows       = left * right * EstimateSelectivity(join->conds_, tables, db);
+    // every left record is kept by a left outer join
+    if (join->type_ == OUTER_JOIN) {
+      rows = std::max(rows, left);
+    }
+  } else {
+    return std::numeric_limits<size_t>::max() / 2;
+  }
+  return static_cast<size_t>(std::min(std::ceil(rows), static_cast<double>(std::numeric_limits<size_t>::max() / 2)));
+}
+
+auto Optimizer::EstimateCost(const std::shared_ptr<AbstractPlan> &plan, DatabaseHandle *db) -> PlanCost
+{
+  auto width = [db](const std::string &table_name) -> double {
+    auto tab = db->GetTable(table_name);
+    return tab == nullptr ? 0 : static_cast<double>(tab->GetTableHeader().rec_size_);
+  };
+  auto table_rows = [db](const std::string &table_name) -> double {
+    auto tab = db->GetTable(table_name);
+    return tab == nullptr ? 0 : static_cast<double>(tab->GetTableHeader().rec_num_);
+  };
+  PlanCost est{static_cast<double>(EstimateRows(plan, db)), 0, 0};
+  if (auto scan = std::dynamic_pointer_cast<ScanPlan>(plan)) {
+    auto tab = db->GetTable(scan->table_name_);
+    if (tab == nullptr) {
+      return est;
+    }
+    // pages the zone map skips are not read
+    auto pages = tab->GetTableHeader().page_num_ - std::min(scan->pruned_pages_, tab->GetTableHeader().page_num_);
+    est.cost_ =
+        CostModel::SeqScanCost(static_cast<double>(pages), table_rows(scan->table_name_), scan->conds_.size());
+    est.width_ = width(scan->table_name_);
+  } else if (auto idx_scan = std::dynamic_pointer_cast<IdxScanPlan>(plan)) {
+    est.cost_  = CostModel::IndexScanCost(table_rows(idx_scan->table_name_), est.rows_, idx_scan->index_only_);
+    est.width_ = width(idx_scan->table_name_);
+  } else if (auto bitmap_scan = std::dynamic_pointer_cast<BitmapScanPlan>(plan)) {
+    auto tab = db->GetTable(bitmap_scan->table_name_);
+    if (tab == nullptr) {
+      return est;
+    }
+    est.width_ = width(bitmap_scan->table_name_);
+    if (bitmap_scan->IsIndexOnly()) {
+      est.cost_ = CostModel::IndexScanCost(table_rows(bitmap_scan->table_name_), est.rows_, true);
+      return est;
+    }
+    for (const auto &scan_of_idx : bitmap_scan->index_scans_) {
+      est.cost_ += CostModel::IndexScanCost(
+          table_rows(bitmap_scan->table_name_), static_cast<double>(EstimateRows(scan_of_idx, db)), true);
+    }
+    est.cost_ += CostModel::BitmapHeapCost(static_cast<double>(tab->GetTableHeader().page_num_), est.rows_);
+  } else if (auto filter = std::dynamic_pointer_cast<FilterPlan>(plan)) {
+    auto child = EstimateCost(filter->child_, db);
+    est.cost_  = child.cost_ + child.rows_ * static_cast<double>(filter->conds_.size()) * CPU_OPERATOR_COST;
+    est.width_ = child.width_;
+  } else if (auto sort = std::dynamic_pointer_cast<SortPlan>(plan)) {
+    auto child = EstimateCost(sort->child_, db);
+    est.cost_  = child.cost_ + CostModel::SortCost(child);
+    est.width_ = child.width_;
+  } else if (auto proj = std::dynamic_pointer_cast<ProjectPlan>(plan)) {
+    return EstimateCost(proj->child_, db);
+  } else if (auto lim = std::dynamic_pointer_cast<LimitPlan>(plan)) {
+    // the input may be blocking, e.g. a sort, so its cost is not scaled down by the limit
+    auto child = EstimateCost(lim->child_, db);
+    est.cost_  = child.cost_;
+    est.width_ = child.width_;
+  } else if (auto join = std::dynamic_pointer_cast<JoinPlan>(plan)) {
+    auto left  = EstimateCost(join->left_, db);
+    auto right = EstimateCost(join->right_, db);
+    est.width_ = left.width_ + right.width_;
+    switch (join->strategy_) {
+      case INDEX_NESTED_LOOP: {
+        auto inner = std::dynamic_pointer_cast<ScanPlan>(join->right_);
+        est.cost_  = CostModel::IndexJoinCost(left, inner == nullptr ? 0 : table_rows(inner->table_name_), est.rows_);
+        break;
+      }
+      case HASH_JOIN: est.cost_ = CostModel::HashJoinCost(left, right, est.rows_); break;
+      case SORT_MERGE: {
+        std::vector<RTField> left_keys;
+        std::vector<RTField> right_keys;
+        for (const auto &cond : join->conds_) {
+          left_keys.push_back(cond.GetLCol());
+          right_keys.push_back(cond.GetRCol());
+        }
+        est.cost_ = CostModel::SortMergeJoinCost(left,
+            right,
+            est.rows_,
+            !IsOrderedOn(join->left_, left_keys, db),
+            !IsOrderedOn(join->right_, right_keys, db));
+        break;
+      }
+      default: est.cost_ = CostModel::NestedLoopJoinCost(left, right, est.rows_, join->conds_.size()); break;
+    }
+  }
+  return est;
+}
+
+void Optimizer::CollectEstimates(const std::shared_ptr<AbstractPlan> &plan, DatabaseHandle *db,
+    std::unordered_map<const AbstractPlan *, std::pair<double, double>> &estimates)
+{
+  if (plan == nullptr) {
+    return;
+  }
+  auto est              = EstimateCost(plan, db);
+  estimates[plan.get()] = {est.rows_, est.cost_};
+  if (auto filter = std::dynamic_pointer_cast<FilterPlan>(plan)) {
+    CollectEstimates(filter->child_, db, estimates);
+  } else if (auto bitmap_scan = std::dynamic_pointer_cast<BitmapScanPlan>(plan)) {
+    for (const auto &idx_scan : bitmap_scan->index_scans_) {
+      CollectEstimates(idx_scan, db, estimates);
+    }
+  } else if (auto sort = std::dynamic_pointer_cast<SortPlan>(plan)) {
+    CollectEstimates(sort->child_, db, estimates);
+  } else if (auto proj = std::dynamic_pointer_cast<ProjectPlan>(plan)) {
+    CollectEstimates(proj->child_, db, estimates);
+  } else if (auto join = std::dynamic_pointer_cast<JoinPlan>(plan)) {
+    CollectEstimates(join->left_, db, estimates);
+    CollectEstimates(join->right_, db, estimates);
+  } else if (auto agg = std::dynamic_pointer_cast<AggregatePlan>(plan)) {
+    CollectEstimates(agg->child_, db, estimates);
+  } else if (auto lim = std::dynamic_pointer_cast<LimitPlan>(plan)) {
+    CollectEstimates(lim->child_, db, estimates);
+  } else if (auto gather = std::dynamic_pointer_cast<GatherPlan>(plan)) {
+    CollectEstimates(gather->child_, db, estimates);
+  } else if (auto upd = std::dynamic_pointer_cast<UpdatePlan>(plan)) {
+    CollectEstimates(upd->child_, db, estimates);
+  } else if (auto del = std::dynamic_pointer_cast<DeletePlan>(plan)) {
+    CollectEstimates(del->child_, db, estimates);
+  } else if (auto copy = std::dynamic_pointer_cast<CopyToPlan>(plan)) {
+    CollectEstimates(copy->child_, db, estimates);
+  }
+}
+
+auto Optimizer::EstimateSelectivity(
+    const ConditionVec &conds, const std::vector<TableHandle *> &tables, DatabaseHandle *db) -> double
+{
+  auto stats_of = [&tables, db](const RTField &field) -> TableStatsSptr {
+    for (auto tab : tables) {
+      if (tab->GetTableId() == field.field_.table_id_) {
+        return TableStats::Get(db->GetName(), tab);
+      }
+    }
+    return nullptr;
+  };
+  double sel = 1;
+  for (const auto &cond : conds) {
+    auto lhs = stats_of(cond.GetLCol());
+    if (cond.GetRhsType() == kColumn && cond.GetRCol().field_.table_id_ != cond.GetLCol().field_.table_id_) {
+      // a join condition, each side has its own table
+      auto rhs = stats_of(cond.GetRCol());
+      if (cond.GetOp() != OP_EQ && cond.GetOp() != OP_NE) {
+        sel *= DEFAULT_RANGE_SELECTIVITY;
+        continue;
+      }
+      auto eq = TableStats::EstimateJoinSelectivity(lhs == nullptr ? nullptr : lhs->GetColumn(cond.GetLCol()),
+          rhs == nullptr ? nullptr : rhs->GetColumn(cond.GetRCol()));
+      sel *= cond.GetOp() == OP_EQ ? eq : 1 - eq;
+      continue;
+    }
+    sel *= lhs == nullptr ? TableStats::DefaultSelectivity(cond) : lhs->EstimateSelectivity(cond);
+  }
+  return sel;
+}
+
+void Optimizer::CollectTables(
+    const std::shared_ptr<AbstractPlan> &plan, DatabaseHandle *db, std::vector<TableHandle *> &tables)
+{
+  auto add_table = [db, &tables](const std::string &table_name) {
+    if (auto tab = db->GetTable(table_name)) {
+      tables.push_back(tab);
+    }
+  };
+  if (auto scan = std::dynamic_pointer_cast<ScanPlan>(plan)) {
+    add_table(scan->table_name_);
+  } else if (auto idx_scan = std::dynamic_pointer_cast<IdxScanPlan>(plan)) {
+    add_table(idx_scan->table_name_);
+  } else if (auto bitmap_scan = std::dynamic_pointer_cast<BitmapScanPlan>(plan)) {
+    add_table(bitmap_scan->table_name_);
+  } else if (auto filter = std::dynamic_pointer_cast<FilterPlan>(plan)) {
+    CollectTables(filter->child_, db, tables);
+  } else if (auto sort = std::dynamic_pointer_cast<SortPlan>(plan)) {
+    CollectTables(sort->child_, db, tables);
+  } else if (auto proj = std::dynamic_pointer_cast<ProjectPlan>(plan)) {
+    CollectTables(proj->child_, db, tables);
+  } else if (auto join = std::dynamic_pointer_cast<JoinPlan>(plan)) {
+    CollectTables(join->left_, db, tables);
+    CollectTables(join->right_, db, tables);
+  }
+}
+
+void Optimizer::PruneScanColumns(
+    const std::shared_ptr<AbstractPlan> &plan, const std::vector<RTField> *required, DatabaseHandle *db)
+{
+  auto add_cond_fields = [](std::vector<RTField> &fields, const ConditionVec &conds) {
+    for (const auto &cond : conds) {
+      fields.push_back(cond.GetLCol());
+      if (cond.GetRhsType() == kColumn) {
+        fields.push_back(cond.GetRCol());
+      }
+    }
+  };
+  if (auto scan = std::dynamic_pointer_cast<ScanPlan>(plan)) {
+    auto tab = db->GetTable(scan->table_name_);
+    if (required == nullptr || tab == nullptr) {
+      return;
+    }
+    scan->proj_fields_.clear();
+    for (const auto &field : tab->GetSchema().GetFields()) {
+      auto it = std::find_if(required->begin(), required->end(), [&field](const RTField &f) {
+        return f.field_.table_id_ == field.field_.table_id_ && f.field_.field_name_ == field.field_.field_name_;
+      });
+      if (it != required->end()) {
+        scan->proj_fields_.push_back(field);
+      }
+    }
+    // nothing of the table is referenced, e.g. count(*), still keep one field to produce the records
+    if (scan->proj_fields_.empty()) {
+      scan->proj_fields_.push_back(tab->GetSchema().GetFieldAt(0));
+    }
+    // reading all fields is the same as no projection
+    if (scan->proj_fields_.size() == tab->GetSchema().GetFieldCount()) {
+      scan->proj_fields_.clear();
+    }
+  } else if (auto idx_scan = std::dynamic_pointer_cast<IdxScanPlan>(plan)) {
+    auto tab = db->GetTable(idx_scan->table_name_);
+    auto idx = db->GetIndex(idx_scan->idx_id_);
+    if (required == nullptr || tab == nullptr || idx == nullptr) {
+      return;
+    }
+    // the index covers the query if it stores every referenced field of the table, the heap is then never read
+    const auto &index_fields = idx->GetKeySchema().GetFields();
+    idx_scan->index_only_    = std::all_of(required->begin(), required->end(), [&](const RTField &f) {
+      return f.field_.table_id_ != tab->GetTableId() ||
+             std::any_of(index_fields.begin(), index_fields.end(), [&f](const RTField &field) {
+               return f.field_.field_name_ == field.field_.field_name_;
+             });
+    });
+  } else if (auto bitmap_scan = std::dynamic_pointer_cast<BitmapScanPlan>(plan)) {
+    // a single index scan that covers the query skips the bitmap, several of them still need the table
+    if (bitmap_scan->index_scans_.size() == 1) {
+      PruneScanColumns(bitmap_scan->index_scans_.front(), required, db);
+    }
+  } else if (auto proj = std::dynamic_pointer_cast<ProjectPlan>(plan)) {
+    PruneScanColumns(proj->child_, &proj->schema_->GetFields(), db);
+  } else if (auto agg = std::dynamic_pointer_cast<AggregatePlan>(plan)) {
+    std::vector<RTField> fields = agg->group_fields_;
+    fields.insert(fields.end(), agg->agg_fields.begin(), agg->agg_fields.end());
+    PruneScanColumns(agg->child_, &fields, db);
+  } else if (auto filter = std::dynamic_pointer_cast<FilterPlan>(plan)) {
+    if (required == nullptr) {
+      PruneScanColumns(filter->child_, nullptr, db);
+      return;
+    }
+    std::vector<RTField> fields = *required;
+    add_cond_fields(fields, filter->conds_);
+    PruneScanColumns(filter->child_, &fields, db);
+  } else if (auto sort = std::dynamic_pointer_cast<SortPlan>(plan)) {
+    if (required == nullptr) {
+      PruneScanColumns(sort->child_, nullptr, db);
+      return;
+    }
+    std::vector<RTField> fields = *required;
+    fields.insert(fields.end(), sort->key_schema_->GetFields().begin(), sort->key_schema_->GetFields().end());
+    PruneScanColumns(sort->child_, &fields, db);
+  } else if (auto join = std::dynamic_pointer_cast<JoinPlan>(plan)) {
+    if (required == nullptr) {
+      PruneScanColumns(join->left_, nullptr, db);
+      PruneScanColumns(join->right_, nullptr, db);
+      return;
+    }
+    // every scan only keeps the fields of its own table, so both sides can share the list
+    std::vector<RTField> fields = *required;
+    add_cond_fields(fields, join->conds_);
+    PruneScanColumns(join->left_, &fields, db);
+    PruneScanColumns(join->right_, &fields, db);
+  } else if (auto lim = std::dynamic_pointer_cast<LimitPlan>(plan)) {
+    PruneScanColumns(lim->child_, required, db);
+  }
+}
+
 auto Optimizer::PhysicalOptimize(
     std::shared_ptr<AbstractPlan> plan, DatabaseHandle *db) -> std::shared_ptr<AbstractPlan>
 {
+  // update and delete modify the table they scan, keep them on one thread
+  if (std::dynamic_pointer_cast<UpdatePlan>(plan) != nullptr || std::dynamic_pointer_cast<DeletePlan>(plan) != nullptr) {
+    return plan;
+  }
+  auto dop = ThreadPool::ResolveDop(Session::Current().GetDop());
+  if (dop > 1) {
+    plan = ParallelizeScan(plan, db, dop);
+  }
+  return plan;
+}
+
+auto Optimizer::ParallelizeScan(
+    std::shared_ptr<AbstractPlan> plan, DatabaseHandle *db, size_t dop) -> std::shared_ptr<AbstractPlan>
+{
+  if (auto scan = GetPipelineScan(plan)) {
+    auto tab = db->GetTable(scan->table_name_);
+    if (tab == nullptr) {
+      return plan;
+    }
+    auto page_num = tab->GetTableHeader().page_num_;
+    if (page_num < PARALLEL_SCAN_MIN_PAGES) {
+      return plan;
+    }
+    // every worker pins at most one table page at a time, leave half of the buffer pool to the rest of the plan
+    dop = std::min({dop, page_num / MORSEL_PAGE_NUM, std::max<size_t>(BUFFER_POOL_SIZE / 2, 1)});
+    if (dop <= 1) {
+      return plan;
+    }
+    return std::make_shared<GatherPlan>(plan, scan->table_name_, dop);
+  }
+  if (auto filter = std::dynamic_pointer_cast<FilterPlan>(plan)) {
+    filter->child_ = ParallelizeScan(filter->child_, db, dop);
+  } else if (auto sort = std::dynamic_pointer_cast<SortPlan>(plan)) {
+    sort->child_ = ParallelizeScan(sort->child_, db, dop);
+  } else if (auto proj = std::dynamic_pointer_cast<ProjectPlan>(plan)) {
+    proj->child_ = ParallelizeScan(proj->child_, db, dop);
+  } else if (auto join = std::dynamic_pointer_cast<JoinPlan>(plan)) {
+    join->left_ = ParallelizeScan(join->left_, db, dop);
+    // the inner side of a nested loop join is rescanned for every outer record, starting workers each time does not
+    // pay, and the inner side of an index join is only probed
+    if (join->strategy_ == SORT_MERGE || join->strategy_ == HASH_JOIN) {
+      join->right_ = ParallelizeScan(join->right_, db, dop);
+    }
+  } else if (auto agg = std::dynamic_pointer_cast<AggregatePlan>(plan)) {
+    agg->child_ = ParallelizeScan(agg->child_, db, dop);
+  } else if (auto lim = std::dynamic_pointer_cast<LimitPlan>(plan)) {
+    lim->child_ = ParallelizeScan(lim->child_, db, dop);
+  }
   return plan;
 }
 
+auto Optimizer::GetPipelineScan(const std::shared_ptr<AbstractPlan> &plan) -> std::shared_ptr<ScanPlan>
+{
+  if (auto scan = std::dynamic_pointer_cast<ScanPlan>(plan)) {
+    return scan;
+  } else if (auto filter = std::dynamic_pointer_cast<FilterPlan>(plan)) {
+    return GetPipelineScan(filter->child_);
+  } else if (auto proj = std::dynamic_pointer_cast<ProjectPlan>(plan)) {
+    return GetPipelineScan(proj->child_);
+  }
+  return nullptr;
+}
+
 auto Optimizer::CanIndexScan(ConditionVec &conds, ConditionVec &index_conds, const std::list<IndexHandle *> &indexes,
     size_t &max_matched_fields) -> IndexHandle *
 {
   std::vector<int> best_conds_pos;
+  std::vector<int> best_range_pos;
   max_matched_fields      = 0;
   IndexHandle *best_index = nullptr;
   for (const auto idx : indexes) {
+    bool             is_hash = idx->GetIndexType() == IndexType::HASH;
     std::vector<int> tmp_conds_pos;
-    for (const auto &field : idx->GetKeySchema().GetFields()) {
-      bool matched = false;
+    std::vector<int> tmp_range_pos;
+    // the included fields after the key only ride along in the leaves, they are not ordered
+    const auto &key_fields = idx->GetKeySchema().GetFields();
+    auto        key_num    = idx->GetIndex()->GetKeyFieldNum();
+    size_t      range_num  = 1;
+    for (auto it = key_fields.begin(); it != key_fields.begin() + key_num; ++it) {
+      const auto &field   = *it;
+      bool        matched = false;
+      bool        capped  = false;
       for (int i = 0; i < static_cast<int>(conds.size()); ++i) {
         auto       &cond = conds[i];
         const auto &lcol = cond.GetLCol();
-        if (lcol.field_.table_id_ == field.field_.table_id_ && lcol.field_.field_name_ == field.field_.field_name_) {
-          matched = true;
-          if (cond.GetOp() != OP_EQ) {
-            matched = false;
+        if (lcol.field_.table_id_ != field.field_.table_id_ || lcol.field_.field_name_ != field.field_.field_name_ ||
+            cond.GetRhsType() != kValue) {
+          continue;
+        }
+        // equalities on a constant pin a key field, an IN list is probed value by value. The scan has a range for
+        // every combination of the IN values, a list that makes too many of them ends the prefix
+        if (auto list = std::dynamic_pointer_cast<ArrayValue>(cond.GetRVal());
+            cond.GetOp() == OP_IN && list != nullptr) {
+          auto value_num = std::max<size_t>(list->Get().size(), 1);
+          if (!tmp_conds_pos.empty() && range_num * value_num > INDEX_SCAN_MAX_RANGES) {
+            capped = true;
+            continue;
           }
+          range_num *= value_num;
+          matched = true;
+        }
+        if (cond.GetOp() == OP_EQ || matched) {
+          matched = true;
           tmp_conds_pos.push_back(i);
           break;
         }
       }
-      if (!matched) {
+      if (matched) {
+        continue;
+      }
+      if (capped) {
         break;
       }
+      // the entries of a b+ tree with the same prefix are ordered by the next field, so its ranges bound the scan
+      for (int i = 0; !is_hash && i < static_cast<int>(conds.size()); ++i) {
+        auto       &cond = conds[i];
+        const auto &lcol = cond.GetLCol();
+        auto        op   = cond.GetOp();
+        if (lcol.field_.table_id_ == field.field_.table_id_ && lcol.field_.field_name_ == field.field_.field_name_ &&
+            cond.GetRhsType() == kValue && (op == OP_LT || op == OP_LE || op == OP_GT || op == OP_GE)) {
+          tmp_range_pos.push_back(i);
+        }
+      }
+      break;
+    }
+    // a hash index can only probe the full key
+    if (is_hash && tmp_conds_pos.size() != key_num) {
+      continue;
+    }
+    // more matched fields first, then more equalities. A hash index is preferred over a b+ tree for the same
+    // equalities, a probe costs one bucket instead of a descent
+    auto tmp_fields  = tmp_conds_pos.size() + (tmp_range_pos.empty() ? 0 : 1);
+    auto best_fields = best_conds_pos.size() + (best_range_pos.empty() ? 0 : 1);
+    if (tmp_fields == 0) {
+      continue;
     }
-    if (tmp_conds_pos.size() > best_conds_pos.size()) {
+    if (tmp_fields > best_fields ||
+        (tmp_fields == best_fields && tmp_conds_pos.size() > best_conds_pos.size()) ||
+        (tmp_fields == best_fields && tmp_conds_pos.size() == best_conds_pos.size() && is_hash &&
+            best_index->GetIndexType() != IndexType::HASH)) {
       best_conds_pos = tmp_conds_pos;
+      best_range_pos = tmp_range_pos;
       best_index     = idx;
     }
   }
-  max_matched_fields = best_conds_pos.size();
+  max_matched_fields = best_conds_pos.size() + (best_range_pos.empty() ? 0 : 1);
   if (max_matched_fields == 0) {
     return nullptr;
   }
   index_conds.clear();
-  // add index conds;
+  // add index conds, the ranges go after the equalities
   for (auto pos : best_conds_pos) {
     index_conds.push_back(conds[pos]);
   }
-  // erase index conds from conds
+  for (auto pos : best_range_pos) {
+    index_conds.push_back(conds[pos]);
+  }
+  // erase the equalities from conds, from the back so that the positions stay valid. The ranges stay, the scan bounds
+  // are inclusive and let nulls in when there is no lower bound
+  std::sort(best_conds_pos.begin(), best_conds_pos.end(), std::greater<>());
   for (auto pos : best_conds_pos) {
     conds.erase(conds.begin() + pos);
   }
@@ -21,8 +21,10 @@
 
 #ifndef WSDB_OPTIMIZER_H
 #define WSDB_OPTIMIZER_H
+#include "optimizer/cost_model.h"
 #include "plan/plan.h"
 #include "system/handle/database_handle.h"
+#include "system/session.h"
 
 namespace wsdb {
 class Optimizer
@@ -34,19 +36,151 @@ public:
   static auto Optimize(std::shared_ptr<AbstractPlan> plan, DatabaseHandle *db) -> std::shared_ptr<AbstractPlan>;
 
 private:
+  // the rewrites that do not look at the catalog are tested one by one
+  friend class OptimizerTest;
+
+  /**
+   * move the conditions of filters and inner joins to the lowest plan that has all of their fields, so single table
+   * conditions end up right above their scans and take part in index selection. Inside a tree of inner joins the
+   * equalities between columns are closed transitively and comparisons with constants are copied to equal columns
+   * @param conds conditions pushed from above, all of them are checked somewhere in the returned plan
+   */
+  static auto PushDownPredicates(
+      std::shared_ptr<AbstractPlan> plan, ConditionVec conds, DatabaseHandle *db) -> std::shared_ptr<AbstractPlan>;
+
+  /// take the conditions of a tree of inner joins and of the filters right above its scans out of the plan
+  static void CollectJoinConditions(const std::shared_ptr<JoinPlan> &join, ConditionVec &conds);
+
+  /// put every condition in the lowest join or scan of a tree of inner joins that has all of its fields
+  static auto PlaceJoinConditions(
+      std::shared_ptr<AbstractPlan> plan, ConditionVec conds, DatabaseHandle *db) -> std::shared_ptr<AbstractPlan>;
+
+  /// append the conditions implied by the equalities between columns in conds
+  static void InferConditions(ConditionVec &conds);
+
   static auto LogicalOptimize(std::shared_ptr<AbstractPlan> plan, DatabaseHandle *db) -> std::shared_ptr<AbstractPlan>;
 
   static auto LogicalOptimizeScan(const std::shared_ptr<ScanPlan> &scan, ConditionVec conds,
       wsdb::DatabaseHandle *db) -> std::shared_ptr<AbstractPlan>;
 
-  static auto LogicalOptimizeJoin(std::shared_ptr<JoinPlan> join) -> std::shared_ptr<AbstractPlan>;
+  static auto LogicalOptimizeJoin(std::shared_ptr<JoinPlan> join, DatabaseHandle *db) -> std::shared_ptr<AbstractPlan>;
+
+  /**
+   * drop the sort if its input is already in order, otherwise read a single table through a b+ tree whose key order
+   * gives the sort order when that is cheaper than sorting
+   * @param limit number of records read from the sort, an ordered scan stops after them
+   */
+  static auto LogicalOptimizeSort(
+      const std::shared_ptr<SortPlan> &sort, size_t limit, DatabaseHandle *db) -> std::shared_ptr<AbstractPlan>;
+
+  /**
+   * the order of the records produced by the plan, they are ascending on the fields of order, the fields in pinned
+   * have the same value in every record
+   */
+  static void GetOrder(const std::shared_ptr<AbstractPlan> &plan, DatabaseHandle *db, std::vector<RTField> &order,
+      std::vector<RTField> &pinned);
+
+  /// check if the records produced by the plan are ascending on keys
+  static auto IsOrderedOn(
+      const std::shared_ptr<AbstractPlan> &plan, const std::vector<RTField> &keys, DatabaseHandle *db) -> bool;
+
+  /// arrange the conditions of an equi join so that the keys follow the order one of its sides already has
+  static void OrderJoinKeys(const std::shared_ptr<JoinPlan> &join, DatabaseHandle *db);
+
+  /// a plan joining the leaves in mask_ of a join tree being reordered
+  struct JoinEntry
+  {
+    std::shared_ptr<AbstractPlan> plan_;
+    uint64_t                      mask_{0};
+    PlanCost                      cost_;
+  };
+
+  /**
+   * reorder a tree of inner joins without a strategy hint. The best plan of a set of inputs is built from the best
+   * plans of two of its subsets by dynamic programming, or greedily by joining the cheapest pair first when there are
+   * more than DP_JOIN_MAX_TABLES inputs. Cross products are only considered when no condition connects the subsets
+   */
+  static auto ReorderJoins(const std::shared_ptr<JoinPlan> &join, DatabaseHandle *db) -> std::shared_ptr<AbstractPlan>;
+
+  /// the inputs and the conditions of a tree of inner joins without a strategy hint
+  static void FlattenJoins(const std::shared_ptr<AbstractPlan> &plan, std::vector<std::shared_ptr<AbstractPlan>> &leaves,
+      ConditionVec &conds);
+
+  /**
+   * set the cheapest of nested loop, hash and index nested loop join, an index nested loop join replaces the right side
+   * with the inner table scan
+   * @param left, right estimates of the two sides
+   * @param rows estimated records produced by the join
+   * @return the cost of the join
+   */
+  static auto ChooseJoinStrategy(const std::shared_ptr<JoinPlan> &join, const PlanCost &left, const PlanCost &right,
+      double rows, DatabaseHandle *db) -> double;
+
+  /// add the key schemas, sorts and runtime filter the strategy of the join needs
+  static auto FinishJoin(std::shared_ptr<JoinPlan> join, DatabaseHandle *db) -> std::shared_ptr<AbstractPlan>;
+
+  /**
+   * turn the join into an index nested loop join if the right side is a table with an index whose key prefix is
+   * matched by equalities on the left fields
+   * @param small_outer only if the left side is small enough that probing is cheaper than reading the right table
+   * @return true if the join has been changed
+   */
+  static auto CanIndexJoin(const std::shared_ptr<JoinPlan> &join, DatabaseHandle *db, bool small_outer) -> bool;
+
+  /**
+   * build a bloom filter on the right keys of an inner hash join if the right side is the smaller one, it is checked by
+   * the scan of the left table the left keys come from
+   */
+  static void AddRuntimeFilter(const std::shared_ptr<JoinPlan> &join, const std::vector<RTField> &left_key_fields,
+      const std::vector<RTField> &right_key_fields, DatabaseHandle *db);
+
+  /// the scan of the table in plan through filters, projections, sorts and joins, nullptr if there is none
+  static auto FindTableScan(
+      const std::shared_ptr<AbstractPlan> &plan, table_id_t table_id, DatabaseHandle *db) -> std::shared_ptr<ScanPlan>;
+
+  /// estimated number of records produced by the plan, from the statistics of ANALYZE when there are some
+  static auto EstimateRows(const std::shared_ptr<AbstractPlan> &plan, DatabaseHandle *db) -> size_t;
+
+  /// estimated size and cost of the plan under the cost model
+  static auto EstimateCost(const std::shared_ptr<AbstractPlan> &plan, DatabaseHandle *db) -> PlanCost;
+
+  /// the estimated records and cost of every node of the plan, by node
+  static void CollectEstimates(const std::shared_ptr<AbstractPlan> &plan, DatabaseHandle *db,
+      std::unordered_map<const AbstractPlan *, std::pair<double, double>> &estimates);
+
+  /**
+   * estimated fraction of the records satisfying all conds, which are assumed to be independent
+   * @param tables the tables the fields of conds belong to
+   */
+  static auto EstimateSelectivity(
+      const ConditionVec &conds, const std::vector<TableHandle *> &tables, DatabaseHandle *db) -> double;
+
+  /// the tables read by the plan
+  static void CollectTables(
+      const std::shared_ptr<AbstractPlan> &plan, DatabaseHandle *db, std::vector<TableHandle *> &tables);
+
+  /**
+   * read only the fields used by the plan above the table scans, required is nullptr when all fields are needed,
+   * e.g. no projection has been met yet or the root is a dml plan
+   */
+  static void PruneScanColumns(
+      const std::shared_ptr<AbstractPlan> &plan, const std::vector<RTField> *required, DatabaseHandle *db);
 
   static auto PhysicalOptimize(std::shared_ptr<AbstractPlan> plan, DatabaseHandle *db) -> std::shared_ptr<AbstractPlan>;
 
+  /// put a gather on top of every scan pipeline that is large enough to be split among dop workers
+  static auto ParallelizeScan(
+      std::shared_ptr<AbstractPlan> plan, DatabaseHandle *db, size_t dop) -> std::shared_ptr<AbstractPlan>;
+
+  /// return the table scan if plan is a chain of filters and projections over a table scan, otherwise nullptr
+  static auto GetPipelineScan(const std::shared_ptr<AbstractPlan> &plan) -> std::shared_ptr<ScanPlan>;
+
   /**
    * check if there is an index that can be used to scan the table,
    * and return the index with the most matched fields, should store
-   * the rearranged conditions in index_conds and erase them from conds
+   * the rearranged conditions in index_conds and erase them from conds.
+   * A prefix of the key is matched by equalities and IN lists, and a b+ tree also matches the ranges on
+   * the next key field. The ranges come last in index_conds and are kept in conds to be checked again
    * @param conds
    * @param index_conds
    * @param indexes
@@ -24,5 +24,6 @@
 namespace wsdb {
 namespace ast{
 std::shared_ptr<TreeNode> wsdb_ast_;
+size_t                    wsdb_param_num_{0};
 }
 }
@@ -55,8 +55,10 @@ struct Help : public TreeNode
 struct Explain : public TreeNode
 {
   std::shared_ptr<TreeNode> stmt;
+  bool                      analyze;  // run the statement and show what every operator did
 
-  explicit Explain(std::shared_ptr<TreeNode> stmt_) : stmt(std::move(stmt_)) {}
+  explicit Explain(std::shared_ptr<TreeNode> stmt_, bool analyze_ = false) : stmt(std::move(stmt_)), analyze(analyze_)
+  {}
 };
 
 struct ShowTables : public TreeNode
@@ -136,13 +138,26 @@ struct DescTable : public TreeNode
   DescTable(std::string tab_name) : tab_name_(std::move(tab_name)) {}
 };
 
+struct Analyze : public TreeNode
+{
+  std::string tab_name_;
+
+  explicit Analyze(std::string tab_name) : tab_name_(std::move(tab_name)) {}
+};
+
 struct CreateIndex : public TreeNode
 {
   std::string              tab_name_;
   std::vector<std::string> col_names_;
-
-  CreateIndex(std::string tab_name, std::vector<std::string> col_names)
-      : tab_name_(std::move(tab_name)), col_names_(std::move(col_names))
+  IndexType                index_type_;
+  std::vector<std::string> include_names_;  // non-key payload columns stored in the index leaves
+
+  CreateIndex(std::string tab_name, std::vector<std::string> col_names, IndexType index_type = IndexType::BPTREE,
+      std::vector<std::string> include_names = {})
+      : tab_name_(std::move(tab_name)),
+        col_names_(std::move(col_names)),
+        index_type_(index_type),
+        include_names_(std::move(include_names))
   {}
 };
 
@@ -150,9 +165,10 @@ struct DropIndex : public TreeNode
 {
   std::string              tab_name_;
   std::vector<std::string> col_names_;
+  std::vector<std::string> include_names_;
 
-  DropIndex(std::string tab_name, std::vector<std::string> col_names)
-      : tab_name_(std::move(tab_name)), col_names_(std::move(col_names))
+  DropIndex(std::string tab_name, std::vector<std::string> col_names, std::vector<std::string> include_names = {})
+      : tab_name_(std::move(tab_name)), col_names_(std::move(col_names)), include_names_(std::move(include_names))
   {}
 };
 
@@ -166,6 +182,43 @@ struct ShowIndexes : public TreeNode
 struct Expr : public TreeNode
 {};
 
+struct Value;
+
+struct SetVariable : public TreeNode
+{
+  std::string            name_;
+  std::shared_ptr<Value> val_;
+
+  SetVariable(std::string name, std::shared_ptr<Value> val) : name_(std::move(name)), val_(std::move(val)) {}
+};
+
+struct Prepare : public TreeNode
+{
+  std::string               name_;
+  std::shared_ptr<TreeNode> stmt_;
+  size_t                    param_num_;  // the ? in stmt_ are numbered from 0 in the order they appear
+
+  Prepare(std::string name, std::shared_ptr<TreeNode> stmt, size_t param_num)
+      : name_(std::move(name)), stmt_(std::move(stmt)), param_num_(param_num)
+  {}
+};
+
+struct Execute : public TreeNode
+{
+  std::string                         name_;
+  std::vector<std::shared_ptr<Value>> vals_;
+
+  Execute(std::string name, std::vector<std::shared_ptr<Value>> vals) : name_(std::move(name)), vals_(std::move(vals))
+  {}
+};
+
+struct Deallocate : public TreeNode
+{
+  std::string name_;
+
+  explicit Deallocate(std::string name) : name_(std::move(name)) {}
+};
+
 struct Value : public Expr
 {};
 
@@ -207,6 +260,13 @@ struct ArrLit : public Value
 struct NullLit : public Value
 {};
 
+struct ParamLit : public Value
+{
+  size_t idx_;
+
+  explicit ParamLit(size_t idx) : idx_(idx) {}
+};
+
 struct Col : public Expr
 {
   std::string tab_name;
@@ -268,11 +328,35 @@ struct GroupBy : public TreeNode
 
 struct InsertStmt : public TreeNode
 {
-  std::string                         tab_name;
-  std::vector<std::shared_ptr<Value>> vals;
+  std::string                                      tab_name;
+  std::vector<std::vector<std::shared_ptr<Value>>> rows;
+
+  InsertStmt(std::string tab_name_, std::vector<std::vector<std::shared_ptr<Value>>> rows_)
+      : tab_name(std::move(tab_name_)), rows(std::move(rows_))
+  {}
+};
+
+// COPY table FROM 'file'
+struct CopyFrom : public TreeNode
+{
+  std::string tab_name_;
+  std::string file_name_;
+  CopyFormat  format_;
 
-  InsertStmt(std::string tab_name_, std::vector<std::shared_ptr<Value>> vals_)
-      : tab_name(std::move(tab_name_)), vals(std::move(vals_))
+  CopyFrom(std::string tab_name, std::string file_name, CopyFormat format)
+      : tab_name_(std::move(tab_name)), file_name_(std::move(file_name)), format_(format)
+  {}
+};
+
+// COPY (query) TO 'file'
+struct CopyTo : public TreeNode
+{
+  std::shared_ptr<TreeNode> query_;
+  std::string               file_name_;
+  CopyFormat                format_;
+
+  CopyTo(std::shared_ptr<TreeNode> query, std::string file_name, CopyFormat format)
+      : query_(std::move(query)), file_name_(std::move(file_name)), format_(format)
   {}
 };
 
@@ -371,6 +455,10 @@ struct SemValue
 
   StorageModel sv_storage_model;
 
+  IndexType sv_index_type;
+
+  CopyFormat sv_copy_format;
+
   std::shared_ptr<TypeLen> sv_type_len;
 
   std::shared_ptr<Field>              sv_field;
@@ -381,6 +469,8 @@ struct SemValue
   std::shared_ptr<Value>              sv_val;
   std::vector<std::shared_ptr<Value>> sv_vals;
 
+  std::vector<std::vector<std::shared_ptr<Value>>> sv_rows;
+
   std::shared_ptr<AggCol>           sv_agg_col;
   std::shared_ptr<Col>              sv_col;
   std::vector<std::shared_ptr<Col>> sv_cols;
@@ -397,6 +487,8 @@ struct SemValue
 };
 
 extern std::shared_ptr<TreeNode> wsdb_ast_;
+// number of ? parameters read so far by the parser
+extern size_t wsdb_param_num_;
 
 }  // namespace ast
 
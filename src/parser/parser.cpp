@@ -20,6 +20,7 @@
 //
 
 #include "parser.h"
+#include <mutex>
 #include "def.h"
 #include "../common/error.h"
 
@@ -27,13 +28,21 @@ namespace wsdb {
 
 std::shared_ptr<ast::TreeNode> Parser::Parse(const std::string &sql)
 {
-  auto buf = yy_scan_string(sql.c_str());
+  // the scanner and the parser keep their state in globals
+  static std::mutex mutex;
+  std::scoped_lock  lock(mutex);
+  ast::wsdb_param_num_ = 0;
+  auto buf             = yy_scan_string(sql.c_str());
   if (yyparse() != 0) {
     yy_delete_buffer(buf);
     WSDB_THROW(WSDB_INVALID_SQL, sql);
   }
   auto ret = ast::wsdb_ast_;
   yy_delete_buffer(buf);
+  // only a prepared statement gets its parameters from the arguments of EXECUTE
+  if (ast::wsdb_param_num_ > 0 && std::dynamic_pointer_cast<ast::Prepare>(ret) == nullptr) {
+    WSDB_THROW(WSDB_INVALID_SQL, fmt::format("parameters outside of PREPARE: {}", sql));
+  }
   return ret;
 }
 
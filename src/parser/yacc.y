@@ -32,8 +32,9 @@ using namespace ast;
 %define parse.error verbose
 
 // keywords
-%token EXPLAIN SHOW TABLES CREATE TABLE DROP DESC INSERT INTO VALUES DELETE FROM OPEN DATABASE ON ASC AS ORDER GROUP BY SUM AVG MAX MIN COUNT IN STATIC_CHECKPOINT USING NESTED_LOOP_JOIN SORT_MERGE_JOIN
-WHERE HAVING UPDATE SET SELECT INT CHAR FLOAT BOOL INDEX AND JOIN INNER OUTER EXIT HELP TXN_BEGIN TXN_COMMIT TXN_ABORT TXN_ROLLBACK ORDER_BY ENABLE_NESTLOOP ENABLE_SORTMERGE STORAGE PAX NARY LIMIT
+%token EXPLAIN SHOW TABLES CREATE TABLE DROP DESC INSERT INTO VALUES DELETE FROM OPEN DATABASE ON ASC AS ORDER GROUP BY SUM AVG MAX MIN COUNT IN STATIC_CHECKPOINT USING NESTED_LOOP_JOIN SORT_MERGE_JOIN T_HASH_JOIN ANALYZE
+WHERE HAVING UPDATE SET SELECT INT CHAR FLOAT BOOL INDEX AND JOIN INNER OUTER EXIT HELP TXN_BEGIN TXN_COMMIT TXN_ABORT TXN_ROLLBACK ORDER_BY ENABLE_NESTLOOP ENABLE_SORTMERGE STORAGE PAX NARY LIMIT BTREE HASH BETWEEN INCLUDE PREPARE EXECUTE DEALLOCATE
+COPY TO FORMAT CSV BINARY
 // non-keywords
 %token LEQ NEQ GEQ T_EOF
 
@@ -44,19 +45,22 @@ WHERE HAVING UPDATE SET SELECT INT CHAR FLOAT BOOL INDEX AND JOIN INNER OUTER EX
 %token <sv_bool> VALUE_BOOL
 
 // specify types for non-terminal symbol
-%type <sv_node> stmt dbStmt ddl dml txnStmt indexStmt logStmt table
+%type <sv_node> stmt dbStmt ddl dml txnStmt indexStmt logStmt setStmt table
 %type <sv_sel> selectStmt
 %type <sv_field> field
 %type <sv_fields> fieldList
 %type <sv_type_len> type
 %type <sv_comp_op> op
 %type <sv_storage_model> optStorageModel
+%type <sv_index_type> optIndexType
+%type <sv_copy_format> optCopyFormat
 %type <sv_int> optLimit
 %type <sv_expr> expr
 %type <sv_val> value
 %type <sv_vals> valueList
+%type <sv_rows> rowList
 %type <sv_str> tbName colName optAlias
-%type <sv_strs> colNameList
+%type <sv_strs> colNameList optInclude
 %type <sv_node_arr> tableList
 %type <sv_col> col aggCol
 %type <sv_cols> colList selector colListWithoutAlias
@@ -82,6 +86,33 @@ start:
         wsdb_ast_ = std::make_shared<Explain>($2);
         YYACCEPT;
     }
+    |
+        EXPLAIN ANALYZE stmt ';'
+    {
+        wsdb_ast_ = std::make_shared<Explain>($3, true);
+        YYACCEPT;
+    }
+    |
+        PREPARE IDENTIFIER AS stmt ';'
+    {
+        wsdb_ast_ = std::make_shared<Prepare>($2, $4, wsdb_param_num_);
+        YYACCEPT;
+    }
+    |   EXECUTE IDENTIFIER ';'
+    {
+        wsdb_ast_ = std::make_shared<Execute>($2, std::vector<std::shared_ptr<Value>>{});
+        YYACCEPT;
+    }
+    |   EXECUTE IDENTIFIER '(' valueList ')' ';'
+    {
+        wsdb_ast_ = std::make_shared<Execute>($2, $4);
+        YYACCEPT;
+    }
+    |   DEALLOCATE IDENTIFIER ';'
+    {
+        wsdb_ast_ = std::make_shared<Deallocate>($2);
+        YYACCEPT;
+    }
     |   HELP
     {
         wsdb_ast_ = std::make_shared<Help>();
@@ -106,9 +137,17 @@ stmt:
     |   txnStmt
     |   indexStmt
     |   logStmt
+    |   setStmt
     |   /*empty*/ { $$ = nullptr; }
     ;
 
+setStmt:
+        SET IDENTIFIER '=' value
+    {
+        $$ = std::make_shared<SetVariable>($2, $4);
+    }
+    ;
+
 txnStmt:
         TXN_BEGIN
     {
@@ -168,16 +207,42 @@ ddl:
     {
         $$ = std::make_shared<DescTable>($2);
     }
-    |   CREATE INDEX tbName '(' colNameList ')'
+    |   ANALYZE tbName
+    {
+        $$ = std::make_shared<Analyze>($2);
+    }
+    |   CREATE INDEX tbName '(' colNameList ')' optInclude optIndexType
     {
-        $$ = std::make_shared<CreateIndex>($3, $5);
+        $$ = std::make_shared<CreateIndex>($3, $5, $8, $7);
     }
-    |   DROP INDEX tbName '(' colNameList ')'
+    |   DROP INDEX tbName '(' colNameList ')' optInclude
     {
-        $$ = std::make_shared<DropIndex>($3, $5);
+        $$ = std::make_shared<DropIndex>($3, $5, $7);
     }
     ;
 
+optInclude:
+    /* epsilon */ { $$ = std::vector<std::string>{}; }
+    | INCLUDE '(' colNameList ')'
+    { $$ = $3; }
+    ;
+
+optIndexType:
+    /* epsilon */ { $$ = IndexType::BPTREE; }
+    | USING BTREE
+    { $$ = IndexType::BPTREE; }
+    | USING HASH
+    { $$ = IndexType::HASH; }
+    ;
+
+optCopyFormat:
+    /* epsilon */ { $$ = CopyFormat::CSV; }
+    | FORMAT CSV
+    { $$ = CopyFormat::CSV; }
+    | FORMAT BINARY
+    { $$ = CopyFormat::BINARY; }
+    ;
+
 optStorageModel:
     /* epsilon */ { $$ = NARY_MODEL; }
     | STORAGE '=' NARY
@@ -187,9 +252,17 @@ optStorageModel:
     ;
 
 dml:
-        INSERT INTO tbName VALUES '(' valueList ')'
+        INSERT INTO tbName VALUES rowList
     {
-        $$ = std::make_shared<InsertStmt>($3, $6);
+        $$ = std::make_shared<InsertStmt>($3, $5);
+    }
+    |   COPY tbName FROM VALUE_STRING optCopyFormat
+    {
+        $$ = std::make_shared<CopyFrom>($2, $4, $5);
+    }
+    |   COPY '(' selectStmt ')' TO VALUE_STRING optCopyFormat
+    {
+        $$ = std::make_shared<CopyTo>($3, $6, $7);
     }
     |   DELETE FROM tbName optWhereClause
     {
@@ -268,6 +341,17 @@ type:
     }
     ;
 
+rowList:
+        '(' valueList ')'
+    {
+        $$ = std::vector<std::vector<std::shared_ptr<Value>>>{$2};
+    }
+    |   rowList ',' '(' valueList ')'
+    {
+        $$.push_back($4);
+    }
+    ;
+
 valueList:
         value
     {
@@ -296,6 +380,10 @@ value:
     {
         $$ = std::make_shared<BoolLit>($1);
     }
+    |   '?'
+    {
+        $$ = std::make_shared<ParamLit>(wsdb_param_num_++);
+    }
     | /* epsilon */
     {
         $$ = std::make_shared<NullLit>();
@@ -350,11 +438,13 @@ optWhereClause:
     ;
 
 optUsingJoinClause:
-    /* epsilon */ {$$ = NESTED_LOOP;}
+    /* epsilon */ {$$ = AUTO_JOIN;}
     |   USING NESTED_LOOP_JOIN
     {   $$ = NESTED_LOOP;  }
     |   USING SORT_MERGE_JOIN
     {   $$ = SORT_MERGE;}
+    |   USING T_HASH_JOIN
+    {   $$ = HASH_JOIN;}
 
 conditionAgg:
         aggCol op value
@@ -396,10 +486,20 @@ whereClause:
     {
         $$ = std::vector<std::shared_ptr<BinaryExpr>>{$1};
     }
+    |   col BETWEEN value AND value
+    {
+        $$ = std::vector<std::shared_ptr<BinaryExpr>>{
+            std::make_shared<BinaryExpr>($1, OP_GE, $3), std::make_shared<BinaryExpr>($1, OP_LE, $5)};
+    }
     |   whereClause AND condition
     {
         $$.push_back($3);
     }
+    |   whereClause AND col BETWEEN value AND value
+    {
+        $$.push_back(std::make_shared<BinaryExpr>($3, OP_GE, $5));
+        $$.push_back(std::make_shared<BinaryExpr>($3, OP_LE, $7));
+    }
     ;
 
 col:
@@ -21,10 +21,12 @@
 
 #ifndef WSDB_PLAN_H
 #define WSDB_PLAN_H
+#include <unordered_map>
 #include <utility>
 
 #include "system/handle/record_handle.h"
 #include "common/condition.h"
+#include "expr/runtime_filter.h"
 
 #define TAB_STR(level) std::string(2 * level, ' ')
 
@@ -40,9 +42,14 @@ public:
 class ExplainPlan : public AbstractPlan
 {
 public:
-  explicit ExplainPlan(std::shared_ptr<AbstractPlan> plan) : logical_plan_(std::move(plan)) {}
+  explicit ExplainPlan(std::shared_ptr<AbstractPlan> plan, bool analyze = false)
+      : logical_plan_(std::move(plan)), analyze_(analyze)
+  {}
 
   std::shared_ptr<AbstractPlan> logical_plan_;
+  bool                          analyze_;  // run the plan and show what every operator did next to the estimates
+  // estimated records and cost of the nodes of logical_plan_, filled by the optimizer for EXPLAIN ANALYZE
+  std::unordered_map<const AbstractPlan *, std::pair<double, double>> estimates_;
 };
 
 class CreateDBPlan : public AbstractPlan
@@ -108,29 +115,148 @@ public:
   std::string table_name_;
 };
 
+class AnalyzePlan : public AbstractPlan
+{
+public:
+  explicit AnalyzePlan(std::string table_name) : table_name_(std::move(table_name)) {}
+  auto ToString(int level) const -> std::string override
+  {
+    return fmt::format("{}AnalyzePlan [{}]", TAB_STR(level), table_name_);
+  }
+  std::string table_name_;
+};
+
 class ShowTablesPlan : public AbstractPlan
 {
   auto ToString(int level) const -> std::string override { return fmt::format("{}ShowTablesPlan", TAB_STR(level)); }
 };
 
+class CreateIndexPlan : public AbstractPlan
+{
+public:
+  CreateIndexPlan(std::string table_name, std::vector<RTField> key_fields, IndexType index_type, size_t include_num = 0)
+      : table_name_(std::move(table_name)),
+        key_fields_(std::move(key_fields)),
+        index_type_(index_type),
+        include_num_(include_num)
+  {}
+  auto ToString(int level) const -> std::string override
+  {
+    std::string key_str;
+    std::string include_str;
+    for (size_t i = 0; i < key_fields_.size(); ++i) {
+      auto &str = i + include_num_ < key_fields_.size() ? key_str : include_str;
+      str += (str.empty() ? "" : ", ") + key_fields_[i].field_.field_name_;
+    }
+    return fmt::format("{}CreateIndexPlan [{}] <{}>{} {}",
+        TAB_STR(level),
+        table_name_,
+        key_str,
+        include_num_ > 0 ? fmt::format(" include <{}>", include_str) : "",
+        index_type_ == IndexType::HASH ? "HASH" : "BPTREE");
+  }
+  std::string          table_name_;
+  std::vector<RTField> key_fields_;   // key columns followed by the included columns
+  IndexType            index_type_;
+  size_t               include_num_;  // number of trailing non-key columns in key_fields_
+};
+
+class DropIndexPlan : public AbstractPlan
+{
+public:
+  DropIndexPlan(std::string table_name, std::vector<RTField> key_fields, size_t include_num = 0)
+      : table_name_(std::move(table_name)), key_fields_(std::move(key_fields)), include_num_(include_num)
+  {}
+  auto ToString(int level) const -> std::string override
+  {
+    std::string key_str;
+    std::string include_str;
+    for (size_t i = 0; i < key_fields_.size(); ++i) {
+      auto &str = i + include_num_ < key_fields_.size() ? key_str : include_str;
+      str += (str.empty() ? "" : ", ") + key_fields_[i].field_.field_name_;
+    }
+    return fmt::format("{}DropIndexPlan [{}] <{}>{}",
+        TAB_STR(level),
+        table_name_,
+        key_str,
+        include_num_ > 0 ? fmt::format(" include <{}>", include_str) : "");
+  }
+  std::string          table_name_;
+  std::vector<RTField> key_fields_;   // key columns followed by the included columns
+  size_t               include_num_;  // number of trailing non-key columns in key_fields_
+};
+
+class ShowIndexesPlan : public AbstractPlan
+{
+public:
+  explicit ShowIndexesPlan(std::string table_name) : table_name_(std::move(table_name)) {}
+  auto ToString(int level) const -> std::string override
+  {
+    return fmt::format("{}ShowIndexesPlan [{}]", TAB_STR(level), table_name_);
+  }
+  std::string table_name_;
+};
+
 class InsertPlan : public AbstractPlan
 {
 public:
-  InsertPlan(std::string table_name, std::vector<ValueSptr> values)
-      : table_name_(std::move(table_name)), values_(std::move(values))
+  InsertPlan(std::string table_name, std::vector<std::vector<ValueSptr>> rows)
+      : table_name_(std::move(table_name)), rows_(std::move(rows))
   {}
   auto ToString(int level) const -> std::string override
   {
+    // a bulk insert only shows its first row, the rest are summarized by the row count
     std::string value_str;
-    for (const auto &value : values_) {
+    for (const auto &value : rows_.front()) {
       value_str += value->ToString() + ", ";
     }
     value_str.back() = ')';
     value_str        = "(" + value_str;
+    if (rows_.size() > 1) {
+      value_str += fmt::format(" ... {} rows", rows_.size());
+    }
     return fmt::format("{}InsertPlan [{}] <{}>", TAB_STR(level), table_name_, value_str);
   }
-  std::string            table_name_;
-  std::vector<ValueSptr> values_;
+  std::string                         table_name_;
+  std::vector<std::vector<ValueSptr>> rows_;
+};
+
+class CopyFromPlan : public AbstractPlan
+{
+public:
+  CopyFromPlan(std::string table_name, std::string file_name, CopyFormat format)
+      : table_name_(std::move(table_name)), file_name_(std::move(file_name)), format_(format)
+  {}
+  auto ToString(int level) const -> std::string override
+  {
+    return fmt::format("{}CopyFromPlan [{}] <'{}' {}>",
+        TAB_STR(level),
+        table_name_,
+        file_name_,
+        format_ == CopyFormat::CSV ? "CSV" : "BINARY");
+  }
+  std::string table_name_;
+  std::string file_name_;
+  CopyFormat  format_;
+};
+
+class CopyToPlan : public AbstractPlan
+{
+public:
+  CopyToPlan(std::shared_ptr<AbstractPlan> child, std::string file_name, CopyFormat format)
+      : child_(std::move(child)), file_name_(std::move(file_name)), format_(format)
+  {}
+  auto ToString(int level) const -> std::string override
+  {
+    return fmt::format("{}CopyToPlan <'{}' {}>\n{}",
+        TAB_STR(level),
+        file_name_,
+        format_ == CopyFormat::CSV ? "CSV" : "BINARY",
+        child_->ToString(level + 1));
+  }
+  std::shared_ptr<AbstractPlan> child_;
+  std::string                   file_name_;
+  CopyFormat                    format_;
 };
 
 class UpdatePlan : public AbstractPlan
@@ -195,9 +321,40 @@ public:
   explicit ScanPlan(std::string table_name) : table_name_(std::move(table_name)) {}
   auto ToString(int level) const -> std::string override
   {
-    return fmt::format("{}ScanPlan [{}]", TAB_STR(level), table_name_);
+    std::string cond_str;
+    if (!conds_.empty()) {
+      cond_str += conds_.front().ToString();
+      for (size_t i = 1; i < conds_.size(); i++) {
+        cond_str += " AND " + conds_[i].ToString();
+      }
+    }
+    std::string proj_str;
+    for (const auto &field : proj_fields_) {
+      proj_str += (proj_str.empty() ? "" : ", ") + field.field_.field_name_;
+    }
+    std::string filter_str;
+    for (const auto &filter : runtime_filters_) {
+      for (const auto &field : filter->GetProbeFields()) {
+        filter_str += (filter_str.empty() ? "" : ", ") + field.field_.field_name_;
+      }
+    }
+    return fmt::format("{}ScanPlan [{}]{}{}{}{}",
+        TAB_STR(level),
+        table_name_,
+        cond_str.empty() ? "" : fmt::format(" <{}>", cond_str),
+        proj_str.empty() ? "" : fmt::format(" <fields: {}>", proj_str),
+        pruned_pages_ == 0 ? "" : fmt::format(" <pruned pages: {}>", pruned_pages_),
+        filter_str.empty() ? "" : fmt::format(" <bloom filters: {}>", filter_str));
   }
   std::string table_name_;
+  // predicates evaluated inside the scan
+  ConditionVec conds_;
+  // fields read by the scan, empty means all fields
+  std::vector<RTField> proj_fields_;
+  // pages the zone map can skip for conds_ at planning time
+  size_t pruned_pages_{0};
+  // filters of the joins above on the keys of their right sides, executions check their own copies
+  std::vector<RuntimeFilterSptr> runtime_filters_;
 };
 
 class IdxScanPlan : public AbstractPlan
@@ -215,12 +372,42 @@ public:
         cond_str += " AND " + conds_[i].ToString();
       }
     }
-    return fmt::format("{}IdxScanPlan [{}] <{}>", TAB_STR(level), table_name_, cond_str);
+    return fmt::format(
+        "{}IdxScanPlan [{}] <{}>{}", TAB_STR(level), table_name_, cond_str, index_only_ ? " index only" : "");
   }
   std::string  table_name_;
   idx_id_t     idx_id_;
   ConditionVec conds_;
   int          matched_fields_;
+  bool         index_only_{false};  // the index stores every field the query reads, records come from its entries
+};
+
+class BitmapScanPlan : public AbstractPlan
+{
+public:
+  BitmapScanPlan(std::string table_name, std::vector<std::shared_ptr<IdxScanPlan>> index_scans, bool is_and)
+      : table_name_(std::move(table_name)), index_scans_(std::move(index_scans)), is_and_(is_and)
+  {}
+  auto ToString(int level) const -> std::string override
+  {
+    // a covering index makes the heap fetch unnecessary, the index scan is run directly
+    if (IsIndexOnly()) {
+      return index_scans_.front()->ToString(level);
+    }
+    std::string str = fmt::format("{}BitmapScanPlan [{}] <{}>", TAB_STR(level), table_name_, is_and_ ? "AND" : "OR");
+    for (const auto &idx_scan : index_scans_) {
+      str += "\n" + idx_scan->ToString(level + 1);
+    }
+    return str;
+  }
+  [[nodiscard]] auto IsIndexOnly() const -> bool
+  {
+    return index_scans_.size() == 1 && index_scans_.front()->index_only_;
+  }
+  std::string table_name_;
+  // the rids of every index scan are put on a bitmap of the table slots, the bitmaps are combined by AND or OR
+  std::vector<std::shared_ptr<IdxScanPlan>> index_scans_;
+  bool                                      is_and_;
 };
 
 class SortPlan : public AbstractPlan
@@ -268,11 +455,12 @@ public:
         cond_str += " AND " + conds_[i].ToString();
       }
     }
-    return fmt::format("{}JoinPlan <conds: {}, type: {}, strategy: {}>\n{}\n{}",
+    return fmt::format("{}JoinPlan <conds: {}, type: {}, strategy: {}{}>\n{}\n{}",
         TAB_STR(level),
         cond_str,
         JoinTypeToString(type_),
         JoinStrategyToString(strategy_),
+        runtime_filter_ == nullptr ? "" : ", bloom filter",
         left_->ToString(level + 1),
         right_->ToString(level + 1));
   }
@@ -281,9 +469,15 @@ public:
   ConditionVec                  conds_;
   JoinType                      type_;
   JoinStrategy                  strategy_;
-  // below is available when strategy == SortMerge
+  // below is available when strategy == SortMerge or HashJoin
   RecordSchemaUptr left_key_schema_;
   RecordSchemaUptr right_key_schema_;
+  // hash join only, the keys of a filter on the right keys checked by a scan in the left side, may be nullptr. It stays
+  // empty, every execution fills a copy of its own
+  RuntimeFilterSptr runtime_filter_;
+  // below is available when strategy == IndexNestedLoop, right_ is the scan of the inner table
+  idx_id_t             inner_idx_id_{-1};  // index of the inner table probed for every outer record
+  std::vector<RTField> outer_key_fields_;  // outer fields matched against the first fields of the index key
 };
 
 class AggregatePlan : public AbstractPlan
@@ -322,6 +516,93 @@ public:
   std::vector<RTField>          agg_fields;
 };
 
+class GatherPlan : public AbstractPlan
+{
+public:
+  GatherPlan(std::shared_ptr<AbstractPlan> child, std::string table_name, size_t dop)
+      : child_(std::move(child)), table_name_(std::move(table_name)), dop_(dop)
+  {}
+  auto ToString(int level) const -> std::string override
+  {
+    return fmt::format(
+        "{}GatherPlan [{}] <dop: {}>\n{}", TAB_STR(level), table_name_, dop_, child_->ToString(level + 1));
+  }
+  // the pipeline run by every worker
+  std::shared_ptr<AbstractPlan> child_;
+  // table whose pages are split among the workers
+  std::string table_name_;
+  size_t      dop_;
+};
+
+class SetVariablePlan : public AbstractPlan
+{
+public:
+  SetVariablePlan(std::string name, ValueSptr value) : name_(std::move(name)), value_(std::move(value)) {}
+  auto ToString(int level) const -> std::string override
+  {
+    return fmt::format("{}SetVariablePlan [{}] <{}>", TAB_STR(level), name_, value_->ToString());
+  }
+  std::string name_;
+  ValueSptr   value_;
+};
+
+/// a statement prepared by PREPARE, its plan is optimized once and run by every EXECUTE with new arguments
+struct PreparedStatement
+{
+  std::string                   sql_;  // normalized text of the PREPARE, to prepare it again after DDL or ANALYZE
+  std::shared_ptr<AbstractPlan> plan_;
+  size_t                        param_num_;
+  uint64_t                      version_;  // catalog version plan_ was optimized under
+};
+DEFINE_SHARED_PTR(PreparedStatement);
+
+class PreparePlan : public AbstractPlan
+{
+public:
+  PreparePlan(std::string name, std::shared_ptr<AbstractPlan> plan, size_t param_num)
+      : name_(std::move(name)), plan_(std::move(plan)), param_num_(param_num)
+  {}
+  auto ToString(int level) const -> std::string override
+  {
+    return fmt::format("{}PreparePlan [{}] <{} parameters>\n{}", TAB_STR(level), name_, param_num_,
+        plan_->ToString(level + 1));
+  }
+  std::string                   name_;
+  std::shared_ptr<AbstractPlan> plan_;
+  size_t                        param_num_;
+  std::string                   sql_;  // filled by the plan cache
+  uint64_t                      version_{0};  // filled by the optimizer
+};
+
+class ExecutePlan : public AbstractPlan
+{
+public:
+  ExecutePlan(std::string name, std::vector<ValueSptr> params) : name_(std::move(name)), params_(std::move(params)) {}
+  auto ToString(int level) const -> std::string override
+  {
+    std::string param_str;
+    for (const auto &param : params_) {
+      param_str += (param_str.empty() ? "" : ", ") + param->ToString();
+    }
+    return fmt::format("{}ExecutePlan [{}] <({})>", TAB_STR(level), name_, param_str);
+  }
+  std::string            name_;
+  std::vector<ValueSptr> params_;  // arguments of the ? parameters in order
+  // the statement to run, set by the plan cache which prepares it again if the catalog changed since
+  PreparedStatementSptr stmt_;
+};
+
+class DeallocatePlan : public AbstractPlan
+{
+public:
+  explicit DeallocatePlan(std::string name) : name_(std::move(name)) {}
+  auto ToString(int level) const -> std::string override
+  {
+    return fmt::format("{}DeallocatePlan [{}]", TAB_STR(level), name_);
+  }
+  std::string name_;
+};
+
 class LimitPlan : public AbstractPlan
 {
 public:
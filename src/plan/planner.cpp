@@ -36,7 +36,27 @@ std::shared_ptr<AbstractPlan> Planner::PlanAST(const std::shared_ptr<ast::TreeNo
   } else if (const auto odb = std::dynamic_pointer_cast<ast::OpenDatabase>(ast)) {
     return std::make_shared<OpenDBPlan>(odb->db_name_);
   } else if (const auto exp = std::dynamic_pointer_cast<ast::Explain>(ast)) {
-    return std::make_shared<ExplainPlan>(std::move(PlanAST(exp->stmt, db)));
+    return std::make_shared<ExplainPlan>(std::move(PlanAST(exp->stmt, db)), exp->analyze);
+  } else if (const auto set = std::dynamic_pointer_cast<ast::SetVariable>(ast)) {
+    return std::make_shared<SetVariablePlan>(set->name_, TransformValue(set->val_));
+  } else if (const auto prep = std::dynamic_pointer_cast<ast::Prepare>(ast)) {
+    // the plan of a prepared statement is run many times, only queries and modifications are worth it
+    if (std::dynamic_pointer_cast<ast::SelectStmt>(prep->stmt_) == nullptr &&
+        std::dynamic_pointer_cast<ast::InsertStmt>(prep->stmt_) == nullptr &&
+        std::dynamic_pointer_cast<ast::UpdateStmt>(prep->stmt_) == nullptr &&
+        std::dynamic_pointer_cast<ast::DeleteStmt>(prep->stmt_) == nullptr) {
+      WSDB_THROW(WSDB_UNSUPPORTED_OP, fmt::format("PREPARE {} of a statement other than a query or DML", prep->name_));
+    }
+    return std::make_shared<PreparePlan>(prep->name_, PlanAST(prep->stmt_, db), prep->param_num_);
+  } else if (const auto exec = std::dynamic_pointer_cast<ast::Execute>(ast)) {
+    std::vector<ValueSptr> params;
+    params.reserve(exec->vals_.size());
+    for (const auto &v : exec->vals_) {
+      params.push_back(TransformValue(v));
+    }
+    return std::make_shared<ExecutePlan>(exec->name_, std::move(params));
+  } else if (const auto dealloc = std::dynamic_pointer_cast<ast::Deallocate>(ast)) {
+    return std::make_shared<DeallocatePlan>(dealloc->name_);
   }
   if (db == nullptr) {
     WSDB_THROW(WSDB_DB_NOT_OPEN, "");
@@ -52,12 +72,24 @@ std::shared_ptr<AbstractPlan> Planner::PlanAST(const std::shared_ptr<ast::TreeNo
   }
   /// insert
   if (const auto ins = std::dynamic_pointer_cast<ast::InsertStmt>(ast)) {
-    std::vector<ValueSptr> values;
-    values.reserve(ins->vals.size());
-    for (const auto &v : ins->vals) {
-      values.push_back(TransformValue(v));
+    std::vector<std::vector<ValueSptr>> rows;
+    rows.reserve(ins->rows.size());
+    for (const auto &row : ins->rows) {
+      auto &values = rows.emplace_back();
+      values.reserve(row.size());
+      for (const auto &v : row) {
+        values.push_back(TransformValue(v));
+      }
     }
-    return std::make_shared<InsertPlan>(ins->tab_name, values);
+    return std::make_shared<InsertPlan>(ins->tab_name, std::move(rows));
+  }
+  /// copy from
+  if (const auto copy = std::dynamic_pointer_cast<ast::CopyFrom>(ast)) {
+    return std::make_shared<CopyFromPlan>(copy->tab_name_, copy->file_name_, copy->format_);
+  }
+  /// copy to
+  if (const auto copy = std::dynamic_pointer_cast<ast::CopyTo>(ast)) {
+    return std::make_shared<CopyToPlan>(PlanAST(copy->query_, db), copy->file_name_, copy->format_);
   }
   /// update
   if (const auto upd = std::dynamic_pointer_cast<ast::UpdateStmt>(ast)) {
@@ -95,16 +127,32 @@ std::shared_ptr<AbstractPlan> Planner::PlanAST(const std::shared_ptr<ast::TreeNo
   if (const auto desc = std::dynamic_pointer_cast<ast::DescTable>(ast)) {
     return std::make_shared<DescTablePlan>(desc->tab_name_);
   }
+  /// analyze table
+  if (const auto analyze = std::dynamic_pointer_cast<ast::Analyze>(ast)) {
+    return std::make_shared<AnalyzePlan>(analyze->tab_name_);
+  }
   /// show tables
   if (const auto stab = std::dynamic_pointer_cast<ast::ShowTables>(ast)) {
     return std::make_shared<ShowTablesPlan>();
   }
   /// index related
   if (const auto cidx = std::dynamic_pointer_cast<ast::CreateIndex>(ast)) {
-
+    // included columns are stored after the key columns in the index schema
+    auto col_names = cidx->col_names_;
+    col_names.insert(col_names.end(), cidx->include_names_.begin(), cidx->include_names_.end());
+    auto key_fields = MakeIndexKeyFields(cidx->tab_name_, col_names, db);
+    return std::make_shared<CreateIndexPlan>(
+        cidx->tab_name_, std::move(key_fields), cidx->index_type_, cidx->include_names_.size());
   } else if (const auto didx = std::dynamic_pointer_cast<ast::DropIndex>(ast)) {
-
+    auto col_names = didx->col_names_;
+    col_names.insert(col_names.end(), didx->include_names_.begin(), didx->include_names_.end());
+    auto key_fields = MakeIndexKeyFields(didx->tab_name_, col_names, db);
+    return std::make_shared<DropIndexPlan>(didx->tab_name_, std::move(key_fields), didx->include_names_.size());
   } else if (const auto sidx = std::dynamic_pointer_cast<ast::ShowIndexes>(ast)) {
+    if (db->GetTable(sidx->tab_name_) == nullptr) {
+      WSDB_THROW(WSDB_TABLE_MISS, sidx->tab_name_);
+    }
+    return std::make_shared<ShowIndexesPlan>(sidx->tab_name_);
   }
   /// transaction related
   if (const auto txnbeg = std::dynamic_pointer_cast<ast::TxnBegin>(ast)) {
@@ -187,6 +235,10 @@ auto Planner::AnalyseSelect(const std::shared_ptr<ast::SelectStmt> &sel, wsdb::D
   if (sub_plan != nullptr) {
     /// select with sub query
     auto plan = std::move(sub_plan);
+    // the optimizer pushes the conditions down into the sub query
+    if (!where.empty()) {
+      plan = std::make_shared<FilterPlan>(std::move(plan), where);
+    }
     if (is_agg) {
       plan = MakeAggregatePlan(plan, group_fields, sel_fields, having);
     }
@@ -261,6 +313,15 @@ auto Planner::TransformValue(const std::shared_ptr<ast::Value> &val) -> ValueSpt
     // as we do not know the type or size of the null value, we use int type and 0 size, should
     // handle carefully in executors
     return ValueFactory::CreateNullValue(TYPE_INT);
+  } else if (const auto p = std::dynamic_pointer_cast<ast::ParamLit>(val)) {
+    return std::make_shared<ParamValue>(p->idx_);
+  } else if (const auto arr = std::dynamic_pointer_cast<ast::ArrLit>(val)) {
+    std::vector<ValueSptr> values;
+    values.reserve(arr->val_.size());
+    for (const auto &v : arr->val_) {
+      values.push_back(TransformValue(v));
+    }
+    return ValueFactory::CreateArrayValue(values);
   } else {
     WSDB_FETAL("Invalid value type");
   }
@@ -354,6 +415,33 @@ auto Planner::CreateRecordSchema(const std::vector<std::shared_ptr<ast::Field>>
   return std::make_unique<RecordSchema>(rt_fields);
 }
 
+auto Planner::MakeIndexKeyFields(const std::string &tab_name, const std::vector<std::string> &col_names,
+    DatabaseHandle *db) -> std::vector<RTField>
+{
+  auto tab = db->GetTable(tab_name);
+  if (tab == nullptr) {
+    WSDB_THROW(WSDB_TABLE_MISS, tab_name);
+  }
+  if (col_names.empty()) {
+    WSDB_THROW(WSDB_GRAMMAR_ERROR, "Index key cannot be empty");
+  }
+  std::vector<RTField> key_fields;
+  key_fields.reserve(col_names.size());
+  for (const auto &col_name : col_names) {
+    if (!tab->HasField(col_name)) {
+      WSDB_THROW(WSDB_FIELD_MISS, col_name);
+    }
+    auto &field = tab->GetSchema().GetFieldByName(tab->GetTableId(), col_name);
+    for (const auto &key_field : key_fields) {
+      if (key_field.field_.field_name_ == col_name) {
+        WSDB_THROW(WSDB_GRAMMAR_ERROR, fmt::format("Duplicate index key field: {}", col_name));
+      }
+    }
+    key_fields.push_back(field);
+  }
+  return key_fields;
+}
+
 void Planner::CheckFieldTabName(
     std::string &tab_name, const std::string &field_name, DatabaseHandle *db, const std::vector<std::string> &cand_tabs)
 {
@@ -419,14 +507,17 @@ auto Planner::GetConditionsForJoin(
 {
   ConditionVec ret;
   // move the condition of the join to ret, should check if the rhs is column
+  auto left_id  = db->GetTable(left)->GetTableId();
+  auto right_id = db->GetTable(right)->GetTableId();
   for (const auto &c : conds) {
-    if (c.GetLCol().field_.table_id_ == db->GetTable(left)->GetTableId()) {
-      if (c.GetRhsType() == kColumn) {
-        if (c.GetRCol().field_.table_id_ == db->GetTable(right)->GetTableId() &&
-            c.GetLCol().field_.table_id_ != c.GetRCol().field_.table_id_) {
-          ret.push_back(c);
-        }
-      }
+    if (c.GetRhsType() != kColumn || left_id == right_id) {
+      continue;
+    }
+    // the left field of a join condition comes from the left side, e.g. b.y = a.x joining a and b becomes a.x = b.y
+    if (c.GetLCol().field_.table_id_ == left_id && c.GetRCol().field_.table_id_ == right_id) {
+      ret.push_back(c);
+    } else if (c.GetLCol().field_.table_id_ == right_id && c.GetRCol().field_.table_id_ == left_id) {
+      ret.push_back(c.Swap());
     }
   }
   return ret;
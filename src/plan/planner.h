@@ -56,6 +56,10 @@ private:
   static auto CreateRecordSchema(const std::vector<std::shared_ptr<ast::Field>> &fields, std::string &tab_name,
       DatabaseHandle *db) -> RecordSchemaUptr;
 
+  /// make the key fields of an index on tab_name, in the order of col_names
+  static auto MakeIndexKeyFields(const std::string &tab_name, const std::vector<std::string> &col_names,
+      DatabaseHandle *db) -> std::vector<RTField>;
+
   /// check if the table has the specific field, if tab_name is empty string, fulfill tab_name by checking all tables in
   /// the database
   static void CheckFieldTabName(std::string &tab_name, const std::string &field_name, DatabaseHandle *db,
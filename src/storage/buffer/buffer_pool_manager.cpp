@@ -23,6 +23,7 @@
 #include "replacer/lru_k_replacer.h"
 
 #include "../../../common/error.h"
+#include "common/io_stats.h"
 
 namespace wsdb {
 
@@ -61,6 +62,7 @@ auto BufferPoolManager::FetchPage(file_id_t fid, page_id_t pid) -> Page * {
           break;
         }
       }
+      IoStats::Local().hits_++;
       return frame->GetPage(); // 返回该页面的指针
     }
     //页面不在缓冲区中，需要获取可用帧并更新内容
@@ -68,6 +70,7 @@ auto BufferPoolManager::FetchPage(file_id_t fid, page_id_t pid) -> Page * {
     UpdateFrame(frame_id, fid, pid);// 更新帧内容并加载新页面
     frame = &frames_[frame_id];
     page_frame_lookup_[fid_pid] = frame_id;
+    IoStats::Local().misses_++;
     return frame->GetPage();  // 返回页面的指针
  
 }
@@ -92,7 +95,10 @@ auto BufferPoolManager::UnpinPage(file_id_t fid, page_id_t pid, bool is_dirty) -
       free_list_.push_back(frame_id);   
     }
     replacer_->Unpin(frame_id);
-    frame.SetDirty(is_dirty);// 设置脏位
+    // a clean unpin must not clear the dirty bit left by an earlier writer
+    if (is_dirty) {
+      frame.SetDirty(true);
+    }
     return true;
 
 }
@@ -24,6 +24,7 @@
 #include <unistd.h>
 #include "disk_manager.h"
 #include "../../common/config.h"
+#include "../../common/io_stats.h"
 #include "../../../common/error.h"
 
 namespace wsdb {
@@ -86,6 +87,7 @@ void DiskManager::WritePage(file_id_t fid, page_id_t page_id, const char *data)
     WSDB_THROW(
         WSDB_FILE_WRITE_ERROR, fmt::format("fid: {}, page_id: {}", fid, page_id));
   }
+  IoStats::Local().writes_++;
 }
 
 void DiskManager::ReadPage(file_id_t fid, page_id_t page_id, char *data)
@@ -96,6 +98,7 @@ void DiskManager::ReadPage(file_id_t fid, page_id_t page_id, char *data)
     WSDB_THROW(
         WSDB_FILE_READ_ERROR, fmt::format("fid: {}, page_id: {}", fid, page_id));
   }
+  IoStats::Local().reads_++;
 }
 
 void DiskManager::ReadFile(file_id_t fid, char *data, size_t size, size_t offset, int type)
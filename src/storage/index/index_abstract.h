@@ -28,13 +28,24 @@
 
 namespace wsdb {
 
-enum class IndexType
+/// iterates over the rids of the index entries in a key range, in key order if the index is ordered
+class IndexIterator
 {
-  NONE,
-  BPTREE,
-  HASH,
+public:
+  virtual ~IndexIterator() = default;
+
+  [[nodiscard]] virtual auto IsEnd() const -> bool = 0;
+
+  virtual void Next() = 0;
+
+  [[nodiscard]] virtual auto GetRID() const -> RID = 0;
+
+  /// the current entry as a record of the index key schema, with the rid of the entry
+  [[nodiscard]] virtual auto GetRecord() const -> RecordUptr = 0;
 };
 
+DEFINE_UNIQUE_PTR(IndexIterator);
+
 class Index
 {
 public:
@@ -55,9 +66,29 @@ public:
 
   virtual void Delete(const Record &key, const RID &rid) = 0;
 
+  /**
+   * find the entries whose first low_field_num key fields are not less than those of low, and whose first
+   * high_field_num key fields are not greater than those of high. Both low and high have the key schema and only
+   * their first low_field_num and high_field_num fields are used, a bound of 0 fields is open
+   */
+  virtual auto Scan(const Record &low, size_t low_field_num, const Record &high, size_t high_field_num)
+      -> IndexIteratorUptr = 0;
+
+  /// find the entries whose first field_num key fields are in [low, high]
+  auto Scan(const Record &low, const Record &high, size_t field_num) -> IndexIteratorUptr
+  {
+    return Scan(low, field_num, high, field_num);
+  }
+
+  /// write what the index keeps in memory to its pages, at the end of every statement that changed the index
+  virtual void Flush() {}
+
   [[nodiscard]] auto GetIndexType() const -> IndexType { return index_type_; }
 
-private:
+  /// number of leading key schema fields the index is searched by, the fields after them are only stored
+  [[nodiscard]] virtual auto GetKeyFieldNum() const -> size_t { return key_schema_->GetFieldCount(); }
+
+protected:
   DiskManager       *disk_manager_;
   BufferPoolManager *buffer_pool_manager_;
   IndexType          index_type_;
@@ -20,16 +20,934 @@
 //
 
 #include "index_bp_tree.h"
+#include "common/parallel_sort.h"
 
 namespace wsdb {
 
-// FIXME: BPTreeIndex initializer should include more BPTree parameters, like order, etc.
-BPTreeIndex::BPTreeIndex(
-    DiskManager *disk_manager, BufferPoolManager *buffer_pool_manager, idx_id_t index_id, RecordSchema *key_schema)
-    : Index(disk_manager, buffer_pool_manager, IndexType::BPTREE, index_id, key_schema)
+/// BPTreeIndex::NodeGuard
+
+BPTreeIndex::NodeGuard::NodeGuard(BPTreeIndex *tree, page_id_t pid) : tree_(tree), pid_(pid)
+{
+  WSDB_ASSERT(pid != INVALID_PAGE_ID && pid != FILE_HEADER_PAGE_ID, fmt::format("invalid node page {}", pid));
+  page_       = tree_->buffer_pool_manager_->FetchPage(tree_->fid_, pid_);
+  header_     = reinterpret_cast<BPTreeNodeHeader *>(page_->GetData() + PAGE_HEADER_SIZE);
+  entries_    = page_->GetData() + PAGE_HEADER_SIZE + sizeof(BPTreeNodeHeader);
+  entry_size_ = header_->is_leaf_ != 0 ? tree_->leaf_entry_size_ : tree_->internal_entry_size_;
+}
+
+BPTreeIndex::NodeGuard::~NodeGuard() { tree_->buffer_pool_manager_->UnpinPage(tree_->fid_, pid_, dirty_); }
+
+auto BPTreeIndex::NodeGuard::Child(size_t idx) -> page_id_t
+{
+  WSDB_ASSERT(!IsLeaf(), "leaf has no child");
+  page_id_t child;
+  memcpy(&child, Key(idx) + tree_->key_size_, sizeof(page_id_t));
+  return child;
+}
+
+void BPTreeIndex::NodeGuard::SetChild(size_t idx, page_id_t child)
+{
+  WSDB_ASSERT(!IsLeaf(), "leaf has no child");
+  memcpy(Key(idx) + tree_->key_size_, &child, sizeof(page_id_t));
+  dirty_ = true;
+}
+
+auto BPTreeIndex::NodeGuard::Sane() const -> bool
+{
+  if (header_->is_leaf_ > 1) {
+    return false;
+  }
+  bool is_leaf = header_->is_leaf_ == 1;
+  if (entry_size_ != (is_leaf ? tree_->leaf_entry_size_ : tree_->internal_entry_size_)) {
+    return false;
+  }
+  return header_->size_ <= (is_leaf ? tree_->leaf_max_size_ : tree_->internal_max_size_) + 1;
+}
+
+void BPTreeIndex::NodeGuard::Reset(bool is_leaf)
+{
+  header_->is_leaf_ = is_leaf ? 1 : 0;
+  header_->size_    = 0;
+  header_->prev_    = INVALID_PAGE_ID;
+  header_->next_    = INVALID_PAGE_ID;
+  entry_size_       = is_leaf ? tree_->leaf_entry_size_ : tree_->internal_entry_size_;
+  dirty_            = true;
+}
+
+void BPTreeIndex::NodeGuard::Shift(size_t idx, int delta)
+{
+  if (idx < Size()) {
+    memmove(Key(idx + delta), Key(idx), (Size() - idx) * entry_size_);
+  }
+  header_->size_ += delta;
+  dirty_ = true;
+}
+
+/// BPTreeIterator
+
+BPTreeIterator::BPTreeIterator(BPTreeIndex *tree, std::string begin, std::string end)
+    : tree_(tree), key_(std::move(begin)), end_(std::move(end))
+{
+  Fetch();
+}
+
+void BPTreeIterator::Next()
+{
+  WSDB_ASSERT(!IsEnd(), "BPTreeIterator is end");
+  slot_++;
+  Fetch();
+}
+
+void BPTreeIterator::Fetch()
+{
+  rid_ = INVALID_RID;
+  while (!done_) {
+    if (leaf_ == INVALID_PAGE_ID && !Seek()) {
+      leaf_ = INVALID_PAGE_ID;
+      continue;
+    }
+    if (done_ || Load()) {
+      return;
+    }
+    leaf_ = INVALID_PAGE_ID;
+  }
+}
+
+auto BPTreeIterator::GetRecord() const -> RecordUptr
+{
+  WSDB_ASSERT(!IsEnd(), "BPTreeIterator is end");
+  return tree_->DecodeEntry(key_.data());
+}
+
+auto BPTreeIterator::Seek() -> bool
+{
+  if (!tree_->Descend(key_.data(), leaf_, version_)) {
+    return false;
+  }
+  if (leaf_ == INVALID_PAGE_ID) {
+    done_ = true;
+    return true;
+  }
+  BPTreeIndex::NodeGuard node(tree_, leaf_);
+  if (!tree_->Readable(node, version_)) {
+    return false;
+  }
+  slot_ = tree_->LeafLowerBound(node, key_.data());
+  if (started_ && slot_ < node.Size() && tree_->CompareKey(node.Key(slot_), key_.data()) == 0) {
+    slot_++;
+  }
+  return tree_->Latch(leaf_).Validate(version_);
+}
+
+auto BPTreeIterator::Load() -> bool
+{
+  while (true) {
+    BPTreeIndex::NodeGuard node(tree_, leaf_);
+    auto                  &latch = tree_->Latch(leaf_);
+    if (!tree_->Readable(node, version_)) {
+      return false;
+    }
+    if (slot_ < node.Size()) {
+      std::string entry(node.Key(slot_), tree_->leaf_entry_size_);
+      if (!latch.Validate(version_)) {
+        return false;
+      }
+      key_     = std::move(entry);
+      started_ = true;
+      if (memcmp(key_.data(), end_.data(), end_.size()) > 0) {
+        done_ = true;
+      } else {
+        rid_ = BPTreeIndex::DecodeRID(key_.data() + tree_->encoder_.GetKeySize());
+      }
+      return true;
+    }
+    auto next = node.Header()->next_;
+    if (!latch.Validate(version_)) {
+      return false;
+    }
+    if (next == INVALID_PAGE_ID) {
+      done_ = true;
+      return true;
+    }
+    auto next_version = tree_->Latch(next).ReadLock();
+    if (!latch.Validate(version_)) {
+      return false;
+    }
+    leaf_    = next;
+    version_ = next_version;
+    slot_    = 0;
+  }
+}
+
+/// BPTreeIndex
+
+BPTreeIndex::BPTreeIndex(DiskManager *disk_manager, BufferPoolManager *buffer_pool_manager, file_id_t fid,
+    idx_id_t index_id, RecordSchema *key_schema)
+    : Index(disk_manager, buffer_pool_manager, IndexType::BPTREE, index_id, key_schema),
+      fid_(fid),
+      latch_chunks_(std::make_unique<std::atomic<OptimisticLatch *>[]>(LATCH_CHUNK_NUM))
+{
+  LoadHeader();
+  InitLayout();
+}
+
+BPTreeIndex::~BPTreeIndex()
+{
+  FlushHeader();
+  for (size_t i = 0; i < LATCH_CHUNK_NUM; i++) {
+    delete[] latch_chunks_[i].load();
+  }
+}
+
+void BPTreeIndex::Insert(const Record &key, const RID &rid)
+{
+  std::string entry(leaf_entry_size_, '\0');
+  EncodeEntry(key, rid, entry.data());
+  {
+    std::shared_lock lock(smo_latch_);
+    while (!TryInsert(entry.data())) {}
+  }
+  entry_num_++;
+  if (header_dirty_.load()) {
+    FlushHeader();
+  }
+}
+
+void BPTreeIndex::Delete(const Record &key, const RID &rid)
+{
+  std::string entry(leaf_entry_size_, '\0');
+  EncodeEntry(key, rid, entry.data());
+  auto result = TryResult::RESTART;
+  {
+    std::shared_lock lock(smo_latch_);
+    while ((result = TryDelete(entry.data(), rid)) == TryResult::RESTART) {}
+  }
+  if (result == TryResult::UNDERFLOW) {
+    std::unique_lock lock(smo_latch_);
+    DeleteExclusive(entry.data(), rid);
+  }
+  entry_num_--;
+  if (header_dirty_.load()) {
+    FlushHeader();
+  }
+}
+
+auto BPTreeIndex::Scan(const Record &low, size_t low_field_num, const Record &high, size_t high_field_num)
+    -> IndexIteratorUptr
+{
+  WSDB_ASSERT(low_field_num <= encoder_.GetFieldCount() && high_field_num <= encoder_.GetFieldCount(),
+      "too many fields for the key");
+  auto        low_size  = encoder_.GetPrefixSize(low_field_num);
+  auto        high_size = encoder_.GetPrefixSize(high_field_num);
+  std::string begin(key_size_, '\0');
+  std::string end(encoder_.GetKeySize(), '\0');
+  encoder_.Encode(low, begin.data());
+  encoder_.Encode(high, end.data());
+  // entries with the low prefix are not less than the prefix followed by zeros
+  memset(begin.data() + low_size, 0, key_size_ - low_size);
+  end.resize(high_size);
+  return std::make_unique<BPTreeIterator>(this, std::move(begin), std::move(end));
+}
+
+auto BPTreeIndex::Search(const Record &key) -> std::vector<RID>
+{
+  std::vector<RID> rids;
+  for (auto it = Scan(key, key, encoder_.GetFieldCount()); !it->IsEnd(); it->Next()) {
+    rids.push_back(it->GetRID());
+  }
+  return rids;
+}
+
+void BPTreeIndex::BulkLoad(const std::vector<std::pair<RecordUptr, RID>> &entries, double fill_factor, size_t dop)
+{
+  std::unique_lock lock(smo_latch_);
+  if (!IsEmpty()) {
+    WSDB_THROW(WSDB_UNSUPPORTED_OP, "bulk load into a non-empty b+ tree");
+  }
+  if (entries.empty()) {
+    return;
+  }
+  fill_factor = std::clamp(fill_factor, 0.5, 1.0);
+  // encode and sort the entries through their 8 byte prefixes, the same way as the sort executor
+  struct SortEntry
+  {
+    uint64_t prefix_;
+    size_t   idx_;
+  };
+  std::vector<char>      keys(entries.size() * leaf_entry_size_);
+  std::vector<SortEntry> order(entries.size());
+  for (size_t i = 0; i < entries.size(); i++) {
+    char *key = keys.data() + i * leaf_entry_size_;
+    EncodeEntry(*entries[i].first, entries[i].second, key);
+    order[i] = {SortKeyEncoder::LoadPrefix(key), i};
+  }
+  ParallelSort(
+      order,
+      [this, &keys](const SortEntry &lhs, const SortEntry &rhs) {
+        if (lhs.prefix_ != rhs.prefix_) {
+          return lhs.prefix_ < rhs.prefix_;
+        }
+        return CompareKey(keys.data() + lhs.idx_ * leaf_entry_size_, keys.data() + rhs.idx_ * leaf_entry_size_) < 0;
+      },
+      dop);
+  for (size_t i = 1; i < order.size(); i++) {
+    auto prev = keys.data() + order[i - 1].idx_ * leaf_entry_size_;
+    if (CompareKey(prev, keys.data() + order[i].idx_ * leaf_entry_size_) == 0) {
+      WSDB_THROW(WSDB_RECORD_EXISTS, "duplicate index entry in bulk load");
+    }
+  }
+
+  // spread n entries evenly over the fewest nodes filled to at most fill_factor, so that no node underflows
+  auto split = [fill_factor](size_t n, size_t max_size) {
+    auto per_node = std::max<size_t>(static_cast<size_t>(static_cast<double>(max_size) * fill_factor), 2);
+    auto node_num = (n + per_node - 1) / per_node;
+    std::vector<size_t> sizes(node_num, n / node_num);
+    for (size_t i = 0; i < n % node_num; i++) {
+      sizes[i]++;
+    }
+    return sizes;
+  };
+
+  // the nodes are not reachable before the root is set, readers only see the finished tree
+  // leaves, the first key of every node is kept to build the level above
+  std::vector<std::pair<std::string, page_id_t>> level;
+  page_id_t                                      prev_pid = INVALID_PAGE_ID;
+  size_t                                         pos      = 0;
+  for (auto size : split(order.size(), leaf_max_size_)) {
+    auto pid = AllocatePage();
+    {
+      NodeGuard leaf(this, pid);
+      leaf.Reset(true);
+      for (size_t i = 0; i < size; i++) {
+        memcpy(leaf.Key(i), keys.data() + order[pos + i].idx_ * leaf_entry_size_, leaf_entry_size_);
+      }
+      leaf.Header()->size_ = size;
+      leaf.Header()->prev_ = prev_pid;
+      level.emplace_back(std::string(leaf.Key(0), key_size_), pid);
+    }
+    if (prev_pid != INVALID_PAGE_ID) {
+      NodeGuard prev(this, prev_pid);
+      prev.Header()->next_ = pid;
+      prev.MarkDirty();
+    } else {
+      std::lock_guard meta_lock(meta_latch_);
+      header_.first_leaf_ = pid;
+    }
+    prev_pid = pid;
+    pos += size;
+  }
+  // internal levels
+  while (level.size() > 1) {
+    std::vector<std::pair<std::string, page_id_t>> upper;
+    pos = 0;
+    for (auto size : split(level.size(), internal_max_size_)) {
+      auto      pid = AllocatePage();
+      NodeGuard node(this, pid);
+      node.Reset(false);
+      for (size_t i = 0; i < size; i++) {
+        memcpy(node.Key(i), level[pos + i].first.data(), key_size_);
+        node.SetChild(i, level[pos + i].second);
+      }
+      node.Header()->size_ = size;
+      upper.emplace_back(level[pos].first, pid);
+      pos += size;
+    }
+    level = std::move(upper);
+  }
+  {
+    WriteLatchGuard root_guard(root_latch_);
+    root_.store(level.front().second);
+  }
+  entry_num_.store(entries.size());
+  FlushHeader();
+}
+
+auto BPTreeIndex::GetHeight() -> size_t
 {
-  WSDB_THROW(WSDB_NOT_IMPLEMENTED, "");
+  size_t height = 0;
+  for (auto pid = root_.load(); pid != INVALID_PAGE_ID; height++) {
+    NodeGuard node(this, pid);
+    pid = node.IsLeaf() ? INVALID_PAGE_ID : node.Child(0);
+  }
+  return height;
 }
-void BPTreeIndex::Insert(const Record &key, const RID &rid) {}
-void BPTreeIndex::Delete(const Record &key, const RID &rid) {}
-}  // namespace wsdb
\ No newline at end of file
+
+void BPTreeIndex::InitLayout()
+{
+  const auto &fields  = key_schema_->GetFields();
+  auto        key_num = header_.key_field_num_ == 0 ? fields.size() : static_cast<size_t>(header_.key_field_num_);
+  WSDB_ASSERT(key_num <= fields.size(), fmt::format("b+ tree of {} key fields", key_num));
+  key_fields_ = std::make_unique<RecordSchema>(std::vector<RTField>(fields.begin(), fields.begin() + key_num));
+  encoder_    = SortKeyEncoder(key_fields_.get(), key_schema_, false);
+  size_t include_size = 0;
+  if (key_num < fields.size()) {
+    include_fields_  = std::make_unique<RecordSchema>(std::vector<RTField>(fields.begin() + key_num, fields.end()));
+    include_encoder_ = SortKeyEncoder(include_fields_.get(), key_schema_, false);
+    include_size     = include_encoder_.GetKeySize();
+  } else {
+    include_fields_ = nullptr;
+  }
+  key_size_            = encoder_.GetKeySize() + sizeof(page_id_t) + sizeof(slot_id_t);
+  leaf_entry_size_     = key_size_ + include_size;
+  internal_entry_size_ = key_size_ + sizeof(page_id_t);
+  // one slot is kept free, so that a node read while it is being changed never runs past the page
+  auto space         = PAGE_SIZE - PAGE_HEADER_SIZE - sizeof(BPTreeNodeHeader);
+  leaf_max_size_     = space / leaf_entry_size_ - 1;
+  internal_max_size_ = space / internal_entry_size_ - 1;
+  if (leaf_max_size_ < 3 || internal_max_size_ < 3) {
+    WSDB_THROW(WSDB_UNSUPPORTED_OP, fmt::format("index entry of {} bytes is too long", leaf_entry_size_));
+  }
+}
+
+void BPTreeIndex::SetIncludeFieldNum(size_t include_num)
+{
+  std::unique_lock lock(smo_latch_);
+  if (!IsEmpty()) {
+    WSDB_THROW(WSDB_UNSUPPORTED_OP, "include fields in a non-empty b+ tree");
+  }
+  if (include_num >= key_schema_->GetFieldCount()) {
+    WSDB_THROW(WSDB_UNSUPPORTED_OP, "b+ tree without key fields");
+  }
+  header_.key_field_num_ = static_cast<uint32_t>(key_schema_->GetFieldCount() - include_num);
+  InitLayout();
+  FlushHeader();
+}
+
+auto BPTreeIndex::DecodeEntry(const char *entry) const -> RecordUptr
+{
+  auto values = encoder_.DecodeValues(entry);
+  if (include_fields_ != nullptr) {
+    auto include_values = include_encoder_.DecodeValues(entry + key_size_);
+    values.insert(values.end(), include_values.begin(), include_values.end());
+  }
+  return std::make_unique<Record>(key_schema_, values, DecodeRID(entry + encoder_.GetKeySize()));
+}
+
+void BPTreeIndex::EncodeEntry(const Record &key, const RID &rid, char *dst) const
+{
+  encoder_.Encode(key, dst);
+  EncodeRID(rid, dst + encoder_.GetKeySize());
+  if (include_fields_ != nullptr) {
+    include_encoder_.Encode(key, dst + key_size_);
+  }
+}
+
+void BPTreeIndex::EncodeRID(const RID &rid, char *dst)
+{
+  SortKeyEncoder::EncodeInt(rid.PageID(), dst);
+  SortKeyEncoder::EncodeInt(rid.SlotID(), dst + sizeof(page_id_t));
+}
+
+auto BPTreeIndex::DecodeRID(const char *src) -> RID
+{
+  return {SortKeyEncoder::DecodeInt(src), SortKeyEncoder::DecodeInt(src + sizeof(page_id_t))};
+}
+
+auto BPTreeIndex::LeafLowerBound(NodeGuard &node, const char *key) const -> size_t
+{
+  size_t lo = 0, hi = node.Size();
+  while (lo < hi) {
+    auto mid = (lo + hi) / 2;
+    if (CompareKey(node.Key(mid), key) < 0) {
+      lo = mid + 1;
+    } else {
+      hi = mid;
+    }
+  }
+  return lo;
+}
+
+auto BPTreeIndex::InternalLookup(NodeGuard &node, const char *key) const -> size_t
+{
+  // the last child whose key is not greater than key, the key of the first child is minus infinity
+  size_t lo = 1, hi = node.Size();
+  while (lo < hi) {
+    auto mid = (lo + hi) / 2;
+    if (CompareKey(node.Key(mid), key) <= 0) {
+      lo = mid + 1;
+    } else {
+      hi = mid;
+    }
+  }
+  return lo - 1;
+}
+
+auto BPTreeIndex::Latch(page_id_t pid) -> OptimisticLatch &
+{
+  auto idx = static_cast<size_t>(pid) / LATCH_CHUNK_SIZE;
+  WSDB_ASSERT(idx < LATCH_CHUNK_NUM, fmt::format("page {} is out of the latch table", pid));
+  auto chunk = latch_chunks_[idx].load(std::memory_order_acquire);
+  if (chunk == nullptr) {
+    auto created = new OptimisticLatch[LATCH_CHUNK_SIZE];
+    if (latch_chunks_[idx].compare_exchange_strong(chunk, created, std::memory_order_acq_rel)) {
+      chunk = created;
+    } else {
+      // another thread has installed the chunk, chunk holds it now
+      delete[] created;
+    }
+  }
+  return chunk[pid % LATCH_CHUNK_SIZE];
+}
+
+auto BPTreeIndex::Readable(NodeGuard &node, uint64_t version) -> bool
+{
+  if (node.Sane()) {
+    return true;
+  }
+  WSDB_ASSERT(!Latch(node.PageId()).Validate(version), fmt::format("corrupted node page {}", node.PageId()));
+  return false;
+}
+
+auto BPTreeIndex::Descend(const char *key, page_id_t &leaf, uint64_t &version) -> bool
+{
+  auto root_version = root_latch_.ReadLock();
+  auto pid          = root_.load();
+  if (pid == INVALID_PAGE_ID) {
+    leaf = INVALID_PAGE_ID;
+    return root_latch_.Validate(root_version);
+  }
+  version = Latch(pid).ReadLock();
+  if (!root_latch_.Validate(root_version)) {
+    return false;
+  }
+  while (true) {
+    page_id_t child;
+    {
+      NodeGuard node(this, pid);
+      if (!Readable(node, version)) {
+        return false;
+      }
+      if (node.IsLeaf()) {
+        leaf = pid;
+        return true;
+      }
+      child = node.Child(InternalLookup(node, key));
+    }
+    // the child id is only trusted once the parent is validated, then the child version is read before the parent
+    // is validated again, so that a split or merge between the two reads is not missed
+    auto &latch = Latch(pid);
+    if (!latch.Validate(version)) {
+      return false;
+    }
+    auto child_version = Latch(child).ReadLock();
+    if (!latch.Validate(version)) {
+      return false;
+    }
+    pid     = child;
+    version = child_version;
+  }
+}
+
+auto BPTreeIndex::TryInsert(const char *entry) -> bool
+{
+  auto root_version = root_latch_.ReadLock();
+  auto pid          = root_.load();
+  if (pid == INVALID_PAGE_ID) {
+    // the first entry, an empty leaf becomes the root and the insert restarts
+    if (!root_latch_.TryUpgrade(root_version)) {
+      return false;
+    }
+    pid = AllocatePage();
+    {
+      WriteLatchGuard latch_guard(Latch(pid));
+      NodeGuard       root(this, pid);
+      root.Reset(true);
+    }
+    {
+      std::lock_guard meta_lock(meta_latch_);
+      header_.first_leaf_ = pid;
+    }
+    root_.store(pid);
+    header_dirty_.store(true);
+    root_latch_.Unlock();
+    return false;
+  }
+  // the parent latch of the root is the root latch
+  page_id_t        parent         = INVALID_PAGE_ID;
+  OptimisticLatch *parent_latch   = &root_latch_;
+  uint64_t         parent_version = root_version;
+  auto             version        = Latch(pid).ReadLock();
+  if (!root_latch_.Validate(root_version)) {
+    return false;
+  }
+  while (true) {
+    auto     &latch = Latch(pid);
+    bool      is_leaf;
+    page_id_t child = INVALID_PAGE_ID;
+    {
+      NodeGuard node(this, pid);
+      if (!Readable(node, version)) {
+        return false;
+      }
+      is_leaf   = node.IsLeaf();
+      bool full = node.Size() >= (is_leaf ? leaf_max_size_ : internal_max_size_);
+      if (!full && is_leaf) {
+        if (!latch.TryUpgrade(version)) {
+          return false;
+        }
+        auto slot = LeafLowerBound(node, entry);
+        if (slot < node.Size() && CompareKey(node.Key(slot), entry) == 0) {
+          latch.Unlock();
+          auto rid = DecodeRID(entry + encoder_.GetKeySize());
+          WSDB_THROW(WSDB_RECORD_EXISTS, fmt::format("index entry of rid ({}, {})", rid.PageID(), rid.SlotID()));
+        }
+        node.Shift(slot, 1);
+        memcpy(node.Key(slot), entry, leaf_entry_size_);
+        latch.Unlock();
+        return true;
+      }
+      if (!full) {
+        child = node.Child(InternalLookup(node, entry));
+      }
+    }
+    if (child == INVALID_PAGE_ID) {
+      // split the full node on the way down, its parent is not full so it takes the separator, then restart
+      if (!parent_latch->TryUpgrade(parent_version)) {
+        return false;
+      }
+      if (!latch.TryUpgrade(version)) {
+        parent_latch->Unlock();
+        return false;
+      }
+      Split(parent, pid, is_leaf);
+      latch.Unlock();
+      parent_latch->Unlock();
+      return false;
+    }
+    if (!latch.Validate(version)) {
+      return false;
+    }
+    auto child_version = Latch(child).ReadLock();
+    if (!latch.Validate(version)) {
+      return false;
+    }
+    parent         = pid;
+    parent_latch   = &latch;
+    parent_version = version;
+    pid            = child;
+    version        = child_version;
+  }
+}
+
+auto BPTreeIndex::TryDelete(const char *entry, const RID &rid) -> TryResult
+{
+  auto root_version = root_latch_.ReadLock();
+  auto pid          = root_.load();
+  if (pid == INVALID_PAGE_ID) {
+    if (!root_latch_.Validate(root_version)) {
+      return TryResult::RESTART;
+    }
+    WSDB_THROW(WSDB_RECORD_MISS, fmt::format("index entry of rid ({}, {})", rid.PageID(), rid.SlotID()));
+  }
+  bool is_root = true;
+  auto version = Latch(pid).ReadLock();
+  if (!root_latch_.Validate(root_version)) {
+    return TryResult::RESTART;
+  }
+  while (true) {
+    auto     &latch = Latch(pid);
+    page_id_t child;
+    {
+      NodeGuard node(this, pid);
+      if (!Readable(node, version)) {
+        return TryResult::RESTART;
+      }
+      if (node.IsLeaf()) {
+        auto slot  = LeafLowerBound(node, entry);
+        bool found = slot < node.Size() && CompareKey(node.Key(slot), entry) == 0;
+        // a root leaf may hold any number of entries, but an empty tree has no root
+        bool underflow = is_root ? node.Size() == 1 : node.Size() - 1 < leaf_max_size_ / 2;
+        if (!found || underflow) {
+          if (!latch.Validate(version)) {
+            return TryResult::RESTART;
+          }
+          if (!found) {
+            WSDB_THROW(WSDB_RECORD_MISS, fmt::format("index entry of rid ({}, {})", rid.PageID(), rid.SlotID()));
+          }
+          return TryResult::UNDERFLOW;
+        }
+        if (!latch.TryUpgrade(version)) {
+          return TryResult::RESTART;
+        }
+        node.Shift(slot + 1, -1);
+        latch.Unlock();
+        return TryResult::DONE;
+      }
+      child = node.Child(InternalLookup(node, entry));
+    }
+    if (!latch.Validate(version)) {
+      return TryResult::RESTART;
+    }
+    auto child_version = Latch(child).ReadLock();
+    if (!latch.Validate(version)) {
+      return TryResult::RESTART;
+    }
+    is_root = false;
+    pid     = child;
+    version = child_version;
+  }
+}
+
+void BPTreeIndex::DeleteExclusive(const char *entry, const RID &rid)
+{
+  if (IsEmpty()) {
+    WSDB_THROW(WSDB_RECORD_MISS, fmt::format("index entry of rid ({}, {})", rid.PageID(), rid.SlotID()));
+  }
+  // no other writer runs, but readers do, so every node is write latched while it changes
+  std::vector<page_id_t> path;
+  auto                   leaf_pid  = FindLeaf(entry, &path);
+  bool                   underflow = false;
+  bool                   empty     = false;
+  {
+    NodeGuard leaf(this, leaf_pid);
+    auto      slot = LeafLowerBound(leaf, entry);
+    if (slot == leaf.Size() || CompareKey(leaf.Key(slot), entry) != 0) {
+      WSDB_THROW(WSDB_RECORD_MISS, fmt::format("index entry of rid ({}, {})", rid.PageID(), rid.SlotID()));
+    }
+    WriteLatchGuard latch_guard(Latch(leaf_pid));
+    leaf.Shift(slot + 1, -1);
+    underflow = leaf.Size() < leaf_max_size_ / 2;
+    empty     = leaf.Size() == 0;
+  }
+  if (path.empty()) {
+    // the root is a leaf, it may hold any number of entries
+    if (empty) {
+      {
+        WriteLatchGuard root_guard(root_latch_);
+        root_.store(INVALID_PAGE_ID);
+      }
+      FreePage(leaf_pid);
+      std::lock_guard meta_lock(meta_latch_);
+      header_.first_leaf_ = INVALID_PAGE_ID;
+      header_dirty_.store(true);
+    }
+  } else if (underflow) {
+    HandleUnderflow(path, leaf_pid);
+  }
+}
+
+void BPTreeIndex::Split(page_id_t parent, page_id_t pid, bool is_leaf)
+{
+  auto            new_pid = AllocatePage();
+  WriteLatchGuard new_guard(Latch(new_pid));
+  std::string     sep;
+  page_id_t       next_pid = INVALID_PAGE_ID;
+  {
+    // move the upper half to the new right sibling
+    NodeGuard node(this, pid);
+    NodeGuard right(this, new_pid);
+    right.Reset(is_leaf);
+    size_t left_size = node.Size() / 2;
+    memcpy(right.Key(0),
+        node.Key(left_size),
+        (node.Size() - left_size) * (is_leaf ? leaf_entry_size_ : internal_entry_size_));
+    right.Header()->size_ = node.Size() - left_size;
+    node.Header()->size_  = left_size;
+    node.MarkDirty();
+    sep.assign(right.Key(0), key_size_);
+    if (is_leaf) {
+      next_pid              = node.Header()->next_;
+      right.Header()->prev_ = pid;
+      right.Header()->next_ = next_pid;
+      node.Header()->next_  = new_pid;
+    } else {
+      // the first key of the new node moves up, its child stays as the first child of the new node
+      memset(right.Key(0), 0, key_size_);
+    }
+  }
+  if (next_pid != INVALID_PAGE_ID) {
+    // latches are only waited for from left to right on the leaf level, so this can not deadlock
+    WriteLatchGuard next_guard(Latch(next_pid));
+    NodeGuard       next(this, next_pid);
+    next.Header()->prev_ = new_pid;
+    next.MarkDirty();
+  }
+  if (parent == INVALID_PAGE_ID) {
+    // the node was the root, grow the tree by one level, the root latch is held by the caller
+    auto            root_pid = AllocatePage();
+    WriteLatchGuard root_guard(Latch(root_pid));
+    {
+      NodeGuard root(this, root_pid);
+      root.Reset(false);
+      root.Header()->size_ = 2;
+      memset(root.Key(0), 0, key_size_);
+      root.SetChild(0, pid);
+      memcpy(root.Key(1), sep.data(), key_size_);
+      root.SetChild(1, new_pid);
+    }
+    root_.store(root_pid);
+    header_dirty_.store(true);
+    return;
+  }
+  NodeGuard node(this, parent);
+  auto      slot = InternalLookup(node, sep.data()) + 1;
+  node.Shift(slot, 1);
+  memcpy(node.Key(slot), sep.data(), key_size_);
+  node.SetChild(slot, new_pid);
+}
+
+auto BPTreeIndex::FindLeaf(const char *key, std::vector<page_id_t> *path) -> page_id_t
+{
+  auto pid = root_.load();
+  while (true) {
+    NodeGuard node(this, pid);
+    if (node.IsLeaf()) {
+      return pid;
+    }
+    if (path != nullptr) {
+      path->push_back(pid);
+    }
+    pid = node.Child(InternalLookup(node, key));
+  }
+}
+
+auto BPTreeIndex::AllocatePage() -> page_id_t
+{
+  std::lock_guard lock(meta_latch_);
+  if (header_.first_free_page_ != INVALID_PAGE_ID) {
+    auto      pid = header_.first_free_page_;
+    NodeGuard node(this, pid);
+    header_.first_free_page_ = node.Header()->next_;
+    header_dirty_.store(true);
+    return pid;
+  }
+  WSDB_ASSERT(static_cast<size_t>(header_.page_num_) < LATCH_CHUNK_NUM * LATCH_CHUNK_SIZE, "b+ tree file is full");
+  header_dirty_.store(true);
+  return header_.page_num_++;
+}
+
+void BPTreeIndex::FreePage(page_id_t pid)
+{
+  // bump the version, so that readers still holding the page restart
+  WriteLatchGuard latch_guard(Latch(pid));
+  std::lock_guard lock(meta_latch_);
+  NodeGuard       node(this, pid);
+  node.Reset(true);
+  node.Header()->next_     = header_.first_free_page_;
+  header_.first_free_page_ = pid;
+  header_dirty_.store(true);
+}
+void BPTreeIndex::HandleUnderflow(std::vector<page_id_t> &path, page_id_t pid)
+{
+  auto parent_pid = path.back();
+  path.pop_back();
+  bool      parent_underflow = false;
+  page_id_t freed            = INVALID_PAGE_ID;
+  page_id_t relink           = INVALID_PAGE_ID;
+  page_id_t relink_prev      = INVALID_PAGE_ID;
+  page_id_t freed_root       = INVALID_PAGE_ID;
+  {
+    NodeGuard parent(this, parent_pid);
+    size_t    idx = 0;
+    while (parent.Child(idx) != pid) {
+      idx++;
+    }
+    // prefer the left sibling, so that the node is always merged into its left neighbour
+    size_t    l_idx = idx > 0 ? idx - 1 : idx;
+    size_t    r_idx = l_idx + 1;
+    NodeGuard left(this, parent.Child(l_idx));
+    NodeGuard right(this, parent.Child(r_idx));
+    // readers may be in any of the three nodes
+    WriteLatchGuard parent_guard(Latch(parent_pid));
+    WriteLatchGuard left_guard(Latch(left.PageId()));
+    WriteLatchGuard right_guard(Latch(right.PageId()));
+    bool      is_leaf  = left.IsLeaf();
+    size_t    max_size = is_leaf ? leaf_max_size_ : internal_max_size_;
+    if (left.Size() + right.Size() > max_size) {
+      // the two nodes do not fit in one, borrow one entry from the sibling through the parent
+      if (idx > 0) {
+        right.Shift(0, 1);
+        if (is_leaf) {
+          memcpy(right.Key(0), left.Key(left.Size() - 1), leaf_entry_size_);
+          memcpy(parent.Key(r_idx), right.Key(0), key_size_);
+        } else {
+          memcpy(right.Key(1), parent.Key(r_idx), key_size_);
+          right.SetChild(0, left.Child(left.Size() - 1));
+          memcpy(parent.Key(r_idx), left.Key(left.Size() - 1), key_size_);
+        }
+        left.Shift(left.Size(), -1);
+      } else {
+        if (is_leaf) {
+          memcpy(left.Key(left.Size()), right.Key(0), leaf_entry_size_);
+          left.Shift(left.Size(), 1);
+          right.Shift(1, -1);
+          memcpy(parent.Key(r_idx), right.Key(0), key_size_);
+        } else {
+          auto slot = left.Size();
+          left.Shift(slot, 1);
+          memcpy(left.Key(slot), parent.Key(r_idx), key_size_);
+          left.SetChild(slot, right.Child(0));
+          memcpy(parent.Key(r_idx), right.Key(1), key_size_);
+          right.Shift(1, -1);
+        }
+      }
+      parent.MarkDirty();
+      return;
+    }
+    // merge the right node into the left one
+    auto slot = left.Size();
+    left.Shift(slot, static_cast<int>(right.Size()));
+    memcpy(left.Key(slot), right.Key(0), right.Size() * (is_leaf ? leaf_entry_size_ : internal_entry_size_));
+    if (is_leaf) {
+      left.Header()->next_ = right.Header()->next_;
+      relink               = right.Header()->next_;
+      relink_prev          = left.PageId();
+    } else {
+      // the first key of the right node is minus infinity, take the separator from the parent
+      memcpy(left.Key(slot), parent.Key(r_idx), key_size_);
+    }
+    freed = right.PageId();
+    parent.Shift(r_idx + 1, -1);
+    parent_underflow = parent.Size() < (internal_max_size_ + 1) / 2;
+    if (path.empty() && parent.Size() == 1) {
+      // the root has only one child left, the child becomes the root
+      WriteLatchGuard root_guard(root_latch_);
+      root_.store(left.PageId());
+      parent_underflow = false;
+      freed_root            = parent_pid;
+    }
+  }
+  if (relink != INVALID_PAGE_ID) {
+    WriteLatchGuard next_guard(Latch(relink));
+    NodeGuard       next(this, relink);
+    next.Header()->prev_ = relink_prev;
+    next.MarkDirty();
+  }
+  if (freed != INVALID_PAGE_ID) {
+    FreePage(freed);
+  }
+  if (freed_root != INVALID_PAGE_ID) {
+    FreePage(freed_root);
+  }
+  if (parent_underflow && !path.empty()) {
+    HandleUnderflow(path, parent_pid);
+  }
+}
+
+void BPTreeIndex::LoadHeader()
+{
+  auto page = buffer_pool_manager_->FetchPage(fid_, FILE_HEADER_PAGE_ID);
+  memcpy(&header_, page->GetData(), sizeof(BPTreeHeader));
+  buffer_pool_manager_->UnpinPage(fid_, FILE_HEADER_PAGE_ID, false);
+  // a new index file is all zeros, while page_num_ counts at least the header page
+  if (header_.page_num_ == 0) {
+    header_ = BPTreeHeader{};
+  }
+  root_.store(header_.root_page_id_);
+  entry_num_.store(header_.entry_num_);
+  FlushHeader();
+}
+
+void BPTreeIndex::FlushHeader()
+{
+  std::lock_guard lock(meta_latch_);
+  // cleared before the copy, a change made meanwhile marks the header again and is flushed by its own operation
+  header_dirty_.store(false);
+  header_.root_page_id_ = root_.load();
+  header_.entry_num_    = entry_num_.load();
+  auto page             = buffer_pool_manager_->FetchPage(fid_, FILE_HEADER_PAGE_ID);
+  memcpy(page->GetData(), &header_, sizeof(BPTreeHeader));
+  buffer_pool_manager_->UnpinPage(fid_, FILE_HEADER_PAGE_ID, true);
+}
+
+}  // namespace wsdb
@@ -19,21 +19,275 @@
 // Created by ziqi on 2024/7/28.
 //
 
+/**
+ * @brief A disk resident B+ tree on the buffer pool.
+ * Keys are stored as normalized binary keys (see SortKeyEncoder) followed by the big endian RID, so every entry is
+ * unique and entries are ordered by memcmp. The page FILE_HEADER_PAGE_ID of the index file holds a BPTreeHeader, the
+ * other pages are nodes: a BPTreeNodeHeader after the common page header, then the entries. A leaf entry is the entry
+ * key followed by the encoded included fields, an internal entry is the entry key and a child page id, where the key of
+ * the first entry is not used. Leaves are linked in both directions for range scans.
+ * The key schema of the index lists the key fields, then the included fields, which are carried by the leaves only so
+ * that scans reading them need not visit the table.
+ *
+ * Concurrency follows optimistic lock coupling. Every node has an OptimisticLatch kept in memory, apart from the page,
+ * so a node can be validated without being pinned. Readers latch nothing and restart from the root when a node they
+ * read changes under them. Inserts go down the same way, split full nodes eagerly on the way down, and only take the
+ * write latches of the leaf they change, or of a node and its parent while splitting. A delete that would make a leaf
+ * underflow is redone holding smo_latch_ exclusively, which keeps the other writers out while nodes merge. A reader
+ * pins one node at a time, a writer at most two, or three while merging.
+ */
+
 #ifndef WSDB_INDEX_BP_TREE_H
 #define WSDB_INDEX_BP_TREE_H
 
+#include <shared_mutex>
 #include "index_abstract.h"
+#include "common/optimistic_latch.h"
+#include "expr/sort_key.h"
 
 namespace wsdb {
+
+struct BPTreeHeader
+{
+  page_id_t root_page_id_{INVALID_PAGE_ID};
+  page_id_t first_leaf_{INVALID_PAGE_ID};
+  // pages in the file, including the header page
+  page_id_t page_num_{FILE_HEADER_PAGE_ID + 1};
+  // pages freed by merges, linked by BPTreeNodeHeader::next_
+  page_id_t first_free_page_{INVALID_PAGE_ID};
+  size_t    entry_num_{0};
+  // leading fields of the key schema that make the key, 0 if all of them do
+  uint32_t  key_field_num_{0};
+};
+
+struct BPTreeNodeHeader
+{
+  uint32_t  is_leaf_;
+  uint32_t  size_;
+  page_id_t prev_;
+  page_id_t next_;
+};
+
+class BPTreeIndex;
+
+class BPTreeIterator : public IndexIterator
+{
+public:
+  /// position on the first entry not less than begin, stop after the entries whose first end.size() bytes equal end
+  BPTreeIterator(BPTreeIndex *tree, std::string begin, std::string end);
+
+  [[nodiscard]] auto IsEnd() const -> bool override { return rid_ == INVALID_RID; }
+
+  void Next() override;
+
+  [[nodiscard]] auto GetRID() const -> RID override { return rid_; }
+
+  [[nodiscard]] auto GetRecord() const -> RecordUptr override;
+
+private:
+  /// load the next entry into rid_, seeking from the root again whenever the leaf changed since it was visited
+  void Fetch();
+
+  /// find the leaf and the slot of the first entry after key_, or not less than key_ if no entry is returned yet
+  auto Seek() -> bool;
+
+  /// load the entry at slot_ of leaf_ or of the leaves after it, false if a leaf changed while it was read
+  auto Load() -> bool;
+
+  BPTreeIndex *tree_;
+  // begin, then the last returned leaf entry
+  std::string key_;
+  std::string end_;
+  bool        started_{false};
+  bool        done_{false};
+  page_id_t   leaf_{INVALID_PAGE_ID};
+  uint64_t    version_{0};
+  size_t      slot_{0};
+  RID         rid_{INVALID_RID};
+};
+
 class BPTreeIndex : public Index
 {
+  friend class BPTreeIterator;
+
 public:
+  BPTreeIndex(DiskManager *disk_manager, BufferPoolManager *buffer_pool_manager, file_id_t fid, idx_id_t index_id,
+      RecordSchema *key_schema);
+
+  ~BPTreeIndex() override;
+
+  DISABLE_COPY_MOVE_AND_ASSIGN(BPTreeIndex)
+
   void Insert(const Record &key, const RID &rid) override;
 
   void Delete(const Record &key, const RID &rid) override;
 
+  using Index::Scan;
+
+  auto Scan(const Record &low, size_t low_field_num, const Record &high, size_t high_field_num)
+      -> IndexIteratorUptr override;
+
+  void Flush() override { FlushHeader(); }
+
+  /// rids of the entries with exactly the given key
+  auto Search(const Record &key) -> std::vector<RID>;
+
+  /// store the last include_num fields of the key schema in the leaves instead of the key, the tree should be empty
+  void SetIncludeFieldNum(size_t include_num);
+
+  [[nodiscard]] auto GetKeyFieldNum() const -> size_t override { return encoder_.GetFieldCount(); }
+
+  /// a leaf entry as a record of the key schema
+  [[nodiscard]] auto DecodeEntry(const char *entry) const -> RecordUptr;
+
+  /**
+   * build the tree bottom up from unsorted entries, the tree should be empty. Entries are sorted by their binary keys,
+   * by dop threads, then packed into leaves filled to fill_factor, and the internal levels are built over the leaves
+   */
+  void BulkLoad(
+      const std::vector<std::pair<RecordUptr, RID>> &entries, double fill_factor = BPTREE_FILL_FACTOR, size_t dop = 1);
+
+  [[nodiscard]] auto IsEmpty() const -> bool { return root_.load() == INVALID_PAGE_ID; }
+
+  [[nodiscard]] auto GetEntryNum() const -> size_t { return entry_num_.load(); }
+
+  /// height of the tree, not synchronized with concurrent splits
+  [[nodiscard]] auto GetHeight() -> size_t;
+
+  [[nodiscard]] auto GetLeafMaxSize() const -> size_t { return leaf_max_size_; }
+
+  [[nodiscard]] auto GetInternalMaxSize() const -> size_t { return internal_max_size_; }
+
+private:
+  /// pinned node, unpinned on destruction
+  class NodeGuard
+  {
+  public:
+    NodeGuard(BPTreeIndex *tree, page_id_t pid);
+    ~NodeGuard();
+    DISABLE_COPY_MOVE_AND_ASSIGN(NodeGuard)
+
+    [[nodiscard]] auto PageId() const -> page_id_t { return pid_; }
+    auto Header() -> BPTreeNodeHeader * { return header_; }
+    [[nodiscard]] auto IsLeaf() const -> bool { return header_->is_leaf_ != 0; }
+    [[nodiscard]] auto Size() const -> size_t { return header_->size_; }
+    auto Key(size_t idx) -> char * { return entries_ + idx * entry_size_; }
+    auto Child(size_t idx) -> page_id_t;
+    void SetChild(size_t idx, page_id_t child);
+    void MarkDirty() { dirty_ = true; }
+
+    /// whether the header of the node is consistent, it may not be while a writer changes the node
+    [[nodiscard]] auto Sane() const -> bool;
+
+    /// make the node an empty leaf or internal node
+    void Reset(bool is_leaf);
+
+    /// move entries [idx, size) by delta slots, delta may be negative
+    void Shift(size_t idx, int delta);
+
+  private:
+    BPTreeIndex      *tree_;
+    page_id_t         pid_;
+    Page             *page_;
+    BPTreeNodeHeader *header_;
+    char             *entries_;
+    size_t            entry_size_;
+    bool              dirty_{false};
+  };
+
+  enum class TryResult
+  {
+    DONE,
+    RESTART,
+    UNDERFLOW,
+  };
+
+  /// split the key schema into the key and the included fields, and size the entries after them
+  void InitLayout();
+
+  /// leaf entry of a key record and a rid
+  void EncodeEntry(const Record &key, const RID &rid, char *dst) const;
+
+  static void EncodeRID(const RID &rid, char *dst);
+
+  static auto DecodeRID(const char *src) -> RID;
+
+  auto CompareKey(const char *lhs, const char *rhs) const -> int { return memcmp(lhs, rhs, key_size_); }
+
+  /// first slot in the leaf whose key is not less than key
+  auto LeafLowerBound(NodeGuard &node, const char *key) const -> size_t;
+
+  /// slot of the child of an internal node covering key
+  auto InternalLookup(NodeGuard &node, const char *key) const -> size_t;
+
+  /// latch of a node, the latches live as long as the tree
+  auto Latch(page_id_t pid) -> OptimisticLatch &;
+
+  /// whether the node read at version can be used, false if a writer is changing it
+  auto Readable(NodeGuard &node, uint64_t version) -> bool;
+
+  /// descend to the leaf covering key without latching, leaf is INVALID_PAGE_ID if the tree is empty. Returns false if
+  /// a writer got in the way, the leaf should then be validated against version after it is read
+  auto Descend(const char *key, page_id_t &leaf, uint64_t &version) -> bool;
+
+  /// one optimistic attempt of an insert, false if it has to restart
+  auto TryInsert(const char *entry) -> bool;
+
+  /// one optimistic attempt of a delete, UNDERFLOW if the leaf would underflow and nodes have to merge
+  auto TryDelete(const char *entry, const RID &rid) -> TryResult;
+
+  /// delete with the other writers excluded, merging nodes on underflow
+  void DeleteExclusive(const char *entry, const RID &rid);
+
+  /// split a full node into a new right sibling, both the node and its parent are write latched. The parent is the
+  /// root latch if the node is the root
+  void Split(page_id_t parent, page_id_t pid, bool is_leaf);
+
+  /// find the leaf covering key, the internal nodes on the way are recorded in path if it is not nullptr. Only used
+  /// with the other writers excluded
+  auto FindLeaf(const char *key, std::vector<page_id_t> *path) -> page_id_t;
+
+  auto AllocatePage() -> page_id_t;
+
+  void FreePage(page_id_t pid);
+
+  /// fix the underflow of node by borrowing from or merging with a sibling
+  void HandleUnderflow(std::vector<page_id_t> &path, page_id_t pid);
+
+  void LoadHeader();
+
+  void FlushHeader();
+
+private:
+  // latches are allocated by chunks of LATCH_CHUNK_SIZE nodes as the file grows
+  static constexpr size_t LATCH_CHUNK_SIZE = 1024;
+  static constexpr size_t LATCH_CHUNK_NUM  = 1 << 14;
 
-  BPTreeIndex(DiskManager *disk_manager, BufferPoolManager *buffer_pool_manager, idx_id_t index_id, RecordSchema *key_schema);
+  file_id_t        fid_;
+  RecordSchemaUptr key_fields_;
+  RecordSchemaUptr include_fields_;
+  SortKeyEncoder   encoder_;
+  SortKeyEncoder   include_encoder_;
+  // page_num_, first_free_page_ and first_leaf_ of the header are protected by meta_latch_, the root and the entry
+  // number are kept in root_ and entry_num_ and copied into the header when it is flushed. The header page is only
+  // written when the pages or the root change, on Flush, which the statements changing the index call at their end,
+  // and on destruction, not for every entry
+  BPTreeHeader           header_;
+  std::mutex             meta_latch_;
+  std::atomic<page_id_t> root_{INVALID_PAGE_ID};
+  std::atomic<size_t>    entry_num_{0};
+  std::atomic<bool>      header_dirty_{false};
+  // taken shared by every insert and delete, and exclusively by the deletes that merge nodes and by bulk loading
+  std::shared_mutex smo_latch_;
+  // latch of the root pointer, it acts as the parent latch of the root node
+  OptimisticLatch                                   root_latch_;
+  std::unique_ptr<std::atomic<OptimisticLatch *>[]> latch_chunks_;
+  // size of the encoded key with the rid, a leaf entry also holds the encoded included fields
+  size_t key_size_;
+  size_t leaf_entry_size_;
+  size_t internal_entry_size_;
+  size_t leaf_max_size_;
+  size_t internal_max_size_;
 };
 }  // namespace wsdb
 
@@ -23,13 +23,478 @@
 
 namespace wsdb {
 
-// FIXME: HashIndex initialization should include more information, such as bucket size, etc.
-HashIndex::HashIndex(
-    DiskManager *disk_manager, BufferPoolManager *buffer_pool_manager, idx_id_t index_id, RecordSchema *key_schema)
-    : Index(disk_manager, buffer_pool_manager, IndexType::HASH, index_id, key_schema)
+namespace {
+/**
+ * 64 bit hash of an encoded key, eight bytes at a time with a murmur finalizer so that the low bits the directory
+ * takes depend on all bytes. The directory slots of the entries are on disk, so the hash must not change between builds
+ */
+auto HashKey(const char *data, size_t size) -> uint64_t
 {
-  WSDB_THROW(WSDB_NOT_IMPLEMENTED, "");
+  uint64_t h = 0x9e3779b97f4a7c15ULL ^ size;
+  size_t   i = 0;
+  for (; i + sizeof(uint64_t) <= size; i += sizeof(uint64_t)) {
+    uint64_t word;
+    memcpy(&word, data + i, sizeof(word));
+    h = (h ^ word) * 0x100000001b3ULL;
+    h ^= h >> 29;
+  }
+  for (; i < size; i++) {
+    h = (h ^ static_cast<uint8_t>(data[i])) * 0x100000001b3ULL;
+  }
+  h ^= h >> 33;
+  h *= 0xff51afd7ed558ccdULL;
+  h ^= h >> 33;
+  h *= 0xc4ceb9fe1a85ec53ULL;
+  h ^= h >> 33;
+  return h;
 }
-void HashIndex::Insert(const Record &key, const RID &rid) {}
-void HashIndex::Delete(const Record &key, const RID &rid) {}
-}  // namespace wsdb
\ No newline at end of file
+}  // namespace
+
+/// HashIterator
+
+auto HashIterator::GetRID() const -> RID { return index_->DecodeRID(entries_[pos_].data()); }
+
+auto HashIterator::GetRecord() const -> RecordUptr { return index_->DecodeEntry(entries_[pos_].data()); }
+
+/// HashIndex::BucketGuard
+
+HashIndex::BucketGuard::BucketGuard(HashIndex *index, page_id_t pid) : index_(index), pid_(pid)
+{
+  WSDB_ASSERT(pid != INVALID_PAGE_ID && pid != FILE_HEADER_PAGE_ID, fmt::format("invalid bucket page {}", pid));
+  page_    = index_->buffer_pool_manager_->FetchPage(index_->fid_, pid_);
+  header_  = reinterpret_cast<HashBucketHeader *>(page_->GetData() + PAGE_HEADER_SIZE);
+  entries_ = page_->GetData() + PAGE_HEADER_SIZE + sizeof(HashBucketHeader);
+}
+
+HashIndex::BucketGuard::~BucketGuard() { index_->buffer_pool_manager_->UnpinPage(index_->fid_, pid_, dirty_); }
+
+void HashIndex::BucketGuard::Reset(uint32_t local_depth)
+{
+  header_->local_depth_ = local_depth;
+  header_->size_        = 0;
+  header_->next_        = INVALID_PAGE_ID;
+  dirty_                = true;
+}
+
+void HashIndex::BucketGuard::Append(const char *entry)
+{
+  WSDB_ASSERT(Size() < index_->bucket_max_size_, "bucket page is full");
+  memcpy(Entry(header_->size_++), entry, index_->entry_size_);
+  dirty_ = true;
+}
+
+/// HashIndex
+
+HashIndex::HashIndex(DiskManager *disk_manager, BufferPoolManager *buffer_pool_manager, file_id_t fid,
+    idx_id_t index_id, RecordSchema *key_schema)
+    : Index(disk_manager, buffer_pool_manager, IndexType::HASH, index_id, key_schema),
+      fid_(fid),
+      encoder_(key_schema, key_schema, false),
+      dir_dirty_(HASH_DIR_PAGE_NUM, false)
+{
+  key_size_        = encoder_.GetKeySize();
+  entry_size_      = key_size_ + sizeof(page_id_t) + sizeof(slot_id_t);
+  bucket_max_size_ = (PAGE_SIZE - PAGE_HEADER_SIZE - sizeof(HashBucketHeader)) / entry_size_;
+  if (bucket_max_size_ < 2) {
+    WSDB_THROW(WSDB_UNSUPPORTED_OP, fmt::format("index key of {} bytes is too long", key_size_));
+  }
+  LoadHeader();
+  LoadDirectory();
+}
+
+HashIndex::~HashIndex() { FlushHeader(); }
+
+void HashIndex::Insert(const Record &key, const RID &rid)
+{
+  std::string entry(entry_size_, '\0');
+  EncodeEntry(key, rid, entry.data());
+  auto hash = Hash(entry.data());
+
+  std::unique_lock lock(latch_);
+  while (true) {
+    auto slot   = Slot(hash);
+    auto bucket = dir_[slot];
+    auto depth  = depths_[slot];
+    // entries that differ from the new one in the hash bits above the local depth can be split apart
+    auto   split_mask = ((1UL << HASH_MAX_DEPTH) - 1) & ~((1UL << depth) - 1);
+    bool   splittable = false;
+    size_t last_size  = 0;
+    for (auto pid = bucket; pid != INVALID_PAGE_ID;) {
+      BucketGuard page(this, pid);
+      for (size_t i = 0; i < page.Size(); i++) {
+        if (EqualEntry(page.Entry(i), entry.data())) {
+          WSDB_THROW(WSDB_RECORD_EXISTS, fmt::format("index entry of rid ({}, {})", rid.PageID(), rid.SlotID()));
+        }
+        splittable = splittable || ((Hash(page.Entry(i)) ^ hash) & split_mask) != 0;
+      }
+      last_size = page.Size();
+      pid       = page.Next();
+    }
+    if (last_size < bucket_max_size_ || !splittable) {
+      AppendToBucket(bucket, entry.data());
+      break;
+    }
+    Split(slot);
+  }
+  header_.entry_num_++;
+  if (header_dirty_) {
+    FlushHeader();
+  }
+}
+
+void HashIndex::Delete(const Record &key, const RID &rid)
+{
+  std::string entry(entry_size_, '\0');
+  EncodeEntry(key, rid, entry.data());
+  auto hash = Hash(entry.data());
+
+  std::unique_lock lock(latch_);
+  auto      slot   = Slot(hash);
+  auto      bucket = dir_[slot];
+  page_id_t found  = INVALID_PAGE_ID;
+  size_t    found_idx{0};
+  page_id_t prev = INVALID_PAGE_ID;
+  page_id_t last = INVALID_PAGE_ID;
+  for (auto pid = bucket; pid != INVALID_PAGE_ID;) {
+    BucketGuard page(this, pid);
+    for (size_t i = 0; found == INVALID_PAGE_ID && i < page.Size(); i++) {
+      if (EqualEntry(page.Entry(i), entry.data())) {
+        found     = pid;
+        found_idx = i;
+      }
+    }
+    prev = last;
+    last = pid;
+    pid  = page.Next();
+  }
+  if (found == INVALID_PAGE_ID) {
+    WSDB_THROW(WSDB_RECORD_MISS, fmt::format("index entry of rid ({}, {})", rid.PageID(), rid.SlotID()));
+  }
+  // fill the hole with the last entry of the bucket, so that only the last page of a bucket is not full
+  bool last_empty;
+  {
+    BucketGuard last_page(this, last);
+    auto        last_idx = last_page.Size() - 1;
+    if (found != last || found_idx != last_idx) {
+      BucketGuard page(this, found);
+      memcpy(page.Entry(found_idx), last_page.Entry(last_idx), entry_size_);
+      page.MarkDirty();
+    }
+    last_page.Header()->size_--;
+    last_page.MarkDirty();
+    last_empty = last_page.Size() == 0;
+  }
+  if (last_empty && last != bucket) {
+    {
+      BucketGuard prev_page(this, prev);
+      prev_page.Header()->next_ = INVALID_PAGE_ID;
+      prev_page.MarkDirty();
+    }
+    FreePage(last);
+  }
+  header_.entry_num_--;
+  Merge(slot);
+  if (header_dirty_) {
+    FlushHeader();
+  }
+}
+
+void HashIndex::Flush()
+{
+  std::unique_lock lock(latch_);
+  FlushHeader();
+}
+
+auto HashIndex::Scan(const Record &low, size_t low_field_num, const Record &high, size_t high_field_num)
+    -> IndexIteratorUptr
+{
+  if (low_field_num != encoder_.GetFieldCount() || high_field_num != encoder_.GetFieldCount()) {
+    WSDB_THROW(WSDB_UNSUPPORTED_OP, "hash index only supports lookups on the whole key");
+  }
+  auto low_key  = encoder_.Encode(low);
+  auto high_key = encoder_.Encode(high);
+  if (low_key != high_key) {
+    WSDB_THROW(WSDB_UNSUPPORTED_OP, "hash index only supports equality lookups");
+  }
+  return std::make_unique<HashIterator>(this, Lookup(low_key.data()));
+}
+
+auto HashIndex::Search(const Record &key) -> std::vector<RID>
+{
+  std::vector<RID> rids;
+  for (const auto &entry : Lookup(encoder_.Encode(key).data())) {
+    rids.push_back(DecodeRID(entry.data()));
+  }
+  return rids;
+}
+
+auto HashIndex::DecodeEntry(const char *entry) const -> RecordUptr
+{
+  return std::make_unique<Record>(key_schema_, encoder_.DecodeValues(entry), DecodeRID(entry));
+}
+
+auto HashIndex::DecodeRID(const char *entry) const -> RID
+{
+  return {SortKeyEncoder::DecodeInt(entry + key_size_),
+      SortKeyEncoder::DecodeInt(entry + key_size_ + sizeof(page_id_t))};
+}
+
+auto HashIndex::GetBucketNum() const -> size_t
+{
+  // a bucket of local depth d is counted at the only slot of it below 2^d
+  size_t num = 0;
+  for (size_t i = 0; i < dir_.size(); i++) {
+    num += i < (1UL << depths_[i]) ? 1 : 0;
+  }
+  return num;
+}
+
+void HashIndex::EncodeEntry(const Record &key, const RID &rid, char *dst) const
+{
+  encoder_.Encode(key, dst);
+  SortKeyEncoder::EncodeInt(rid.PageID(), dst + key_size_);
+  SortKeyEncoder::EncodeInt(rid.SlotID(), dst + key_size_ + sizeof(page_id_t));
+}
+
+auto HashIndex::Lookup(const char *key) -> std::vector<std::string>
+{
+  auto                     hash = Hash(key);
+  std::vector<std::string> entries;
+  std::shared_lock         lock(latch_);
+  for (auto pid = dir_[Slot(hash)]; pid != INVALID_PAGE_ID;) {
+    BucketGuard page(this, pid);
+    for (size_t i = 0; i < page.Size(); i++) {
+      if (EqualKey(page.Entry(i), key)) {
+        entries.emplace_back(page.Entry(i), entry_size_);
+      }
+    }
+    pid = page.Next();
+  }
+  return entries;
+}
+
+auto HashIndex::Hash(const char *entry) const -> size_t
+{
+  return HashKey(entry, key_size_);
+}
+
+void HashIndex::AppendToBucket(page_id_t bucket, const char *entry)
+{
+  auto pid = bucket;
+  while (true) {
+    BucketGuard page(this, pid);
+    if (page.Next() != INVALID_PAGE_ID) {
+      pid = page.Next();
+      continue;
+    }
+    if (page.Size() < bucket_max_size_) {
+      page.Append(entry);
+      return;
+    }
+    auto        next = AllocatePage();
+    BucketGuard overflow(this, next);
+    overflow.Reset(page.Header()->local_depth_);
+    overflow.Append(entry);
+    page.Header()->next_ = next;
+    page.MarkDirty();
+    return;
+  }
+}
+
+void HashIndex::Split(size_t slot)
+{
+  auto bucket = dir_[slot];
+  auto depth  = depths_[slot];
+  if (depth == header_.global_depth_) {
+    WSDB_ASSERT(header_.global_depth_ < HASH_MAX_DEPTH, "hash directory is full");
+    auto size = dir_.size();
+    dir_.resize(size * 2);
+    depths_.resize(size * 2);
+    std::copy_n(dir_.begin(), size, dir_.begin() + static_cast<long>(size));
+    std::copy_n(depths_.begin(), size, depths_.begin() + static_cast<long>(size));
+    header_.global_depth_++;
+    header_dirty_ = true;
+    std::fill(dir_dirty_.begin(), dir_dirty_.end(), true);
+  }
+
+  // take the entries out of the bucket and its overflow pages
+  std::string entries;
+  page_id_t   next;
+  {
+    BucketGuard page(this, bucket);
+    entries.append(page.Entry(0), page.Size() * entry_size_);
+    next = page.Next();
+    page.Reset(depth + 1);
+  }
+  while (next != INVALID_PAGE_ID) {
+    auto pid = next;
+    {
+      BucketGuard page(this, pid);
+      entries.append(page.Entry(0), page.Size() * entry_size_);
+      next = page.Next();
+    }
+    FreePage(pid);
+  }
+  auto image = AllocatePage();
+  {
+    BucketGuard page(this, image);
+    page.Reset(depth + 1);
+  }
+  SetBucket(slot & ~(1UL << depth), depth + 1, bucket);
+  SetBucket(slot | (1UL << depth), depth + 1, image);
+  for (size_t off = 0; off < entries.size(); off += entry_size_) {
+    auto entry = entries.data() + off;
+    AppendToBucket((Hash(entry) >> depth & 1) != 0 ? image : bucket, entry);
+  }
+  FlushDirectory();
+}
+
+void HashIndex::Merge(size_t slot)
+{
+  bool merged = false;
+  while (depths_[slot] > 0) {
+    auto depth      = depths_[slot];
+    auto bit        = 1UL << (depth - 1);
+    auto buddy_slot = slot ^ bit;
+    if (depths_[buddy_slot] != depth) {
+      break;
+    }
+    // the bucket at the slot without the bit survives
+    auto keep = dir_[slot & ~bit];
+    auto drop = dir_[slot | bit];
+    {
+      BucketGuard keep_page(this, keep);
+      BucketGuard drop_page(this, drop);
+      if (keep_page.Next() != INVALID_PAGE_ID || drop_page.Next() != INVALID_PAGE_ID ||
+          keep_page.Size() + drop_page.Size() > bucket_max_size_ / 2) {
+        break;
+      }
+      for (size_t i = 0; i < drop_page.Size(); i++) {
+        keep_page.Append(drop_page.Entry(i));
+      }
+      keep_page.Header()->local_depth_ = depth - 1;
+    }
+    FreePage(drop);
+    SetBucket(slot, depth - 1, keep);
+    slot &= bit - 1;
+    merged = true;
+  }
+  if (!merged) {
+    return;
+  }
+  // halve the directory while no bucket tells the two halves apart
+  while (header_.global_depth_ > 0 &&
+         std::all_of(depths_.begin(), depths_.end(), [&](uint32_t d) { return d < header_.global_depth_; })) {
+    header_.global_depth_--;
+    header_dirty_ = true;
+    dir_.resize(dir_.size() / 2);
+    depths_.resize(depths_.size() / 2);
+  }
+  FlushDirectory();
+}
+
+void HashIndex::SetBucket(size_t slot, uint32_t depth, page_id_t bucket)
+{
+  auto stride = 1UL << depth;
+  for (auto i = slot & (stride - 1); i < dir_.size(); i += stride) {
+    dir_[i]                            = bucket;
+    depths_[i]                         = depth;
+    dir_dirty_[i / HASH_DIR_PAGE_SLOTS] = true;
+  }
+}
+
+auto HashIndex::AllocatePage() -> page_id_t
+{
+  if (header_.first_free_page_ != INVALID_PAGE_ID) {
+    auto        pid = header_.first_free_page_;
+    BucketGuard page(this, pid);
+    header_.first_free_page_ = page.Next();
+    header_dirty_            = true;
+    return pid;
+  }
+  header_dirty_ = true;
+  return header_.page_num_++;
+}
+
+void HashIndex::FreePage(page_id_t pid)
+{
+  BucketGuard page(this, pid);
+  page.Reset(0);
+  page.Header()->next_     = header_.first_free_page_;
+  header_.first_free_page_ = pid;
+  header_dirty_            = true;
+}
+
+void HashIndex::LoadHeader()
+{
+  auto page = buffer_pool_manager_->FetchPage(fid_, FILE_HEADER_PAGE_ID);
+  memcpy(&header_, page->GetData(), sizeof(HashHeader));
+  buffer_pool_manager_->UnpinPage(fid_, FILE_HEADER_PAGE_ID, false);
+  // a new index file is all zeros, while page_num_ counts at least the header page
+  if (header_.page_num_ == 0) {
+    header_ = HashHeader{};
+    header_.dir_pages_.fill(INVALID_PAGE_ID);
+  }
+}
+
+void HashIndex::FlushHeader()
+{
+  header_dirty_ = false;
+  auto page = buffer_pool_manager_->FetchPage(fid_, FILE_HEADER_PAGE_ID);
+  memcpy(page->GetData(), &header_, sizeof(HashHeader));
+  buffer_pool_manager_->UnpinPage(fid_, FILE_HEADER_PAGE_ID, true);
+}
+
+void HashIndex::LoadDirectory()
+{
+  if (header_.dir_pages_[0] == INVALID_PAGE_ID) {
+    // a new index starts with one empty bucket
+    auto bucket = AllocatePage();
+    {
+      BucketGuard page(this, bucket);
+      page.Reset(0);
+    }
+    dir_    = {bucket};
+    depths_ = {0};
+    dir_dirty_[0] = true;
+    FlushDirectory();
+    FlushHeader();
+    return;
+  }
+  dir_.resize(1UL << header_.global_depth_);
+  depths_.resize(dir_.size());
+  for (size_t i = 0; i * HASH_DIR_PAGE_SLOTS < dir_.size(); i++) {
+    auto num  = std::min(HASH_DIR_PAGE_SLOTS, dir_.size() - i * HASH_DIR_PAGE_SLOTS);
+    auto page = buffer_pool_manager_->FetchPage(fid_, header_.dir_pages_[i]);
+    memcpy(dir_.data() + i * HASH_DIR_PAGE_SLOTS, page->GetData() + PAGE_HEADER_SIZE, num * sizeof(page_id_t));
+    buffer_pool_manager_->UnpinPage(fid_, header_.dir_pages_[i], false);
+  }
+  // the local depths are read once per bucket, at the only slot of the bucket below 2^depth
+  for (size_t i = 0; i < dir_.size(); i++) {
+    BucketGuard page(this, dir_[i]);
+    auto        depth = page.Header()->local_depth_;
+    if (i < (1UL << depth)) {
+      SetBucket(i, depth, dir_[i]);
+    }
+  }
+  std::fill(dir_dirty_.begin(), dir_dirty_.end(), false);
+}
+
+void HashIndex::FlushDirectory()
+{
+  for (size_t i = 0; i * HASH_DIR_PAGE_SLOTS < dir_.size(); i++) {
+    if (!dir_dirty_[i]) {
+      continue;
+    }
+    if (header_.dir_pages_[i] == INVALID_PAGE_ID) {
+      header_.dir_pages_[i] = AllocatePage();
+    }
+    auto num  = std::min(HASH_DIR_PAGE_SLOTS, dir_.size() - i * HASH_DIR_PAGE_SLOTS);
+    auto page = buffer_pool_manager_->FetchPage(fid_, header_.dir_pages_[i]);
+    memcpy(page->GetData() + PAGE_HEADER_SIZE, dir_.data() + i * HASH_DIR_PAGE_SLOTS, num * sizeof(page_id_t));
+    buffer_pool_manager_->UnpinPage(fid_, header_.dir_pages_[i], true);
+    dir_dirty_[i] = false;
+  }
+}
+
+}  // namespace wsdb
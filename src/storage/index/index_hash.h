@@ -19,21 +19,207 @@
 // Created by ziqi on 2024/7/28.
 //
 
+/**
+ * @brief A disk resident extendible hash index on the buffer pool.
+ * Entries are the normalized binary key (see SortKeyEncoder) followed by the big endian RID, and are hashed on the key
+ * part, the low global_depth_ bits of the hash select a slot of the directory. The page FILE_HEADER_PAGE_ID of the
+ * index file holds a HashHeader, which lists the directory pages, every directory page holds HASH_DIR_PAGE_SLOTS
+ * bucket page ids. A bucket page is a HashBucketHeader after the common page header, then the unordered entries. A full
+ * bucket splits on the next bit of the hash, doubling the directory if its local depth reaches the global depth.
+ * Entries that no split can separate, which are the duplicates of one key, go to overflow pages chained after the
+ * bucket. A bucket that gets small is merged with its buddy, and the directory halves when no bucket needs its last
+ * bit.
+ *
+ * The directory and the local depths are cached in memory and written through to the directory pages. The header
+ * page is written when pages are allocated or freed or the global depth changes, the entry number only on Flush and
+ * on destruction. Lookups share latch_, inserts and deletes take it exclusively.
+ */
+
 #ifndef WSDB_INDEX_HASH_H
 #define WSDB_INDEX_HASH_H
 
+#include <array>
+#include <shared_mutex>
 #include "index_abstract.h"
+#include "expr/sort_key.h"
 
 namespace wsdb {
 
+// directory slots of a directory page and directory pages of an index, the directory can grow to their product
+constexpr size_t HASH_DIR_PAGE_SLOTS = 512;
+constexpr size_t HASH_DIR_PAGE_NUM   = 512;
+constexpr size_t HASH_MAX_DEPTH      = 18;
+
+static_assert(HASH_DIR_PAGE_SLOTS * sizeof(page_id_t) <= PAGE_SIZE - PAGE_HEADER_SIZE);
+static_assert((1UL << HASH_MAX_DEPTH) == HASH_DIR_PAGE_SLOTS * HASH_DIR_PAGE_NUM);
+
+struct HashHeader
+{
+  uint32_t  global_depth_{0};
+  // pages in the file, including the header page
+  page_id_t page_num_{FILE_HEADER_PAGE_ID + 1};
+  // pages freed by merges, linked by HashBucketHeader::next_
+  page_id_t first_free_page_{INVALID_PAGE_ID};
+  size_t    entry_num_{0};
+  // directory pages, slot i of the directory is on page dir_pages_[i / HASH_DIR_PAGE_SLOTS]
+  std::array<page_id_t, HASH_DIR_PAGE_NUM> dir_pages_;
+};
+
+static_assert(sizeof(HashHeader) <= PAGE_SIZE);
+
+struct HashBucketHeader
+{
+  uint32_t  local_depth_;
+  uint32_t  size_;
+  // next overflow page of the bucket, or the next free page
+  page_id_t next_;
+};
+
+class HashIndex;
+
+/// entries collected by a lookup, the index may change after the iterator is created
+class HashIterator : public IndexIterator
+{
+public:
+  HashIterator(const HashIndex *index, std::vector<std::string> entries) : index_(index), entries_(std::move(entries))
+  {}
+
+  [[nodiscard]] auto IsEnd() const -> bool override { return pos_ >= entries_.size(); }
+
+  void Next() override { pos_++; }
+
+  [[nodiscard]] auto GetRID() const -> RID override;
+
+  [[nodiscard]] auto GetRecord() const -> RecordUptr override;
+
+private:
+  const HashIndex         *index_;
+  std::vector<std::string> entries_;
+  size_t                   pos_{0};
+};
+
 class HashIndex : public Index
 {
 public:
-  HashIndex(DiskManager *disk_manager, BufferPoolManager *buffer_pool_manager, idx_id_t index_id, RecordSchema *key_schema);
+  HashIndex(DiskManager *disk_manager, BufferPoolManager *buffer_pool_manager, file_id_t fid, idx_id_t index_id,
+      RecordSchema *key_schema);
+
+  ~HashIndex() override;
+
+  DISABLE_COPY_MOVE_AND_ASSIGN(HashIndex)
 
   void Insert(const Record &key, const RID &rid) override;
 
   void Delete(const Record &key, const RID &rid) override;
+
+  void Flush() override;
+
+  using Index::Scan;
+
+  /// only equality lookups on the whole key are supported, low and high should hold the same key
+  auto Scan(const Record &low, size_t low_field_num, const Record &high, size_t high_field_num)
+      -> IndexIteratorUptr override;
+
+  /// rids of the entries with exactly the given key
+  auto Search(const Record &key) -> std::vector<RID>;
+
+  /// an entry as a record of the key schema
+  [[nodiscard]] auto DecodeEntry(const char *entry) const -> RecordUptr;
+
+  [[nodiscard]] auto DecodeRID(const char *entry) const -> RID;
+
+  [[nodiscard]] auto GetEntryNum() const -> size_t { return header_.entry_num_; }
+
+  [[nodiscard]] auto GetGlobalDepth() const -> size_t { return header_.global_depth_; }
+
+  /// number of distinct buckets, overflow pages are not counted
+  [[nodiscard]] auto GetBucketNum() const -> size_t;
+
+  [[nodiscard]] auto GetBucketMaxSize() const -> size_t { return bucket_max_size_; }
+
+private:
+  /// pinned bucket page, unpinned on destruction
+  class BucketGuard
+  {
+  public:
+    BucketGuard(HashIndex *index, page_id_t pid);
+    ~BucketGuard();
+    DISABLE_COPY_MOVE_AND_ASSIGN(BucketGuard)
+
+    auto Header() -> HashBucketHeader * { return header_; }
+    [[nodiscard]] auto Size() const -> size_t { return header_->size_; }
+    [[nodiscard]] auto Next() const -> page_id_t { return header_->next_; }
+    auto Entry(size_t idx) -> char * { return entries_ + idx * index_->entry_size_; }
+    void MarkDirty() { dirty_ = true; }
+
+    /// make the page an empty bucket page
+    void Reset(uint32_t local_depth);
+
+    void Append(const char *entry);
+
+  private:
+    HashIndex        *index_;
+    page_id_t         pid_;
+    Page             *page_;
+    HashBucketHeader *header_;
+    char             *entries_;
+    bool              dirty_{false};
+  };
+
+  void EncodeEntry(const Record &key, const RID &rid, char *dst) const;
+
+  /// the entries with exactly the given encoded key
+  auto Lookup(const char *key) -> std::vector<std::string>;
+
+  auto Hash(const char *entry) const -> size_t;
+
+  auto EqualKey(const char *lhs, const char *rhs) const -> bool { return memcmp(lhs, rhs, key_size_) == 0; }
+
+  auto EqualEntry(const char *lhs, const char *rhs) const -> bool { return memcmp(lhs, rhs, entry_size_) == 0; }
+
+  /// directory slot of a hash
+  [[nodiscard]] auto Slot(size_t hash) const -> size_t { return hash & ((1UL << header_.global_depth_) - 1); }
+
+  /// append an entry to the last page of a bucket, chaining an overflow page if the last page is full
+  void AppendToBucket(page_id_t bucket, const char *entry);
+
+  /// split the bucket at a directory slot on its next hash bit, doubling the directory if needed
+  void Split(size_t slot);
+
+  /// merge the bucket at a directory slot with its buddy while both are small, then shrink the directory
+  void Merge(size_t slot);
+
+  /// point every slot of the directory that shares the low depth bits of slot to bucket
+  void SetBucket(size_t slot, uint32_t depth, page_id_t bucket);
+
+  auto AllocatePage() -> page_id_t;
+
+  void FreePage(page_id_t pid);
+
+  void LoadHeader();
+
+  void FlushHeader();
+
+  void LoadDirectory();
+
+  /// write the directory pages marked in dir_dirty_
+  void FlushDirectory();
+
+private:
+  file_id_t      fid_;
+  SortKeyEncoder encoder_;
+  // written when the pages or the directory depth change, on Flush and on destruction, not for every entry
+  HashHeader     header_;
+  bool           header_dirty_{false};
+  // the directory and the local depth of the bucket of every slot
+  std::vector<page_id_t> dir_;
+  std::vector<uint32_t>  depths_;
+  std::vector<bool>      dir_dirty_;
+  std::shared_mutex      latch_;
+  // size of the encoded key, and of the key with the rid
+  size_t key_size_;
+  size_t entry_size_;
+  size_t bucket_max_size_;
 };
 
 }  // namespace wsdb
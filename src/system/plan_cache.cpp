@@ -0,0 +1,191 @@
+/*------------------------------------------------------------------------------
+ - Copyright (c) 2024. Websoft research group, Nanjing University.
+ -
+ - This program is free software: you can redistribute it and/or modify
+ - it under the terms of the GNU General Public License as published by
+ - the Free Software Foundation, either version 3 of the License, or
+ - (at your option) any later version.
+ -
+ - This program is distributed in the hope that it will be useful,
+ - but WITHOUT ANY WARRANTY; without even the implied warranty of
+ - MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ - GNU General Public License for more details.
+ -
+ - You should have received a copy of the GNU General Public License
+ - along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ -----------------------------------------------------------------------------*/
+
+#include "plan_cache.h"
+#include <cctype>
+#include "common/catalog_version.h"
+#include "optimizer/optimizer.h"
+#include "parser/parser.h"
+#include "plan/planner.h"
+#include "system/session.h"
+
+namespace wsdb {
+
+auto PlanCache::GetPlan(const std::string &sql, DatabaseHandle *db) -> std::shared_ptr<AbstractPlan>
+{
+  auto     text    = Normalize(sql);
+  auto     key     = MakeKey(text, db);
+  uint64_t version = 0;
+  if (auto plan = Lookup(key, version)) {
+    return plan;
+  }
+  // a DDL running meanwhile leaves the new plan out of date
+  version  = CatalogVersion::Get();
+  auto ast = Parser::Parse(text);
+  if (const auto prep = std::dynamic_pointer_cast<ast::Prepare>(ast)) {
+    return Prepare(prep, text, db, version);
+  }
+  if (std::dynamic_pointer_cast<ast::Execute>(ast) != nullptr) {
+    auto execute   = std::static_pointer_cast<ExecutePlan>(Planner::PlanAST(ast, db));
+    execute->stmt_ = GetPrepared(execute->name_, db);
+    return execute;
+  }
+  auto plan = Optimizer::Optimize(Planner::PlanAST(ast, db), db);
+  if (IsCacheable(ast)) {
+    misses_++;
+    Put(key, plan, version);
+  }
+  return plan;
+}
+
+auto PlanCache::Normalize(const std::string &sql) -> std::string
+{
+  std::string text;
+  text.reserve(sql.size());
+  bool space = false;
+  for (size_t i = 0; i < sql.size(); i++) {
+    if (sql[i] == '\'') {
+      // string literals are kept as they are, up to the closing quote
+      auto end = sql.find('\'', i + 1);
+      end      = end == std::string::npos ? sql.size() : end + 1;
+      if (space && !text.empty()) {
+        text += ' ';
+      }
+      text.append(sql, i, end - i);
+      space = false;
+      i     = end - 1;
+    } else if (sql.compare(i, 2, "--") == 0) {
+      auto end = sql.find('\n', i);
+      i        = end == std::string::npos ? sql.size() : end;
+      space    = true;
+    } else if (sql.compare(i, 2, "/*") == 0) {
+      auto end = sql.find("*/", i + 2);
+      i        = end == std::string::npos ? sql.size() : end + 1;
+      space    = true;
+    } else if (std::isspace(static_cast<unsigned char>(sql[i])) != 0) {
+      space = true;
+    } else {
+      if (space && !text.empty()) {
+        text += ' ';
+      }
+      text += sql[i];
+      space = false;
+    }
+  }
+  return text;
+}
+
+void PlanCache::Clear()
+{
+  std::scoped_lock lock(mutex_);
+  lru_.clear();
+  entries_.clear();
+  hits_   = 0;
+  misses_ = 0;
+}
+
+auto PlanCache::Lookup(const std::string &key, uint64_t &version) -> std::shared_ptr<AbstractPlan>
+{
+  std::scoped_lock lock(mutex_);
+  auto             it = entries_.find(key);
+  if (it == entries_.end()) {
+    return nullptr;
+  }
+  if (it->second.version_ != CatalogVersion::Get()) {
+    lru_.erase(it->second.lru_pos_);
+    entries_.erase(it);
+    return nullptr;
+  }
+  lru_.splice(lru_.begin(), lru_, it->second.lru_pos_);
+  hits_++;
+  version = it->second.version_;
+  return it->second.plan_;
+}
+
+void PlanCache::Put(const std::string &key, std::shared_ptr<AbstractPlan> plan, uint64_t version)
+{
+  std::scoped_lock lock(mutex_);
+  if (auto it = entries_.find(key); it != entries_.end()) {
+    it->second.plan_    = std::move(plan);
+    it->second.version_ = version;
+    lru_.splice(lru_.begin(), lru_, it->second.lru_pos_);
+    return;
+  }
+  lru_.push_front(key);
+  entries_.emplace(key, Entry{std::move(plan), version, lru_.begin()});
+  while (entries_.size() > capacity_) {
+    entries_.erase(lru_.back());
+    lru_.pop_back();
+  }
+}
+
+auto PlanCache::Prepare(const std::shared_ptr<ast::Prepare> &prep, const std::string &sql, DatabaseHandle *db,
+    uint64_t version) -> std::shared_ptr<PreparePlan>
+{
+  // the statement is cached under its own text, which keeps the ? parameters
+  auto prefix = fmt::format("PREPARE {} AS ", prep->name_);
+  WSDB_ASSERT(sql.starts_with(prefix), fmt::format("not normalized: {}", sql));
+  auto                         key        = MakeKey(sql.substr(prefix.size()), db);
+  uint64_t                     cached_ver = 0;
+  std::shared_ptr<PreparePlan> plan;
+  if (auto cached = Lookup(key, cached_ver)) {
+    plan           = std::make_shared<PreparePlan>(prep->name_, cached, prep->param_num_);
+    plan->version_ = cached_ver;
+  } else {
+    plan           = std::static_pointer_cast<PreparePlan>(Optimizer::Optimize(Planner::PlanAST(prep, db), db));
+    plan->version_ = version;
+    misses_++;
+    Put(key, plan->plan_, version);
+  }
+  plan->sql_ = sql;
+  return plan;
+}
+
+auto PlanCache::GetPrepared(const std::string &name, DatabaseHandle *db) -> PreparedStatementSptr
+{
+  auto stmt = Session::Current().GetPrepared(name);
+  if (stmt->version_ == CatalogVersion::Get()) {
+    return stmt;
+  }
+  // tables, indexes or statistics changed since it was prepared
+  auto version = CatalogVersion::Get();
+  auto prep    = std::dynamic_pointer_cast<ast::Prepare>(Parser::Parse(stmt->sql_));
+  WSDB_ASSERT(prep != nullptr, fmt::format("not a PREPARE: {}", stmt->sql_));
+  auto plan      = Prepare(prep, stmt->sql_, db, version);
+  stmt->plan_    = plan->plan_;
+  stmt->version_ = plan->version_;
+  return stmt;
+}
+
+auto PlanCache::MakeKey(const std::string &sql, DatabaseHandle *db) -> std::string
+{
+  // plans differ between databases and degrees of parallelism
+  return fmt::format("{}|{}|{}", db == nullptr ? "" : db->GetName(), Session::Current().GetDop(), sql);
+}
+
+auto PlanCache::IsCacheable(const std::shared_ptr<ast::TreeNode> &ast) -> bool
+{
+  // a multi-row insert is a bulk load, the same rows are hardly ever inserted twice and the text can be a whole packet
+  if (auto insert = std::dynamic_pointer_cast<ast::InsertStmt>(ast); insert != nullptr) {
+    return insert->rows.size() == 1;
+  }
+  return std::dynamic_pointer_cast<ast::SelectStmt>(ast) != nullptr ||
+         std::dynamic_pointer_cast<ast::UpdateStmt>(ast) != nullptr ||
+         std::dynamic_pointer_cast<ast::DeleteStmt>(ast) != nullptr;
+}
+
+}  // namespace wsdb
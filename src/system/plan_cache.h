@@ -0,0 +1,111 @@
+/*------------------------------------------------------------------------------
+ - Copyright (c) 2024. Websoft research group, Nanjing University.
+ -
+ - This program is free software: you can redistribute it and/or modify
+ - it under the terms of the GNU General Public License as published by
+ - the Free Software Foundation, either version 3 of the License, or
+ - (at your option) any later version.
+ -
+ - This program is distributed in the hope that it will be useful,
+ - but WITHOUT ANY WARRANTY; without even the implied warranty of
+ - MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ - GNU General Public License for more details.
+ -
+ - You should have received a copy of the GNU General Public License
+ - along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ -----------------------------------------------------------------------------*/
+
+/**
+ * @brief Optimized plans shared by all sessions, keyed by the normalized text of the statement, the database it runs
+ * on and the degree of parallelism it is planned for. A statement seen before skips parsing, planning and optimizing,
+ * which take longer than running a point query or a single row insert. A plan optimized before the last DDL or ANALYZE
+ * (see CatalogVersion) is optimized again.
+ *
+ * PREPARE keeps the plan of its statement in the session, and the statement is looked up in the cache by its text with
+ * the ? parameters in it, so sessions preparing the same statement share one plan. EXECUTE runs the plan with its
+ * arguments bound while the plan is translated to executors.
+ *
+ */
+
+#ifndef WSDB_PLAN_CACHE_H
+#define WSDB_PLAN_CACHE_H
+
+#include <atomic>
+#include <list>
+#include <mutex>
+#include <unordered_map>
+#include "parser/ast.h"
+#include "plan/plan.h"
+#include "system/handle/database_handle.h"
+
+namespace wsdb {
+
+class PlanCache
+{
+public:
+  explicit PlanCache(size_t capacity = PLAN_CACHE_SIZE) : capacity_(capacity) {}
+
+  DISABLE_COPY_MOVE_AND_ASSIGN(PlanCache)
+
+  static auto GetInstance() -> PlanCache &
+  {
+    static PlanCache cache;
+    return cache;
+  }
+
+  /**
+   * the optimized plan of sql, from the cache if possible. Plans of queries and DML are cached, EXECUTE gets the
+   * prepared statement of the session, prepared again if it is out of date
+   * @return nullptr for an empty statement
+   */
+  auto GetPlan(const std::string &sql, DatabaseHandle *db) -> std::shared_ptr<AbstractPlan>;
+
+  /// sql with comments dropped and every run of white space outside of string literals turned into one space
+  static auto Normalize(const std::string &sql) -> std::string;
+
+  [[nodiscard]] auto GetHitNum() const -> size_t { return hits_; }
+
+  [[nodiscard]] auto GetMissNum() const -> size_t { return misses_; }
+
+  void Clear();
+
+private:
+  struct Entry
+  {
+    std::shared_ptr<AbstractPlan>    plan_;
+    uint64_t                         version_;  // catalog version plan_ was optimized under
+    std::list<std::string>::iterator lru_pos_;
+  };
+
+  /// plan and its version of an up to date entry, nullptr on a miss
+  auto Lookup(const std::string &key, uint64_t &version) -> std::shared_ptr<AbstractPlan>;
+
+  void Put(const std::string &key, std::shared_ptr<AbstractPlan> plan, uint64_t version);
+
+  /**
+   * plan of a PREPARE, whose statement is optimized unless another session prepared the same one
+   * @param sql normalized text of the PREPARE
+   * @param version catalog version before sql was parsed
+   */
+  auto Prepare(const std::shared_ptr<ast::Prepare> &prep, const std::string &sql, DatabaseHandle *db,
+      uint64_t version) -> std::shared_ptr<PreparePlan>;
+
+  /// the statement prepared by name in the current session, prepared again if tables, indexes or statistics changed
+  auto GetPrepared(const std::string &name, DatabaseHandle *db) -> PreparedStatementSptr;
+
+  static auto MakeKey(const std::string &sql, DatabaseHandle *db) -> std::string;
+
+  static auto IsCacheable(const std::shared_ptr<ast::TreeNode> &ast) -> bool;
+
+private:
+  size_t                                 capacity_;
+  std::mutex                             mutex_;
+  std::list<std::string>                 lru_;  // keys, the most recently used first
+  std::unordered_map<std::string, Entry> entries_;
+  std::atomic<size_t>                    hits_{0};
+  std::atomic<size_t>                    misses_{0};
+};
+
+}  // namespace wsdb
+
+#endif  // WSDB_PLAN_CACHE_H
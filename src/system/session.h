@@ -0,0 +1,122 @@
+/*------------------------------------------------------------------------------
+ - Copyright (c) 2024. Websoft research group, Nanjing University.
+ -
+ - This program is free software: you can redistribute it and/or modify
+ - it under the terms of the GNU General Public License as published by
+ - the Free Software Foundation, either version 3 of the License, or
+ - (at your option) any later version.
+ -
+ - This program is distributed in the hope that it will be useful,
+ - but WITHOUT ANY WARRANTY; without even the implied warranty of
+ - MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ - GNU General Public License for more details.
+ -
+ - You should have received a copy of the GNU General Public License
+ - along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ -----------------------------------------------------------------------------*/
+
+/**
+ * @brief Per connection settings, changed by SET statements, and the statements prepared by PREPARE. A session is bound
+ * to the thread serving the connection, planner, optimizer and executors read it through Session::Current()
+ *
+ */
+
+#ifndef WSDB_SESSION_H
+#define WSDB_SESSION_H
+
+#include <string>
+#include <unordered_map>
+#include "common/config.h"
+#include "common/value.h"
+
+namespace wsdb {
+
+struct PreparedStatement;
+
+class Session
+{
+public:
+  Session() = default;
+
+  DISABLE_COPY_MOVE_AND_ASSIGN(Session)
+
+  /// the session served by the calling thread, every thread owns a default session until another one is bound
+  static auto Current() -> Session & { return *CurrentRef(); }
+
+  /// serve session on the calling thread, nullptr restores the thread's own session
+  static void Bind(Session *session) { CurrentRef() = session == nullptr ? &Own() : session; }
+
+  void SetVariable(const std::string &name, const ValueSptr &value)
+  {
+    if (name == "dop") {
+      dop_ = static_cast<size_t>(GetNonNegativeInt(name, value));
+    } else {
+      WSDB_THROW(WSDB_UNSUPPORTED_OP, fmt::format("unknown variable: {}", name));
+    }
+  }
+
+  [[nodiscard]] auto GetVariable(const std::string &name) const -> ValueSptr
+  {
+    if (name == "dop") {
+      return ValueFactory::CreateIntValue(static_cast<int>(dop_));
+    }
+    WSDB_THROW(WSDB_UNSUPPORTED_OP, fmt::format("unknown variable: {}", name));
+  }
+
+  /// degree of parallelism of parallel operators, 0 means the size of the worker pool
+  [[nodiscard]] auto GetDop() const -> size_t { return dop_; }
+
+  void Prepare(const std::string &name, std::shared_ptr<PreparedStatement> stmt)
+  {
+    if (!prepared_.emplace(name, std::move(stmt)).second) {
+      WSDB_THROW(WSDB_STMT_EXIST, name);
+    }
+  }
+
+  [[nodiscard]] auto GetPrepared(const std::string &name) const -> std::shared_ptr<PreparedStatement>
+  {
+    auto it = prepared_.find(name);
+    if (it == prepared_.end()) {
+      WSDB_THROW(WSDB_STMT_MISS, name);
+    }
+    return it->second;
+  }
+
+  void Deallocate(const std::string &name)
+  {
+    if (prepared_.erase(name) == 0) {
+      WSDB_THROW(WSDB_STMT_MISS, name);
+    }
+  }
+
+private:
+  static auto Own() -> Session &
+  {
+    thread_local Session own;
+    return own;
+  }
+
+  static auto CurrentRef() -> Session *&
+  {
+    thread_local Session *current = &Own();
+    return current;
+  }
+
+  static auto GetNonNegativeInt(const std::string &name, const ValueSptr &value) -> int
+  {
+    auto v = std::dynamic_pointer_cast<IntValue>(value);
+    if (v == nullptr || v->IsNull() || v->Get() < 0) {
+      WSDB_THROW(WSDB_TYPE_MISSMATCH, fmt::format("{} expects a non-negative integer", name));
+    }
+    return v->Get();
+  }
+
+private:
+  size_t dop_{DEFAULT_DOP};
+  // statements prepared by PREPARE, by name
+  std::unordered_map<std::string, std::shared_ptr<PreparedStatement>> prepared_;
+};
+
+}  // namespace wsdb
+
+#endif  // WSDB_SESSION_H
@@ -0,0 +1,135 @@
+/*------------------------------------------------------------------------------
+ - Copyright (c) 2024. Websoft research group, Nanjing University.
+ -
+ - This program is free software: you can redistribute it and/or modify
+ - it under the terms of the GNU General Public License as published by
+ - the Free Software Foundation, either version 3 of the License, or
+ - (at your option) any later version.
+ -
+ - This program is distributed in the hope that it will be useful,
+ - but WITHOUT ANY WARRANTY; without even the implied warranty of
+ - MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ - GNU General Public License for more details.
+ -
+ - You should have received a copy of the GNU General Public License
+ - along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ -----------------------------------------------------------------------------*/
+
+/**
+ * @brief A blocking client connection and a timer shared by the benchmarks that talk to a running server.
+ */
+
+#ifndef WSDB_BENCH_CLIENT_H
+#define WSDB_BENCH_CLIENT_H
+
+#include <sys/socket.h>
+#include <netinet/in.h>
+#include <unistd.h>
+#include <chrono>
+#include <cstring>
+#include <iostream>
+#include <string>
+#include <vector>
+#include "../common/net/net.h"
+#include "../common/error.h"
+
+class Connection
+{
+public:
+  Connection()
+  {
+    fd_ = socket(AF_INET, SOCK_STREAM, 0);
+    sockaddr_in addr{};
+    addr.sin_family      = AF_INET;
+    addr.sin_port        = htons(net::SERVER_PORT);
+    addr.sin_addr.s_addr = INADDR_ANY;
+    if (fd_ < 0 || connect(fd_, reinterpret_cast<sockaddr *>(&addr), sizeof(addr)) < 0) {
+      std::cerr << "cannot connect to the server on port " << net::SERVER_PORT << std::endl;
+      exit(1);
+    }
+  }
+
+  ~Connection() { close(fd_); }
+
+  /// send sql and read the whole response, false if the server reports an error. result records are decoded the
+  /// way the client does and counted in Rows(), Packets() and Bytes()
+  auto Query(const std::string &sql) -> bool
+  {
+    if (sql.size() > net::NET_BUFFER_SIZE) {
+      std::cerr << "statement of " << sql.size() << " bytes does not fit in a packet" << std::endl;
+      exit(1);
+    }
+    pkg_.type_ = net::NET_PKG_QUERY;
+    pkg_.len_  = sql.size();
+    memcpy(pkg_.buf_, sql.c_str(), sql.size());
+    if (net::WriteNetPkg(fd_, pkg_) < 0) {
+      exit(1);
+    }
+    rows_    = 0;
+    packets_ = 0;
+    bytes_   = 0;
+    while (true) {
+      if (net::ReadNetPkg(fd_, pkg_) < 0) {
+        exit(1);
+      }
+      packets_++;
+      bytes_ += pkg_.len_;
+      if (pkg_.type_ == net::NET_PKG_REC_HEADER) {
+        if (!net::DecodeRecHeader(pkg_, columns_)) {
+          std::cerr << "malformed result header" << std::endl;
+          exit(1);
+        }
+      } else if (pkg_.type_ == net::NET_PKG_REC_BODY) {
+        records_.clear();
+        if (!net::DecodeRecBody(pkg_, columns_, records_)) {
+          std::cerr << "malformed result records" << std::endl;
+          exit(1);
+        }
+        rows_ += records_.size();
+      } else if (pkg_.type_ == net::NET_PKG_ERROR) {
+        error_ = std::string(pkg_.buf_, pkg_.len_);
+        return false;
+      }
+      if (pkg_.type_ == net::NET_PKG_OK || pkg_.type_ == net::NET_PKG_REC_END) {
+        return true;
+      }
+    }
+  }
+
+  /// like Query, but the benchmark cannot go on if it fails
+  void MustQuery(const std::string &sql)
+  {
+    if (!Query(sql)) {
+      std::cerr << sql << "\n" << error_ << std::endl;
+      exit(1);
+    }
+  }
+
+  [[nodiscard]] auto Rows() const -> size_t { return rows_; }
+  [[nodiscard]] auto Packets() const -> size_t { return packets_; }
+  [[nodiscard]] auto Bytes() const -> size_t { return bytes_; }
+
+private:
+  int                                   fd_;
+  net::NetPkg                           pkg_;
+  std::string                           error_;
+  std::vector<net::NetColumn>           columns_;
+  std::vector<std::vector<std::string>> records_;
+  size_t                                rows_{0};
+  size_t                                packets_{0};
+  size_t                                bytes_{0};
+};
+
+/// calls func(i) for i in [0, ops) and returns the operations per second
+template <typename Func>
+inline auto Measure(size_t ops, Func &&func) -> double
+{
+  auto start = std::chrono::steady_clock::now();
+  for (size_t i = 0; i < ops; i++) {
+    func(i);
+  }
+  auto end = std::chrono::steady_clock::now();
+  return static_cast<double>(ops) / std::chrono::duration<double>(end - start).count();
+}
+
+#endif  // WSDB_BENCH_CLIENT_H
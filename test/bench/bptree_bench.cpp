@@ -0,0 +1,232 @@
+/*------------------------------------------------------------------------------
+ - Copyright (c) 2024. Websoft research group, Nanjing University.
+ -
+ - This program is free software: you can redistribute it and/or modify
+ - it under the terms of the GNU General Public License as published by
+ - the Free Software Foundation, either version 3 of the License, or
+ - (at your option) any later version.
+ -
+ - This program is distributed in the hope that it will be useful,
+ - but WITHOUT ANY WARRANTY; without even the implied warranty of
+ - MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ - GNU General Public License for more details.
+ -
+ - You should have received a copy of the GNU General Public License
+ - along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ -----------------------------------------------------------------------------*/
+
+/**
+ * @brief Benchmark of point lookups: a B+ tree index built by bulk loading and an extendible hash index built by
+ * inserts against a sequential scan with a filter over a heap file of the same rows, all going through the buffer pool.
+ * Then a mixed workload of lookups and inserts (one in ten) runs on the B+ tree with 1, 2, 4, ... threads.
+ *
+ * usage: bptree_bench [rows] [lookups] [threads] [ops], default 1M rows, 1000 lookups, up to BUFFER_POOL_SIZE / 2
+ * threads since an inserting thread pins up to two pages, and 200K operations per thread
+ */
+
+#include <chrono>
+#include <cstring>
+#include <filesystem>
+#include <iostream>
+#include <random>
+#include <thread>
+#include "storage/index/index_bp_tree.h"
+#include "storage/index/index_hash.h"
+#include "../test_util.h"
+
+using namespace wsdb;
+
+// heap rows are a 4 byte key followed by the payload
+constexpr size_t ROW_SIZE  = 64;
+constexpr size_t PAGE_ROWS = (PAGE_SIZE - PAGE_HEADER_SIZE) / ROW_SIZE;
+
+static auto OpenFile(DiskManager *disk_manager, const std::string &name) -> file_id_t
+{
+  if (std::filesystem::exists(name)) {
+    std::filesystem::remove(name);
+  }
+  DiskManager::CreateFile(name);
+  return disk_manager->OpenFile(name);
+}
+
+template <typename Func>
+static auto Measure(Func &&func) -> double
+{
+  auto start = std::chrono::steady_clock::now();
+  func();
+  auto end = std::chrono::steady_clock::now();
+  return std::chrono::duration<double>(end - start).count();
+}
+
+/// scan every page of the heap and collect the rids of the rows whose key is key
+static auto ScanFilter(BufferPoolManager *bpm, file_id_t fid, size_t page_num, int key) -> std::vector<RID>
+{
+  std::vector<RID> rids;
+  for (size_t pid = 0; pid < page_num; pid++) {
+    auto page = bpm->FetchPage(fid, static_cast<page_id_t>(pid));
+    auto data = page->GetData() + PAGE_HEADER_SIZE;
+    for (size_t slot = 0; slot < PAGE_ROWS; slot++) {
+      int row_key;
+      memcpy(&row_key, data + slot * ROW_SIZE, sizeof(int));
+      if (row_key == key) {
+        rids.push_back({static_cast<page_id_t>(pid), static_cast<slot_id_t>(slot)});
+      }
+    }
+    bpm->UnpinPage(fid, static_cast<page_id_t>(pid), false);
+  }
+  return rids;
+}
+
+int main(int argc, char *argv[])
+{
+  size_t rows    = argc > 1 ? std::stoull(argv[1]) : 1'000'000;
+  size_t lookups = argc > 2 ? std::stoull(argv[2]) : 1000;
+  size_t threads = argc > 3 ? std::stoull(argv[3]) : std::max<size_t>(BUFFER_POOL_SIZE / 2, 1);
+  size_t ops     = argc > 4 ? std::stoull(argv[4]) : 200'000;
+
+  DiskManager       disk_manager;
+  BufferPoolManager bpm(&disk_manager, nullptr);
+  std::string       heap_name = "bptree_bench" + TAB_SUFFIX;
+  std::string       idx_name  = "bptree_bench" + IDX_SUFFIX;
+  std::string       hash_name = "bptree_bench_hash" + IDX_SUFFIX;
+  auto              heap_fid  = OpenFile(&disk_manager, heap_name);
+  auto              idx_fid   = OpenFile(&disk_manager, idx_name);
+  auto              hash_fid  = OpenFile(&disk_manager, hash_name);
+
+  RTField key_field;
+  key_field.field_.field_name_ = "k";
+  key_field.field_.field_type_ = TYPE_INT;
+  key_field.field_.field_size_ = sizeof(int);
+  RecordSchema key_schema({key_field});
+
+  // unique keys in random order
+  std::vector<int> keys(rows);
+  for (size_t i = 0; i < rows; i++) {
+    keys[i] = static_cast<int>(i);
+  }
+  std::mt19937 gen(TEST_SEED);
+  std::shuffle(keys.begin(), keys.end(), gen);
+
+  // heap file
+  size_t page_num   = (rows + PAGE_ROWS - 1) / PAGE_ROWS;
+  double heap_build = Measure([&]() {
+    for (size_t pid = 0; pid < page_num; pid++) {
+      auto page = bpm.FetchPage(heap_fid, static_cast<page_id_t>(pid));
+      auto data = page->GetData() + PAGE_HEADER_SIZE;
+      for (size_t slot = 0; slot < PAGE_ROWS && pid * PAGE_ROWS + slot < rows; slot++) {
+        memcpy(data + slot * ROW_SIZE, &keys[pid * PAGE_ROWS + slot], sizeof(int));
+      }
+      bpm.UnpinPage(heap_fid, static_cast<page_id_t>(pid), true);
+    }
+  });
+
+  // index, bulk loaded from the heap rows
+  BPTreeIndex tree(&disk_manager, &bpm, idx_fid, 0, &key_schema);
+  double      idx_build = Measure([&]() {
+    std::vector<std::pair<RecordUptr, RID>> entries;
+    entries.reserve(rows);
+    for (size_t i = 0; i < rows; i++) {
+      auto key = std::vector<ValueSptr>{ValueFactory::CreateIntValue(keys[i])};
+      entries.emplace_back(std::make_unique<Record>(&key_schema, key, INVALID_RID),
+          RID{static_cast<page_id_t>(i / PAGE_ROWS), static_cast<slot_id_t>(i % PAGE_ROWS)});
+    }
+    tree.BulkLoad(entries);
+  });
+
+  // hash index, filled by inserts
+  HashIndex hash(&disk_manager, &bpm, hash_fid, 1, &key_schema);
+  double    hash_build = Measure([&]() {
+    for (size_t i = 0; i < rows; i++) {
+      auto key = Record(&key_schema, std::vector<ValueSptr>{ValueFactory::CreateIntValue(keys[i])}, INVALID_RID);
+      hash.Insert(key, RID{static_cast<page_id_t>(i / PAGE_ROWS), static_cast<slot_id_t>(i % PAGE_ROWS)});
+    }
+  });
+
+  std::uniform_int_distribution<int> dist(0, static_cast<int>(rows) - 1);
+  std::vector<int>                   probes(lookups);
+  for (auto &probe : probes) {
+    probe = dist(gen);
+  }
+  size_t found_idx  = 0;
+  size_t found_hash = 0;
+  size_t found_scan = 0;
+  double idx_time   = Measure([&]() {
+    for (auto probe : probes) {
+      auto key = Record(&key_schema, std::vector<ValueSptr>{ValueFactory::CreateIntValue(probe)}, INVALID_RID);
+      found_idx += tree.Search(key).size();
+    }
+  });
+  double hash_time = Measure([&]() {
+    for (auto probe : probes) {
+      auto key = Record(&key_schema, std::vector<ValueSptr>{ValueFactory::CreateIntValue(probe)}, INVALID_RID);
+      found_hash += hash.Search(key).size();
+    }
+  });
+  // the scan is orders of magnitude slower, probe a subset of the keys
+  size_t scan_lookups = std::min<size_t>(lookups, 20);
+  double scan_time    = Measure([&]() {
+    for (size_t i = 0; i < scan_lookups; i++) {
+      found_scan += ScanFilter(&bpm, heap_fid, page_num, probes[i]).size();
+    }
+  });
+
+  std::cout << "rows: " << rows << ", heap pages: " << page_num << ", tree height: " << tree.GetHeight()
+            << ", leaf capacity: " << tree.GetLeafMaxSize() << std::endl;
+  std::cout << "hash global depth: " << hash.GetGlobalDepth() << ", buckets: " << hash.GetBucketNum()
+            << ", bucket capacity: " << hash.GetBucketMaxSize() << std::endl;
+  std::cout << "build heap: " << heap_build << "s, bulk load index: " << idx_build << "s, insert hash: " << hash_build
+            << "s" << std::endl;
+  double idx_us  = idx_time / static_cast<double>(lookups) * 1e6;
+  double hash_us = hash_time / static_cast<double>(lookups) * 1e6;
+  double scan_us = scan_time / static_cast<double>(scan_lookups) * 1e6;
+  std::cout << "index lookup: " << idx_us << "us/lookup (" << found_idx << " found in " << lookups << ")" << std::endl;
+  std::cout << "hash lookup: " << hash_us << "us/lookup (" << found_hash << " found in " << lookups << ")"
+            << std::endl;
+  std::cout << "seqscan + filter: " << scan_us << "us/lookup (" << found_scan << " found in " << scan_lookups << ")"
+            << std::endl;
+  std::cout << "speedup: " << scan_us / idx_us << "x" << std::endl;
+
+  // mixed lookups and inserts of new keys
+  std::atomic<int> next_key{static_cast<int>(rows)};
+  double           base = 0;
+  for (size_t thread_num = 1; thread_num <= threads; thread_num *= 2) {
+    double time = Measure([&]() {
+      std::vector<std::thread> workers;
+      for (size_t t = 0; t < thread_num; t++) {
+        workers.emplace_back([&, t]() {
+          std::mt19937                       worker_gen(t);
+          std::uniform_int_distribution<int> worker_dist(0, static_cast<int>(rows) - 1);
+          for (size_t i = 0; i < ops; i++) {
+            if (i % 10 == 0) {
+              int  k   = next_key++;
+              auto key = Record(&key_schema, std::vector<ValueSptr>{ValueFactory::CreateIntValue(k)}, INVALID_RID);
+              tree.Insert(key, RID{static_cast<page_id_t>(k / PAGE_ROWS), static_cast<slot_id_t>(k % PAGE_ROWS)});
+            } else {
+              int  k   = worker_dist(worker_gen);
+              auto key = Record(&key_schema, std::vector<ValueSptr>{ValueFactory::CreateIntValue(k)}, INVALID_RID);
+              tree.Search(key);
+            }
+          }
+        });
+      }
+      for (auto &worker : workers) {
+        worker.join();
+      }
+    });
+    double throughput = static_cast<double>(thread_num * ops) / time / 1e6;
+    base              = thread_num == 1 ? throughput : base;
+    std::cout << "mixed 90% lookup / 10% insert, " << thread_num << " threads: " << throughput << " Mops/s ("
+              << throughput / base << "x)" << std::endl;
+  }
+
+  bpm.DeleteAllPages(heap_fid);
+  bpm.DeleteAllPages(idx_fid);
+  bpm.DeleteAllPages(hash_fid);
+  disk_manager.CloseFile(heap_fid);
+  disk_manager.CloseFile(idx_fid);
+  disk_manager.CloseFile(hash_fid);
+  DiskManager::DestroyFile(heap_name);
+  DiskManager::DestroyFile(idx_name);
+  DiskManager::DestroyFile(hash_name);
+  return 0;
+}
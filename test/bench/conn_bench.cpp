@@ -0,0 +1,189 @@
+/*------------------------------------------------------------------------------
+ - Copyright (c) 2024. Websoft research group, Nanjing University.
+ -
+ - This program is free software: you can redistribute it and/or modify
+ - it under the terms of the GNU General Public License as published by
+ - the Free Software Foundation, either version 3 of the License, or
+ - (at your option) any later version.
+ -
+ - This program is distributed in the hope that it will be useful,
+ - but WITHOUT ANY WARRANTY; without even the implied warranty of
+ - MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ - GNU General Public License for more details.
+ -
+ - You should have received a copy of the GNU General Public License
+ - along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ -----------------------------------------------------------------------------*/
+
+/**
+ * @brief Load generator for the server: many connections on localhost, each sending a point query and the next one as
+ * soon as the answer arrives, driven by one thread over epoll. Reports statements per second and their latencies.
+ * Idle connections opened besides the active ones show that connections waiting for their clients cost the server no
+ * worker.
+ *
+ * Start the server first, the benchmark creates the database if needed and replaces table conn_bench in it.
+ *
+ * usage: conn_bench [database] [connections] [seconds] [idle connections], default database connbench, 4000
+ * connections for 10 seconds and no idle ones
+ */
+
+#include <sys/epoll.h>
+#include <sys/resource.h>
+#include <fcntl.h>
+#include <algorithm>
+#include <cerrno>
+#include "bench_client.h"
+
+struct LoadConn
+{
+  int         fd_{-1};
+  std::string wbuf_;  // the request not sent yet
+  std::string rbuf_;  // the responses not parsed yet
+  size_t      queries_{0};
+
+  std::chrono::steady_clock::time_point start_;
+};
+
+static auto Connect() -> int
+{
+  int         fd = socket(AF_INET, SOCK_STREAM, 0);
+  sockaddr_in addr{};
+  addr.sin_family      = AF_INET;
+  addr.sin_port        = htons(net::SERVER_PORT);
+  addr.sin_addr.s_addr = INADDR_ANY;
+  if (fd < 0 || connect(fd, reinterpret_cast<sockaddr *>(&addr), sizeof(addr)) < 0) {
+    std::cerr << "cannot open connection: " << strerror(errno) << std::endl;
+    exit(1);
+  }
+  fcntl(fd, F_SETFL, fcntl(fd, F_GETFL) | O_NONBLOCK);
+  return fd;
+}
+
+static void Request(LoadConn &conn, const std::string &sql)
+{
+  net::NetPkg pkg;
+  pkg.type_ = net::NET_PKG_QUERY;
+  pkg.len_  = sql.size();
+  memcpy(pkg.buf_, sql.data(), sql.size());
+  net::AppendNetPkg(pkg, conn.wbuf_);
+  conn.start_ = std::chrono::steady_clock::now();
+}
+
+/// send what the socket takes, false if the server closed the connection
+static auto WriteOut(LoadConn &conn) -> bool
+{
+  while (!conn.wbuf_.empty()) {
+    auto n = send(conn.fd_, conn.wbuf_.data(), conn.wbuf_.size(), MSG_NOSIGNAL);
+    if (n < 0) {
+      return errno == EAGAIN;
+    }
+    conn.wbuf_.erase(0, n);
+  }
+  return true;
+}
+
+int main(int argc, char *argv[])
+{
+  std::string db_name  = argc > 1 ? argv[1] : "connbench";
+  size_t      conn_num = argc > 2 ? std::stoul(argv[2]) : 4000;
+  double      seconds  = argc > 3 ? std::stod(argv[3]) : 10;
+  size_t      idle_num = argc > 4 ? std::stoul(argv[4]) : 0;
+
+  rlimit limit{};
+  getrlimit(RLIMIT_NOFILE, &limit);
+  limit.rlim_cur = std::min<rlim_t>(limit.rlim_max, conn_num + idle_num + 64);
+  setrlimit(RLIMIT_NOFILE, &limit);
+
+  {
+    Connection conn;
+    conn.Query(fmt::format("CREATE DATABASE {};", db_name));
+    conn.MustQuery(fmt::format("OPEN DATABASE {};", db_name));
+    conn.Query("DROP TABLE conn_bench;");
+    conn.MustQuery("CREATE TABLE conn_bench (id INT, name CHAR(16));");
+    std::string sql = "INSERT INTO conn_bench VALUES ";
+    for (int i = 0; i < 1000; i++) {
+      sql += fmt::format("({}, 'name{}'),", i, i);
+    }
+    sql.back() = ';';
+    conn.MustQuery(sql);
+    conn.MustQuery("CREATE INDEX conn_bench (id);");
+  }
+
+  std::vector<int> idle(idle_num);
+  for (auto &fd : idle) {
+    fd = Connect();
+  }
+  int                   epoll_fd = epoll_create1(0);
+  std::vector<LoadConn> conns(conn_num);
+  for (size_t i = 0; i < conn_num; i++) {
+    conns[i].fd_ = Connect();
+    epoll_event ev{};
+    ev.events   = EPOLLIN | EPOLLOUT | EPOLLET;
+    ev.data.u64 = i;
+    epoll_ctl(epoll_fd, EPOLL_CTL_ADD, conns[i].fd_, &ev);
+    Request(conns[i], fmt::format("OPEN DATABASE {};", db_name));
+  }
+
+  std::vector<double>      latencies;
+  std::vector<epoll_event> events(1024);
+  std::vector<char>        buf(net::NET_BUFFER_SIZE);
+  size_t                   errors = 0;
+  auto                     start  = std::chrono::steady_clock::now();
+  auto                     end    = start + std::chrono::duration<double>(seconds);
+  while (std::chrono::steady_clock::now() < end) {
+    int n = epoll_wait(epoll_fd, events.data(), static_cast<int>(events.size()), 100);
+    for (int i = 0; i < n; i++) {
+      auto &conn = conns[events[i].data.u64];
+      while (true) {
+        auto len = recv(conn.fd_, buf.data(), buf.size(), 0);
+        if (len <= 0) {
+          if (len == 0 || errno != EAGAIN) {
+            std::cerr << "server closed a connection" << std::endl;
+            return 1;
+          }
+          break;
+        }
+        conn.rbuf_.append(buf.data(), len);
+      }
+      net::NetPkgType  type;
+      std::string_view body;
+      ssize_t          len;
+      while ((len = net::ParseNetPkg(conn.rbuf_.data(), conn.rbuf_.size(), type, body)) > 0) {
+        conn.rbuf_.erase(0, len);
+        if (type != net::NET_PKG_OK && type != net::NET_PKG_REC_END && type != net::NET_PKG_ERROR) {
+          continue;
+        }
+        errors += type == net::NET_PKG_ERROR ? 1 : 0;
+        auto now = std::chrono::steady_clock::now();
+        if (conn.queries_++ > 0) {
+          latencies.push_back(std::chrono::duration<double, std::micro>(now - conn.start_).count());
+        }
+        Request(conn, fmt::format("SELECT * FROM conn_bench WHERE id = {};", conn.queries_ % 1000));
+      }
+      if (!WriteOut(conn)) {
+        std::cerr << "server closed a connection" << std::endl;
+        return 1;
+      }
+    }
+  }
+  auto secs = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+  for (auto &conn : conns) {
+    close(conn.fd_);
+  }
+  for (auto fd : idle) {
+    close(fd);
+  }
+  close(epoll_fd);
+
+  std::sort(latencies.begin(), latencies.end());
+  auto percentile = [&latencies](double p) {
+    return latencies.empty() ? 0 : latencies[static_cast<size_t>(p * static_cast<double>(latencies.size() - 1))];
+  };
+  std::cout << fmt::format("{} active and {} idle connections, {:.1f}s", conn_num, idle_num, secs) << std::endl;
+  std::cout << fmt::format("{:<20}{:>12.0f}", "queries/s", static_cast<double>(latencies.size()) / secs) << std::endl;
+  std::cout << fmt::format("{:<20}{:>12}", "errors", errors) << std::endl;
+  std::cout << fmt::format("{:<20}{:>12.0f}", "p50 latency (us)", percentile(0.5)) << std::endl;
+  std::cout << fmt::format("{:<20}{:>12.0f}", "p99 latency (us)", percentile(0.99)) << std::endl;
+  std::cout << fmt::format("{:<20}{:>12.0f}", "max latency (us)", percentile(1)) << std::endl;
+  return 0;
+}
@@ -0,0 +1,99 @@
+/*------------------------------------------------------------------------------
+ - Copyright (c) 2024. Websoft research group, Nanjing University.
+ -
+ - This program is free software: you can redistribute it and/or modify
+ - it under the terms of the GNU General Public License as published by
+ - the Free Software Foundation, either version 3 of the License, or
+ - (at your option) any later version.
+ -
+ - This program is distributed in the hope that it will be useful,
+ - but WITHOUT ANY WARRANTY; without even the implied warranty of
+ - MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ - GNU General Public License for more details.
+ -
+ - You should have received a copy of the GNU General Public License
+ - along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ -----------------------------------------------------------------------------*/
+
+/**
+ * @brief Rows per second loaded into an indexed table by a running server over one connection: one INSERT per row,
+ * EXECUTE of a prepared insert per row, and multi-row INSERTs packed with as many rows as fit in a packet. The keys
+ * come in random order, and every mode loads a fresh copy of the table.
+ *
+ * Start the server first, the benchmark creates the database if needed and replaces table insert_bench in it.
+ *
+ * usage: insert_bench [database] [rows], default database insbench and 50K rows
+ */
+
+#include <algorithm>
+#include <numeric>
+#include <random>
+#include <vector>
+#include "bench_client.h"
+#include "../test_util.h"
+
+static void ResetTable(Connection &conn)
+{
+  conn.Query("DROP TABLE insert_bench;");
+  conn.MustQuery("CREATE TABLE insert_bench (id INT, name CHAR(16), score FLOAT);");
+  conn.MustQuery("CREATE INDEX insert_bench (id);");
+}
+
+static auto Row(int key) -> std::string { return fmt::format("({}, 'name{}', {}.5)", key, key, key % 100); }
+
+int main(int argc, char *argv[])
+{
+  std::string db_name = argc > 1 ? argv[1] : "insbench";
+  size_t      rows    = argc > 2 ? std::stoul(argv[2]) : 50000;
+
+  std::vector<int> keys(rows);
+  std::iota(keys.begin(), keys.end(), 0);
+  std::shuffle(keys.begin(), keys.end(), std::mt19937(wsdb::TEST_SEED));
+
+  Connection conn;
+  conn.Query(fmt::format("CREATE DATABASE {};", db_name));
+  conn.MustQuery(fmt::format("OPEN DATABASE {};", db_name));
+
+  ResetTable(conn);
+  auto single = Measure(rows, [&](size_t i) {
+    conn.MustQuery("INSERT INTO insert_bench VALUES " + Row(keys[i]) + ";");
+  });
+
+  ResetTable(conn);
+  conn.MustQuery("PREPARE bench_insert AS INSERT INTO insert_bench VALUES (?, ?, ?);");
+  auto prepared = Measure(rows, [&](size_t i) {
+    conn.MustQuery(fmt::format("EXECUTE bench_insert ({}, 'name{}', {}.5);", keys[i], keys[i], keys[i] % 100));
+  });
+  conn.MustQuery("DEALLOCATE bench_insert;");
+
+  // pack the statements up front, so that only the server side is timed
+  std::vector<std::string> batches;
+  std::string              sql;
+  for (auto key : keys) {
+    auto row = Row(key);
+    if (!sql.empty() && sql.size() + row.size() + 2 > net::NET_BUFFER_SIZE) {
+      sql.back() = ';';
+      batches.push_back(std::move(sql));
+      sql.clear();
+    }
+    if (sql.empty()) {
+      sql = "INSERT INTO insert_bench VALUES ";
+    }
+    sql += row + ",";
+  }
+  if (!sql.empty()) {
+    sql.back() = ';';
+    batches.push_back(std::move(sql));
+  }
+  ResetTable(conn);
+  auto batched = Measure(batches.size(), [&](size_t i) { conn.MustQuery(batches[i]); });
+  batched *= static_cast<double>(rows) / static_cast<double>(batches.size());
+
+  std::cout << fmt::format("{:<40}{:>12}", fmt::format("load {} rows", rows), "rows/s") << std::endl;
+  std::cout << fmt::format("{:<40}{:>12.0f}", "INSERT per row", single) << std::endl;
+  std::cout << fmt::format("{:<40}{:>12.0f}", "EXECUTE of a prepared insert per row", prepared) << std::endl;
+  std::cout << fmt::format(
+                   "{:<40}{:>12.0f}", fmt::format("multi-row INSERT, {} rows each", rows / batches.size()), batched)
+            << std::endl;
+  return 0;
+}
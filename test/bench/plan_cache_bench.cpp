@@ -0,0 +1,77 @@
+/*------------------------------------------------------------------------------
+ - Copyright (c) 2024. Websoft research group, Nanjing University.
+ -
+ - This program is free software: you can redistribute it and/or modify
+ - it under the terms of the GNU General Public License as published by
+ - the Free Software Foundation, either version 3 of the License, or
+ - (at your option) any later version.
+ -
+ - This program is distributed in the hope that it will be useful,
+ - but WITHOUT ANY WARRANTY; without even the implied warranty of
+ - MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ - GNU General Public License for more details.
+ -
+ - You should have received a copy of the GNU General Public License
+ - along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ -----------------------------------------------------------------------------*/
+
+/**
+ * @brief Queries per second of point lookups sent to a running server over one connection: lookups of a new key every
+ * time, each a new statement text that goes through the parser, planner and optimizer, the same lookup again and
+ * again, which is planned once and then found in the plan cache, and EXECUTE of a prepared lookup with a new key every
+ * time. The rows are loaded by EXECUTE of a prepared insert.
+ *
+ * Start the server first, the benchmark creates the database if needed and replaces table plan_cache_bench in it.
+ *
+ * usage: plan_cache_bench [database] [rows] [queries], default database pcbench, 10K rows and 20K queries per round
+ */
+
+#include <random>
+#include "bench_client.h"
+#include "../test_util.h"
+
+int main(int argc, char *argv[])
+{
+  std::string db_name = argc > 1 ? argv[1] : "pcbench";
+  size_t      rows    = argc > 2 ? std::stoul(argv[2]) : 10000;
+  size_t      queries = argc > 3 ? std::stoul(argv[3]) : 20000;
+
+  Connection conn;
+  conn.Query(fmt::format("CREATE DATABASE {};", db_name));
+  conn.MustQuery(fmt::format("OPEN DATABASE {};", db_name));
+  conn.Query("DROP TABLE plan_cache_bench;");
+  conn.MustQuery("CREATE TABLE plan_cache_bench (id INT, name CHAR(16), score FLOAT);");
+  conn.MustQuery("CREATE INDEX plan_cache_bench (id);");
+
+  conn.MustQuery("PREPARE bench_insert AS INSERT INTO plan_cache_bench VALUES (?, ?, ?);");
+  auto load = Measure(rows, [&conn](size_t i) {
+    conn.MustQuery(fmt::format("EXECUTE bench_insert ({}, 'name{}', {}.5);", i, i, i % 100));
+  });
+  conn.MustQuery("ANALYZE plan_cache_bench;");
+  std::cout << fmt::format("load {} rows with a prepared insert: {:.0f} rows/s", rows, load) << std::endl;
+
+  std::mt19937                          gen(wsdb::TEST_SEED);
+  std::uniform_int_distribution<size_t> dist(0, rows - 1);
+
+  auto plain = Measure(queries, [&](size_t) {
+    conn.MustQuery(fmt::format("SELECT * FROM plan_cache_bench WHERE id = {};", dist(gen)));
+  });
+
+  auto key  = dist(gen);
+  auto same = Measure(queries, [&](size_t) {
+    conn.MustQuery(fmt::format("SELECT * FROM plan_cache_bench WHERE id = {};", key));
+  });
+
+  conn.MustQuery("PREPARE bench_lookup AS SELECT * FROM plan_cache_bench WHERE id = ?;");
+  auto prepared = Measure(queries, [&](size_t) {
+    conn.MustQuery(fmt::format("EXECUTE bench_lookup ({});", dist(gen)));
+  });
+  conn.MustQuery("DEALLOCATE bench_lookup;");
+  conn.MustQuery("DEALLOCATE bench_insert;");
+
+  std::cout << fmt::format("{:<32}{:>12}", "point lookup", "QPS") << std::endl;
+  std::cout << fmt::format("{:<32}{:>12.0f}", "new text every time", plain) << std::endl;
+  std::cout << fmt::format("{:<32}{:>12.0f}", "same text (plan cache)", same) << std::endl;
+  std::cout << fmt::format("{:<32}{:>12.0f}", "EXECUTE (prepared)", prepared) << std::endl;
+  return 0;
+}
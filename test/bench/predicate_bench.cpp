@@ -0,0 +1,134 @@
+/*------------------------------------------------------------------------------
+ - Copyright (c) 2024. Websoft research group, Nanjing University.
+ -
+ - This program is free software: you can redistribute it and/or modify
+ - it under the terms of the GNU General Public License as published by
+ - the Free Software Foundation, either version 3 of the License, or
+ - (at your option) any later version.
+ -
+ - This program is distributed in the hope that it will be useful,
+ - but WITHOUT ANY WARRANTY; without even the implied warranty of
+ - MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ - GNU General Public License for more details.
+ -
+ - You should have received a copy of the GNU General Public License
+ - along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ -----------------------------------------------------------------------------*/
+
+/**
+ * @brief Benchmark of filter evaluation: ConditionExpr::Eval on every record against a CompiledPredicate evaluating
+ * every record, and filtering batches of records into a selection vector.
+ *
+ * usage: predicate_bench [rows] [batch_size], default 10M rows in batches of 1024
+ */
+
+#include <chrono>
+#include <iostream>
+#include <random>
+#include "expr/compiled_predicate.h"
+#include "expr/condition_expr.h"
+#include "../test_util.h"
+
+using namespace wsdb;
+
+template <typename Func>
+static auto Measure(Func &&func, size_t &selected) -> double
+{
+  auto start = std::chrono::steady_clock::now();
+  selected   = func();
+  auto end   = std::chrono::steady_clock::now();
+  return std::chrono::duration<double>(end - start).count();
+}
+
+int main(int argc, char *argv[])
+{
+  size_t rows       = argc > 1 ? std::stoull(argv[1]) : 10'000'000;
+  size_t batch_size = argc > 2 ? std::stoull(argv[2]) : 1024;
+
+  std::vector<RTField> fields = {MakeField("id", TYPE_INT, 4),
+      MakeField("price", TYPE_FLOAT, 4),
+      MakeField("qty", TYPE_INT, 4),
+      MakeField("name", TYPE_STRING, 16)};
+  RecordSchema         schema(fields);
+
+  std::mt19937            gen(rows);
+  std::vector<RecordUptr> records;
+  records.reserve(rows);
+  for (size_t i = 0; i < rows; i++) {
+    std::string name = fmt::format("item_{}", gen() % 1000);
+    records.push_back(std::make_unique<Record>(&schema,
+        std::vector<ValueSptr>{ValueFactory::CreateIntValue(static_cast<int>(i)),
+            ValueFactory::CreateFloatValue(static_cast<float>(gen() % 10000) / 100),
+            gen() % 10 == 0 ? ValueFactory::CreateNullValue(TYPE_INT)
+                            : ValueFactory::CreateIntValue(static_cast<int>(gen() % 100)),
+            ValueFactory::CreateStringValue(name.c_str(), name.size())},
+        INVALID_RID));
+  }
+
+  // price < 50.0 AND qty >= 10 AND name <> 'item_7' AND qty < id
+  ValueSptr    price = ValueFactory::CreateFloatValue(50.0f);
+  ValueSptr    qty   = ValueFactory::CreateIntValue(10);
+  ValueSptr    name  = ValueFactory::CreateStringValue("item_7", 6);
+  ConditionVec conds = {Condition(OP_LT, fields[1], price),
+      Condition(OP_GE, fields[2], qty),
+      Condition(OP_NE, fields[3], name),
+      Condition(OP_LT, fields[2], fields[0])};
+
+  size_t interpreted_num;
+  auto   interpreted = Measure(
+      [&]() {
+        size_t n = 0;
+        for (const auto &record : records) {
+          n += ConditionExpr::Eval(conds, *record) ? 1 : 0;
+        }
+        return n;
+      },
+      interpreted_num);
+
+  CompiledPredicate pred(conds, &schema);
+  size_t            compiled_num;
+  auto              compiled = Measure(
+      [&]() {
+        size_t n = 0;
+        for (const auto &record : records) {
+          n += pred.Eval(*record) ? 1 : 0;
+        }
+        return n;
+      },
+      compiled_num);
+
+  // batches own their records like the pages read by a scan, move them in and out to keep the setup out of the timing
+  std::vector<std::vector<RecordUptr>> batches;
+  for (size_t i = 0; i < rows; i += batch_size) {
+    auto &batch = batches.emplace_back();
+    for (size_t j = i; j < std::min(rows, i + batch_size); j++) {
+      batch.push_back(std::move(records[j]));
+    }
+  }
+  std::vector<size_t> sel;
+  size_t              batch_num;
+  auto                batched = Measure(
+      [&]() {
+        size_t n = 0;
+        for (const auto &batch : batches) {
+          n += pred.Filter(batch, sel);
+        }
+        return n;
+      },
+      batch_num);
+
+  if (interpreted_num != compiled_num || interpreted_num != batch_num) {
+    std::cerr << fmt::format("result mismatch: {} {} {}", interpreted_num, compiled_num, batch_num) << std::endl;
+    std::abort();
+  }
+  std::cout << fmt::format("{} rows, {} selected, {} of {} conditions compiled\n",
+      rows,
+      interpreted_num,
+      pred.GetCompiledCount(),
+      conds.size());
+  std::cout << fmt::format("{:>12} {:>12} {:>8}\n", "evaluator", "seconds", "speedup");
+  std::cout << fmt::format("{:>12} {:>12.3f} {:>7.2f}x\n", "interpreted", interpreted, 1.0);
+  std::cout << fmt::format("{:>12} {:>12.3f} {:>7.2f}x\n", "compiled", compiled, interpreted / compiled);
+  std::cout << fmt::format("{:>12} {:>12.3f} {:>7.2f}x\n", "batched", batched, interpreted / batched);
+  return 0;
+}
@@ -0,0 +1,74 @@
+/*------------------------------------------------------------------------------
+ - Copyright (c) 2024. Websoft research group, Nanjing University.
+ -
+ - This program is free software: you can redistribute it and/or modify
+ - it under the terms of the GNU General Public License as published by
+ - the Free Software Foundation, either version 3 of the License, or
+ - (at your option) any later version.
+ -
+ - This program is distributed in the hope that it will be useful,
+ - but WITHOUT ANY WARRANTY; without even the implied warranty of
+ - MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ - GNU General Public License for more details.
+ -
+ - You should have received a copy of the GNU General Public License
+ - along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ -----------------------------------------------------------------------------*/
+
+/**
+ * @brief Result rows per second a running server streams to one client over loopback. The table is loaded with COPY
+ * FROM a generated csv file, then full scans and projections are read back and decoded the way the client does.
+ *
+ * Start the server on the same host first, the benchmark creates the database if needed and replaces table
+ * result_bench in it.
+ *
+ * usage: result_bench [database] [rows], default database resbench and 1M rows
+ */
+
+#include <fstream>
+#include "bench_client.h"
+
+int main(int argc, char *argv[])
+{
+  std::string db_name = argc > 1 ? argv[1] : "resbench";
+  size_t      rows    = argc > 2 ? std::stoul(argv[2]) : 1000000;
+
+  std::string csv_path = fmt::format("/tmp/result_bench_{}.csv", getpid());
+  {
+    std::ofstream csv(csv_path);
+    for (size_t i = 0; i < rows; i++) {
+      csv << i << ",name" << i << "," << i % 1000 << ".5," << (i % 2 == 0 ? "1" : "0") << "\n";
+    }
+  }
+
+  Connection conn;
+  conn.Query(fmt::format("CREATE DATABASE {};", db_name));
+  conn.MustQuery(fmt::format("OPEN DATABASE {};", db_name));
+  conn.Query("DROP TABLE result_bench;");
+  conn.MustQuery("CREATE TABLE result_bench (id INT, name CHAR(32), score FLOAT, flag BOOL);");
+  conn.MustQuery(fmt::format("COPY result_bench FROM '{}';", csv_path));
+  unlink(csv_path.c_str());
+
+  const char *queries[] = {
+      "SELECT * FROM result_bench;",
+      "SELECT id FROM result_bench;",
+      "SELECT name, score FROM result_bench;",
+  };
+  std::cout << fmt::format("{:<40}{:>12}{:>10}{:>10}", "query", "rows/s", "MB/s", "packets") << std::endl;
+  for (const auto *sql : queries) {
+    auto start = std::chrono::steady_clock::now();
+    conn.MustQuery(sql);
+    auto secs = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    if (conn.Rows() != rows) {
+      std::cerr << sql << " returned " << conn.Rows() << " rows, expected " << rows << std::endl;
+      return 1;
+    }
+    std::cout << fmt::format("{:<40}{:>12.0f}{:>10.1f}{:>10}",
+                     sql,
+                     static_cast<double>(conn.Rows()) / secs,
+                     static_cast<double>(conn.Bytes()) / secs / (1 << 20),
+                     conn.Packets())
+              << std::endl;
+  }
+  return 0;
+}
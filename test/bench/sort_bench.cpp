@@ -0,0 +1,133 @@
+/*------------------------------------------------------------------------------
+ - Copyright (c) 2024. Websoft research group, Nanjing University.
+ -
+ - This program is free software: you can redistribute it and/or modify
+ - it under the terms of the GNU General Public License as published by
+ - the Free Software Foundation, either version 3 of the License, or
+ - (at your option) any later version.
+ -
+ - This program is distributed in the hope that it will be useful,
+ - but WITHOUT ANY WARRANTY; without even the implied warranty of
+ - MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ - GNU General Public License for more details.
+ -
+ - You should have received a copy of the GNU General Public License
+ - along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ -----------------------------------------------------------------------------*/
+
+/**
+ * @brief Benchmark of SortExecutor on int and string keys: the records of an in-memory child are loaded, sorted by
+ * one thread and by the shared worker pool, and read back.
+ *
+ * usage: sort_bench [max_rows] [dop], rows go from 1M to max_rows (default 10M) in steps of 10x
+ */
+
+#include <chrono>
+#include <cstring>
+#include <iostream>
+#include <random>
+#include "common/thread_pool.h"
+#include "execution/executor_sort.h"
+#include "system/session.h"
+#include "../test_util.h"
+
+using namespace wsdb;
+
+static constexpr size_t STR_WIDTH = 16;
+
+/// hand out copies of rows in order, the way SortExecutor reads its child
+class RowsExecutor : public AbstractExecutor
+{
+public:
+  RowsExecutor(const RecordSchema *schema, const std::vector<RecordUptr> &rows)
+      : AbstractExecutor(Basic), schema_(schema), rows_(rows)
+  {}
+
+  void Init() override { idx_ = 0; }
+
+  void Next() override
+  {
+    if (idx_ < rows_.size()) {
+      record_ = std::make_unique<Record>(*rows_[idx_++]);
+    } else {
+      record_.reset();
+    }
+  }
+
+  [[nodiscard]] auto IsEnd() const -> bool override { return idx_ >= rows_.size(); }
+
+  [[nodiscard]] auto GetOutSchema() const -> const RecordSchema * override { return schema_; }
+
+private:
+  const RecordSchema            *schema_;
+  const std::vector<RecordUptr> &rows_;
+  size_t                         idx_{0};
+};
+
+/// records of a random int and a string of up to STR_WIDTH chars
+static auto BuildRows(const RecordSchema *schema, size_t n) -> std::vector<RecordUptr>
+{
+  std::mt19937            gen(TEST_SEED);
+  std::vector<RecordUptr> rows;
+  rows.reserve(n);
+  char str[STR_WIDTH];
+  for (size_t i = 0; i < n; i++) {
+    // a shared prefix makes the inline prefix collide now and then, like real world string keys
+    size_t len = 4 + gen() % (STR_WIDTH - 4);
+    memcpy(str, "key_", 4);
+    for (size_t j = 4; j < len; j++) {
+      str[j] = static_cast<char>('a' + gen() % 26);
+    }
+    std::vector<ValueSptr> values{
+        ValueFactory::CreateIntValue(static_cast<int32_t>(gen())), ValueFactory::CreateStringValue(str, len)};
+    rows.push_back(std::make_unique<Record>(schema, values, INVALID_RID));
+  }
+  return rows;
+}
+
+/// sort rows on their field key_idx with dop threads, return the seconds SortExecutor takes for it
+static auto RunSort(const RecordSchema *schema, const std::vector<RecordUptr> &rows, size_t key_idx, size_t dop)
+    -> double
+{
+  Session::Current().SetVariable("dop", ValueFactory::CreateIntValue(static_cast<int>(dop)));
+  auto key_schema = std::make_unique<RecordSchema>(std::vector<RTField>{schema->GetFieldAt(key_idx)});
+  SortExecutor            sort(std::make_unique<RowsExecutor>(schema, rows), std::move(key_schema), false);
+  std::vector<RecordUptr> out;
+  out.reserve(rows.size());
+  auto start = std::chrono::steady_clock::now();
+  for (sort.Init(); !sort.IsEnd();) {
+    sort.Next();
+    out.push_back(sort.GetRecord());
+  }
+  auto end = std::chrono::steady_clock::now();
+  if (out.size() != rows.size()) {
+    std::cerr << fmt::format("{} of {} records are returned", out.size(), rows.size()) << std::endl;
+    std::abort();
+  }
+  for (size_t i = 1; i < out.size(); i++) {
+    if (*out[i]->GetValueAt(key_idx) < *out[i - 1]->GetValueAt(key_idx)) {
+      std::cerr << "result is not sorted" << std::endl;
+      std::abort();
+    }
+  }
+  return std::chrono::duration<double>(end - start).count();
+}
+
+int main(int argc, char *argv[])
+{
+  size_t       max_rows = argc > 1 ? std::stoull(argv[1]) : 10'000'000;
+  size_t       dop      = ThreadPool::ResolveDop(argc > 2 ? std::stoull(argv[2]) : 0);
+  RecordSchema schema(std::vector<RTField>{MakeField("k"), MakeField("s", TYPE_STRING, STR_WIDTH)});
+  std::cout << fmt::format("{:>8} {:>12} {:>12} {:>12} {:>8}\n", "key", "rows", "1 thread",
+                   fmt::format("{} threads", dop), "speedup");
+  for (size_t rows = 1'000'000; rows <= max_rows; rows *= 10) {
+    auto data = BuildRows(&schema, rows);
+    for (size_t key_idx : {0, 1}) {
+      auto serial = RunSort(&schema, data, key_idx, 1);
+      auto para   = RunSort(&schema, data, key_idx, dop);
+      std::cout << fmt::format("{:>8} {:>12} {:>12.3f} {:>12.3f} {:>7.2f}x\n", key_idx == 0 ? "int" : "string", rows,
+          serial, para, serial / para);
+    }
+  }
+  return 0;
+}
@@ -0,0 +1,71 @@
+/*------------------------------------------------------------------------------
+ - Copyright (c) 2024. Websoft research group, Nanjing University.
+ -
+ - This program is free software: you can redistribute it and/or modify
+ - it under the terms of the GNU General Public License as published by
+ - the Free Software Foundation, either version 3 of the License, or
+ - (at your option) any later version.
+ -
+ - This program is distributed in the hope that it will be useful,
+ - but WITHOUT ANY WARRANTY; without even the implied warranty of
+ - MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ - GNU General Public License for more details.
+ -
+ - You should have received a copy of the GNU General Public License
+ - along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ -----------------------------------------------------------------------------*/
+
+#include "execution/executor_bitmapscan.h"
+#include "gtest/gtest.h"
+using namespace wsdb;
+
+using PageBitmaps = BitmapScanExecutor::PageBitmaps;
+
+/// the set slots in the order the executor reads them, pages in id order and slots in order within a page
+static auto SetRIDs(const PageBitmaps &bitmaps, size_t slot_num) -> std::vector<RID>
+{
+  std::vector<RID> rids;
+  for (const auto &[page_id, bitmap] : bitmaps) {
+    EXPECT_EQ(bitmap.size(), BITMAP_SIZE(slot_num));
+    auto slot = BitMap::FindFirst(bitmap.data(), slot_num, 0, true);
+    while (slot < slot_num) {
+      rids.emplace_back(page_id, static_cast<slot_id_t>(slot));
+      slot = BitMap::FindFirst(bitmap.data(), slot_num, slot + 1, true);
+    }
+  }
+  return rids;
+}
+
+TEST(BitmapScan, Build)
+{
+  // 11 slots take two bytes, the last slot is in the second byte
+  auto bitmaps = BitmapScanExecutor::BuildBitmaps({RID(3, 10), RID(3, 0), RID(1, 5), RID(3, 0)}, 11);
+  ASSERT_EQ(bitmaps.size(), 2U);
+  ASSERT_EQ(SetRIDs(bitmaps, 11), (std::vector<RID>{RID(1, 5), RID(3, 0), RID(3, 10)}));
+  ASSERT_TRUE(BitmapScanExecutor::BuildBitmaps({}, 11).empty());
+}
+
+TEST(BitmapScan, And)
+{
+  auto bitmaps = BitmapScanExecutor::BuildBitmaps({RID(1, 1), RID(1, 2), RID(2, 3), RID(4, 0), RID(5, 16)}, 17);
+  auto other   = BitmapScanExecutor::BuildBitmaps({RID(1, 2), RID(1, 3), RID(3, 0), RID(4, 1), RID(5, 16)}, 17);
+  BitmapScanExecutor::CombineBitmaps(bitmaps, other, true, 17);
+  // pages 2 and 3 are missing on one side, page 4 is on both sides without a common slot
+  ASSERT_EQ(SetRIDs(bitmaps, 17), (std::vector<RID>{RID(1, 2), RID(5, 16)}));
+  ASSERT_EQ(bitmaps.count(2) + bitmaps.count(3), 0U);
+  // with nothing on the other side nothing is left
+  BitmapScanExecutor::CombineBitmaps(bitmaps, {}, true, 17);
+  ASSERT_TRUE(bitmaps.empty());
+}
+
+TEST(BitmapScan, Or)
+{
+  auto bitmaps = BitmapScanExecutor::BuildBitmaps({RID(1, 1), RID(2, 8), RID(4, 0)}, 9);
+  auto other   = BitmapScanExecutor::BuildBitmaps({RID(1, 1), RID(1, 7), RID(3, 8), RID(4, 2)}, 9);
+  BitmapScanExecutor::CombineBitmaps(bitmaps, other, false, 9);
+  // the pages of either side are kept, a slot set on both sides is read once
+  ASSERT_EQ(SetRIDs(bitmaps, 9),
+      (std::vector<RID>{RID(1, 1), RID(1, 7), RID(2, 8), RID(3, 8), RID(4, 0), RID(4, 2)}));
+  BitmapScanExecutor::CombineBitmaps(bitmaps, {}, false, 9);
+  ASSERT_EQ(SetRIDs(bitmaps, 9).size(), 6U);
+}
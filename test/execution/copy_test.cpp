@@ -0,0 +1,152 @@
+/*------------------------------------------------------------------------------
+ - Copyright (c) 2024. Websoft research group, Nanjing University.
+ -
+ - This program is free software: you can redistribute it and/or modify
+ - it under the terms of the GNU General Public License as published by
+ - the Free Software Foundation, either version 3 of the License, or
+ - (at your option) any later version.
+ -
+ - This program is distributed in the hope that it will be useful,
+ - but WITHOUT ANY WARRANTY; without even the implied warranty of
+ - MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ - GNU General Public License for more details.
+ -
+ - You should have received a copy of the GNU General Public License
+ - along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ -----------------------------------------------------------------------------*/
+
+#include "execution/executor_copy.h"
+#include "../test_util.h"
+#include "gtest/gtest.h"
+using namespace wsdb;
+
+static auto MakeSchema() -> RecordSchemaUptr
+{
+  return std::make_unique<RecordSchema>(std::vector<RTField>{
+      MakeField("id", TYPE_INT, 4), MakeField("name", TYPE_STRING, 8), MakeField("score", TYPE_FLOAT, 4)});
+}
+
+TEST(CopyCsv, Plain)
+{
+  auto schema = MakeSchema();
+  auto values = CopyFromExecutor::ParseCsvLine(*schema, "7,alice,2.5");
+  ASSERT_EQ(values.size(), 3);
+  ASSERT_EQ(std::dynamic_pointer_cast<IntValue>(values[0])->Get(), 7);
+  ASSERT_EQ(std::dynamic_pointer_cast<StringValue>(values[1])->Get(), "alice");
+  ASSERT_FLOAT_EQ(std::dynamic_pointer_cast<FloatValue>(values[2])->Get(), 2.5f);
+}
+
+TEST(CopyCsv, QuotesAndNulls)
+{
+  auto schema = MakeSchema();
+  auto values = CopyFromExecutor::ParseCsvLine(*schema, R"(-3,"a,""b""",)");
+  ASSERT_EQ(std::dynamic_pointer_cast<IntValue>(values[0])->Get(), -3);
+  ASSERT_EQ(std::dynamic_pointer_cast<StringValue>(values[1])->Get(), R"(a,"b")");
+  ASSERT_TRUE(values[2]->IsNull());
+
+  // a quoted empty field is an empty string, an unquoted one is null
+  values = CopyFromExecutor::ParseCsvLine(*schema, R"(,"",1)");
+  ASSERT_TRUE(values[0]->IsNull());
+  ASSERT_FALSE(values[1]->IsNull());
+  ASSERT_EQ(std::dynamic_pointer_cast<StringValue>(values[1])->Get(), "");
+}
+
+TEST(CopyCsv, Errors)
+{
+  auto schema = MakeSchema();
+  ASSERT_THROW(CopyFromExecutor::ParseCsvLine(*schema, "1,a"), WSDBException_);
+  ASSERT_THROW(CopyFromExecutor::ParseCsvLine(*schema, "1,a,2,3"), WSDBException_);
+  ASSERT_THROW(CopyFromExecutor::ParseCsvLine(*schema, "x,a,2"), WSDBException_);
+  ASSERT_THROW(CopyFromExecutor::ParseCsvLine(*schema, "1,a,2.5f"), WSDBException_);
+  ASSERT_THROW(CopyFromExecutor::ParseCsvLine(*schema, "1,abcdefghi,2"), WSDBException_);
+  ASSERT_THROW(CopyFromExecutor::ParseCsvLine(*schema, R"(1,"a,2)"), WSDBException_);
+  ASSERT_THROW(CopyFromExecutor::ParseCsvLine(*schema, R"(1,"a"b,2)"), WSDBException_);
+}
+
+TEST(CopyBinary, RowGroupSize)
+{
+  auto schema = MakeSchema();
+  ASSERT_EQ(CopyRowGroupSize(*schema, 0), 0);
+  ASSERT_EQ(CopyRowGroupSize(*schema, 10), 3 * 2 + 10 * (4 + 8 + 4));
+}
+
+TEST(CopyCsv, RoundTrip)
+{
+  auto                   schema = MakeSchema();
+  std::vector<ValueSptr> values{ValueFactory::CreateIntValue(-42),
+      ValueFactory::CreateStringValue("a,\"b\"", 5),
+      ValueFactory::CreateFloatValue(0.1f)};
+  Record                 record(schema.get(), values, INVALID_RID);
+  std::string            line;
+  CopyToExecutor::AppendCsvLine(*schema, record, line);
+  ASSERT_EQ(line, "-42,\"a,\"\"b\"\"\",0.1\n");
+
+  line.pop_back();
+  auto parsed = CopyFromExecutor::ParseCsvLine(*schema, line);
+  for (size_t i = 0; i < values.size(); i++) {
+    ASSERT_FALSE(*parsed[i] < *values[i] || *values[i] < *parsed[i]);
+  }
+
+  // empty strings are quoted, nulls are left empty
+  values = {ValueFactory::CreateNullValue(TYPE_INT),
+      ValueFactory::CreateStringValue("", 0),
+      ValueFactory::CreateNullValue(TYPE_FLOAT)};
+  Record empty(schema.get(), values, INVALID_RID);
+  line.clear();
+  CopyToExecutor::AppendCsvLine(*schema, empty, line);
+  ASSERT_EQ(line, ",\"\",\n");
+}
+
+TEST(CopyCsv, RecordEnd)
+{
+  // a line break in a quoted field, after escaped quotes too, belongs to the field
+  std::string data = "1,a,2\n2,\"x\ny\",3\n3,\"\"\"\n\",4\n4,\"open\n";
+  const char *end  = data.data() + data.size();
+  std::vector<std::string> records;
+  for (const char *pos = data.data(); pos < end;) {
+    auto eol = CopyFromExecutor::FindCsvRecordEnd(pos, end);
+    records.emplace_back(pos, eol);
+    pos = eol == end ? end : eol + 1;
+  }
+  ASSERT_EQ(records, (std::vector<std::string>{"1,a,2", "2,\"x\ny\",3", "3,\"\"\"\n\",4", "4,\"open\n"}));
+
+  // a string with a line break is written in one record and read back
+  auto                   schema = MakeSchema();
+  std::vector<ValueSptr> values{ValueFactory::CreateIntValue(1),
+      ValueFactory::CreateStringValue("a\nb", 3),
+      ValueFactory::CreateFloatValue(2.0f)};
+  Record                 record(schema.get(), values, INVALID_RID);
+  std::string            line;
+  CopyToExecutor::AppendCsvLine(*schema, record, line);
+  ASSERT_EQ(CopyFromExecutor::FindCsvRecordEnd(line.data(), line.data() + line.size()), &line.back());
+  line.pop_back();
+  auto parsed = CopyFromExecutor::ParseCsvLine(*schema, line);
+  for (size_t i = 0; i < values.size(); i++) {
+    ASSERT_FALSE(*parsed[i] < *values[i] || *values[i] < *parsed[i]);
+  }
+}
+
+TEST(CopyBinary, RowGroup)
+{
+  auto                    schema = MakeSchema();
+  std::vector<RecordUptr> records;
+  for (int i = 0; i < 10; i++) {
+    std::vector<ValueSptr> values{ValueFactory::CreateIntValue(i),
+        i % 3 == 0 ? ValueFactory::CreateNullValue(TYPE_STRING) : ValueFactory::CreateStringValue("x", 1),
+        ValueFactory::CreateFloatValue(static_cast<float>(i))};
+    records.push_back(std::make_unique<Record>(schema.get(), values, INVALID_RID));
+  }
+  std::string group;
+  CopyToExecutor::AppendRowGroup(*schema, records, group);
+  ASSERT_EQ(group.size(), sizeof(uint32_t) + CopyRowGroupSize(*schema, 10));
+
+  // the ints follow the row count and the null bitmap of the first column
+  int32_t value;
+  memcpy(&value, group.data() + sizeof(uint32_t) + 2 + 7 * sizeof(int32_t), sizeof(value));
+  ASSERT_EQ(value, 7);
+  // rows 0, 3, 6 and 9 have null names
+  const char *names_nullmap = group.data() + sizeof(uint32_t) + 2 + 10 * sizeof(int32_t);
+  for (size_t i = 0; i < 10; i++) {
+    ASSERT_EQ(BitMap::GetBit(names_nullmap, i), i % 3 == 0);
+  }
+}
@@ -0,0 +1,107 @@
+/*------------------------------------------------------------------------------
+ - Copyright (c) 2024. Websoft research group, Nanjing University.
+ -
+ - This program is free software: you can redistribute it and/or modify
+ - it under the terms of the GNU General Public License as published by
+ - the Free Software Foundation, either version 3 of the License, or
+ - (at your option) any later version.
+ -
+ - This program is distributed in the hope that it will be useful,
+ - but WITHOUT ANY WARRANTY; without even the implied warranty of
+ - MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ - GNU General Public License for more details.
+ -
+ - You should have received a copy of the GNU General Public License
+ - along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ -----------------------------------------------------------------------------*/
+
+#include <set>
+#include "execution/executor_gather.h"
+#include "common/thread_pool.h"
+#include "../test_util.h"
+#include "gtest/gtest.h"
+using namespace wsdb;
+
+/// a copy of a pipeline, the copies sharing next produce the numbers 0 to num - 1 between them
+class NumberExecutor : public AbstractExecutor
+{
+public:
+  NumberExecutor(std::shared_ptr<std::atomic<int>> next, int num)
+      : AbstractExecutor(Basic), next_(std::move(next)), num_(num)
+  {
+    out_schema_ = std::make_unique<RecordSchema>(std::vector<RTField>{MakeField("n")});
+  }
+
+  void Init() override { Next(); }
+
+  void Next() override
+  {
+    cur_ = (*next_)++;
+    if (cur_ < num_) {
+      std::vector<ValueSptr> values{ValueFactory::CreateIntValue(cur_)};
+      record_ = std::make_unique<Record>(out_schema_.get(), values, INVALID_RID);
+    }
+  }
+
+  [[nodiscard]] auto IsEnd() const -> bool override { return cur_ >= num_; }
+
+private:
+  std::shared_ptr<std::atomic<int>> next_;
+  int                               num_;
+  int                               cur_{0};
+};
+
+static auto MakeGather(size_t dop, int num) -> std::unique_ptr<GatherExecutor>
+{
+  auto                              next = std::make_shared<std::atomic<int>>(0);
+  std::vector<AbstractExecutorUptr> pipelines;
+  for (size_t i = 0; i < dop; i++) {
+    pipelines.push_back(std::make_unique<NumberExecutor>(next, num));
+  }
+  return std::make_unique<GatherExecutor>(std::move(pipelines), nullptr);
+}
+
+static auto Drain(GatherExecutor &gather) -> std::set<int>
+{
+  std::set<int> nums;
+  for (gather.Init(); !gather.IsEnd(); gather.Next()) {
+    nums.insert(std::dynamic_pointer_cast<IntValue>(gather.GetRecord()->GetValueAt(0))->Get());
+  }
+  return nums;
+}
+
+TEST(GatherTest, AllRecords)
+{
+  // more pipelines than workers too
+  for (size_t dop : {1, 2, 4, 64}) {
+    auto gather = MakeGather(dop, 10000);
+    ASSERT_EQ(Drain(*gather).size(), 10000U) << dop;
+    // a new Init runs the pipelines again, the numbers are all taken
+    ASSERT_EQ(Drain(*gather).size(), 0U) << dop;
+  }
+  // a gather stopped before the end
+  auto gather = MakeGather(8, 100000);
+  gather->Init();
+  for (int i = 0; i < 1000; i++) {
+    gather->Next();
+  }
+}
+
+TEST(GatherTest, BusyPool)
+{
+  // gathers whose consumers take up every worker of the pool still end
+  auto               &pool = ThreadPool::GetInstance();
+  size_t              num  = pool.GetThreadNum() * 2;
+  std::atomic<size_t> done{0};
+  for (size_t i = 0; i < num; i++) {
+    pool.Submit([&done] {
+      auto gather = MakeGather(8, 10000);
+      EXPECT_EQ(Drain(*gather).size(), 10000U);
+      done++;
+    });
+  }
+  for (int i = 0; i < 1000 && done < num; i++) {
+    std::this_thread::sleep_for(std::chrono::milliseconds(10));
+  }
+  ASSERT_EQ(done, num);
+}
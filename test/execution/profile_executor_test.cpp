@@ -0,0 +1,143 @@
+/*------------------------------------------------------------------------------
+ - Copyright (c) 2024. Websoft research group, Nanjing University.
+ -
+ - This program is free software: you can redistribute it and/or modify
+ - it under the terms of the GNU General Public License as published by
+ - the Free Software Foundation, either version 3 of the License, or
+ - (at your option) any later version.
+ -
+ - This program is distributed in the hope that it will be useful,
+ - but WITHOUT ANY WARRANTY; without even the implied warranty of
+ - MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ - GNU General Public License for more details.
+ -
+ - You should have received a copy of the GNU General Public License
+ - along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ -----------------------------------------------------------------------------*/
+
+#include "execution/executor_profile.h"
+#include "../test_util.h"
+#include "gtest/gtest.h"
+using namespace wsdb;
+
+/// produce the numbers 0 to num - 1, every record counts as a page hit
+class NumberExecutor : public AbstractExecutor
+{
+public:
+  explicit NumberExecutor(int num) : AbstractExecutor(Basic), num_(num)
+  {
+    out_schema_ = std::make_unique<RecordSchema>(std::vector<RTField>{MakeField("n")});
+  }
+
+  void Init() override
+  {
+    cur_ = 0;
+    Load();
+  }
+
+  void Next() override
+  {
+    cur_++;
+    Load();
+  }
+
+  [[nodiscard]] auto IsEnd() const -> bool override { return cur_ >= num_; }
+
+private:
+  void Load()
+  {
+    if (IsEnd()) {
+      record_ = nullptr;
+      return;
+    }
+    IoStats::Local().hits_++;
+    std::vector<ValueSptr> values{ValueFactory::CreateIntValue(cur_)};
+    record_ = std::make_unique<Record>(out_schema_.get(), values, INVALID_RID);
+  }
+
+  int num_;
+  int cur_{0};
+};
+
+/// keep the even numbers of the child, every record read counts as a page miss
+class EvenExecutor : public AbstractExecutor
+{
+public:
+  explicit EvenExecutor(AbstractExecutorUptr child) : AbstractExecutor(Basic), child_(std::move(child)) {}
+
+  void Init() override
+  {
+    child_->Init();
+    Skip();
+  }
+
+  void Next() override
+  {
+    child_->Next();
+    Skip();
+  }
+
+  [[nodiscard]] auto IsEnd() const -> bool override { return child_->IsEnd(); }
+
+  [[nodiscard]] auto GetOutSchema() const -> const RecordSchema * override { return child_->GetOutSchema(); }
+
+private:
+  void Skip()
+  {
+    for (; !child_->IsEnd(); child_->Next()) {
+      IoStats::Local().misses_++;
+      record_ = child_->GetRecord();
+      if (std::dynamic_pointer_cast<IntValue>(record_->GetValueAt(0))->Get() % 2 == 0) {
+        return;
+      }
+    }
+    record_ = nullptr;
+  }
+
+  AbstractExecutorUptr child_;
+};
+
+TEST(ProfileExecutorTest, CountRecordsAndLoops)
+{
+  ProfileExecutor exec(std::make_unique<NumberExecutor>(10));
+  for (int loop = 0; loop < 3; loop++) {
+    int expected = 0;
+    for (exec.Init(); !exec.IsEnd(); exec.Next()) {
+      auto rec = exec.GetRecord();
+      ASSERT_NE(rec, nullptr);
+      EXPECT_EQ(std::dynamic_pointer_cast<IntValue>(rec->GetValueAt(0))->Get(), expected++);
+    }
+    EXPECT_EQ(expected, 10);
+  }
+  const auto &stats = exec.GetStats();
+  EXPECT_EQ(stats->rows_, 30);
+  EXPECT_EQ(stats->loops_, 3);
+  EXPECT_EQ(stats->io_.hits_, 30);
+  EXPECT_EQ(stats->io_.misses_, 0);
+  EXPECT_EQ(stats->child_io_.hits_, 0);
+  EXPECT_GE(stats->time_ms_, 0);
+  EXPECT_EQ(stats->child_time_ms_, 0);
+}
+
+TEST(ProfileExecutorTest, SplitChildren)
+{
+  auto child       = std::make_unique<ProfileExecutor>(std::make_unique<NumberExecutor>(100));
+  auto child_stats = child->GetStats();
+  ProfileExecutor exec(std::make_unique<EvenExecutor>(std::move(child)));
+  size_t          num = 0;
+  for (exec.Init(); !exec.IsEnd(); exec.Next()) {
+    num++;
+  }
+  EXPECT_EQ(num, 50);
+  const auto &stats = exec.GetStats();
+  EXPECT_EQ(stats->rows_, 50);
+  EXPECT_EQ(child_stats->rows_, 100);
+  // the hits are made by the child, the misses by the parent itself
+  EXPECT_EQ(stats->io_.hits_, 100);
+  EXPECT_EQ(stats->io_.misses_, 100);
+  EXPECT_EQ(stats->child_io_.hits_, 100);
+  EXPECT_EQ(stats->child_io_.misses_, 0);
+  EXPECT_EQ(child_stats->io_.hits_, 100);
+  EXPECT_DOUBLE_EQ(stats->child_time_ms_, child_stats->time_ms_);
+  EXPECT_LE(stats->child_time_ms_, stats->time_ms_);
+}
@@ -0,0 +1,111 @@
+/*------------------------------------------------------------------------------
+ - Copyright (c) 2024. Websoft research group, Nanjing University.
+ -
+ - This program is free software: you can redistribute it and/or modify
+ - it under the terms of the GNU General Public License as published by
+ - the Free Software Foundation, either version 3 of the License, or
+ - (at your option) any later version.
+ -
+ - This program is distributed in the hope that it will be useful,
+ - but WITHOUT ANY WARRANTY; without even the implied warranty of
+ - MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ - GNU General Public License for more details.
+ -
+ - You should have received a copy of the GNU General Public License
+ - along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ -----------------------------------------------------------------------------*/
+
+#include <random>
+#include "expr/compiled_predicate.h"
+#include "expr/condition_expr.h"
+#include "../test_util.h"
+#include "gtest/gtest.h"
+using namespace wsdb;
+
+class CompiledPredicateTest : public ::testing::Test
+{
+protected:
+  void SetUp() override
+  {
+    fields_ = {MakeField("i", TYPE_INT, 4),
+        MakeField("f", TYPE_FLOAT, 4),
+        MakeField("s", TYPE_STRING, 8),
+        MakeField("j", TYPE_INT, 4)};
+    schema_ = std::make_unique<RecordSchema>(fields_);
+    std::mt19937 gen(TEST_SEED);
+    auto maybe_null = [&gen](ValueSptr val, FieldType type) {
+      return gen() % 8 == 0 ? ValueFactory::CreateNullValue(type) : std::move(val);
+    };
+    for (int k = 0; k < 500; k++) {
+      const auto &s = TEST_STRS[gen() % TEST_STRS.size()];
+      records_.push_back(std::make_unique<Record>(schema_.get(),
+          std::vector<ValueSptr>{maybe_null(ValueFactory::CreateIntValue(static_cast<int>(gen() % 20) - 10), TYPE_INT),
+              maybe_null(ValueFactory::CreateFloatValue(static_cast<float>(gen() % 40) / 4 - 5), TYPE_FLOAT),
+              maybe_null(ValueFactory::CreateStringValue(s.c_str(), s.size()), TYPE_STRING),
+              maybe_null(ValueFactory::CreateIntValue(static_cast<int>(gen() % 20) - 10), TYPE_INT)},
+          INVALID_RID));
+    }
+  }
+
+  /// compiled evaluation, one by one and batched, should agree with ConditionExpr
+  void CheckSame(const ConditionVec &conds, size_t compiled_num)
+  {
+    CompiledPredicate   pred(conds, schema_.get());
+    std::vector<size_t> expected;
+    for (size_t k = 0; k < records_.size(); k++) {
+      bool res = ConditionExpr::Eval(conds, *records_[k]);
+      ASSERT_EQ(pred.Eval(*records_[k]), res) << records_[k]->ToString();
+      if (res) {
+        expected.push_back(k);
+      }
+    }
+    std::vector<size_t> sel;
+    ASSERT_EQ(pred.Filter(records_, sel), expected.size());
+    ASSERT_EQ(sel, expected);
+    ASSERT_EQ(pred.GetCompiledCount(), compiled_num);
+  }
+
+  std::vector<RTField>    fields_;
+  RecordSchemaUptr        schema_;
+  std::vector<RecordUptr> records_;
+};
+
+TEST_F(CompiledPredicateTest, Constant)
+{
+  ValueSptr i_val = ValueFactory::CreateIntValue(3);
+  ValueSptr f_val = ValueFactory::CreateFloatValue(-1.25f);
+  ValueSptr s_val = ValueFactory::CreateStringValue("ab", 2);
+  for (auto op : {OP_EQ, OP_NE, OP_LT, OP_LE, OP_GT, OP_GE}) {
+    CheckSame({Condition(op, fields_[0], i_val)}, 1);
+    CheckSame({Condition(op, fields_[1], f_val)}, 1);
+    CheckSame({Condition(op, fields_[2], s_val)}, 1);
+    // int column against float constant and the other way round
+    CheckSame({Condition(op, fields_[0], f_val)}, 1);
+    CheckSame({Condition(op, fields_[1], i_val)}, 1);
+  }
+}
+
+TEST_F(CompiledPredicateTest, Column)
+{
+  for (auto op : {OP_EQ, OP_NE, OP_LT, OP_LE, OP_GT, OP_GE}) {
+    CheckSame({Condition(op, fields_[0], fields_[3])}, 1);
+    CheckSame({Condition(op, fields_[0], fields_[1])}, 1);
+    CheckSame({Condition(op, fields_[1], fields_[3])}, 1);
+  }
+}
+
+TEST_F(CompiledPredicateTest, Conjunction)
+{
+  ValueSptr i_val  = ValueFactory::CreateIntValue(0);
+  ValueSptr s_val  = ValueFactory::CreateStringValue("b", 1);
+  ValueSptr in_val = ValueFactory::CreateArrayValue(
+      {ValueFactory::CreateIntValue(1), ValueFactory::CreateIntValue(2), ValueFactory::CreateIntValue(-3)});
+  ValueSptr null_val = ValueFactory::CreateNullValue(TYPE_INT);
+  CheckSame({Condition(OP_GE, fields_[0], i_val),
+                Condition(OP_LT, fields_[2], s_val),
+                Condition(OP_NE, fields_[3], fields_[0])},
+      3);
+  // IN and null constants are left to ConditionExpr
+  CheckSame({Condition(OP_IN, fields_[3], in_val), Condition(OP_LE, fields_[0], fields_[3])}, 1);
+  CheckSame({Condition(OP_EQ, fields_[0], null_val), Condition(OP_LT, fields_[1], i_val)}, 1);
+}
@@ -0,0 +1,111 @@
+/*------------------------------------------------------------------------------
+ - Copyright (c) 2024. Websoft research group, Nanjing University.
+ -
+ - This program is free software: you can redistribute it and/or modify
+ - it under the terms of the GNU General Public License as published by
+ - the Free Software Foundation, either version 3 of the License, or
+ - (at your option) any later version.
+ -
+ - This program is distributed in the hope that it will be useful,
+ - but WITHOUT ANY WARRANTY; without even the implied warranty of
+ - MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ - GNU General Public License for more details.
+ -
+ - You should have received a copy of the GNU General Public License
+ - along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ -----------------------------------------------------------------------------*/
+
+#include <random>
+#include "expr/runtime_filter.h"
+#include "../test_util.h"
+#include "gtest/gtest.h"
+using namespace wsdb;
+
+TEST(BloomFilterTest, FalsePositiveRate)
+{
+  std::mt19937_64       gen(TEST_SEED);
+  std::vector<uint64_t> keys(100000);
+  for (auto &key : keys) {
+    key = gen();
+  }
+  for (double fpr : {0.1, 0.01, 0.001}) {
+    BloomFilter filter(keys.size(), fpr, 1 << 30);
+    for (auto key : keys) {
+      filter.Add(BloomFilter::Hash(reinterpret_cast<const char *>(&key), sizeof(key)));
+    }
+    // no false negatives
+    for (auto key : keys) {
+      ASSERT_TRUE(filter.MayContain(BloomFilter::Hash(reinterpret_cast<const char *>(&key), sizeof(key))));
+    }
+    size_t false_positive = 0;
+    size_t probe_num      = 100000;
+    for (size_t i = 0; i < probe_num; i++) {
+      auto key = gen();
+      false_positive += filter.MayContain(BloomFilter::Hash(reinterpret_cast<const char *>(&key), sizeof(key)));
+    }
+    EXPECT_LT(static_cast<double>(false_positive) / static_cast<double>(probe_num), fpr * 1.5);
+    EXPECT_LT(filter.EstimateFpr(keys.size()), fpr * 1.5);
+  }
+  // a capped size raises the expected false positive rate
+  BloomFilter small(keys.size(), 0.01, 64 * 1024);
+  EXPECT_EQ(small.GetBitNum(), 64 * 1024);
+  EXPECT_GT(small.EstimateFpr(keys.size()), 0.3);
+}
+
+TEST(RuntimeFilterTest, ProbeKeys)
+{
+  // probe side keys are ints, build side keys are floats
+  std::vector<RTField> probe_fields = {MakeField("a", TYPE_INT, 4, 0), MakeField("b", TYPE_STRING, 4, 0)};
+  std::vector<RTField> build_fields = {MakeField("x", TYPE_FLOAT, 4, 1), MakeField("y", TYPE_STRING, 8, 1)};
+  std::vector<RTField> probe_table  = {MakeField("c", TYPE_INT, 4, 0), probe_fields[1], probe_fields[0]};
+  RecordSchema         probe_schema(probe_table);
+  RecordSchema         build_schema(build_fields);
+  RuntimeFilter        filter(probe_fields, build_fields);
+
+  auto probe_encoder = filter.MakeProbeEncoder(&probe_schema);
+  auto probe_record  = [&probe_schema](int a, const std::string &b) {
+    return Record(&probe_schema,
+        {ValueFactory::CreateIntValue(0),
+            ValueFactory::CreateStringValue(b.c_str(), b.size()),
+            a < 0 ? ValueFactory::CreateNullValue(TYPE_INT) : ValueFactory::CreateIntValue(a)},
+        INVALID_RID);
+  };
+  // records pass before the filter is built
+  ASSERT_TRUE(filter.MayContain(probe_encoder, probe_record(1, "b")));
+
+  // the build keys are encoded like the join does, aligned with the probe key
+  RecordSchemaUptr build_key_schema = std::make_unique<RecordSchema>(build_fields);
+  RecordSchemaUptr probe_key_schema = std::make_unique<RecordSchema>(probe_fields);
+  SortKeyEncoder   build_encoder(build_key_schema.get(), &build_schema);
+  SortKeyEncoder   join_probe_encoder(probe_key_schema.get(), &probe_schema);
+  SortKeyEncoder::AlignWith(join_probe_encoder, build_encoder);
+  std::vector<uint64_t> hashes;
+  for (int i = 0; i < 100; i += 2) {
+    auto   s = std::to_string(i);
+    Record rec(&build_schema,
+        {ValueFactory::CreateFloatValue(static_cast<float>(i)), ValueFactory::CreateStringValue(s.c_str(), s.size())},
+        INVALID_RID);
+    hashes.push_back(RuntimeFilter::HashKey(build_encoder.Encode(rec)));
+  }
+  filter.Build(hashes);
+  ASSERT_TRUE(filter.IsReady());
+  size_t passed = 0;
+  for (int i = 0; i < 100; i++) {
+    auto rec = probe_record(i, std::to_string(i));
+    ASSERT_EQ(probe_encoder.Encode(rec), join_probe_encoder.Encode(rec));
+    if (i % 2 == 0) {
+      ASSERT_TRUE(filter.MayContain(probe_encoder, rec));
+    }
+    passed += filter.MayContain(probe_encoder, rec);
+  }
+  EXPECT_LT(passed, 55);
+  // a null key equals nothing
+  ASSERT_FALSE(filter.MayContain(probe_encoder, probe_record(-1, "0")));
+
+  filter.Reset();
+  ASSERT_FALSE(filter.IsReady());
+  ASSERT_TRUE(filter.MayContain(probe_encoder, probe_record(1, "1")));
+  // an empty build side drops everything
+  filter.Build({});
+  ASSERT_FALSE(filter.MayContain(probe_encoder, probe_record(0, "0")));
+}
@@ -0,0 +1,141 @@
+/*------------------------------------------------------------------------------
+ - Copyright (c) 2024. Websoft research group, Nanjing University.
+ -
+ - This program is free software: you can redistribute it and/or modify
+ - it under the terms of the GNU General Public License as published by
+ - the Free Software Foundation, either version 3 of the License, or
+ - (at your option) any later version.
+ -
+ - This program is distributed in the hope that it will be useful,
+ - but WITHOUT ANY WARRANTY; without even the implied warranty of
+ - MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ - GNU General Public License for more details.
+ -
+ - You should have received a copy of the GNU General Public License
+ - along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ -----------------------------------------------------------------------------*/
+
+#include <random>
+#include "expr/sort_key.h"
+#include "../test_util.h"
+#include "gtest/gtest.h"
+using namespace wsdb;
+
+static auto Sign(int v) -> int { return (v > 0) - (v < 0); }
+
+TEST(SortKey, Int)
+{
+  std::vector<int32_t> vals = {INT32_MIN, -100000, -1, 0, 1, 7, 100000, INT32_MAX};
+  for (auto l : vals) {
+    for (auto r : vals) {
+      char lk[4], rk[4];
+      SortKeyEncoder::EncodeInt(l, lk);
+      SortKeyEncoder::EncodeInt(r, rk);
+      ASSERT_EQ(Sign(memcmp(lk, rk, 4)), Sign((l > r) - (l < r)));
+      ASSERT_EQ(SortKeyEncoder::DecodeInt(lk), l);
+    }
+  }
+}
+
+TEST(SortKey, Float)
+{
+  std::vector<float> vals = {-1e30f, -2.5f, -1.0f, -1e-30f, -0.0f, 0.0f, 1e-30f, 1.0f, 2.5f, 1e30f};
+  for (auto l : vals) {
+    for (auto r : vals) {
+      char lk[4], rk[4];
+      SortKeyEncoder::EncodeFloat(l, lk);
+      SortKeyEncoder::EncodeFloat(r, rk);
+      ASSERT_EQ(Sign(memcmp(lk, rk, 4)), Sign((l > r) - (l < r)));
+      ASSERT_EQ(SortKeyEncoder::DecodeFloat(lk), l);
+    }
+  }
+}
+
+TEST(SortKey, RecordOrder)
+{
+  std::vector<RTField> fields = {
+      MakeField("i", TYPE_INT, 4), MakeField("s", TYPE_STRING, 8), MakeField("f", TYPE_FLOAT, 4)};
+  RecordSchema rec_schema(fields);
+  RecordSchema key_schema({fields[1], fields[0]});
+
+  std::mt19937            gen(TEST_SEED);
+  std::vector<RecordUptr> recs;
+  for (int i = 0; i < 200; i++) {
+    const auto &s = TEST_STRS[gen() % TEST_STRS.size()];
+    recs.push_back(std::make_unique<Record>(&rec_schema,
+        std::vector<ValueSptr>{ValueFactory::CreateIntValue(static_cast<int>(gen() % 20) - 10),
+            ValueFactory::CreateStringValue(s.c_str(), s.size()),
+            ValueFactory::CreateFloatValue(static_cast<float>(gen() % 100) / 3)},
+        INVALID_RID));
+  }
+
+  for (bool desc : {false, true}) {
+    SortKeyEncoder encoder(&key_schema, &rec_schema, desc);
+    ASSERT_EQ(encoder.GetKeySize(), 1 + 8 + 1 + 4);
+    for (const auto &l : recs) {
+      for (const auto &r : recs) {
+        auto lkey = Record(&key_schema, *l);
+        auto rkey = Record(&key_schema, *r);
+        auto expect = Sign(Record::Compare(lkey, rkey));
+        auto got    = Sign(SortKeyEncoder::Compare(
+            encoder.Encode(*l).data(), encoder.Encode(*r).data(), encoder.GetKeySize()));
+        ASSERT_EQ(got, desc ? -expect : expect);
+      }
+    }
+  }
+}
+
+TEST(SortKey, AlignAndPrefix)
+{
+  std::vector<RTField> lfields = {MakeField("a", TYPE_INT, 4), MakeField("s", TYPE_STRING, 4)};
+  std::vector<RTField> rfields = {MakeField("b", TYPE_FLOAT, 4), MakeField("t", TYPE_STRING, 10)};
+  RecordSchema         lschema(lfields);
+  RecordSchema         rschema(rfields);
+  SortKeyEncoder       lenc(&lschema, &lschema);
+  SortKeyEncoder       renc(&rschema, &rschema);
+  SortKeyEncoder::AlignWith(lenc, renc);
+  ASSERT_EQ(lenc.GetKeySize(), renc.GetKeySize());
+
+  Record l(&lschema,
+      std::vector<ValueSptr>{ValueFactory::CreateIntValue(3), ValueFactory::CreateStringValue("abc", 3)},
+      INVALID_RID);
+  Record r(&rschema,
+      std::vector<ValueSptr>{ValueFactory::CreateFloatValue(3.0f), ValueFactory::CreateStringValue("abc", 3)},
+      INVALID_RID);
+  ASSERT_EQ(lenc.Encode(l), renc.Encode(r));
+
+  // a prefix encoded from literals is a prefix of the full key
+  auto prefix = lenc.EncodeValues({ValueFactory::CreateIntValue(3)});
+  ASSERT_EQ(prefix.size(), lenc.GetPrefixSize(1));
+  ASSERT_EQ(lenc.Encode(l).substr(0, prefix.size()), prefix);
+}
+
+TEST(SortKey, Decode)
+{
+  std::vector<RTField> fields = {MakeField("i", TYPE_INT, 4),
+      MakeField("s", TYPE_STRING, 8),
+      MakeField("f", TYPE_FLOAT, 4),
+      MakeField("b", TYPE_BOOL, 1)};
+  RecordSchema         schema(fields);
+  std::vector<std::vector<ValueSptr>> rows = {
+      {ValueFactory::CreateIntValue(-7),
+          ValueFactory::CreateStringValue("abc", 3),
+          ValueFactory::CreateFloatValue(2.5f),
+          ValueFactory::CreateBoolValue(true)},
+      {ValueFactory::CreateNullValue(TYPE_INT),
+          ValueFactory::CreateStringValue("zzzzzzzz", 8),
+          ValueFactory::CreateNullValue(TYPE_FLOAT),
+          ValueFactory::CreateBoolValue(false)}};
+  for (bool desc : {false, true}) {
+    SortKeyEncoder encoder(&schema, &schema, desc);
+    for (const auto &row : rows) {
+      auto values = encoder.DecodeValues(encoder.EncodeValues(row).data());
+      ASSERT_EQ(values.size(), row.size());
+      for (size_t i = 0; i < row.size(); i++) {
+        ASSERT_EQ(values[i]->IsNull(), row[i]->IsNull());
+        ASSERT_EQ(values[i]->GetType(), row[i]->GetType());
+        ASSERT_TRUE(*values[i] == *row[i]);
+      }
+    }
+  }
+}
@@ -0,0 +1,150 @@
+/*------------------------------------------------------------------------------
+ - Copyright (c) 2024. Websoft research group, Nanjing University.
+ -
+ - This program is free software: you can redistribute it and/or modify
+ - it under the terms of the GNU General Public License as published by
+ - the Free Software Foundation, either version 3 of the License, or
+ - (at your option) any later version.
+ -
+ - This program is distributed in the hope that it will be useful,
+ - but WITHOUT ANY WARRANTY; without even the implied warranty of
+ - MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ - GNU General Public License for more details.
+ -
+ - You should have received a copy of the GNU General Public License
+ - along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ -----------------------------------------------------------------------------*/
+
+#include <random>
+#include <sstream>
+#include "common/bloom_filter.h"
+#include "expr/statistics.h"
+#include "../test_util.h"
+#include "gtest/gtest.h"
+using namespace wsdb;
+
+TEST(HyperLogLogTest, Estimate)
+{
+  for (uint64_t n : {10, 1000, 100000}) {
+    HyperLogLog hll;
+    for (uint64_t k = 0; k < n; k++) {
+      auto key = std::to_string(k);
+      hll.Add(BloomFilter::Hash(key.data(), key.size()));
+      // duplicates do not count
+      hll.Add(BloomFilter::Hash(key.data(), key.size()));
+    }
+    EXPECT_NEAR(hll.Estimate(), static_cast<double>(n), static_cast<double>(n) * 0.05 + 1);
+  }
+}
+
+class StatisticsTest : public ::testing::Test
+{
+protected:
+  void SetUp() override
+  {
+    fields_ = {MakeField("i", TYPE_INT, 4), MakeField("s", TYPE_STRING, 8)};
+    schema_ = std::make_unique<RecordSchema>(fields_);
+  }
+
+  void AddRow(TableStatsBuilder &builder, ValueSptr i, ValueSptr s)
+  {
+    Record rec(schema_.get(), {std::move(i), std::move(s)}, INVALID_RID);
+    builder.Add(rec);
+  }
+
+  /// 20000 rows: i is 7 in a quarter of them, null in a tenth and uniform in [0, 1000) otherwise,
+  /// s is one of 100 strings
+  auto Build(size_t sample_size) -> TableStatsSptr
+  {
+    TableStatsBuilder builder(*schema_, sample_size);
+    std::mt19937      gen(1);
+    for (int k = 0; k < 20000; k++) {
+      ValueSptr i;
+      if (k % 4 == 0) {
+        i = ValueFactory::CreateIntValue(7);
+      } else if (k % 10 == 1) {
+        i = ValueFactory::CreateNullValue(TYPE_INT);
+      } else {
+        i = ValueFactory::CreateIntValue(static_cast<int>(gen() % 1000));
+      }
+      auto s = "s" + std::to_string(k % 100);
+      AddRow(builder, i, ValueFactory::CreateStringValue(s.c_str(), s.size()));
+    }
+    return builder.Finish();
+  }
+
+  auto Selectivity(const TableStats &stats, const std::string &field, CompOp op, ValueSptr val) -> double
+  {
+    Condition cond(op, fields_[field == "i" ? 0 : 1], val);
+    return stats.EstimateSelectivity(cond);
+  }
+
+  std::vector<RTField> fields_;
+  RecordSchemaUptr     schema_;
+};
+
+TEST_F(StatisticsTest, Selectivity)
+{
+  // 0.25 of the rows hold 7, 0.1 are null and the rest are spread over 1000 values
+  for (size_t sample_size : {size_t{100000}, size_t{2000}}) {
+    auto stats = Build(sample_size);
+    ASSERT_EQ(stats->GetRowNum(), 20000);
+    const auto &col = stats->GetColumn(0);
+    EXPECT_NEAR(col.null_frac_, 0.1, 0.001);
+    EXPECT_NEAR(col.ndv_, 1000, 60);
+    ASSERT_FALSE(col.mcvs_.empty());
+    EXPECT_EQ(col.mcvs_[0].first, *TableStats::StatKey(*ValueFactory::CreateIntValue(7)));
+
+    EXPECT_NEAR(Selectivity(*stats, "i", OP_EQ, ValueFactory::CreateIntValue(7)), 0.25, 0.02);
+    EXPECT_NEAR(Selectivity(*stats, "i", OP_EQ, ValueFactory::CreateIntValue(500)), 0.00065, 0.0005);
+    EXPECT_EQ(Selectivity(*stats, "i", OP_EQ, ValueFactory::CreateIntValue(5000)), 0);
+    EXPECT_NEAR(Selectivity(*stats, "i", OP_EQ, ValueFactory::CreateNullValue(TYPE_INT)), 0.1, 0.001);
+    // ints and floats compare with each other
+    EXPECT_NEAR(Selectivity(*stats, "i", OP_LT, ValueFactory::CreateFloatValue(500.5)), 0.25 + 0.325, 0.03);
+    EXPECT_NEAR(Selectivity(*stats, "i", OP_GE, ValueFactory::CreateIntValue(500)), 0.325, 0.03);
+    EXPECT_NEAR(Selectivity(*stats, "i", OP_GT, ValueFactory::CreateIntValue(-1)), 0.9, 0.01);
+    EXPECT_NEAR(Selectivity(*stats, "i", OP_LE, ValueFactory::CreateIntValue(2000)), 0.9, 0.01);
+
+    EXPECT_NEAR(Selectivity(*stats, "s", OP_EQ, ValueFactory::CreateStringValue("s42", 3)), 0.01, 0.005);
+    EXPECT_NEAR(stats->GetColumn(1).ndv_, 100, 3);
+
+    auto join = TableStats::EstimateJoinSelectivity(&stats->GetColumn(0), &stats->GetColumn(1));
+    EXPECT_NEAR(join, 0.9 / 1000, 0.0002);
+  }
+}
+
+TEST_F(StatisticsTest, Serialize)
+{
+  auto              stats = Build(ANALYZE_SAMPLE_SIZE);
+  std::stringstream ss;
+  stats->Serialize(ss);
+  auto copy = TableStats::Deserialize(ss, *schema_);
+  ASSERT_NE(copy, nullptr);
+  EXPECT_EQ(copy->GetRowNum(), stats->GetRowNum());
+  for (size_t col = 0; col < fields_.size(); col++) {
+    EXPECT_EQ(copy->GetColumn(col).ndv_, stats->GetColumn(col).ndv_);
+    EXPECT_EQ(copy->GetColumn(col).mcvs_, stats->GetColumn(col).mcvs_);
+    EXPECT_EQ(copy->GetColumn(col).bounds_, stats->GetColumn(col).bounds_);
+  }
+
+  // statistics of another schema or truncated files are not used
+  std::stringstream ss2;
+  stats->Serialize(ss2);
+  RecordSchema other({fields_[1], fields_[0]});
+  EXPECT_EQ(TableStats::Deserialize(ss2, other), nullptr);
+  std::stringstream ss3;
+  stats->Serialize(ss3);
+  std::stringstream truncated(ss3.str().substr(0, ss3.str().size() / 2));
+  EXPECT_EQ(TableStats::Deserialize(truncated, *schema_), nullptr);
+}
+
+TEST_F(StatisticsTest, Empty)
+{
+  TableStatsBuilder builder(*schema_);
+  AddRow(builder, ValueFactory::CreateNullValue(TYPE_INT), ValueFactory::CreateNullValue(TYPE_STRING));
+  auto stats = builder.Finish();
+  EXPECT_EQ(stats->GetColumn(0).null_frac_, 1);
+  EXPECT_EQ(stats->GetColumn(0).ndv_, 0);
+  EXPECT_EQ(Selectivity(*stats, "i", OP_EQ, ValueFactory::CreateIntValue(1)), 0);
+  EXPECT_EQ(Selectivity(*stats, "i", OP_NE, ValueFactory::CreateNullValue(TYPE_INT)), 0);
+}
@@ -0,0 +1,179 @@
+/*------------------------------------------------------------------------------
+ - Copyright (c) 2024. Websoft research group, Nanjing University.
+ -
+ - This program is free software: you can redistribute it and/or modify
+ - it under the terms of the GNU General Public License as published by
+ - the Free Software Foundation, either version 3 of the License, or
+ - (at your option) any later version.
+ -
+ - This program is distributed in the hope that it will be useful,
+ - but WITHOUT ANY WARRANTY; without even the implied warranty of
+ - MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ - GNU General Public License for more details.
+ -
+ - You should have received a copy of the GNU General Public License
+ - along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ -----------------------------------------------------------------------------*/
+
+#include <random>
+#include "expr/condition_expr.h"
+#include "expr/zone_map.h"
+#include "../test_util.h"
+#include "gtest/gtest.h"
+using namespace wsdb;
+
+class ZoneMapTest : public ::testing::Test
+{
+protected:
+  void SetUp() override
+  {
+    fields_ = {MakeField("i", TYPE_INT, 4), MakeField("f", TYPE_FLOAT, 4), MakeField("s", TYPE_STRING, 8)};
+    schema_ = std::make_unique<RecordSchema>(fields_);
+  }
+
+  auto MakeRecord(ValueSptr i, ValueSptr f, ValueSptr s) -> RecordUptr
+  {
+    return std::make_unique<Record>(schema_.get(), std::vector<ValueSptr>{std::move(i), std::move(f), std::move(s)},
+        INVALID_RID);
+  }
+
+  /// a page of int values in [lo, hi], float values in [lo / 2, hi / 2] and strings of a single letter
+  auto MakePage(int lo, int hi, bool with_null) -> std::vector<RecordUptr>
+  {
+    std::vector<RecordUptr> records;
+    for (int k = lo; k <= hi; k++) {
+      auto s = std::string(1, static_cast<char>('a' + (k % 26 + 26) % 26));
+      records.push_back(MakeRecord(ValueFactory::CreateIntValue(k),
+          ValueFactory::CreateFloatValue(static_cast<float>(k) / 2),
+          ValueFactory::CreateStringValue(s.c_str(), s.size())));
+    }
+    if (with_null) {
+      records.push_back(MakeRecord(ValueFactory::CreateNullValue(TYPE_INT),
+          ValueFactory::CreateNullValue(TYPE_FLOAT),
+          ValueFactory::CreateNullValue(TYPE_STRING)));
+    }
+    return records;
+  }
+
+  std::vector<RTField> fields_;
+  RecordSchemaUptr     schema_;
+};
+
+TEST_F(ZoneMapTest, Compare)
+{
+  ZoneMap zm(*schema_);
+  auto    page = MakePage(10, 20, false);
+  zm.BuildZone(1, page, zm.GetVersion());
+  ASSERT_TRUE(zm.HasZone(1, schema_.get()));
+  ASSERT_FALSE(zm.HasZone(2, schema_.get()));
+
+  auto skip = [&zm](CompOp op, const RTField &field, ValueSptr val) {
+    return zm.CanSkip(1, {Condition(op, field, val)});
+  };
+  auto int_val = [](int v) { return ValueFactory::CreateIntValue(v); };
+  EXPECT_TRUE(skip(OP_EQ, fields_[0], int_val(9)));
+  EXPECT_FALSE(skip(OP_EQ, fields_[0], int_val(10)));
+  EXPECT_FALSE(skip(OP_EQ, fields_[0], int_val(20)));
+  EXPECT_TRUE(skip(OP_EQ, fields_[0], int_val(21)));
+  EXPECT_TRUE(skip(OP_LT, fields_[0], int_val(10)));
+  EXPECT_FALSE(skip(OP_LT, fields_[0], int_val(11)));
+  EXPECT_TRUE(skip(OP_LE, fields_[0], int_val(9)));
+  EXPECT_FALSE(skip(OP_LE, fields_[0], int_val(10)));
+  EXPECT_TRUE(skip(OP_GT, fields_[0], int_val(20)));
+  EXPECT_FALSE(skip(OP_GT, fields_[0], int_val(19)));
+  EXPECT_TRUE(skip(OP_GE, fields_[0], int_val(21)));
+  EXPECT_FALSE(skip(OP_GE, fields_[0], int_val(20)));
+  EXPECT_FALSE(skip(OP_NE, fields_[0], int_val(15)));
+  // negative values and int constants against a float column
+  EXPECT_TRUE(skip(OP_LT, fields_[1], int_val(-1)));
+  EXPECT_TRUE(skip(OP_GT, fields_[1], ValueFactory::CreateFloatValue(10.5f)));
+  EXPECT_FALSE(skip(OP_GE, fields_[1], ValueFactory::CreateFloatValue(10.0f)));
+  // strings compare as padded bytes
+  EXPECT_TRUE(skip(OP_GT, fields_[2], ValueFactory::CreateStringValue("z", 1)));
+  EXPECT_FALSE(skip(OP_EQ, fields_[2], ValueFactory::CreateStringValue("k", 1)));
+  EXPECT_TRUE(skip(OP_EQ, fields_[2], ValueFactory::CreateStringValue("ua", 2)));
+  // IN is skipped only when every value is out of range
+  EXPECT_TRUE(skip(OP_IN, fields_[0], ValueFactory::CreateArrayValue({int_val(1), int_val(30)})));
+  EXPECT_FALSE(skip(OP_IN, fields_[0], ValueFactory::CreateArrayValue({int_val(1), int_val(15)})));
+  // any skipping conjunct skips the page, column conditions never do
+  ValueSptr zero = int_val(0);
+  ASSERT_TRUE(zm.CanSkip(1, {Condition(OP_GT, fields_[0], fields_[1]), Condition(OP_EQ, fields_[0], zero)}));
+  ASSERT_FALSE(zm.CanSkip(1, {Condition(OP_GT, fields_[0], fields_[1])}));
+  // pages without zones are never skipped
+  ASSERT_FALSE(zm.CanSkip(2, {Condition(OP_EQ, fields_[0], zero)}));
+  ASSERT_EQ(zm.CountSkipped({Condition(OP_EQ, fields_[0], zero)}), 1);
+}
+
+TEST_F(ZoneMapTest, Null)
+{
+  ZoneMap zm(*schema_);
+  auto    page = MakePage(5, 5, true);
+  zm.BuildZone(1, page, zm.GetVersion());
+  ValueSptr five = ValueFactory::CreateIntValue(5);
+  // null <> 5 holds, the single non-null value does not
+  ASSERT_FALSE(zm.CanSkip(1, {Condition(OP_NE, fields_[0], five)}));
+  ASSERT_TRUE(zm.CanSkip(1, {Condition(OP_GT, fields_[0], five)}));
+  // null constants are left to the scan
+  ValueSptr null_val = ValueFactory::CreateNullValue(TYPE_INT);
+  ASSERT_FALSE(zm.CanSkip(1, {Condition(OP_EQ, fields_[0], null_val)}));
+
+  ZoneMap zm_no_null(*schema_);
+  auto    page_no_null = MakePage(5, 5, false);
+  zm_no_null.BuildZone(1, page_no_null, zm_no_null.GetVersion());
+  ASSERT_TRUE(zm_no_null.CanSkip(1, {Condition(OP_NE, fields_[0], five)}));
+}
+
+TEST_F(ZoneMapTest, Maintain)
+{
+  ZoneMap zm(*schema_);
+  auto    page = MakePage(10, 20, false);
+  // a change after the version was taken discards the zone built from the stale page
+  auto version = zm.GetVersion();
+  auto added   = MakeRecord(ValueFactory::CreateIntValue(100),
+      ValueFactory::CreateFloatValue(0.0f),
+      ValueFactory::CreateStringValue("a", 1));
+  zm.Add(1, *added);
+  zm.BuildZone(1, page, version);
+  ASSERT_FALSE(zm.HasZone(1, schema_.get()));
+
+  zm.BuildZone(1, page, zm.GetVersion());
+  ValueSptr hundred = ValueFactory::CreateIntValue(100);
+  ASSERT_TRUE(zm.CanSkip(1, {Condition(OP_EQ, fields_[0], hundred)}));
+  zm.Add(1, *added);
+  ASSERT_FALSE(zm.CanSkip(1, {Condition(OP_EQ, fields_[0], hundred)}));
+
+  // a zone built from a subset of the columns only covers that subset
+  RecordSchema            sub_schema({fields_[0]});
+  std::vector<RecordUptr> sub_page;
+  sub_page.push_back(std::make_unique<Record>(&sub_schema, *page.front()));
+  zm.BuildZone(2, sub_page, zm.GetVersion());
+  ASSERT_TRUE(zm.HasZone(2, &sub_schema));
+  ASSERT_FALSE(zm.HasZone(2, schema_.get()));
+  ValueSptr z = ValueFactory::CreateStringValue("z", 1);
+  ASSERT_FALSE(zm.CanSkip(2, {Condition(OP_EQ, fields_[2], z)}));
+}
+
+TEST_F(ZoneMapTest, Random)
+{
+  std::mt19937                         gen(TEST_SEED);
+  ZoneMap                              zm(*schema_);
+  std::vector<std::vector<RecordUptr>> pages;
+  for (page_id_t p = 0; p < 50; p++) {
+    int lo = static_cast<int>(gen() % 200) - 100;
+    pages.push_back(MakePage(lo, lo + static_cast<int>(gen() % 20), gen() % 2 == 0));
+    zm.BuildZone(p, pages.back(), zm.GetVersion());
+  }
+  // a skipped page must not hold any record satisfying the conditions
+  for (int k = 0; k < 500; k++) {
+    auto         op    = static_cast<CompOp>(OP_EQ + gen() % 6);
+    ValueSptr    val   = ValueFactory::CreateIntValue(static_cast<int>(gen() % 240) - 120);
+    ConditionVec conds = {Condition(op, fields_[gen() % 2], val)};
+    for (page_id_t p = 0; p < 50; p++) {
+      if (zm.CanSkip(p, conds)) {
+        for (const auto &rec : pages[p]) {
+          ASSERT_FALSE(ConditionExpr::Eval(conds, *rec)) << conds.front().ToString() << " " << rec->ToString();
+        }
+      }
+    }
+  }
+}
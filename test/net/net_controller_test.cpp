@@ -0,0 +1,220 @@
+/*------------------------------------------------------------------------------
+ - Copyright (c) 2024. Websoft research group, Nanjing University.
+ -
+ - This program is free software: you can redistribute it and/or modify
+ - it under the terms of the GNU General Public License as published by
+ - the Free Software Foundation, either version 3 of the License, or
+ - (at your option) any later version.
+ -
+ - This program is distributed in the hope that it will be useful,
+ - but WITHOUT ANY WARRANTY; without even the implied warranty of
+ - MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ - GNU General Public License for more details.
+ -
+ - You should have received a copy of the GNU General Public License
+ - along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ -----------------------------------------------------------------------------*/
+
+#include <netinet/in.h>
+#include <sys/socket.h>
+#include <thread>
+#include "net/net_controller.h"
+#include "gtest/gtest.h"
+using namespace wsdb;
+
+static constexpr size_t WORKER_NUM = 4;
+
+/// a server whose statements are commands of the test instead of sql, served by Serve on a port of its own
+class NetControllerTest : public ::testing::Test
+{
+protected:
+  void SetUp() override
+  {
+    ASSERT_EQ(net_.Listen(), 0);
+    server_ = std::thread([this] {
+      net_.Serve(WORKER_NUM, [this](int fd, const std::string &sql) { Handle(fd, sql); }, [this](int) { closed_++; });
+    });
+  }
+
+  void TearDown() override
+  {
+    net_.Stop();
+    server_.join();
+    net_.Close();
+  }
+
+  /**
+   * ECHO <text> answers the text, SET <n> and GET set and show the dop of the session, BIG <n> answers n packages of
+   * 60KB and FAIL fails
+   */
+  void Handle(int fd, const std::string &sql)
+  {
+    if (sql.starts_with("ECHO ")) {
+      net_.SendRawString(fd, sql.substr(5));
+    } else if (sql.starts_with("SET ")) {
+      Session::Current().SetVariable("dop", ValueFactory::CreateIntValue(std::stoi(sql.substr(4))));
+    } else if (sql == "GET") {
+      net_.SendRawString(fd, Session::Current().GetVariable("dop")->ToString());
+    } else if (sql.starts_with("BIG ")) {
+      std::string str(60 * 1024, 'x');
+      for (int i = std::stoi(sql.substr(4)); i > 0; i--) {
+        net_.SendRawString(fd, str);
+      }
+    } else {
+      WSDB_THROW(WSDB_UNSUPPORTED_OP, sql);
+    }
+    net_.SendOK(fd);
+  }
+
+  /// a receive buffer of rcvbuf bytes, if it is not 0, keeps the results a client does not read on the server
+  [[nodiscard]] auto Connect(int rcvbuf = 0) const -> int
+  {
+    int fd = socket(AF_INET, SOCK_STREAM, 0);
+    if (rcvbuf > 0) {
+      setsockopt(fd, SOL_SOCKET, SO_RCVBUF, &rcvbuf, sizeof(rcvbuf));
+    }
+    sockaddr_in addr{};
+    addr.sin_family      = AF_INET;
+    addr.sin_port        = htons(net_.GetPort());
+    addr.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+    EXPECT_EQ(connect(fd, reinterpret_cast<sockaddr *>(&addr), sizeof(addr)), 0);
+    return fd;
+  }
+
+  static void Send(int fd, const std::string &sql)
+  {
+    pkg_.type_ = net::NET_PKG_QUERY;
+    pkg_.len_  = sql.size();
+    memcpy(pkg_.buf_, sql.data(), sql.size());
+    ASSERT_GT(net::WriteNetPkg(fd, pkg_), 0);
+  }
+
+  /// the raw strings answered to a statement, and the error if it failed
+  static auto Receive(int fd, std::string *error = nullptr) -> std::vector<std::string>
+  {
+    std::vector<std::string> strs;
+    while (net::ReadNetPkg(fd, pkg_) > 0) {
+      if (pkg_.type_ == net::NET_PKG_RAW_STRING) {
+        strs.emplace_back(pkg_.buf_, pkg_.len_);
+      } else if (pkg_.type_ == net::NET_PKG_ERROR) {
+        if (error != nullptr) {
+          error->assign(pkg_.buf_, pkg_.len_);
+        }
+        break;
+      } else if (pkg_.type_ == net::NET_PKG_OK) {
+        break;
+      }
+    }
+    return strs;
+  }
+
+  static auto Query(int fd, const std::string &sql) -> std::vector<std::string>
+  {
+    Send(fd, sql);
+    return Receive(fd);
+  }
+
+  NetController      net_{0};
+  std::thread        server_;
+  std::atomic<int>   closed_{0};
+  static net::NetPkg pkg_;
+};
+
+net::NetPkg NetControllerTest::pkg_;
+
+TEST_F(NetControllerTest, Statements)
+{
+  int fd = Connect();
+  EXPECT_EQ(Query(fd, "ECHO a"), std::vector<std::string>{"a"});
+  EXPECT_EQ(Query(fd, "ECHO b"), std::vector<std::string>{"b"});
+  // the connection stays usable after a failed statement
+  std::string error;
+  Send(fd, "FAIL");
+  EXPECT_TRUE(Receive(fd, &error).empty());
+  EXPECT_NE(error.find("FAIL"), std::string::npos);
+  EXPECT_EQ(Query(fd, "ECHO c"), std::vector<std::string>{"c"});
+  // requests sent together are run one after another, in order
+  for (int i = 0; i < 10; i++) {
+    Send(fd, fmt::format("ECHO {}", i));
+  }
+  for (int i = 0; i < 10; i++) {
+    EXPECT_EQ(Receive(fd), std::vector<std::string>{std::to_string(i)});
+  }
+  close(fd);
+}
+
+TEST_F(NetControllerTest, Sessions)
+{
+  // every connection has its own session, whichever worker runs its statements
+  std::vector<int> fds;
+  for (int i = 0; i < 8; i++) {
+    fds.push_back(Connect());
+    EXPECT_TRUE(Query(fds.back(), fmt::format("SET {}", i)).empty());
+  }
+  for (int round = 0; round < 3; round++) {
+    for (int i = 0; i < 8; i++) {
+      EXPECT_EQ(Query(fds[i], "GET"), std::vector<std::string>{std::to_string(i)});
+    }
+  }
+  for (auto fd : fds) {
+    close(fd);
+  }
+  // the loop thread closes the connections
+  for (int i = 0; i < 100 && closed_ < 8; i++) {
+    std::this_thread::sleep_for(std::chrono::milliseconds(10));
+  }
+  EXPECT_EQ(closed_, 8);
+}
+
+TEST_F(NetControllerTest, LargeResult)
+{
+  int  fd   = Connect();
+  auto strs = Query(fd, "BIG 100");
+  ASSERT_EQ(strs.size(), 100U);
+  EXPECT_EQ(strs.front(), std::string(60 * 1024, 'x'));
+  EXPECT_EQ(Query(fd, "ECHO a"), std::vector<std::string>{"a"});
+  close(fd);
+}
+
+TEST_F(NetControllerTest, SlowClients)
+{
+  // clients that never read their results get no more than half of the workers
+  std::vector<int> slow;
+  for (size_t i = 0; i < WORKER_NUM * 2; i++) {
+    slow.push_back(Connect());
+    Send(slow.back(), "BIG 1000");
+  }
+  std::this_thread::sleep_for(std::chrono::milliseconds(100));
+  int  fd    = Connect();
+  auto start = std::chrono::steady_clock::now();
+  for (int i = 0; i < 10; i++) {
+    EXPECT_EQ(Query(fd, "ECHO a"), std::vector<std::string>{"a"});
+  }
+  EXPECT_LT(std::chrono::steady_clock::now() - start, std::chrono::milliseconds(net::NET_WRITE_TIMEOUT_MS / 2));
+  close(fd);
+  for (auto slow_fd : slow) {
+    close(slow_fd);
+  }
+}
+
+TEST_F(NetControllerTest, WriteBudget)
+{
+  // the results of slow clients add up to more than NET_WRITE_BUFFER_TOTAL, the ones with the most are dropped
+  // the socket of the server keeps a few MB of the 15MB each one is sent
+  size_t           client_num = net::NET_WRITE_BUFFER_TOTAL / (10 * 1024 * 1024) + 4;
+  std::vector<int> slow;
+  for (size_t i = 0; i < client_num; i++) {
+    slow.push_back(Connect(4096));
+    Send(slow.back(), "BIG 250");
+  }
+  for (int i = 0; i < 500 && closed_ == 0; i++) {
+    std::this_thread::sleep_for(std::chrono::milliseconds(10));
+  }
+  EXPECT_GT(closed_, 0);
+  int fd = Connect();
+  EXPECT_EQ(Query(fd, "ECHO a"), std::vector<std::string>{"a"});
+  close(fd);
+  for (auto slow_fd : slow) {
+    close(slow_fd);
+  }
+}
@@ -0,0 +1,78 @@
+/*------------------------------------------------------------------------------
+ - Copyright (c) 2024. Websoft research group, Nanjing University.
+ -
+ - This program is free software: you can redistribute it and/or modify
+ - it under the terms of the GNU General Public License as published by
+ - the Free Software Foundation, either version 3 of the License, or
+ - (at your option) any later version.
+ -
+ - This program is distributed in the hope that it will be useful,
+ - but WITHOUT ANY WARRANTY; without even the implied warranty of
+ - MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ - GNU General Public License for more details.
+ -
+ - You should have received a copy of the GNU General Public License
+ - along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ -----------------------------------------------------------------------------*/
+
+#include <cstring>
+#include "common/net/net.h"
+#include "gtest/gtest.h"
+using namespace net;
+
+/// a REC_BODY of an int and a string column: (7, "abc") and (null, "")
+static void MakeBody(NetPkg &pkg)
+{
+  const char data[] = {0, 7, 0, 0, 0, 3, 0, 'a', 'b', 'c', 1, 0, 0};
+  memcpy(pkg.buf_, data, sizeof(data));
+  pkg.type_ = NET_PKG_REC_BODY;
+  pkg.len_  = sizeof(data);
+}
+
+TEST(NetTest, RecHeader)
+{
+  NetPkg pkg;
+  EncodeRecHeader({{NET_FIELD_INT, "id"}, {NET_FIELD_STRING, "name"}}, pkg);
+  std::vector<NetColumn> columns;
+  ASSERT_TRUE(DecodeRecHeader(pkg, columns));
+  ASSERT_EQ(columns.size(), 2);
+  EXPECT_EQ(columns[0].type_, NET_FIELD_INT);
+  EXPECT_EQ(columns[1].name_, "name");
+
+  // every cut of the package ends inside a count, a type or a name
+  auto len = pkg.len_;
+  for (pkg.len_ = 0; pkg.len_ < len; pkg.len_++) {
+    EXPECT_FALSE(DecodeRecHeader(pkg, columns)) << pkg.len_;
+  }
+  // a column count larger than the package can hold
+  uint32_t column_num = 1 << 30;
+  memcpy(pkg.buf_, &column_num, sizeof(column_num));
+  EXPECT_FALSE(DecodeRecHeader(pkg, columns));
+  // a type no column has
+  EncodeRecHeader({{NET_FIELD_INT, ""}}, pkg);
+  pkg.buf_[sizeof(column_num)] = NET_FIELD_STRING + 1;
+  EXPECT_FALSE(DecodeRecHeader(pkg, columns));
+}
+
+TEST(NetTest, RecBody)
+{
+  std::vector<NetColumn> columns = {{NET_FIELD_INT, "id"}, {NET_FIELD_STRING, "name"}};
+  NetPkg                 pkg;
+  MakeBody(pkg);
+  std::vector<std::vector<std::string>> records;
+  ASSERT_TRUE(DecodeRecBody(pkg, columns, records));
+  ASSERT_EQ(records, (std::vector<std::vector<std::string>>{{"7", "abc"}, {"(null)", ""}}));
+
+  // a record cut short is not appended, the ones before it are
+  auto len = pkg.len_;
+  for (pkg.len_ = 1; pkg.len_ < len; pkg.len_++) {
+    records.clear();
+    EXPECT_EQ(DecodeRecBody(pkg, columns, records), pkg.len_ == 10) << pkg.len_;
+    EXPECT_EQ(records.size(), pkg.len_ < 10 ? 0 : 1) << pkg.len_;
+  }
+  // a string longer than what is left of the package
+  MakeBody(pkg);
+  pkg.buf_[5] = 100;
+  records.clear();
+  EXPECT_FALSE(DecodeRecBody(pkg, columns, records));
+}
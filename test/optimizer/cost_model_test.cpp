@@ -0,0 +1,61 @@
+/*------------------------------------------------------------------------------
+ - Copyright (c) 2024. Websoft research group, Nanjing University.
+ -
+ - This program is free software: you can redistribute it and/or modify
+ - it under the terms of the GNU General Public License as published by
+ - the Free Software Foundation, either version 3 of the License, or
+ - (at your option) any later version.
+ -
+ - This program is distributed in the hope that it will be useful,
+ - but WITHOUT ANY WARRANTY; without even the implied warranty of
+ - MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ - GNU General Public License for more details.
+ -
+ - You should have received a copy of the GNU General Public License
+ - along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ -----------------------------------------------------------------------------*/
+
+#include "common/config.h"
+#include "optimizer/cost_model.h"
+#include "gtest/gtest.h"
+using namespace wsdb;
+
+TEST(CostModelTest, AccessPath)
+{
+  // 100000 records of 100 bytes on 2500 pages
+  double pages = 2500, rows = 100000;
+  auto   seq   = CostModel::SeqScanCost(pages, rows, 1);
+  // a point lookup beats reading the table, a range covering a third of it does not
+  EXPECT_LT(CostModel::IndexScanCost(rows, 1, false), seq);
+  EXPECT_GT(CostModel::IndexScanCost(rows, rows / 3, false), seq);
+  // fetching the records in page order is never worse than reading every page
+  EXPECT_LE(CostModel::BitmapHeapCost(pages, rows / 3), pages * SEQ_PAGE_COST + rows / 3 * CPU_TUPLE_COST);
+  EXPECT_LT(CostModel::BitmapHeapCost(pages, 10), CostModel::BitmapHeapCost(pages, 1000));
+}
+
+TEST(CostModelTest, Join)
+{
+  PlanCost small{100, 10, 100};
+  PlanCost large{1000000, 25000, 100};
+  // building the hash table on the small side is cheaper
+  EXPECT_LT(CostModel::HashJoinCost(large, small, 1000000), CostModel::HashJoinCost(small, large, 1000000));
+  // rescanning the large side for every small record is the worst choice
+  EXPECT_GT(CostModel::NestedLoopJoinCost(small, large, 1000000, 1), CostModel::HashJoinCost(large, small, 1000000));
+  // a few outer records probing an index beat reading the inner table
+  EXPECT_LT(CostModel::IndexJoinCost(small, large.rows_, 100), CostModel::HashJoinCost(small, large, 100));
+  // sorted inputs make a merge join cheaper
+  EXPECT_LT(CostModel::SortMergeJoinCost(large, large, 1000000, false, false),
+      CostModel::SortMergeJoinCost(large, large, 1000000, true, true));
+}
+
+TEST(CostModelTest, Spill)
+{
+  // sorting or hashing more than the memory budget writes and reads the input again
+  auto     in_memory = static_cast<double>(SORT_BUFFER_SIZE) / 200;
+  PlanCost fits{in_memory, 0, 100};
+  PlanCost spills{in_memory * 4, 0, 100};
+  EXPECT_GT(CostModel::SortCost(spills) - 4 * CostModel::SortCost(fits), 2 * spills.rows_ * 100 / PAGE_SIZE);
+  PlanCost probe{1000, 0, 100};
+  EXPECT_GT(CostModel::HashJoinCost(probe, spills, 1000) - CostModel::HashJoinCost(probe, fits, 1000),
+      2 * spills.rows_ * 100 / PAGE_SIZE);
+}
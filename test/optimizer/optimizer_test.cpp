@@ -0,0 +1,180 @@
+/*------------------------------------------------------------------------------
+ - Copyright (c) 2024. Websoft research group, Nanjing University.
+ -
+ - This program is free software: you can redistribute it and/or modify
+ - it under the terms of the GNU General Public License as published by
+ - the Free Software Foundation, either version 3 of the License, or
+ - (at your option) any later version.
+ -
+ - This program is distributed in the hope that it will be useful,
+ - but WITHOUT ANY WARRANTY; without even the implied warranty of
+ - MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ - GNU General Public License for more details.
+ -
+ - You should have received a copy of the GNU General Public License
+ - along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ -----------------------------------------------------------------------------*/
+
+#include <set>
+#include "optimizer/optimizer.h"
+#include "gtest/gtest.h"
+using namespace wsdb;
+
+namespace wsdb {
+/// the plans are built by hand without a database, so they only use table scans, filters, sorts and joins
+class OptimizerTest : public ::testing::Test
+{
+protected:
+  static auto IsOrderedOn(const std::shared_ptr<AbstractPlan> &plan, const std::vector<RTField> &keys) -> bool
+  {
+    return Optimizer::IsOrderedOn(plan, keys, nullptr);
+  }
+
+  static void OrderJoinKeys(const std::shared_ptr<JoinPlan> &join) { Optimizer::OrderJoinKeys(join, nullptr); }
+
+  /// the conditions InferConditions appends to conds, as strings
+  static auto Infer(ConditionVec conds) -> std::set<std::string>
+  {
+    auto given = conds.size();
+    Optimizer::InferConditions(conds);
+    std::set<std::string> inferred;
+    for (size_t i = given; i < conds.size(); i++) {
+      inferred.insert(conds[i].ToString());
+    }
+    return inferred;
+  }
+
+  static auto Col(table_id_t table_id, const std::string &name) -> RTField
+  {
+    RTField f;
+    f.field_.table_id_   = table_id;
+    f.field_.field_name_ = name;
+    f.field_.field_type_ = TYPE_INT;
+    f.field_.field_size_ = sizeof(int);
+    return f;
+  }
+
+  static auto Sorted(const std::string &table_name, const std::vector<RTField> &keys) -> std::shared_ptr<AbstractPlan>
+  {
+    return std::make_shared<SortPlan>(
+        std::make_shared<ScanPlan>(table_name), std::make_unique<RecordSchema>(keys), false);
+  }
+
+  static auto Join(std::shared_ptr<AbstractPlan> left, std::shared_ptr<AbstractPlan> right, ConditionVec conds,
+      JoinType type, JoinStrategy strategy) -> std::shared_ptr<JoinPlan>
+  {
+    return std::make_shared<JoinPlan>(std::move(left), std::move(right), conds, type, strategy);
+  }
+
+  RTField a_id_ = Col(1, "id");
+  RTField a_v_  = Col(1, "v");
+  RTField b_id_ = Col(2, "id");
+  RTField b_w_  = Col(2, "w");
+  RTField c_x_  = Col(3, "x");
+};
+}  // namespace wsdb
+
+TEST_F(OptimizerTest, SortOrder)
+{
+  auto sorted = Sorted("a", {a_id_, a_v_});
+  EXPECT_TRUE(IsOrderedOn(sorted, {a_id_}));
+  EXPECT_TRUE(IsOrderedOn(sorted, {a_id_, a_v_}));
+  EXPECT_FALSE(IsOrderedOn(sorted, {a_v_}));
+  EXPECT_FALSE(IsOrderedOn(sorted, {a_v_, a_id_}));
+  EXPECT_FALSE(IsOrderedOn(std::make_shared<ScanPlan>("a"), {a_id_}));
+  // a descending sort is not ascending on anything
+  auto desc = std::make_shared<SortPlan>(
+      std::make_shared<ScanPlan>("a"), std::make_unique<RecordSchema>(std::vector<RTField>{a_id_}), true);
+  EXPECT_FALSE(IsOrderedOn(desc, {a_id_}));
+  // a field with one value can be skipped in the order and in the keys
+  ValueSptr val = ValueFactory::CreateIntValue(5);
+  auto pinned = std::make_shared<FilterPlan>(sorted, ConditionVec{Condition(OP_EQ, a_id_, val)});
+  EXPECT_TRUE(IsOrderedOn(pinned, {a_v_}));
+  EXPECT_TRUE(IsOrderedOn(pinned, {a_v_, a_id_}));
+  auto range = std::make_shared<FilterPlan>(sorted, ConditionVec{Condition(OP_GT, a_id_, val)});
+  EXPECT_FALSE(IsOrderedOn(range, {a_v_}));
+}
+
+TEST_F(OptimizerTest, JoinOrder)
+{
+  // nested loop and hash joins produce the records in the order of their left side
+  for (auto strategy : {NESTED_LOOP, HASH_JOIN}) {
+    auto join =
+        Join(Sorted("a", {a_id_}), Sorted("b", {b_w_}), {Condition(OP_EQ, a_v_, b_id_)}, INNER_JOIN, strategy);
+    EXPECT_TRUE(IsOrderedOn(join, {a_id_}));
+    EXPECT_FALSE(IsOrderedOn(join, {b_w_}));
+  }
+  // an index nested loop join probes a batch of left records in key order, the order of the left side is lost
+  auto index_join =
+      Join(Sorted("a", {a_id_}), std::make_shared<ScanPlan>("b"), {Condition(OP_EQ, a_v_, b_id_)}, INNER_JOIN,
+          INDEX_NESTED_LOOP);
+  EXPECT_FALSE(IsOrderedOn(index_join, {a_id_}));
+  EXPECT_FALSE(IsOrderedOn(index_join, {a_v_}));
+  // a constant pinned on the right side of an inner join holds in every joined record
+  ValueSptr val = ValueFactory::CreateIntValue(5);
+  auto right =
+      std::make_shared<FilterPlan>(std::make_shared<ScanPlan>("b"), ConditionVec{Condition(OP_EQ, b_w_, val)});
+  auto pinned = Join(Sorted("a", {a_id_}), right, {Condition(OP_EQ, a_v_, b_id_)}, INNER_JOIN, NESTED_LOOP);
+  EXPECT_TRUE(IsOrderedOn(pinned, {b_w_, a_id_}));
+  auto outer = Join(Sorted("a", {a_id_}), right, {Condition(OP_EQ, a_v_, b_id_)}, OUTER_JOIN, NESTED_LOOP);
+  EXPECT_TRUE(IsOrderedOn(outer, {a_id_}));
+  EXPECT_FALSE(IsOrderedOn(outer, {b_w_, a_id_}));
+}
+
+TEST_F(OptimizerTest, MergeJoinOrder)
+{
+  // a sort merge join is ordered on its left keys whatever the order of its inputs
+  auto join = Join(Sorted("a", {a_v_}),
+      Sorted("b", {b_id_}),
+      {Condition(OP_EQ, a_v_, b_id_), Condition(OP_EQ, a_id_, b_w_)},
+      INNER_JOIN,
+      SORT_MERGE);
+  EXPECT_TRUE(IsOrderedOn(join, {a_v_}));
+  EXPECT_TRUE(IsOrderedOn(join, {a_v_, a_id_}));
+  EXPECT_FALSE(IsOrderedOn(join, {a_id_}));
+  // the keys follow the order one side already has, so that side needs no sort
+  auto swapped = Join(Sorted("a", {a_id_, a_v_}),
+      std::make_shared<ScanPlan>("b"),
+      {Condition(OP_EQ, a_v_, b_id_), Condition(OP_EQ, a_id_, b_w_)},
+      INNER_JOIN,
+      SORT_MERGE);
+  OrderJoinKeys(swapped);
+  ASSERT_EQ(swapped->conds_.size(), 2U);
+  EXPECT_EQ(swapped->conds_[0].GetLCol(), a_id_);
+  EXPECT_EQ(swapped->conds_[1].GetLCol(), a_v_);
+  EXPECT_TRUE(IsOrderedOn(swapped->left_, {a_id_, a_v_}));
+  EXPECT_TRUE(IsOrderedOn(swapped, {a_id_, a_v_}));
+  // with the order of the right side when the left side has none
+  auto right_sorted = Join(std::make_shared<ScanPlan>("a"),
+      Sorted("b", {b_w_}),
+      {Condition(OP_EQ, a_v_, b_id_), Condition(OP_EQ, a_id_, b_w_)},
+      INNER_JOIN,
+      SORT_MERGE);
+  OrderJoinKeys(right_sorted);
+  EXPECT_EQ(right_sorted->conds_[0].GetRCol(), b_w_);
+  EXPECT_TRUE(IsOrderedOn(right_sorted->right_, {b_w_}));
+}
+
+TEST_F(OptimizerTest, InferConditions)
+{
+  // a.v = b.id AND b.id = 5 gives a.v = 5, so both sides can be filtered before the join
+  ValueSptr val = ValueFactory::CreateIntValue(5);
+  EXPECT_EQ(Infer({Condition(OP_EQ, a_v_, b_id_), Condition(OP_EQ, b_id_, val)}),
+      std::set<std::string>{Condition(OP_EQ, a_v_, val).ToString()});
+  // every comparison with a constant is copied, whichever side of the equality the compared column is on
+  EXPECT_EQ(Infer({Condition(OP_EQ, a_v_, b_id_), Condition(OP_GT, a_v_, val), Condition(OP_LE, b_id_, val)}),
+      (std::set<std::string>{Condition(OP_GT, b_id_, val).ToString(), Condition(OP_LE, a_v_, val).ToString()}));
+  // the equalities are closed transitively, the known ones are not added again in either direction
+  EXPECT_EQ(Infer({Condition(OP_EQ, a_v_, b_id_), Condition(OP_EQ, c_x_, b_id_)}),
+      std::set<std::string>{Condition(OP_EQ, a_v_, c_x_).ToString()});
+  EXPECT_TRUE(
+      Infer({Condition(OP_EQ, a_v_, b_id_), Condition(OP_EQ, b_id_, c_x_), Condition(OP_EQ, c_x_, a_v_)}).empty());
+  // other comparisons between columns imply nothing
+  EXPECT_TRUE(Infer({Condition(OP_LT, a_v_, b_id_), Condition(OP_EQ, b_id_, val)}).empty());
+  // columns of one table are not joined with themselves
+  EXPECT_TRUE(Infer({Condition(OP_EQ, a_id_, a_v_)}).empty());
+  // an aggregate is only known after the join, nothing is inferred from it
+  auto sum    = b_w_;
+  sum.is_agg_ = true;
+  EXPECT_TRUE(Infer({Condition(OP_EQ, a_v_, sum), Condition(OP_EQ, sum, val)}).empty());
+}
@@ -0,0 +1,1421 @@
+create database db2024;
+open database db2024;
+create table t1 (id int, v int);
+create table t2 (id int, w int);
+insert into t1 values (1, 7);
+insert into t1 values (368, 76);
+insert into t1 values (735, 45);
+insert into t1 values (102, 14);
+insert into t1 values (469, 83);
+insert into t1 values (836, 52);
+insert into t1 values (203, 21);
+insert into t1 values (570, 90);
+insert into t1 values (937, 59);
+insert into t1 values (304, 28);
+insert into t1 values (671, 97);
+insert into t1 values (38, 66);
+insert into t1 values (405, 35);
+insert into t1 values (772, 4);
+insert into t1 values (139, 73);
+insert into t1 values (506, 42);
+insert into t1 values (873, 11);
+insert into t1 values (240, 80);
+insert into t1 values (607, 49);
+insert into t1 values (974, 18);
+insert into t1 values (341, 87);
+insert into t1 values (708, 56);
+insert into t1 values (75, 25);
+insert into t1 values (442, 94);
+insert into t1 values (809, 63);
+insert into t1 values (176, 32);
+insert into t1 values (543, 1);
+insert into t1 values (910, 70);
+insert into t1 values (277, 39);
+insert into t1 values (644, 8);
+insert into t1 values (11, 77);
+insert into t1 values (378, 46);
+insert into t1 values (745, 15);
+insert into t1 values (112, 84);
+insert into t1 values (479, 53);
+insert into t1 values (846, 22);
+insert into t1 values (213, 91);
+insert into t1 values (580, 60);
+insert into t1 values (947, 29);
+insert into t1 values (314, 98);
+insert into t1 values (681, 67);
+insert into t1 values (48, 36);
+insert into t1 values (415, 5);
+insert into t1 values (782, 74);
+insert into t1 values (149, 43);
+insert into t1 values (516, 12);
+insert into t1 values (883, 81);
+insert into t1 values (250, 50);
+insert into t1 values (617, 19);
+insert into t1 values (984, 88);
+insert into t1 values (351, 57);
+insert into t1 values (718, 26);
+insert into t1 values (85, 95);
+insert into t1 values (452, 64);
+insert into t1 values (819, 33);
+insert into t1 values (186, 2);
+insert into t1 values (553, 71);
+insert into t1 values (920, 40);
+insert into t1 values (287, 9);
+insert into t1 values (654, 78);
+insert into t1 values (21, 47);
+insert into t1 values (388, 16);
+insert into t1 values (755, 85);
+insert into t1 values (122, 54);
+insert into t1 values (489, 23);
+insert into t1 values (856, 92);
+insert into t1 values (223, 61);
+insert into t1 values (590, 30);
+insert into t1 values (957, 99);
+insert into t1 values (324, 68);
+insert into t1 values (691, 37);
+insert into t1 values (58, 6);
+insert into t1 values (425, 75);
+insert into t1 values (792, 44);
+insert into t1 values (159, 13);
+insert into t1 values (526, 82);
+insert into t1 values (893, 51);
+insert into t1 values (260, 20);
+insert into t1 values (627, 89);
+insert into t1 values (994, 58);
+insert into t1 values (361, 27);
+insert into t1 values (728, 96);
+insert into t1 values (95, 65);
+insert into t1 values (462, 34);
+insert into t1 values (829, 3);
+insert into t1 values (196, 72);
+insert into t1 values (563, 41);
+insert into t1 values (930, 10);
+insert into t1 values (297, 79);
+insert into t1 values (664, 48);
+insert into t1 values (31, 17);
+insert into t1 values (398, 86);
+insert into t1 values (765, 55);
+insert into t1 values (132, 24);
+insert into t1 values (499, 93);
+insert into t1 values (866, 62);
+insert into t1 values (233, 31);
+insert into t1 values (600, 0);
+insert into t1 values (967, 69);
+insert into t1 values (334, 38);
+insert into t1 values (701, 7);
+insert into t1 values (68, 76);
+insert into t1 values (435, 45);
+insert into t1 values (802, 14);
+insert into t1 values (169, 83);
+insert into t1 values (536, 52);
+insert into t1 values (903, 21);
+insert into t1 values (270, 90);
+insert into t1 values (637, 59);
+insert into t1 values (4, 28);
+insert into t1 values (371, 97);
+insert into t1 values (738, 66);
+insert into t1 values (105, 35);
+insert into t1 values (472, 4);
+insert into t1 values (839, 73);
+insert into t1 values (206, 42);
+insert into t1 values (573, 11);
+insert into t1 values (940, 80);
+insert into t1 values (307, 49);
+insert into t1 values (674, 18);
+insert into t1 values (41, 87);
+insert into t1 values (408, 56);
+insert into t1 values (775, 25);
+insert into t1 values (142, 94);
+insert into t1 values (509, 63);
+insert into t1 values (876, 32);
+insert into t1 values (243, 1);
+insert into t1 values (610, 70);
+insert into t1 values (977, 39);
+insert into t1 values (344, 8);
+insert into t1 values (711, 77);
+insert into t1 values (78, 46);
+insert into t1 values (445, 15);
+insert into t1 values (812, 84);
+insert into t1 values (179, 53);
+insert into t1 values (546, 22);
+insert into t1 values (913, 91);
+insert into t1 values (280, 60);
+insert into t1 values (647, 29);
+insert into t1 values (14, 98);
+insert into t1 values (381, 67);
+insert into t1 values (748, 36);
+insert into t1 values (115, 5);
+insert into t1 values (482, 74);
+insert into t1 values (849, 43);
+insert into t1 values (216, 12);
+insert into t1 values (583, 81);
+insert into t1 values (950, 50);
+insert into t1 values (317, 19);
+insert into t1 values (684, 88);
+insert into t1 values (51, 57);
+insert into t1 values (418, 26);
+insert into t1 values (785, 95);
+insert into t1 values (152, 64);
+insert into t1 values (519, 33);
+insert into t1 values (886, 2);
+insert into t1 values (253, 71);
+insert into t1 values (620, 40);
+insert into t1 values (987, 9);
+insert into t1 values (354, 78);
+insert into t1 values (721, 47);
+insert into t1 values (88, 16);
+insert into t1 values (455, 85);
+insert into t1 values (822, 54);
+insert into t1 values (189, 23);
+insert into t1 values (556, 92);
+insert into t1 values (923, 61);
+insert into t1 values (290, 30);
+insert into t1 values (657, 99);
+insert into t1 values (24, 68);
+insert into t1 values (391, 37);
+insert into t1 values (758, 6);
+insert into t1 values (125, 75);
+insert into t1 values (492, 44);
+insert into t1 values (859, 13);
+insert into t1 values (226, 82);
+insert into t1 values (593, 51);
+insert into t1 values (960, 20);
+insert into t1 values (327, 89);
+insert into t1 values (694, 58);
+insert into t1 values (61, 27);
+insert into t1 values (428, 96);
+insert into t1 values (795, 65);
+insert into t1 values (162, 34);
+insert into t1 values (529, 3);
+insert into t1 values (896, 72);
+insert into t1 values (263, 41);
+insert into t1 values (630, 10);
+insert into t1 values (997, 79);
+insert into t1 values (364, 48);
+insert into t1 values (731, 17);
+insert into t1 values (98, 86);
+insert into t1 values (465, 55);
+insert into t1 values (832, 24);
+insert into t1 values (199, 93);
+insert into t1 values (566, 62);
+insert into t1 values (933, 31);
+insert into t1 values (300, 0);
+insert into t1 values (667, 69);
+insert into t1 values (34, 38);
+insert into t1 values (401, 7);
+insert into t1 values (768, 76);
+insert into t1 values (135, 45);
+insert into t1 values (502, 14);
+insert into t1 values (869, 83);
+insert into t1 values (236, 52);
+insert into t1 values (603, 21);
+insert into t1 values (970, 90);
+insert into t1 values (337, 59);
+insert into t1 values (704, 28);
+insert into t1 values (71, 97);
+insert into t1 values (438, 66);
+insert into t1 values (805, 35);
+insert into t1 values (172, 4);
+insert into t1 values (539, 73);
+insert into t1 values (906, 42);
+insert into t1 values (273, 11);
+insert into t1 values (640, 80);
+insert into t1 values (7, 49);
+insert into t1 values (374, 18);
+insert into t1 values (741, 87);
+insert into t1 values (108, 56);
+insert into t1 values (475, 25);
+insert into t1 values (842, 94);
+insert into t1 values (209, 63);
+insert into t1 values (576, 32);
+insert into t1 values (943, 1);
+insert into t1 values (310, 70);
+insert into t1 values (677, 39);
+insert into t1 values (44, 8);
+insert into t1 values (411, 77);
+insert into t1 values (778, 46);
+insert into t1 values (145, 15);
+insert into t1 values (512, 84);
+insert into t1 values (879, 53);
+insert into t1 values (246, 22);
+insert into t1 values (613, 91);
+insert into t1 values (980, 60);
+insert into t1 values (347, 29);
+insert into t1 values (714, 98);
+insert into t1 values (81, 67);
+insert into t1 values (448, 36);
+insert into t1 values (815, 5);
+insert into t1 values (182, 74);
+insert into t1 values (549, 43);
+insert into t1 values (916, 12);
+insert into t1 values (283, 81);
+insert into t1 values (650, 50);
+insert into t1 values (17, 19);
+insert into t1 values (384, 88);
+insert into t1 values (751, 57);
+insert into t1 values (118, 26);
+insert into t1 values (485, 95);
+insert into t1 values (852, 64);
+insert into t1 values (219, 33);
+insert into t1 values (586, 2);
+insert into t1 values (953, 71);
+insert into t1 values (320, 40);
+insert into t1 values (687, 9);
+insert into t1 values (54, 78);
+insert into t1 values (421, 47);
+insert into t1 values (788, 16);
+insert into t1 values (155, 85);
+insert into t1 values (522, 54);
+insert into t1 values (889, 23);
+insert into t1 values (256, 92);
+insert into t1 values (623, 61);
+insert into t1 values (990, 30);
+insert into t1 values (357, 99);
+insert into t1 values (724, 68);
+insert into t1 values (91, 37);
+insert into t1 values (458, 6);
+insert into t1 values (825, 75);
+insert into t1 values (192, 44);
+insert into t1 values (559, 13);
+insert into t1 values (926, 82);
+insert into t1 values (293, 51);
+insert into t1 values (660, 20);
+insert into t1 values (27, 89);
+insert into t1 values (394, 58);
+insert into t1 values (761, 27);
+insert into t1 values (128, 96);
+insert into t1 values (495, 65);
+insert into t1 values (862, 34);
+insert into t1 values (229, 3);
+insert into t1 values (596, 72);
+insert into t1 values (963, 41);
+insert into t1 values (330, 10);
+insert into t1 values (697, 79);
+insert into t1 values (64, 48);
+insert into t1 values (431, 17);
+insert into t1 values (798, 86);
+insert into t1 values (165, 55);
+insert into t1 values (532, 24);
+insert into t1 values (899, 93);
+insert into t1 values (266, 62);
+insert into t1 values (633, 31);
+insert into t1 values (1000, 0);
+insert into t1 values (367, 69);
+insert into t1 values (734, 38);
+insert into t1 values (101, 7);
+insert into t1 values (468, 76);
+insert into t1 values (835, 45);
+insert into t1 values (202, 14);
+insert into t1 values (569, 83);
+insert into t1 values (936, 52);
+insert into t1 values (303, 21);
+insert into t1 values (670, 90);
+insert into t1 values (37, 59);
+insert into t1 values (404, 28);
+insert into t1 values (771, 97);
+insert into t1 values (138, 66);
+insert into t1 values (505, 35);
+insert into t1 values (872, 4);
+insert into t1 values (239, 73);
+insert into t1 values (606, 42);
+insert into t1 values (973, 11);
+insert into t1 values (340, 80);
+insert into t1 values (707, 49);
+insert into t1 values (74, 18);
+insert into t1 values (441, 87);
+insert into t1 values (808, 56);
+insert into t1 values (175, 25);
+insert into t1 values (542, 94);
+insert into t1 values (909, 63);
+insert into t1 values (276, 32);
+insert into t1 values (643, 1);
+insert into t1 values (10, 70);
+insert into t1 values (377, 39);
+insert into t1 values (744, 8);
+insert into t1 values (111, 77);
+insert into t1 values (478, 46);
+insert into t1 values (845, 15);
+insert into t1 values (212, 84);
+insert into t1 values (579, 53);
+insert into t1 values (946, 22);
+insert into t1 values (313, 91);
+insert into t1 values (680, 60);
+insert into t1 values (47, 29);
+insert into t1 values (414, 98);
+insert into t1 values (781, 67);
+insert into t1 values (148, 36);
+insert into t1 values (515, 5);
+insert into t1 values (882, 74);
+insert into t1 values (249, 43);
+insert into t1 values (616, 12);
+insert into t1 values (983, 81);
+insert into t1 values (350, 50);
+insert into t1 values (717, 19);
+insert into t1 values (84, 88);
+insert into t1 values (451, 57);
+insert into t1 values (818, 26);
+insert into t1 values (185, 95);
+insert into t1 values (552, 64);
+insert into t1 values (919, 33);
+insert into t1 values (286, 2);
+insert into t1 values (653, 71);
+insert into t1 values (20, 40);
+insert into t1 values (387, 9);
+insert into t1 values (754, 78);
+insert into t1 values (121, 47);
+insert into t1 values (488, 16);
+insert into t1 values (855, 85);
+insert into t1 values (222, 54);
+insert into t1 values (589, 23);
+insert into t1 values (956, 92);
+insert into t1 values (323, 61);
+insert into t1 values (690, 30);
+insert into t1 values (57, 99);
+insert into t1 values (424, 68);
+insert into t1 values (791, 37);
+insert into t1 values (158, 6);
+insert into t1 values (525, 75);
+insert into t1 values (892, 44);
+insert into t1 values (259, 13);
+insert into t1 values (626, 82);
+insert into t1 values (993, 51);
+insert into t1 values (360, 20);
+insert into t1 values (727, 89);
+insert into t1 values (94, 58);
+insert into t1 values (461, 27);
+insert into t1 values (828, 96);
+insert into t1 values (195, 65);
+insert into t1 values (562, 34);
+insert into t1 values (929, 3);
+insert into t1 values (296, 72);
+insert into t1 values (663, 41);
+insert into t1 values (30, 10);
+insert into t1 values (397, 79);
+insert into t1 values (764, 48);
+insert into t1 values (131, 17);
+insert into t1 values (498, 86);
+insert into t1 values (865, 55);
+insert into t1 values (232, 24);
+insert into t1 values (599, 93);
+insert into t1 values (966, 62);
+insert into t1 values (333, 31);
+insert into t1 values (700, 0);
+insert into t1 values (67, 69);
+insert into t1 values (434, 38);
+insert into t1 values (801, 7);
+insert into t1 values (168, 76);
+insert into t1 values (535, 45);
+insert into t1 values (902, 14);
+insert into t1 values (269, 83);
+insert into t1 values (636, 52);
+insert into t1 values (3, 21);
+insert into t1 values (370, 90);
+insert into t1 values (737, 59);
+insert into t1 values (104, 28);
+insert into t1 values (471, 97);
+insert into t1 values (838, 66);
+insert into t1 values (205, 35);
+insert into t1 values (572, 4);
+insert into t1 values (939, 73);
+insert into t1 values (306, 42);
+insert into t1 values (673, 11);
+insert into t1 values (40, 80);
+insert into t1 values (407, 49);
+insert into t1 values (774, 18);
+insert into t1 values (141, 87);
+insert into t1 values (508, 56);
+insert into t1 values (875, 25);
+insert into t1 values (242, 94);
+insert into t1 values (609, 63);
+insert into t1 values (976, 32);
+insert into t1 values (343, 1);
+insert into t1 values (710, 70);
+insert into t1 values (77, 39);
+insert into t1 values (444, 8);
+insert into t1 values (811, 77);
+insert into t1 values (178, 46);
+insert into t1 values (545, 15);
+insert into t1 values (912, 84);
+insert into t1 values (279, 53);
+insert into t1 values (646, 22);
+insert into t1 values (13, 91);
+insert into t1 values (380, 60);
+insert into t1 values (747, 29);
+insert into t1 values (114, 98);
+insert into t1 values (481, 67);
+insert into t1 values (848, 36);
+insert into t1 values (215, 5);
+insert into t1 values (582, 74);
+insert into t1 values (949, 43);
+insert into t1 values (316, 12);
+insert into t1 values (683, 81);
+insert into t1 values (50, 50);
+insert into t1 values (417, 19);
+insert into t1 values (784, 88);
+insert into t1 values (151, 57);
+insert into t1 values (518, 26);
+insert into t1 values (885, 95);
+insert into t1 values (252, 64);
+insert into t1 values (619, 33);
+insert into t1 values (986, 2);
+insert into t1 values (353, 71);
+insert into t1 values (720, 40);
+insert into t1 values (87, 9);
+insert into t1 values (454, 78);
+insert into t1 values (821, 47);
+insert into t1 values (188, 16);
+insert into t1 values (555, 85);
+insert into t1 values (922, 54);
+insert into t1 values (289, 23);
+insert into t1 values (656, 92);
+insert into t1 values (23, 61);
+insert into t1 values (390, 30);
+insert into t1 values (757, 99);
+insert into t1 values (124, 68);
+insert into t1 values (491, 37);
+insert into t1 values (858, 6);
+insert into t1 values (225, 75);
+insert into t1 values (592, 44);
+insert into t1 values (959, 13);
+insert into t1 values (326, 82);
+insert into t1 values (693, 51);
+insert into t1 values (60, 20);
+insert into t1 values (427, 89);
+insert into t1 values (794, 58);
+insert into t1 values (161, 27);
+insert into t1 values (528, 96);
+insert into t1 values (895, 65);
+insert into t1 values (262, 34);
+insert into t1 values (629, 3);
+insert into t1 values (996, 72);
+insert into t1 values (363, 41);
+insert into t1 values (730, 10);
+insert into t1 values (97, 79);
+insert into t1 values (464, 48);
+insert into t1 values (831, 17);
+insert into t1 values (198, 86);
+insert into t1 values (565, 55);
+insert into t1 values (932, 24);
+insert into t1 values (299, 93);
+insert into t1 values (666, 62);
+insert into t1 values (33, 31);
+insert into t1 values (400, 0);
+insert into t1 values (767, 69);
+insert into t1 values (134, 38);
+insert into t1 values (501, 7);
+insert into t1 values (868, 76);
+insert into t1 values (235, 45);
+insert into t1 values (602, 14);
+insert into t1 values (969, 83);
+insert into t1 values (336, 52);
+insert into t1 values (703, 21);
+insert into t1 values (70, 90);
+insert into t1 values (437, 59);
+insert into t1 values (804, 28);
+insert into t1 values (171, 97);
+insert into t1 values (538, 66);
+insert into t1 values (905, 35);
+insert into t1 values (272, 4);
+insert into t1 values (639, 73);
+insert into t1 values (6, 42);
+insert into t1 values (373, 11);
+insert into t1 values (740, 80);
+insert into t1 values (107, 49);
+insert into t1 values (474, 18);
+insert into t1 values (841, 87);
+insert into t1 values (208, 56);
+insert into t1 values (575, 25);
+insert into t1 values (942, 94);
+insert into t1 values (309, 63);
+insert into t1 values (676, 32);
+insert into t1 values (43, 1);
+insert into t1 values (410, 70);
+insert into t1 values (777, 39);
+insert into t1 values (144, 8);
+insert into t1 values (511, 77);
+insert into t1 values (878, 46);
+insert into t1 values (245, 15);
+insert into t1 values (612, 84);
+insert into t1 values (979, 53);
+insert into t1 values (346, 22);
+insert into t1 values (713, 91);
+insert into t1 values (80, 60);
+insert into t1 values (447, 29);
+insert into t1 values (814, 98);
+insert into t1 values (181, 67);
+insert into t1 values (548, 36);
+insert into t1 values (915, 5);
+insert into t1 values (282, 74);
+insert into t1 values (649, 43);
+insert into t1 values (16, 12);
+insert into t1 values (383, 81);
+insert into t1 values (750, 50);
+insert into t1 values (117, 19);
+insert into t1 values (484, 88);
+insert into t1 values (851, 57);
+insert into t1 values (218, 26);
+insert into t1 values (585, 95);
+insert into t1 values (952, 64);
+insert into t1 values (319, 33);
+insert into t1 values (686, 2);
+insert into t1 values (53, 71);
+insert into t1 values (420, 40);
+insert into t1 values (787, 9);
+insert into t1 values (154, 78);
+insert into t1 values (521, 47);
+insert into t1 values (888, 16);
+insert into t1 values (255, 85);
+insert into t1 values (622, 54);
+insert into t1 values (989, 23);
+insert into t1 values (356, 92);
+insert into t1 values (723, 61);
+insert into t1 values (90, 30);
+insert into t1 values (457, 99);
+insert into t1 values (824, 68);
+insert into t1 values (191, 37);
+insert into t1 values (558, 6);
+insert into t1 values (925, 75);
+insert into t1 values (292, 44);
+insert into t1 values (659, 13);
+insert into t1 values (26, 82);
+insert into t1 values (393, 51);
+insert into t1 values (760, 20);
+insert into t1 values (127, 89);
+insert into t1 values (494, 58);
+insert into t1 values (861, 27);
+insert into t1 values (228, 96);
+insert into t1 values (595, 65);
+insert into t1 values (962, 34);
+insert into t1 values (329, 3);
+insert into t1 values (696, 72);
+insert into t1 values (63, 41);
+insert into t1 values (430, 10);
+insert into t1 values (797, 79);
+insert into t1 values (164, 48);
+insert into t1 values (531, 17);
+insert into t1 values (898, 86);
+insert into t1 values (265, 55);
+insert into t1 values (632, 24);
+insert into t1 values (999, 93);
+insert into t1 values (366, 62);
+insert into t1 values (733, 31);
+insert into t1 values (100, 0);
+insert into t1 values (467, 69);
+insert into t1 values (834, 38);
+insert into t1 values (201, 7);
+insert into t1 values (568, 76);
+insert into t1 values (935, 45);
+insert into t1 values (302, 14);
+insert into t1 values (669, 83);
+insert into t1 values (36, 52);
+insert into t1 values (403, 21);
+insert into t1 values (770, 90);
+insert into t1 values (137, 59);
+insert into t1 values (504, 28);
+insert into t1 values (871, 97);
+insert into t1 values (238, 66);
+insert into t1 values (605, 35);
+insert into t1 values (972, 4);
+insert into t1 values (339, 73);
+insert into t1 values (706, 42);
+insert into t1 values (73, 11);
+insert into t1 values (440, 80);
+insert into t1 values (807, 49);
+insert into t1 values (174, 18);
+insert into t1 values (541, 87);
+insert into t1 values (908, 56);
+insert into t1 values (275, 25);
+insert into t1 values (642, 94);
+insert into t1 values (9, 63);
+insert into t1 values (376, 32);
+insert into t1 values (743, 1);
+insert into t1 values (110, 70);
+insert into t1 values (477, 39);
+insert into t1 values (844, 8);
+insert into t1 values (211, 77);
+insert into t1 values (578, 46);
+insert into t1 values (945, 15);
+insert into t1 values (312, 84);
+insert into t1 values (679, 53);
+insert into t1 values (46, 22);
+insert into t1 values (413, 91);
+insert into t1 values (780, 60);
+insert into t1 values (147, 29);
+insert into t1 values (514, 98);
+insert into t1 values (881, 67);
+insert into t1 values (248, 36);
+insert into t1 values (615, 5);
+insert into t1 values (982, 74);
+insert into t1 values (349, 43);
+insert into t1 values (716, 12);
+insert into t1 values (83, 81);
+insert into t1 values (450, 50);
+insert into t1 values (817, 19);
+insert into t1 values (184, 88);
+insert into t1 values (551, 57);
+insert into t1 values (918, 26);
+insert into t1 values (285, 95);
+insert into t1 values (652, 64);
+insert into t1 values (19, 33);
+insert into t1 values (386, 2);
+insert into t1 values (753, 71);
+insert into t1 values (120, 40);
+insert into t1 values (487, 9);
+insert into t1 values (854, 78);
+insert into t1 values (221, 47);
+insert into t1 values (588, 16);
+insert into t1 values (955, 85);
+insert into t1 values (322, 54);
+insert into t1 values (689, 23);
+insert into t1 values (56, 92);
+insert into t1 values (423, 61);
+insert into t1 values (790, 30);
+insert into t1 values (157, 99);
+insert into t1 values (524, 68);
+insert into t1 values (891, 37);
+insert into t1 values (258, 6);
+insert into t1 values (625, 75);
+insert into t1 values (992, 44);
+insert into t1 values (359, 13);
+insert into t1 values (726, 82);
+insert into t1 values (93, 51);
+insert into t1 values (460, 20);
+insert into t1 values (827, 89);
+insert into t1 values (194, 58);
+insert into t1 values (561, 27);
+insert into t1 values (928, 96);
+insert into t1 values (295, 65);
+insert into t1 values (662, 34);
+insert into t1 values (29, 3);
+insert into t1 values (396, 72);
+insert into t1 values (763, 41);
+insert into t1 values (130, 10);
+insert into t1 values (497, 79);
+insert into t1 values (864, 48);
+insert into t1 values (231, 17);
+insert into t1 values (598, 86);
+insert into t1 values (965, 55);
+insert into t1 values (332, 24);
+insert into t1 values (699, 93);
+insert into t1 values (66, 62);
+insert into t1 values (433, 31);
+insert into t1 values (800, 0);
+insert into t1 values (167, 69);
+insert into t1 values (534, 38);
+insert into t1 values (901, 7);
+insert into t1 values (268, 76);
+insert into t1 values (635, 45);
+insert into t1 values (2, 14);
+insert into t1 values (369, 83);
+insert into t1 values (736, 52);
+insert into t1 values (103, 21);
+insert into t1 values (470, 90);
+insert into t1 values (837, 59);
+insert into t1 values (204, 28);
+insert into t1 values (571, 97);
+insert into t1 values (938, 66);
+insert into t1 values (305, 35);
+insert into t1 values (672, 4);
+insert into t1 values (39, 73);
+insert into t1 values (406, 42);
+insert into t1 values (773, 11);
+insert into t1 values (140, 80);
+insert into t1 values (507, 49);
+insert into t1 values (874, 18);
+insert into t1 values (241, 87);
+insert into t1 values (608, 56);
+insert into t1 values (975, 25);
+insert into t1 values (342, 94);
+insert into t1 values (709, 63);
+insert into t1 values (76, 32);
+insert into t1 values (443, 1);
+insert into t1 values (810, 70);
+insert into t1 values (177, 39);
+insert into t1 values (544, 8);
+insert into t1 values (911, 77);
+insert into t1 values (278, 46);
+insert into t1 values (645, 15);
+insert into t1 values (12, 84);
+insert into t1 values (379, 53);
+insert into t1 values (746, 22);
+insert into t1 values (113, 91);
+insert into t1 values (480, 60);
+insert into t1 values (847, 29);
+insert into t1 values (214, 98);
+insert into t1 values (581, 67);
+insert into t1 values (948, 36);
+insert into t1 values (315, 5);
+insert into t1 values (682, 74);
+insert into t1 values (49, 43);
+insert into t1 values (416, 12);
+insert into t1 values (783, 81);
+insert into t1 values (150, 50);
+insert into t1 values (517, 19);
+insert into t1 values (884, 88);
+insert into t1 values (251, 57);
+insert into t1 values (618, 26);
+insert into t1 values (985, 95);
+insert into t1 values (352, 64);
+insert into t1 values (719, 33);
+insert into t1 values (86, 2);
+insert into t1 values (453, 71);
+insert into t1 values (820, 40);
+insert into t1 values (187, 9);
+insert into t1 values (554, 78);
+insert into t1 values (921, 47);
+insert into t1 values (288, 16);
+insert into t1 values (655, 85);
+insert into t1 values (22, 54);
+insert into t1 values (389, 23);
+insert into t1 values (756, 92);
+insert into t1 values (123, 61);
+insert into t1 values (490, 30);
+insert into t1 values (857, 99);
+insert into t1 values (224, 68);
+insert into t1 values (591, 37);
+insert into t1 values (958, 6);
+insert into t1 values (325, 75);
+insert into t1 values (692, 44);
+insert into t1 values (59, 13);
+insert into t1 values (426, 82);
+insert into t1 values (793, 51);
+insert into t1 values (160, 20);
+insert into t1 values (527, 89);
+insert into t1 values (894, 58);
+insert into t1 values (261, 27);
+insert into t1 values (628, 96);
+insert into t1 values (995, 65);
+insert into t1 values (362, 34);
+insert into t1 values (729, 3);
+insert into t1 values (96, 72);
+insert into t1 values (463, 41);
+insert into t1 values (830, 10);
+insert into t1 values (197, 79);
+insert into t1 values (564, 48);
+insert into t1 values (931, 17);
+insert into t1 values (298, 86);
+insert into t1 values (665, 55);
+insert into t1 values (32, 24);
+insert into t1 values (399, 93);
+insert into t1 values (766, 62);
+insert into t1 values (133, 31);
+insert into t1 values (500, 0);
+insert into t1 values (867, 69);
+insert into t1 values (234, 38);
+insert into t1 values (601, 7);
+insert into t1 values (968, 76);
+insert into t1 values (335, 45);
+insert into t1 values (702, 14);
+insert into t1 values (69, 83);
+insert into t1 values (436, 52);
+insert into t1 values (803, 21);
+insert into t1 values (170, 90);
+insert into t1 values (537, 59);
+insert into t1 values (904, 28);
+insert into t1 values (271, 97);
+insert into t1 values (638, 66);
+insert into t1 values (5, 35);
+insert into t1 values (372, 4);
+insert into t1 values (739, 73);
+insert into t1 values (106, 42);
+insert into t1 values (473, 11);
+insert into t1 values (840, 80);
+insert into t1 values (207, 49);
+insert into t1 values (574, 18);
+insert into t1 values (941, 87);
+insert into t1 values (308, 56);
+insert into t1 values (675, 25);
+insert into t1 values (42, 94);
+insert into t1 values (409, 63);
+insert into t1 values (776, 32);
+insert into t1 values (143, 1);
+insert into t1 values (510, 70);
+insert into t1 values (877, 39);
+insert into t1 values (244, 8);
+insert into t1 values (611, 77);
+insert into t1 values (978, 46);
+insert into t1 values (345, 15);
+insert into t1 values (712, 84);
+insert into t1 values (79, 53);
+insert into t1 values (446, 22);
+insert into t1 values (813, 91);
+insert into t1 values (180, 60);
+insert into t1 values (547, 29);
+insert into t1 values (914, 98);
+insert into t1 values (281, 67);
+insert into t1 values (648, 36);
+insert into t1 values (15, 5);
+insert into t1 values (382, 74);
+insert into t1 values (749, 43);
+insert into t1 values (116, 12);
+insert into t1 values (483, 81);
+insert into t1 values (850, 50);
+insert into t1 values (217, 19);
+insert into t1 values (584, 88);
+insert into t1 values (951, 57);
+insert into t1 values (318, 26);
+insert into t1 values (685, 95);
+insert into t1 values (52, 64);
+insert into t1 values (419, 33);
+insert into t1 values (786, 2);
+insert into t1 values (153, 71);
+insert into t1 values (520, 40);
+insert into t1 values (887, 9);
+insert into t1 values (254, 78);
+insert into t1 values (621, 47);
+insert into t1 values (988, 16);
+insert into t1 values (355, 85);
+insert into t1 values (722, 54);
+insert into t1 values (89, 23);
+insert into t1 values (456, 92);
+insert into t1 values (823, 61);
+insert into t1 values (190, 30);
+insert into t1 values (557, 99);
+insert into t1 values (924, 68);
+insert into t1 values (291, 37);
+insert into t1 values (658, 6);
+insert into t1 values (25, 75);
+insert into t1 values (392, 44);
+insert into t1 values (759, 13);
+insert into t1 values (126, 82);
+insert into t1 values (493, 51);
+insert into t1 values (860, 20);
+insert into t1 values (227, 89);
+insert into t1 values (594, 58);
+insert into t1 values (961, 27);
+insert into t1 values (328, 96);
+insert into t1 values (695, 65);
+insert into t1 values (62, 34);
+insert into t1 values (429, 3);
+insert into t1 values (796, 72);
+insert into t1 values (163, 41);
+insert into t1 values (530, 10);
+insert into t1 values (897, 79);
+insert into t1 values (264, 48);
+insert into t1 values (631, 17);
+insert into t1 values (998, 86);
+insert into t1 values (365, 55);
+insert into t1 values (732, 24);
+insert into t1 values (99, 93);
+insert into t1 values (466, 62);
+insert into t1 values (833, 31);
+insert into t1 values (200, 0);
+insert into t1 values (567, 69);
+insert into t1 values (934, 38);
+insert into t1 values (301, 7);
+insert into t1 values (668, 76);
+insert into t1 values (35, 45);
+insert into t1 values (402, 14);
+insert into t1 values (769, 83);
+insert into t1 values (136, 52);
+insert into t1 values (503, 21);
+insert into t1 values (870, 90);
+insert into t1 values (237, 59);
+insert into t1 values (604, 28);
+insert into t1 values (971, 97);
+insert into t1 values (338, 66);
+insert into t1 values (705, 35);
+insert into t1 values (72, 4);
+insert into t1 values (439, 73);
+insert into t1 values (806, 42);
+insert into t1 values (173, 11);
+insert into t1 values (540, 80);
+insert into t1 values (907, 49);
+insert into t1 values (274, 18);
+insert into t1 values (641, 87);
+insert into t1 values (8, 56);
+insert into t1 values (375, 25);
+insert into t1 values (742, 94);
+insert into t1 values (109, 63);
+insert into t1 values (476, 32);
+insert into t1 values (843, 1);
+insert into t1 values (210, 70);
+insert into t1 values (577, 39);
+insert into t1 values (944, 8);
+insert into t1 values (311, 77);
+insert into t1 values (678, 46);
+insert into t1 values (45, 15);
+insert into t1 values (412, 84);
+insert into t1 values (779, 53);
+insert into t1 values (146, 22);
+insert into t1 values (513, 91);
+insert into t1 values (880, 60);
+insert into t1 values (247, 29);
+insert into t1 values (614, 98);
+insert into t1 values (981, 67);
+insert into t1 values (348, 36);
+insert into t1 values (715, 5);
+insert into t1 values (82, 74);
+insert into t1 values (449, 43);
+insert into t1 values (816, 12);
+insert into t1 values (183, 81);
+insert into t1 values (550, 50);
+insert into t1 values (917, 19);
+insert into t1 values (284, 88);
+insert into t1 values (651, 57);
+insert into t1 values (18, 26);
+insert into t1 values (385, 95);
+insert into t1 values (752, 64);
+insert into t1 values (119, 33);
+insert into t1 values (486, 2);
+insert into t1 values (853, 71);
+insert into t1 values (220, 40);
+insert into t1 values (587, 9);
+insert into t1 values (954, 78);
+insert into t1 values (321, 47);
+insert into t1 values (688, 16);
+insert into t1 values (55, 85);
+insert into t1 values (422, 54);
+insert into t1 values (789, 23);
+insert into t1 values (156, 92);
+insert into t1 values (523, 61);
+insert into t1 values (890, 30);
+insert into t1 values (257, 99);
+insert into t1 values (624, 68);
+insert into t1 values (991, 37);
+insert into t1 values (358, 6);
+insert into t1 values (725, 75);
+insert into t1 values (92, 44);
+insert into t1 values (459, 13);
+insert into t1 values (826, 82);
+insert into t1 values (193, 51);
+insert into t1 values (560, 20);
+insert into t1 values (927, 89);
+insert into t1 values (294, 58);
+insert into t1 values (661, 27);
+insert into t1 values (28, 96);
+insert into t1 values (395, 65);
+insert into t1 values (762, 34);
+insert into t1 values (129, 3);
+insert into t1 values (496, 72);
+insert into t1 values (863, 41);
+insert into t1 values (230, 10);
+insert into t1 values (597, 79);
+insert into t1 values (964, 48);
+insert into t1 values (331, 17);
+insert into t1 values (698, 86);
+insert into t1 values (65, 55);
+insert into t1 values (432, 24);
+insert into t1 values (799, 93);
+insert into t1 values (166, 62);
+insert into t1 values (533, 31);
+insert into t1 values (900, 0);
+insert into t1 values (267, 69);
+insert into t1 values (634, 38);
+insert into t2 values (0, 0);
+insert into t2 values (37, 111);
+insert into t2 values (74, 222);
+insert into t2 values (11, 33);
+insert into t2 values (48, 144);
+insert into t2 values (85, 255);
+insert into t2 values (22, 66);
+insert into t2 values (59, 177);
+insert into t2 values (96, 288);
+insert into t2 values (33, 99);
+insert into t2 values (70, 210);
+insert into t2 values (7, 21);
+insert into t2 values (44, 132);
+insert into t2 values (81, 243);
+insert into t2 values (18, 54);
+insert into t2 values (55, 165);
+insert into t2 values (92, 276);
+insert into t2 values (29, 87);
+insert into t2 values (66, 198);
+insert into t2 values (3, 9);
+insert into t2 values (40, 120);
+insert into t2 values (77, 231);
+insert into t2 values (14, 42);
+insert into t2 values (51, 153);
+insert into t2 values (88, 264);
+insert into t2 values (25, 75);
+insert into t2 values (62, 186);
+insert into t2 values (99, 297);
+insert into t2 values (36, 108);
+insert into t2 values (73, 219);
+insert into t2 values (10, 30);
+insert into t2 values (47, 141);
+insert into t2 values (84, 252);
+insert into t2 values (21, 63);
+insert into t2 values (58, 174);
+insert into t2 values (95, 285);
+insert into t2 values (32, 96);
+insert into t2 values (69, 207);
+insert into t2 values (6, 18);
+insert into t2 values (43, 129);
+insert into t2 values (80, 240);
+insert into t2 values (17, 51);
+insert into t2 values (54, 162);
+insert into t2 values (91, 273);
+insert into t2 values (28, 84);
+insert into t2 values (65, 195);
+insert into t2 values (2, 6);
+insert into t2 values (39, 117);
+insert into t2 values (76, 228);
+insert into t2 values (13, 39);
+insert into t2 values (50, 150);
+insert into t2 values (87, 261);
+insert into t2 values (24, 72);
+insert into t2 values (61, 183);
+insert into t2 values (98, 294);
+insert into t2 values (35, 105);
+insert into t2 values (72, 216);
+insert into t2 values (9, 27);
+insert into t2 values (46, 138);
+insert into t2 values (83, 249);
+insert into t2 values (20, 60);
+insert into t2 values (57, 171);
+insert into t2 values (94, 282);
+insert into t2 values (31, 93);
+insert into t2 values (68, 204);
+insert into t2 values (5, 15);
+insert into t2 values (42, 126);
+insert into t2 values (79, 237);
+insert into t2 values (16, 48);
+insert into t2 values (53, 159);
+insert into t2 values (90, 270);
+insert into t2 values (27, 81);
+insert into t2 values (64, 192);
+insert into t2 values (1, 3);
+insert into t2 values (38, 114);
+insert into t2 values (75, 225);
+insert into t2 values (12, 36);
+insert into t2 values (49, 147);
+insert into t2 values (86, 258);
+insert into t2 values (23, 69);
+insert into t2 values (60, 180);
+insert into t2 values (97, 291);
+insert into t2 values (34, 102);
+insert into t2 values (71, 213);
+insert into t2 values (8, 24);
+insert into t2 values (45, 135);
+insert into t2 values (82, 246);
+insert into t2 values (19, 57);
+insert into t2 values (56, 168);
+insert into t2 values (93, 279);
+insert into t2 values (30, 90);
+insert into t2 values (67, 201);
+insert into t2 values (4, 12);
+insert into t2 values (41, 123);
+insert into t2 values (78, 234);
+insert into t2 values (15, 45);
+insert into t2 values (52, 156);
+insert into t2 values (89, 267);
+insert into t2 values (26, 78);
+insert into t2 values (63, 189);
+create index t1(id);
+create index t2(id);
+create table t3 (k int, p int);
+create table t4 (a int, b int, c int);
+insert into t3 values (5, 0);
+insert into t3 values (5, 1);
+insert into t3 values (5, 2);
+insert into t3 values (2000, 3);
+insert into t3 values (, 4);
+insert into t3 values (7, 5);
+insert into t3 values (7, 6);
+insert into t3 values (999, 7);
+insert into t3 values (2000, 8);
+insert into t3 values (, 9);
+insert into t3 values (1, 10);
+insert into t3 values (5, 11);
+insert into t4 values (0, 0, 0);
+insert into t4 values (0, 1, 1);
+insert into t4 values (0, 2, 2);
+insert into t4 values (0, 3, 3);
+insert into t4 values (0, 4, 4);
+insert into t4 values (0, 5, 5);
+insert into t4 values (1, 0, 6);
+insert into t4 values (1, 1, 7);
+insert into t4 values (1, 2, 8);
+insert into t4 values (1, 3, 9);
+insert into t4 values (1, 4, 10);
+insert into t4 values (1, 5, 11);
+insert into t4 values (2, 0, 12);
+insert into t4 values (2, 1, 13);
+insert into t4 values (2, 2, 14);
+insert into t4 values (2, 3, 15);
+insert into t4 values (2, 4, 16);
+insert into t4 values (2, 5, 17);
+insert into t4 values (3, 0, 18);
+insert into t4 values (3, 1, 19);
+insert into t4 values (3, 2, 20);
+insert into t4 values (3, 3, 21);
+insert into t4 values (3, 4, 22);
+insert into t4 values (3, 5, 23);
+insert into t4 values (4, 0, 24);
+insert into t4 values (4, 1, 25);
+insert into t4 values (4, 2, 26);
+insert into t4 values (4, 3, 27);
+insert into t4 values (4, 4, 28);
+insert into t4 values (4, 5, 29);
+insert into t4 values (5, 0, 30);
+insert into t4 values (5, 1, 31);
+insert into t4 values (5, 2, 32);
+insert into t4 values (5, 3, 33);
+insert into t4 values (5, 4, 34);
+insert into t4 values (5, 5, 35);
+insert into t4 values (6, 0, 36);
+insert into t4 values (6, 1, 37);
+insert into t4 values (6, 2, 38);
+insert into t4 values (6, 3, 39);
+insert into t4 values (6, 4, 40);
+insert into t4 values (6, 5, 41);
+insert into t4 values (7, 0, 42);
+insert into t4 values (7, 1, 43);
+insert into t4 values (7, 2, 44);
+insert into t4 values (7, 3, 45);
+insert into t4 values (7, 4, 46);
+insert into t4 values (7, 5, 47);
+insert into t4 values (8, 0, 48);
+insert into t4 values (8, 1, 49);
+insert into t4 values (8, 2, 50);
+insert into t4 values (8, 3, 51);
+insert into t4 values (8, 4, 52);
+insert into t4 values (8, 5, 53);
+insert into t4 values (9, 0, 54);
+insert into t4 values (9, 1, 55);
+insert into t4 values (9, 2, 56);
+insert into t4 values (9, 3, 57);
+insert into t4 values (9, 4, 58);
+insert into t4 values (9, 5, 59);
+insert into t4 values (10, 0, 60);
+insert into t4 values (10, 1, 61);
+insert into t4 values (10, 2, 62);
+insert into t4 values (10, 3, 63);
+insert into t4 values (10, 4, 64);
+insert into t4 values (10, 5, 65);
+insert into t4 values (11, 0, 66);
+insert into t4 values (11, 1, 67);
+insert into t4 values (11, 2, 68);
+insert into t4 values (11, 3, 69);
+insert into t4 values (11, 4, 70);
+insert into t4 values (11, 5, 71);
+insert into t4 values (12, 0, 72);
+insert into t4 values (12, 1, 73);
+insert into t4 values (12, 2, 74);
+insert into t4 values (12, 3, 75);
+insert into t4 values (12, 4, 76);
+insert into t4 values (12, 5, 77);
+insert into t4 values (13, 0, 78);
+insert into t4 values (13, 1, 79);
+insert into t4 values (13, 2, 80);
+insert into t4 values (13, 3, 81);
+insert into t4 values (13, 4, 82);
+insert into t4 values (13, 5, 83);
+insert into t4 values (14, 0, 84);
+insert into t4 values (14, 1, 85);
+insert into t4 values (14, 2, 86);
+insert into t4 values (14, 3, 87);
+insert into t4 values (14, 4, 88);
+insert into t4 values (14, 5, 89);
+insert into t4 values (15, 0, 90);
+insert into t4 values (15, 1, 91);
+insert into t4 values (15, 2, 92);
+insert into t4 values (15, 3, 93);
+insert into t4 values (15, 4, 94);
+insert into t4 values (15, 5, 95);
+insert into t4 values (16, 0, 96);
+insert into t4 values (16, 1, 97);
+insert into t4 values (16, 2, 98);
+insert into t4 values (16, 3, 99);
+insert into t4 values (16, 4, 100);
+insert into t4 values (16, 5, 101);
+insert into t4 values (17, 0, 102);
+insert into t4 values (17, 1, 103);
+insert into t4 values (17, 2, 104);
+insert into t4 values (17, 3, 105);
+insert into t4 values (17, 4, 106);
+insert into t4 values (17, 5, 107);
+insert into t4 values (18, 0, 108);
+insert into t4 values (18, 1, 109);
+insert into t4 values (18, 2, 110);
+insert into t4 values (18, 3, 111);
+insert into t4 values (18, 4, 112);
+insert into t4 values (18, 5, 113);
+insert into t4 values (19, 0, 114);
+insert into t4 values (19, 1, 115);
+insert into t4 values (19, 2, 116);
+insert into t4 values (19, 3, 117);
+insert into t4 values (19, 4, 118);
+insert into t4 values (19, 5, 119);
+insert into t4 values (20, 0, 120);
+insert into t4 values (20, 1, 121);
+insert into t4 values (20, 2, 122);
+insert into t4 values (20, 3, 123);
+insert into t4 values (20, 4, 124);
+insert into t4 values (20, 5, 125);
+insert into t4 values (21, 0, 126);
+insert into t4 values (21, 1, 127);
+insert into t4 values (21, 2, 128);
+insert into t4 values (21, 3, 129);
+insert into t4 values (21, 4, 130);
+insert into t4 values (21, 5, 131);
+insert into t4 values (22, 0, 132);
+insert into t4 values (22, 1, 133);
+insert into t4 values (22, 2, 134);
+insert into t4 values (22, 3, 135);
+insert into t4 values (22, 4, 136);
+insert into t4 values (22, 5, 137);
+insert into t4 values (23, 0, 138);
+insert into t4 values (23, 1, 139);
+insert into t4 values (23, 2, 140);
+insert into t4 values (23, 3, 141);
+insert into t4 values (23, 4, 142);
+insert into t4 values (23, 5, 143);
+insert into t4 values (24, 0, 144);
+insert into t4 values (24, 1, 145);
+insert into t4 values (24, 2, 146);
+insert into t4 values (24, 3, 147);
+insert into t4 values (24, 4, 148);
+insert into t4 values (24, 5, 149);
+insert into t4 values (25, 0, 150);
+insert into t4 values (25, 1, 151);
+insert into t4 values (25, 2, 152);
+insert into t4 values (25, 3, 153);
+insert into t4 values (25, 4, 154);
+insert into t4 values (25, 5, 155);
+insert into t4 values (26, 0, 156);
+insert into t4 values (26, 1, 157);
+insert into t4 values (26, 2, 158);
+insert into t4 values (26, 3, 159);
+insert into t4 values (26, 4, 160);
+insert into t4 values (26, 5, 161);
+insert into t4 values (27, 0, 162);
+insert into t4 values (27, 1, 163);
+insert into t4 values (27, 2, 164);
+insert into t4 values (27, 3, 165);
+insert into t4 values (27, 4, 166);
+insert into t4 values (27, 5, 167);
+insert into t4 values (28, 0, 168);
+insert into t4 values (28, 1, 169);
+insert into t4 values (28, 2, 170);
+insert into t4 values (28, 3, 171);
+insert into t4 values (28, 4, 172);
+insert into t4 values (28, 5, 173);
+insert into t4 values (29, 0, 174);
+insert into t4 values (29, 1, 175);
+insert into t4 values (29, 2, 176);
+insert into t4 values (29, 3, 177);
+insert into t4 values (29, 4, 178);
+insert into t4 values (29, 5, 179);
+insert into t4 values (30, 0, 180);
+insert into t4 values (30, 1, 181);
+insert into t4 values (30, 2, 182);
+insert into t4 values (30, 3, 183);
+insert into t4 values (30, 4, 184);
+insert into t4 values (30, 5, 185);
+insert into t4 values (31, 0, 186);
+insert into t4 values (31, 1, 187);
+insert into t4 values (31, 2, 188);
+insert into t4 values (31, 3, 189);
+insert into t4 values (31, 4, 190);
+insert into t4 values (31, 5, 191);
+insert into t4 values (32, 0, 192);
+insert into t4 values (32, 1, 193);
+insert into t4 values (32, 2, 194);
+insert into t4 values (32, 3, 195);
+insert into t4 values (32, 4, 196);
+insert into t4 values (32, 5, 197);
+insert into t4 values (33, 0, 198);
+insert into t4 values (33, 1, 199);
+insert into t4 values (33, 2, 200);
+insert into t4 values (33, 3, 201);
+insert into t4 values (33, 4, 202);
+insert into t4 values (33, 5, 203);
+insert into t4 values (34, 0, 204);
+insert into t4 values (34, 1, 205);
+insert into t4 values (34, 2, 206);
+insert into t4 values (34, 3, 207);
+insert into t4 values (34, 4, 208);
+insert into t4 values (34, 5, 209);
+insert into t4 values (35, 0, 210);
+insert into t4 values (35, 1, 211);
+insert into t4 values (35, 2, 212);
+insert into t4 values (35, 3, 213);
+insert into t4 values (35, 4, 214);
+insert into t4 values (35, 5, 215);
+insert into t4 values (36, 0, 216);
+insert into t4 values (36, 1, 217);
+insert into t4 values (36, 2, 218);
+insert into t4 values (36, 3, 219);
+insert into t4 values (36, 4, 220);
+insert into t4 values (36, 5, 221);
+insert into t4 values (37, 0, 222);
+insert into t4 values (37, 1, 223);
+insert into t4 values (37, 2, 224);
+insert into t4 values (37, 3, 225);
+insert into t4 values (37, 4, 226);
+insert into t4 values (37, 5, 227);
+insert into t4 values (38, 0, 228);
+insert into t4 values (38, 1, 229);
+insert into t4 values (38, 2, 230);
+insert into t4 values (38, 3, 231);
+insert into t4 values (38, 4, 232);
+insert into t4 values (38, 5, 233);
+insert into t4 values (39, 0, 234);
+insert into t4 values (39, 1, 235);
+insert into t4 values (39, 2, 236);
+insert into t4 values (39, 3, 237);
+insert into t4 values (39, 4, 238);
+insert into t4 values (39, 5, 239);
+insert into t4 values (40, 0, 240);
+insert into t4 values (40, 1, 241);
+insert into t4 values (40, 2, 242);
+insert into t4 values (40, 3, 243);
+insert into t4 values (40, 4, 244);
+insert into t4 values (40, 5, 245);
+insert into t4 values (41, 0, 246);
+insert into t4 values (41, 1, 247);
+insert into t4 values (41, 2, 248);
+insert into t4 values (41, 3, 249);
+insert into t4 values (41, 4, 250);
+insert into t4 values (41, 5, 251);
+insert into t4 values (42, 0, 252);
+insert into t4 values (42, 1, 253);
+insert into t4 values (42, 2, 254);
+insert into t4 values (42, 3, 255);
+insert into t4 values (42, 4, 256);
+insert into t4 values (42, 5, 257);
+insert into t4 values (43, 0, 258);
+insert into t4 values (43, 1, 259);
+insert into t4 values (43, 2, 260);
+insert into t4 values (43, 3, 261);
+insert into t4 values (43, 4, 262);
+insert into t4 values (43, 5, 263);
+insert into t4 values (44, 0, 264);
+insert into t4 values (44, 1, 265);
+insert into t4 values (44, 2, 266);
+insert into t4 values (44, 3, 267);
+insert into t4 values (44, 4, 268);
+insert into t4 values (44, 5, 269);
+insert into t4 values (45, 0, 270);
+insert into t4 values (45, 1, 271);
+insert into t4 values (45, 2, 272);
+insert into t4 values (45, 3, 273);
+insert into t4 values (45, 4, 274);
+insert into t4 values (45, 5, 275);
+insert into t4 values (46, 0, 276);
+insert into t4 values (46, 1, 277);
+insert into t4 values (46, 2, 278);
+insert into t4 values (46, 3, 279);
+insert into t4 values (46, 4, 280);
+insert into t4 values (46, 5, 281);
+insert into t4 values (47, 0, 282);
+insert into t4 values (47, 1, 283);
+insert into t4 values (47, 2, 284);
+insert into t4 values (47, 3, 285);
+insert into t4 values (47, 4, 286);
+insert into t4 values (47, 5, 287);
+insert into t4 values (48, 0, 288);
+insert into t4 values (48, 1, 289);
+insert into t4 values (48, 2, 290);
+insert into t4 values (48, 3, 291);
+insert into t4 values (48, 4, 292);
+insert into t4 values (48, 5, 293);
+insert into t4 values (49, 0, 294);
+insert into t4 values (49, 1, 295);
+insert into t4 values (49, 2, 296);
+insert into t4 values (49, 3, 297);
+insert into t4 values (49, 4, 298);
+insert into t4 values (49, 5, 299);
+create index t4(a, b);
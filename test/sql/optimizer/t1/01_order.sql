@@ -0,0 +1,8 @@
+open database db2024;
+select * from t1 order by id limit 5;
+select * from t1 where id > 995 order by id;
+select * from t1 where id < 6 order by desc id;
+select id from t1 where v = 7 order by id limit 3;
+select t1.id, t1.v, t2.w from t1, t2 where t1.v = t2.id and t1.id < 16 order by t1.id;
+select t1.id, t2.w from t1, t2 where t1.v = t2.id and t1.id > 990 order by t1.id limit 3;
+exit;
@@ -0,0 +1,8 @@
+open database db2024;
+select t1.id, t2.w from (select t1.id, t2.w from t1 outer join t2 where t1.id = t2.id) where t2.w > 270 order by t1.id;
+select t1.id, t2.w from (select t1.id, t2.w from t1 outer join t2 where t1.id = t2.id) where t1.id > 95 and t1.id < 105 order by t1.id;
+select t1.id, t2.w from t1 outer join t2 where t1.id = t2.id and t2.w < 30 and t1.id < 15 order by t1.id;
+select t1.id, t1.v, t2.w from t1, t2 where t1.v = t2.id and t2.id = 5 order by t1.id;
+select t1.id, t2.w from t1, t2 where t1.id = t2.id and t2.id > 95 order by t1.id;
+select t1.id, t2.w from t1 join t2 where t2.id = t1.id and t1.id <= 3 order by t1.id;
+exit;
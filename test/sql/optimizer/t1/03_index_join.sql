@@ -0,0 +1,8 @@
+open database db2024;
+select t3.k, t3.p, t1.v from t3, t1 where t3.k = t1.id order by t3.p;
+select t3.k, t3.p, t1.v from t3 outer join t1 where t3.k = t1.id order by t3.p;
+select t3.k, t3.p, t1.v from t3, t1 where t3.k = t1.id and t1.v > 40 order by t3.p;
+select t3.k, t3.p, t1.v from t3 outer join t1 where t3.k = t1.id and t1.v > 40 order by t3.p;
+select t3.k, t3.p, t4.b, t4.c from t3, t4 where t3.k = t4.a order by t3.p, t4.c;
+select t3.k, t3.p, t4.b, t4.c from t3 outer join t4 where t3.k = t4.a and t4.b = 2 order by t3.p, t4.c;
+exit;
@@ -0,0 +1,5 @@
+open database db2024;
+select a, b, c from t4 where a in (0, 1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11, 12, 13, 14, 15, 16, 17, 18, 19, 20, 21, 22, 23, 24, 25, 26, 27, 28, 29, 30, 31, 32, 33, 34, 35, 36, 37, 38, 39, 40, 41, 42, 43, 44, 45, 46, 47, 48, 49) and b in (0, 1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11, 12, 13, 14, 15, 16, 17, 18, 19, 20, 21, 22, 23, 24, 25, 26, 27, 28, 29) and c > 280 order by c;
+select a, b, c from t4 where a in (12, 10, 11) and b in (5, 1, 3) order by c;
+select a, b, c from t4 where a in (3, 3, 4) and b in (0, 0) order by c;
+exit;
@@ -0,0 +1,311 @@
+/*------------------------------------------------------------------------------
+ - Copyright (c) 2024. Websoft research group, Nanjing University.
+ -
+ - This program is free software: you can redistribute it and/or modify
+ - it under the terms of the GNU General Public License as published by
+ - the Free Software Foundation, either version 3 of the License, or
+ - (at your option) any later version.
+ -
+ - This program is distributed in the hope that it will be useful,
+ - but WITHOUT ANY WARRANTY; without even the implied warranty of
+ - MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ - GNU General Public License for more details.
+ -
+ - You should have received a copy of the GNU General Public License
+ - along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ -----------------------------------------------------------------------------*/
+
+#include <filesystem>
+#include <map>
+#include <random>
+#include <thread>
+#include "storage/index/index_bp_tree.h"
+#include "../config.h"
+#include "../test_util.h"
+#include "gtest/gtest.h"
+using namespace wsdb;
+
+class BPTreeIndexTest : public ::testing::Test
+{
+protected:
+  void SetUp() override
+  {
+    disk_manager_        = std::make_unique<DiskManager>();
+    buffer_pool_manager_ = std::make_unique<BufferPoolManager>(disk_manager_.get(), nullptr);
+    if (!std::filesystem::exists(TEST_DIR)) {
+      std::filesystem::create_directory(TEST_DIR);
+    }
+    file_name_ = FILE_NAME(TEST_DIR, ::testing::UnitTest::GetInstance()->current_test_info()->name(), IDX_SUFFIX);
+    if (std::filesystem::exists(file_name_)) {
+      std::filesystem::remove(file_name_);
+    }
+    DiskManager::CreateFile(file_name_);
+    fid_ = disk_manager_->OpenFile(file_name_);
+    RTField i_field, s_field;
+    i_field.field_.field_name_ = "k";
+    i_field.field_.field_type_ = TYPE_INT;
+    i_field.field_.field_size_ = 4;
+    s_field.field_.field_name_ = "s";
+    s_field.field_.field_type_ = TYPE_STRING;
+    s_field.field_.field_size_ = 12;
+    key_schema_                = std::make_unique<RecordSchema>(std::vector<RTField>{i_field, s_field});
+  }
+
+  void TearDown() override
+  {
+    tree_ = nullptr;
+    buffer_pool_manager_->DeleteAllPages(fid_);
+    disk_manager_->CloseFile(fid_);
+    DiskManager::DestroyFile(file_name_);
+  }
+
+  void OpenTree()
+  {
+    tree_ = std::make_unique<BPTreeIndex>(disk_manager_.get(), buffer_pool_manager_.get(), fid_, 0, key_schema_.get());
+  }
+
+  auto MakeKey(int k, const std::string &s = "") -> RecordUptr
+  {
+    return std::make_unique<Record>(key_schema_.get(),
+        std::vector<ValueSptr>{ValueFactory::CreateIntValue(k), ValueFactory::CreateStringValue(s.c_str(), s.size())},
+        INVALID_RID);
+  }
+
+  static auto MakeRID(int i) -> RID { return {i / 100 + 1, i % 100}; }
+
+  /// the index should hold exactly the entries of expected, in key order
+  void CheckEntries(const std::multimap<int, RID> &expected)
+  {
+    ASSERT_EQ(tree_->GetEntryNum(), expected.size());
+    auto low  = MakeKey(0);
+    auto it   = tree_->Scan(*low, *low, 0);
+    auto iter = expected.begin();
+    for (; !it->IsEnd(); it->Next(), ++iter) {
+      ASSERT_NE(iter, expected.end());
+      ASSERT_EQ(it->GetRID(), iter->second);
+    }
+    ASSERT_EQ(iter, expected.end());
+  }
+
+  std::unique_ptr<DiskManager>       disk_manager_;
+  std::unique_ptr<BufferPoolManager> buffer_pool_manager_;
+  std::string                        file_name_;
+  file_id_t                          fid_{INVALID_FILE_ID};
+  RecordSchemaUptr                   key_schema_;
+  std::unique_ptr<BPTreeIndex>       tree_;
+};
+
+TEST_F(BPTreeIndexTest, InsertDelete)
+{
+  OpenTree();
+  // keys repeat 4 times, entries with the same key are ordered by rid
+  constexpr int            n = 20000;
+  std::vector<int>         ids(n);
+  std::multimap<int, RID>  expected;
+  std::mt19937             gen(TEST_SEED);
+  for (int i = 0; i < n; i++) {
+    ids[i] = i;
+  }
+  std::shuffle(ids.begin(), ids.end(), gen);
+  for (auto i : ids) {
+    tree_->Insert(*MakeKey(i / 4), MakeRID(i));
+  }
+  for (int i = 0; i < n; i++) {
+    expected.emplace(i / 4, MakeRID(i));
+  }
+  ASSERT_GT(tree_->GetHeight(), 2);
+  CheckEntries(expected);
+  ASSERT_THROW(tree_->Insert(*MakeKey(7), MakeRID(28)), WSDBException_);
+  for (int k : {0, 1, 777, n / 4 - 1}) {
+    auto rids = tree_->Search(*MakeKey(k));
+    ASSERT_EQ(rids.size(), 4);
+    for (int j = 0; j < 4; j++) {
+      ASSERT_EQ(rids[j], MakeRID(k * 4 + j));
+    }
+  }
+  ASSERT_TRUE(tree_->Search(*MakeKey(n)).empty());
+
+  // delete three quarters in random order, then all
+  std::shuffle(ids.begin(), ids.end(), gen);
+  for (int i = 0; i < n; i++) {
+    tree_->Delete(*MakeKey(ids[i] / 4), MakeRID(ids[i]));
+    auto range = expected.equal_range(ids[i] / 4);
+    for (auto it = range.first; it != range.second; ++it) {
+      if (it->second == MakeRID(ids[i])) {
+        expected.erase(it);
+        break;
+      }
+    }
+    if (i == n / 4 * 3) {
+      CheckEntries(expected);
+    }
+  }
+  ASSERT_THROW(tree_->Delete(*MakeKey(1), MakeRID(4)), WSDBException_);
+  ASSERT_TRUE(tree_->IsEmpty());
+  CheckEntries(expected);
+}
+
+TEST_F(BPTreeIndexTest, RangeScan)
+{
+  OpenTree();
+  std::vector<std::string> strs = {"a", "ab", "b", "ba", "zzz"};
+  for (int i = 0; i < 1000; i++) {
+    tree_->Insert(*MakeKey(i / 5, strs[i % 5]), MakeRID(i));
+  }
+  // prefix on the first field
+  std::vector<RID> rids;
+  for (auto it = tree_->Scan(*MakeKey(10), *MakeKey(19), 1); !it->IsEnd(); it->Next()) {
+    rids.push_back(it->GetRID());
+  }
+  ASSERT_EQ(rids.size(), 50);
+  for (int i = 0; i < 50; i++) {
+    ASSERT_EQ(rids[i], MakeRID(50 + i));
+  }
+  // both fields
+  rids.clear();
+  for (auto it = tree_->Scan(*MakeKey(10, "ab"), *MakeKey(11, "b"), 2); !it->IsEnd(); it->Next()) {
+    rids.push_back(it->GetRID());
+  }
+  ASSERT_EQ(rids, (std::vector<RID>{MakeRID(51), MakeRID(52), MakeRID(53), MakeRID(54), MakeRID(55), MakeRID(56),
+                      MakeRID(57)}));
+  // empty range
+  ASSERT_TRUE(tree_->Scan(*MakeKey(300), *MakeKey(400), 1)->IsEnd());
+  // an equality on the first field and a lower bound on the second, with no upper bound on the second
+  rids.clear();
+  for (auto it = tree_->Scan(*MakeKey(10, "b"), 2, *MakeKey(10), 1); !it->IsEnd(); it->Next()) {
+    rids.push_back(it->GetRID());
+  }
+  ASSERT_EQ(rids, (std::vector<RID>{MakeRID(52), MakeRID(53), MakeRID(54)}));
+  // open on either side
+  size_t num = 0;
+  for (auto it = tree_->Scan(*MakeKey(0), 0, *MakeKey(9), 1); !it->IsEnd(); it->Next(), num++) {}
+  ASSERT_EQ(num, 50);
+  num = 0;
+  for (auto it = tree_->Scan(*MakeKey(190), 1, *MakeKey(0), 0); !it->IsEnd(); it->Next(), num++) {}
+  ASSERT_EQ(num, 50);
+}
+
+TEST_F(BPTreeIndexTest, Include)
+{
+  // the string is stored in the leaves only, the entries are ordered by the int
+  OpenTree();
+  tree_->SetIncludeFieldNum(1);
+  ASSERT_EQ(tree_->GetKeyFieldNum(), 1);
+  std::vector<std::pair<RecordUptr, RID>> entries;
+  for (int i = 0; i < 3000; i++) {
+    entries.emplace_back(MakeKey(i / 2, std::to_string(i)), MakeRID(i));
+  }
+  tree_->BulkLoad(entries);
+  for (int i = 3000; i < 4000; i++) {
+    tree_->Insert(*MakeKey(i / 2, std::to_string(i)), MakeRID(i));
+  }
+  ASSERT_THROW(tree_->SetIncludeFieldNum(0), WSDBException_);
+  tree_->Flush();
+  buffer_pool_manager_->FlushAllPages(fid_);
+  OpenTree();
+  ASSERT_EQ(tree_->GetKeyFieldNum(), 1);
+  int i = 100;
+  for (auto it = tree_->Scan(*MakeKey(50), *MakeKey(1999), 1); !it->IsEnd(); it->Next(), i++) {
+    auto rec = it->GetRecord();
+    ASSERT_EQ(rec->GetRID(), MakeRID(i));
+    ASSERT_EQ(rec->GetValueAt(0)->ToString(), std::to_string(i / 2));
+    ASSERT_EQ(rec->GetValueAt(1)->ToString(), std::to_string(i));
+  }
+  ASSERT_EQ(i, 4000);
+  for (int j = 0; j < 4000; j += 2) {
+    tree_->Delete(*MakeKey(j / 2, std::to_string(j)), MakeRID(j));
+  }
+  ASSERT_EQ(tree_->GetEntryNum(), 2000);
+  ASSERT_EQ(tree_->Search(*MakeKey(7)), std::vector<RID>{MakeRID(15)});
+}
+
+TEST_F(BPTreeIndexTest, BulkLoad)
+{
+  OpenTree();
+  constexpr int                           n = 30000;
+  std::vector<std::pair<RecordUptr, RID>> entries;
+  std::multimap<int, RID>                 expected;
+  std::mt19937                            gen(7);
+  for (int i = 0; i < n; i++) {
+    int k = static_cast<int>(gen() % 10000) - 5000;
+    entries.emplace_back(MakeKey(k), MakeRID(i));
+  }
+  tree_->BulkLoad(entries, 0.7);
+  std::sort(entries.begin(), entries.end(), [](const auto &l, const auto &r) {
+    auto lk = std::dynamic_pointer_cast<IntValue>(l.first->GetValueAt(0))->Get();
+    auto rk = std::dynamic_pointer_cast<IntValue>(r.first->GetValueAt(0))->Get();
+    return lk != rk ? lk < rk : (l.second.PageID() != r.second.PageID() ? l.second.PageID() < r.second.PageID()
+                                                                        : l.second.SlotID() < r.second.SlotID());
+  });
+  for (const auto &e : entries) {
+    expected.emplace(std::dynamic_pointer_cast<IntValue>(e.first->GetValueAt(0))->Get(), e.second);
+  }
+  CheckEntries(expected);
+  ASSERT_THROW(tree_->BulkLoad(entries), WSDBException_);
+
+  // the loaded tree takes inserts and deletes, and survives reopening
+  for (int i = n; i < n + 5000; i++) {
+    tree_->Insert(*MakeKey(i), MakeRID(i));
+    expected.emplace(i, MakeRID(i));
+  }
+  for (int i = 0; i < n; i += 2) {
+    auto k = std::dynamic_pointer_cast<IntValue>(entries[i].first->GetValueAt(0))->Get();
+    tree_->Delete(*entries[i].first, entries[i].second);
+    auto range = expected.equal_range(k);
+    for (auto it = range.first; it != range.second; ++it) {
+      if (it->second == entries[i].second) {
+        expected.erase(it);
+        break;
+      }
+    }
+  }
+  tree_->Flush();
+  buffer_pool_manager_->FlushAllPages(fid_);
+  OpenTree();
+  CheckEntries(expected);
+}
+
+TEST_F(BPTreeIndexTest, Concurrent)
+{
+  OpenTree();
+  // every thread inserts and deletes its own keys while searching the keys of the others, the buffer pool has room
+  // for the pins of BUFFER_POOL_SIZE / 2 threads
+  constexpr int            n         = 20000;
+  constexpr int            persist   = 2;
+  const int                threads   = static_cast<int>(std::max<size_t>(BUFFER_POOL_SIZE / 2, 2));
+  std::atomic<int>         failed{0};
+  std::vector<std::thread> workers;
+  for (int t = 0; t < threads; t++) {
+    workers.emplace_back([&, t]() {
+      std::mt19937 gen(t);
+      for (int i = 0; i < n; i++) {
+        int k = i * threads + t;
+        tree_->Insert(*MakeKey(k), MakeRID(k));
+        // the inserted key must be visible to its writer right away
+        if (tree_->Search(*MakeKey(k)).size() != 1) {
+          failed++;
+        }
+        // keys that are not a multiple of persist are deleted again, which merges nodes
+        if (i % persist != 0) {
+          tree_->Delete(*MakeKey(k), MakeRID(k));
+        }
+        // a key of another thread is either found once or not at all
+        int other = static_cast<int>(gen() % static_cast<unsigned>(n * threads));
+        if (tree_->Search(*MakeKey(other)).size() > 1) {
+          failed++;
+        }
+      }
+    });
+  }
+  for (auto &worker : workers) {
+    worker.join();
+  }
+  ASSERT_EQ(failed.load(), 0);
+  std::multimap<int, RID> expected;
+  for (int i = 0; i < n; i += persist) {
+    for (int t = 0; t < threads; t++) {
+      expected.emplace(i * threads + t, MakeRID(i * threads + t));
+    }
+  }
+  CheckEntries(expected);
+}
@@ -0,0 +1,208 @@
+/*------------------------------------------------------------------------------
+ - Copyright (c) 2024. Websoft research group, Nanjing University.
+ -
+ - This program is free software: you can redistribute it and/or modify
+ - it under the terms of the GNU General Public License as published by
+ - the Free Software Foundation, either version 3 of the License, or
+ - (at your option) any later version.
+ -
+ - This program is distributed in the hope that it will be useful,
+ - but WITHOUT ANY WARRANTY; without even the implied warranty of
+ - MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ - GNU General Public License for more details.
+ -
+ - You should have received a copy of the GNU General Public License
+ - along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ -----------------------------------------------------------------------------*/
+
+#include <filesystem>
+#include <map>
+#include <random>
+#include "storage/index/index_hash.h"
+#include "../config.h"
+#include "../test_util.h"
+#include "gtest/gtest.h"
+using namespace wsdb;
+
+class HashIndexTest : public ::testing::Test
+{
+protected:
+  void SetUp() override
+  {
+    disk_manager_        = std::make_unique<DiskManager>();
+    buffer_pool_manager_ = std::make_unique<BufferPoolManager>(disk_manager_.get(), nullptr);
+    if (!std::filesystem::exists(TEST_DIR)) {
+      std::filesystem::create_directory(TEST_DIR);
+    }
+    file_name_ = FILE_NAME(TEST_DIR, ::testing::UnitTest::GetInstance()->current_test_info()->name(), IDX_SUFFIX);
+    if (std::filesystem::exists(file_name_)) {
+      std::filesystem::remove(file_name_);
+    }
+    DiskManager::CreateFile(file_name_);
+    fid_ = disk_manager_->OpenFile(file_name_);
+    RTField i_field, s_field;
+    i_field.field_.field_name_ = "k";
+    i_field.field_.field_type_ = TYPE_INT;
+    i_field.field_.field_size_ = 4;
+    s_field.field_.field_name_ = "s";
+    s_field.field_.field_type_ = TYPE_STRING;
+    s_field.field_.field_size_ = 12;
+    key_schema_                = std::make_unique<RecordSchema>(std::vector<RTField>{i_field, s_field});
+  }
+
+  void TearDown() override
+  {
+    index_ = nullptr;
+    buffer_pool_manager_->DeleteAllPages(fid_);
+    disk_manager_->CloseFile(fid_);
+    DiskManager::DestroyFile(file_name_);
+  }
+
+  void OpenIndex()
+  {
+    index_ = std::make_unique<HashIndex>(disk_manager_.get(), buffer_pool_manager_.get(), fid_, 0, key_schema_.get());
+  }
+
+  auto MakeKey(int k, const std::string &s = "") -> RecordUptr
+  {
+    return std::make_unique<Record>(key_schema_.get(),
+        std::vector<ValueSptr>{ValueFactory::CreateIntValue(k), ValueFactory::CreateStringValue(s.c_str(), s.size())},
+        INVALID_RID);
+  }
+
+  static auto MakeRID(int i) -> RID { return {i / 100 + 1, i % 100}; }
+
+  /// the rids of every key of expected should be found, in any order
+  void CheckEntries(const std::multimap<int, RID> &expected)
+  {
+    ASSERT_EQ(index_->GetEntryNum(), expected.size());
+    for (auto it = expected.begin(); it != expected.end(); it = expected.upper_bound(it->first)) {
+      auto range = expected.equal_range(it->first);
+      auto rids  = index_->Search(*MakeKey(it->first));
+      ASSERT_EQ(rids.size(), std::distance(range.first, range.second));
+      for (auto iter = range.first; iter != range.second; ++iter) {
+        ASSERT_NE(std::find(rids.begin(), rids.end(), iter->second), rids.end());
+      }
+    }
+  }
+
+  std::unique_ptr<DiskManager>       disk_manager_;
+  std::unique_ptr<BufferPoolManager> buffer_pool_manager_;
+  std::string                        file_name_;
+  file_id_t                          fid_{INVALID_FILE_ID};
+  RecordSchemaUptr                   key_schema_;
+  std::unique_ptr<HashIndex>         index_;
+};
+
+TEST_F(HashIndexTest, InsertDelete)
+{
+  OpenIndex();
+  ASSERT_EQ(index_->GetGlobalDepth(), 0);
+  ASSERT_EQ(index_->GetBucketNum(), 1);
+  // keys repeat twice
+  constexpr int           n = 20000;
+  std::vector<int>        ids(n);
+  std::multimap<int, RID> expected;
+  std::mt19937            gen(TEST_SEED);
+  for (int i = 0; i < n; i++) {
+    ids[i] = i;
+  }
+  std::shuffle(ids.begin(), ids.end(), gen);
+  for (auto i : ids) {
+    index_->Insert(*MakeKey(i / 2), MakeRID(i));
+    expected.emplace(i / 2, MakeRID(i));
+  }
+  // the buckets split and the directory doubled
+  ASSERT_GT(index_->GetBucketNum(), n / index_->GetBucketMaxSize());
+  ASSERT_GE(1UL << index_->GetGlobalDepth(), index_->GetBucketNum());
+  CheckEntries(expected);
+  ASSERT_THROW(index_->Insert(*MakeKey(7), MakeRID(14)), WSDBException_);
+  ASSERT_TRUE(index_->Search(*MakeKey(n)).empty());
+  ASSERT_TRUE(index_->Search(*MakeKey(1, "x")).empty());
+
+  // delete in random order, checking the index as it shrinks
+  std::shuffle(ids.begin(), ids.end(), gen);
+  for (int i = 0; i < n; i++) {
+    index_->Delete(*MakeKey(ids[i] / 2), MakeRID(ids[i]));
+    auto range = expected.equal_range(ids[i] / 2);
+    for (auto it = range.first; it != range.second; ++it) {
+      if (it->second == MakeRID(ids[i])) {
+        expected.erase(it);
+        break;
+      }
+    }
+    if (i % 5000 == 0) {
+      CheckEntries(expected);
+    }
+  }
+  ASSERT_THROW(index_->Delete(*MakeKey(0), MakeRID(0)), WSDBException_);
+  // buckets merged back and the directory halved
+  ASSERT_EQ(index_->GetEntryNum(), 0);
+  ASSERT_EQ(index_->GetGlobalDepth(), 0);
+  ASSERT_EQ(index_->GetBucketNum(), 1);
+}
+
+TEST_F(HashIndexTest, Duplicates)
+{
+  OpenIndex();
+  // key -1 holds several pages of entries, they go to overflow pages as no split separates them
+  int                     dup = static_cast<int>(index_->GetBucketMaxSize()) * 3 + 7;
+  std::multimap<int, RID> expected;
+  for (int i = 0; i < dup; i++) {
+    index_->Insert(*MakeKey(-1), MakeRID(i));
+    index_->Insert(*MakeKey(i), MakeRID(dup + i));
+    expected.emplace(-1, MakeRID(i));
+    expected.emplace(i, MakeRID(dup + i));
+  }
+  CheckEntries(expected);
+  for (int i = 0; i < dup; i += 2) {
+    index_->Delete(*MakeKey(-1), MakeRID(i));
+  }
+  for (auto it = expected.begin(); it != expected.end();) {
+    it = it->first == -1 && it->second.SlotID() % 2 == 0 ? expected.erase(it) : std::next(it);
+  }
+  ASSERT_EQ(index_->Search(*MakeKey(-1)).size(), dup / 2);
+  CheckEntries(expected);
+}
+
+TEST_F(HashIndexTest, Scan)
+{
+  OpenIndex();
+  for (int i = 0; i < 1000; i++) {
+    index_->Insert(*MakeKey(i % 10, "s"), MakeRID(i));
+  }
+  auto key = MakeKey(3, "s");
+  auto it  = index_->Scan(*key, *key, 2);
+  size_t num = 0;
+  for (; !it->IsEnd(); it->Next(), num++) {
+    ASSERT_EQ(it->GetRID().SlotID() % 10, 3);
+    auto rec = it->GetRecord();
+    ASSERT_EQ(rec->GetRID(), it->GetRID());
+    ASSERT_EQ(Record::Compare(*rec, *key), 0);
+  }
+  ASSERT_EQ(num, 100);
+  // a hash index can not serve ranges or key prefixes
+  ASSERT_THROW(index_->Scan(*key, *MakeKey(4, "s"), 2), WSDBException_);
+  ASSERT_THROW(index_->Scan(*key, *key, 1), WSDBException_);
+}
+
+TEST_F(HashIndexTest, Reopen)
+{
+  OpenIndex();
+  std::multimap<int, RID> expected;
+  for (int i = 0; i < 5000; i++) {
+    index_->Insert(*MakeKey(i), MakeRID(i));
+    expected.emplace(i, MakeRID(i));
+  }
+  auto depth  = index_->GetGlobalDepth();
+  auto bucket = index_->GetBucketNum();
+  index_->Flush();
+  buffer_pool_manager_->FlushAllPages(fid_);
+  OpenIndex();
+  ASSERT_EQ(index_->GetGlobalDepth(), depth);
+  ASSERT_EQ(index_->GetBucketNum(), bucket);
+  CheckEntries(expected);
+  index_->Insert(*MakeKey(5000), MakeRID(5000));
+  expected.emplace(5000, MakeRID(5000));
+  CheckEntries(expected);
+}
@@ -0,0 +1,66 @@
+/*------------------------------------------------------------------------------
+ - Copyright (c) 2024. Websoft research group, Nanjing University.
+ -
+ - This program is free software: you can redistribute it and/or modify
+ - it under the terms of the GNU General Public License as published by
+ - the Free Software Foundation, either version 3 of the License, or
+ - (at your option) any later version.
+ -
+ - This program is distributed in the hope that it will be useful,
+ - but WITHOUT ANY WARRANTY; without even the implied warranty of
+ - MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ - GNU General Public License for more details.
+ -
+ - You should have received a copy of the GNU General Public License
+ - along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ -----------------------------------------------------------------------------*/
+
+#include "parser/parser.h"
+#include "system/plan_cache.h"
+#include "gtest/gtest.h"
+using namespace wsdb;
+
+TEST(PlanCacheTest, NormalizeWhiteSpace)
+{
+  EXPECT_EQ(PlanCache::Normalize("  SELECT *\n\tFROM t   WHERE id = 1 ;\n"), "SELECT * FROM t WHERE id = 1 ;");
+  EXPECT_EQ(PlanCache::Normalize("SELECT * FROM t WHERE id = 1;"), "SELECT * FROM t WHERE id = 1;");
+  EXPECT_EQ(PlanCache::Normalize(""), "");
+}
+
+TEST(PlanCacheTest, NormalizeComments)
+{
+  EXPECT_EQ(PlanCache::Normalize("SELECT * -- all columns\nFROM t;"), "SELECT * FROM t;");
+  EXPECT_EQ(PlanCache::Normalize("SELECT */* all columns */FROM t;"), "SELECT * FROM t;");
+  EXPECT_EQ(PlanCache::Normalize("PREPARE q AS/* lookup */SELECT * FROM t WHERE id = ?;"),
+      "PREPARE q AS SELECT * FROM t WHERE id = ?;");
+  EXPECT_EQ(PlanCache::Normalize("SELECT * FROM t; -- no new line"), "SELECT * FROM t;");
+}
+
+TEST(PlanCacheTest, NormalizeKeepsStrings)
+{
+  EXPECT_EQ(PlanCache::Normalize("SELECT * FROM t WHERE name = 'a  b -- c';"),
+      "SELECT * FROM t WHERE name = 'a  b -- c';");
+  EXPECT_EQ(
+      PlanCache::Normalize("INSERT INTO t VALUES ( 'x\n/*y*/' ,  1);"), "INSERT INTO t VALUES ( 'x\n/*y*/' , 1);");
+  // a literal without its closing quote is kept to the end, the parser rejects it
+  EXPECT_EQ(PlanCache::Normalize("SELECT 'abc  "), "SELECT 'abc  ");
+}
+
+TEST(PlanCacheTest, ParamValue)
+{
+  ParamValue param(1);
+  EXPECT_EQ(param.ToString(), "?2");
+  EXPECT_EQ(param.GetIndex(), 1);
+  EXPECT_FALSE(param.IsNull());
+  EXPECT_THROW((void)(param < *ValueFactory::CreateIntValue(1)), WSDBException_);
+}
+
+TEST(PlanCacheTest, PrepareParams)
+{
+  // the text of a PREPARE is parsed again to prepare the statement after DDL or ANALYZE
+  auto prep =
+      std::dynamic_pointer_cast<ast::Prepare>(Parser::Parse("PREPARE q AS SELECT * FROM t WHERE id = ? AND v > ?;"));
+  ASSERT_NE(prep, nullptr);
+  EXPECT_EQ(prep->param_num_, 2U);
+  EXPECT_THROW((void)Parser::Parse("SELECT * FROM t WHERE id = ?;"), WSDBException_);
+}
@@ -0,0 +1,52 @@
+/*------------------------------------------------------------------------------
+ - Copyright (c) 2024. Websoft research group, Nanjing University.
+ -
+ - This program is free software: you can redistribute it and/or modify
+ - it under the terms of the GNU General Public License as published by
+ - the Free Software Foundation, either version 3 of the License, or
+ - (at your option) any later version.
+ -
+ - This program is distributed in the hope that it will be useful,
+ - but WITHOUT ANY WARRANTY; without even the implied warranty of
+ - MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ - GNU General Public License for more details.
+ -
+ - You should have received a copy of the GNU General Public License
+ - along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ -----------------------------------------------------------------------------*/
+
+/**
+ * @brief helpers shared by the tests and benchmarks that build records without a catalog
+ *
+ */
+
+#ifndef WSDB_TEST_UTIL_H
+#define WSDB_TEST_UTIL_H
+
+#include <string>
+#include <vector>
+#include "common/meta.h"
+
+namespace wsdb {
+
+/// seed of the random test data, the same in every run so that a failure can be reproduced
+constexpr uint32_t TEST_SEED = 42;
+
+/// strings from empty to the full size of a char(8) field, with common prefixes
+inline const std::vector<std::string> TEST_STRS = {"", "a", "ab", "abc", "b", "zzzzzzzz"};
+
+inline auto MakeField(const std::string &name, FieldType type = TYPE_INT, size_t size = sizeof(int32_t),
+    table_id_t table_id = INVALID_TABLE_ID) -> RTField
+{
+  RTField f;
+  f.field_.table_id_   = table_id;
+  f.field_.field_name_ = name;
+  f.field_.field_type_ = type;
+  f.field_.field_size_ = size;
+  f.field_.nullable_   = true;
+  return f;
+}
+
+}  // namespace wsdb
+
+#endif  // WSDB_TEST_UTIL_H